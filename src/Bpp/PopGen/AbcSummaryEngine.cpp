@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "AbcSummaryEngine.h"
+#include "SequenceStatistics.h"
+
+// From the STL
+#include <cmath>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+const char* const STATISTIC_NAMES[] = {
+  "S", "singletons", "pi", "thetaW", "thetaH", "tajimaD", "fayWuH",
+  "K", "haplotypeDiversity", "H1", "H12", "H2H1",
+  "ZnS", "ZA", "wallB", "wallQ", "Rm",
+  "dxy", "fstHudson"
+};
+
+const size_t NUMBER_OF_STATISTICS = sizeof(STATISTIC_NAMES) / sizeof(STATISTIC_NAMES[0]);
+}
+
+/******************************************************************************/
+
+AbcSummaryEngine::AbcSummaryEngine(const vector<string>& statistics, size_t batchSize) :
+  names_(statistics),
+  statistics_(),
+  needHaplotypes_(false),
+  needLd_(false),
+  needRm_(false),
+  needGroups_(false),
+  group1_(),
+  group2_(),
+  batch_(batchSize),
+  workspaces_(batchSize),
+  results_()
+{
+  if (batchSize == 0)
+    throw BadIntegerException("AbcSummaryEngine::AbcSummaryEngine: batchSize must be > 0.", 0);
+  for (const auto& name : statistics)
+  {
+    size_t code = 0;
+    while (code < NUMBER_OF_STATISTICS && name != STATISTIC_NAMES[code])
+    {
+      code++;
+    }
+    if (code == NUMBER_OF_STATISTICS)
+      throw Exception("AbcSummaryEngine::AbcSummaryEngine: unknown statistic '" + name + "'.");
+    Statistic_ statistic = static_cast<Statistic_>(code);
+    statistics_.push_back(statistic);
+    needHaplotypes_ |= (statistic >= K_ && statistic <= H2H1_);
+    needLd_ |= (statistic >= ZNS_ && statistic <= WALL_Q_);
+    needRm_ |= (statistic == RM_);
+    needGroups_ |= (statistic >= DXY_);
+  }
+}
+
+/******************************************************************************/
+
+vector<string> AbcSummaryEngine::getAvailableStatistics()
+{
+  return vector<string>(STATISTIC_NAMES, STATISTIC_NAMES + NUMBER_OF_STATISTICS);
+}
+
+/******************************************************************************/
+
+void AbcSummaryEngine::setGroups(const vector<size_t>& group1, const vector<size_t>& group2)
+{
+  group1_ = group1;
+  group2_ = group2;
+}
+
+/******************************************************************************/
+
+void AbcSummaryEngine::compute(const HaplotypeMatrix& hm, double* values) const
+{
+  Workspace workspace;
+  compute(hm, values, workspace);
+}
+
+/******************************************************************************/
+
+void AbcSummaryEngine::compute(const HaplotypeMatrix& hm, double* values, Workspace& workspace) const
+{
+  size_t nbSnps = hm.getNumberOfSnps();
+  size_t nbWords = hm.getNumberOfWords();
+  size_t nbHaplotypes = hm.getNumberOfHaplotypes();
+  double n = static_cast<double>(nbHaplotypes);
+
+  // Site frequency spectrum
+  double singletons = 0., pi = 0., thetaH = 0.;
+  for (size_t i = 0; i < nbSnps; ++i)
+  {
+    size_t k = HaplotypeMatrix::popCount(hm.column(i), nbWords);
+    double kk = static_cast<double>(k);
+    if (k == 1 || k + 1 == nbHaplotypes)
+      singletons++;
+    pi += 2. * kk * (n - kk) / (n * (n - 1.));
+    thetaH += 2. * kk * kk / (n * (n - 1.));
+  }
+  double s = static_cast<double>(nbSnps);
+  double a1 = 0., a2 = 0.;
+  for (double i = 1.; i < n; ++i)
+  {
+    a1 += 1. / i;
+    a2 += 1. / (i * i);
+  }
+  double thetaW = a1 > 0. ? s / a1 : NAN;
+  double tajimaD = NAN;
+  if (nbSnps > 0 && nbHaplotypes > 1)
+  {
+    double b1 = (n + 1.) / (3. * (n - 1.));
+    double b2 = 2. * (n * n + n + 3.) / (9. * n * (n - 1.));
+    double c1 = b1 - 1. / a1;
+    double c2 = b2 - (n + 2.) / (a1 * n) + a2 / (a1 * a1);
+    double e1 = c1 / a1;
+    double e2 = c2 / (a1 * a1 + a2);
+    tajimaD = (pi - thetaW) / sqrt(e1 * s + e2 * s * (s - 1.));
+  }
+
+  SequenceStatistics::HaplotypeFrequencyStats haplotypes = { 0, NAN, NAN, NAN, NAN };
+  if (needHaplotypes_ && nbHaplotypes > 0)
+  {
+    if (nbSnps == 0)
+    {
+      // A single haplotype, carried by all the sequences
+      workspace.haplotypes.counts.assign(1, nbHaplotypes);
+      haplotypes = SequenceStatistics::haplotypeFrequencyStatistics(workspace.haplotypes.counts, workspace.haplotypes.frequencies);
+    }
+    else
+      haplotypes = HaplotypeWindowStatistics::windowStatistics(hm, vector<size_t>(), 0, nbSnps - 1, workspace.haplotypes);
+  }
+
+  LinkageStatistics::LdTests ld = { 0, 0, NAN, NAN, NAN, NAN };
+  if (needLd_)
+    ld = LinkageStatistics::ldTests(hm, workspace.ld);
+  double rm = needRm_ ? static_cast<double>(LinkageStatistics::rm(hm)) : NAN;
+
+  double dxy = NAN, fstHudson = NAN;
+  if (needGroups_)
+  {
+    vector<uint64_t>& mask1 = workspace.mask1;
+    vector<uint64_t>& mask2 = workspace.mask2;
+    hm.getMask(group1_, mask1);
+    hm.getMask(group2_, mask2);
+    double n1 = static_cast<double>(group1_.size());
+    double n2 = static_cast<double>(group2_.size());
+    double within1 = 0., within2 = 0., between = 0.;
+    for (size_t i = 0; i < nbSnps; ++i)
+    {
+      const uint64_t* col = hm.column(i);
+      double k1 = 0., k2 = 0.;
+      for (size_t w = 0; w < nbWords; ++w)
+      {
+        k1 += HaplotypeMatrix::popCount(col[w] & mask1[w]);
+        k2 += HaplotypeMatrix::popCount(col[w] & mask2[w]);
+      }
+      within1 += 2. * k1 * (n1 - k1) / (n1 * (n1 - 1.));
+      within2 += 2. * k2 * (n2 - k2) / (n2 * (n2 - 1.));
+      between += (k1 * (n2 - k2) + k2 * (n1 - k1)) / (n1 * n2);
+    }
+    if (n1 > 0. && n2 > 0.)
+      dxy = between;
+    if (n1 > 1. && n2 > 1. && between > 0.)
+      fstHudson = 1. - (within1 + within2) / 2. / between;
+  }
+
+  for (size_t j = 0; j < statistics_.size(); ++j)
+  {
+    double value = NAN;
+    switch (statistics_[j])
+    {
+    case S_: value = s; break;
+    case SINGLETONS_: value = singletons; break;
+    case PI_: value = nbHaplotypes > 1 ? pi : NAN; break;
+    case THETA_W_: value = thetaW; break;
+    case THETA_H_: value = nbHaplotypes > 1 ? thetaH : NAN; break;
+    case TAJIMA_D_: value = tajimaD; break;
+    case FAY_WU_H_: value = nbHaplotypes > 1 ? pi - thetaH : NAN; break;
+    case K_: value = nbHaplotypes > 0 ? static_cast<double>(haplotypes.numberOfHaplotypes) : NAN; break;
+    case HAPLOTYPE_DIVERSITY_: value = haplotypes.diversity; break;
+    case H1_: value = haplotypes.H1; break;
+    case H12_: value = haplotypes.H12; break;
+    case H2H1_: value = haplotypes.H2H1; break;
+    case ZNS_: value = ld.ZnS; break;
+    case ZA_: value = ld.ZA; break;
+    case WALL_B_: value = ld.wallB; break;
+    case WALL_Q_: value = ld.wallQ; break;
+    case RM_: value = rm; break;
+    case DXY_: value = dxy; break;
+    case FST_HUDSON_: value = fstHudson; break;
+    }
+    values[j] = value;
+  }
+}
+
+/******************************************************************************/
+
+Vdouble AbcSummaryEngine::compute(const HaplotypeMatrix& hm) const
+{
+  Vdouble values(statistics_.size());
+  compute(hm, values.data());
+  return values;
+}
+
+/******************************************************************************/
+
+size_t AbcSummaryEngine::run(
+    ReplicateSource& source,
+    ostream& out,
+    const ExecutionContext& context)
+{
+  size_t nbStatistics = statistics_.size();
+  uint64_t header = static_cast<uint64_t>(nbStatistics);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  size_t total = 0;
+  bool more = true;
+  while (more)
+  {
+    size_t nb = 0;
+    while (nb < batch_.size() && (more = source.nextReplicate(batch_[nb])))
+    {
+      nb++;
+    }
+    results_.resize(nb * nbStatistics);
+    context.parallelFor(0, nb, [&](size_t i) {
+          compute(batch_[i], results_.data() + i * nbStatistics, workspaces_[i]);
+        });
+    out.write(reinterpret_cast<const char*>(results_.data()), static_cast<streamsize>(results_.size() * sizeof(double)));
+    if (!out)
+      throw IOException("AbcSummaryEngine::run: fail to write the results.");
+    total += nb;
+  }
+  return total;
+}
+
+/******************************************************************************/
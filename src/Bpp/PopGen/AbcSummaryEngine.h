@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _ABCSUMMARYENGINE_H_
+#define _ABCSUMMARYENGINE_H_
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/VectorTools.h>
+
+// From local
+#include "ExecutionContext.h"
+#include "HaplotypeMatrix.h"
+#include "HaplotypeWindowStatistics.h"
+#include "LinkageStatistics.h"
+#include "ReplicateSource.h"
+
+// From the STL
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Computation of summary statistics on many replicates, for
+ * Approximate Bayesian Computation.
+ *
+ * The engine is configured once with the list of the statistics to
+ * compute, by name. Each replicate is a HaplotypeMatrix, polarized so that
+ * the derived allele is the 1 bit (as with ms-like simulators). The
+ * intermediate values shared by several statistics (derived allele counts,
+ * haplotype counts, pairs of SNPs) are computed only once per replicate,
+ * and only when a requested statistic needs them.
+ *
+ * Available statistics:
+ * - SFS-based: "S" (number of SNPs), "singletons" (SNPs with an allele
+ *   carried by a single haplotype), "pi" (Tajima 1983), "thetaW"
+ *   (Watterson 1975), "thetaH" (Fay and Wu 2000), "tajimaD", "fayWuH"
+ *   (pi - thetaH).
+ * - Haplotype: "K" (number of haplotypes), "haplotypeDiversity", "H1",
+ *   "H12", "H2H1" (see SequenceStatistics::haplotypeFrequencyStatistics()).
+ * - Linkage disequilibrium: "ZnS", "ZA", "wallB", "wallQ", "Rm" (see
+ *   LinkageStatistics).
+ * - Between groups, see setGroups(): "dxy" (mean number of differences
+ *   between two haplotypes of different groups) and "fstHudson"
+ *   (1 - Hw / Hb, Hudson et al. 1992).
+ *
+ * A statistic that is not defined for a replicate is set to NaN.
+ *
+ * run() reads the replicates from a ReplicateSource by batches, computes
+ * the statistics of a batch in parallel and writes them as a binary
+ * matrix: a 64 bits unsigned integer with the number of statistics,
+ * followed by one row of doubles per replicate, in native byte order.
+ * The matrices of a batch, the buffers used to compute each of them (see
+ * Workspace) and the result buffer are reused from one batch to the next.
+ */
+class AbcSummaryEngine
+{
+public:
+  /**
+   * @brief The buffers used to compute a replicate, reused from one replicate to the next.
+   */
+  struct Workspace
+  {
+    std::vector<uint64_t> mask1;
+    std::vector<uint64_t> mask2;
+    HaplotypeWindowStatistics::Workspace haplotypes;
+    LinkageStatistics::Workspace ld;
+
+    Workspace() : mask1(), mask2(), haplotypes(), ld() {}
+  };
+
+private:
+  enum Statistic_
+  {
+    S_, SINGLETONS_, PI_, THETA_W_, THETA_H_, TAJIMA_D_, FAY_WU_H_,
+    K_, HAPLOTYPE_DIVERSITY_, H1_, H12_, H2H1_,
+    ZNS_, ZA_, WALL_B_, WALL_Q_, RM_,
+    DXY_, FST_HUDSON_
+  };
+
+  std::vector<std::string> names_;
+  std::vector<Statistic_> statistics_;
+  bool needHaplotypes_;
+  bool needLd_;
+  bool needRm_;
+  bool needGroups_;
+  std::vector<size_t> group1_;
+  std::vector<size_t> group2_;
+  std::vector<HaplotypeMatrix> batch_;
+  std::vector<Workspace> workspaces_;
+  std::vector<double> results_;
+
+public:
+  /**
+   * @brief Build a new engine.
+   *
+   * @param statistics The names of the statistics to compute, in the order of the output.
+   * @param batchSize The number of replicates computed together by run().
+   * @throw Exception if a statistic is unknown.
+   * @throw BadIntegerException if batchSize is 0.
+   */
+  AbcSummaryEngine(const std::vector<std::string>& statistics, size_t batchSize = 256);
+
+  virtual ~AbcSummaryEngine() {}
+
+public:
+  /**
+   * @brief Get the names of all the available statistics.
+   */
+  static std::vector<std::string> getAvailableStatistics();
+
+  size_t getNumberOfStatistics() const { return names_.size(); }
+
+  const std::vector<std::string>& getStatisticNames() const { return names_; }
+
+  /**
+   * @brief Set the two groups of haplotypes used by the between-group statistics.
+   *
+   * @param group1 The indices of the haplotypes of the first group.
+   * @param group2 The indices of the haplotypes of the second group.
+   */
+  void setGroups(const std::vector<size_t>& group1, const std::vector<size_t>& group2);
+
+  /**
+   * @brief Compute the statistics of a replicate.
+   *
+   * @param hm The replicate.
+   * @param values The array receiving one value per statistic.
+   * @throw IndexOutOfBoundsException if a group contains an haplotype out of hm.
+   */
+  void compute(const HaplotypeMatrix& hm, double* values) const;
+
+  /**
+   * @brief Compute the statistics of a replicate, with given buffers.
+   *
+   * @param hm The replicate.
+   * @param values The array receiving one value per statistic.
+   * @param workspace The buffers, which can be reused for another replicate.
+   * @throw IndexOutOfBoundsException if a group contains an haplotype out of hm.
+   */
+  void compute(const HaplotypeMatrix& hm, double* values, Workspace& workspace) const;
+
+  /**
+   * @brief Compute the statistics of a replicate.
+   *
+   * @param hm The replicate.
+   * @return One value per statistic.
+   */
+  Vdouble compute(const HaplotypeMatrix& hm) const;
+
+  /**
+   * @brief Compute the statistics of all the replicates of a source.
+   *
+   * @param source The replicates.
+   * @param out The stream receiving the binary matrix of results.
+   * @param context The ExecutionContext used to compute a batch.
+   * @return The number of replicates.
+   * @throw IOException if the results can not be written.
+   */
+  size_t run(
+      ReplicateSource& source,
+      std::ostream& out,
+      const ExecutionContext& context = ExecutionContext::sequential());
+};
+} // end of namespace bpp;
+
+#endif // _ABCSUMMARYENGINE_H_
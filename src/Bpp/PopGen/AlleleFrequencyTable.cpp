@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "AlleleFrequencyTable.h"
+
+// From the STL
+#include <algorithm>
+#include <set>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+AlleleFrequencyTable::AlleleFrequencyTable(const PolymorphismSequenceContainer& psc, unsigned int minSampleSize) :
+  groupIds_(),
+  sites_(),
+  derived_(),
+  sampleSizes_()
+{
+  build_(psc, nullptr, false, minSampleSize);
+}
+
+AlleleFrequencyTable::AlleleFrequencyTable(const PolymorphismSequenceContainer& psc, const Sequence& ancestralSites, unsigned int minSampleSize) :
+  groupIds_(),
+  sites_(),
+  derived_(),
+  sampleSizes_()
+{
+  if (psc.getNumberOfSites() != ancestralSites.size())
+    throw DimensionException("AlleleFrequencyTable::AlleleFrequencyTable: ancestralSites and psc don't have the same size.", ancestralSites.size(), psc.getNumberOfSites());
+  AncestralStates ancestral(ancestralSites);
+  build_(psc, &ancestral, false, minSampleSize);
+}
+
+AlleleFrequencyTable::AlleleFrequencyTable(const PolymorphismSequenceContainer& psc, const AncestralStates& ancestral, unsigned int minSampleSize) :
+  groupIds_(),
+  sites_(),
+  derived_(),
+  sampleSizes_()
+{
+  if (psc.getNumberOfSites() != ancestral.getNumberOfSites())
+    throw DimensionException("AlleleFrequencyTable::AlleleFrequencyTable: ancestral and psc don't have the same size.", ancestral.getNumberOfSites(), psc.getNumberOfSites());
+  build_(psc, &ancestral, true, minSampleSize);
+}
+
+AlleleFrequencyTable::AlleleFrequencyTable(const PolymorphismMultiGContainer& pmgc, unsigned int minSampleSize) :
+  groupIds_(),
+  sites_(),
+  derived_(),
+  sampleSizes_()
+{
+  set<size_t> ids = pmgc.getAllGroupsIds();
+  groupIds_.assign(ids.begin(), ids.end());
+  size_t nbGroups = groupIds_.size();
+  vector<unsigned int> first(nbGroups), second(nbGroups);
+  for (size_t locus = 0; locus < pmgc.getNumberOfLoci(); ++locus)
+  {
+    PolymorphismMultiGContainer::LocusView view = pmgc.locusView(locus);
+    fill(first.begin(), first.end(), 0);
+    fill(second.begin(), second.end(), 0);
+    bool hasFirst = false, hasSecond = false, biallelic = true;
+    size_t a = 0, b = 0;
+    for (const auto& entry : view)
+    {
+      if (!entry.genotype)
+        continue;
+      size_t g = static_cast<size_t>(lower_bound(groupIds_.begin(), groupIds_.end(), entry.groupId) - groupIds_.begin());
+      for (size_t k = 0; k < entry.genotype->getNumberOfAlleles(); ++k)
+      {
+        size_t allele = entry.genotype->getAlleleIndexAt(k);
+        if (!hasFirst)
+        {
+          a = allele;
+          hasFirst = true;
+        }
+        if (allele == a)
+          first[g]++;
+        else if (!hasSecond || allele == b)
+        {
+          b = allele;
+          hasSecond = true;
+          second[g]++;
+        }
+        else
+          biallelic = false;
+      }
+    }
+    if (biallelic && hasSecond)
+      addSite_(locus, first, second, -1, a > b, minSampleSize);
+  }
+}
+
+/******************************************************************************/
+
+void AlleleFrequencyTable::build_(const PolymorphismSequenceContainer& psc, const AncestralStates* ancestral, bool ingroupOnly, unsigned int minSampleSize)
+{
+  // The sampled sequences, and their groups
+  vector<size_t> samples;
+  set<size_t> ids;
+  for (size_t j = 0; j < psc.getNumberOfSequences(); ++j)
+  {
+    if (ingroupOnly && !psc.isIngroupMember(j))
+      continue;
+    samples.push_back(j);
+    ids.insert(psc.getGroupId(j));
+  }
+  groupIds_.assign(ids.begin(), ids.end());
+  size_t nbGroups = groupIds_.size();
+  size_t nbSamples = samples.size();
+  vector<size_t> groupIndex(nbSamples);
+  vector<unsigned int> weight(nbSamples);
+  for (size_t k = 0; k < nbSamples; ++k)
+  {
+    groupIndex[k] = getGroupIndex(psc.getGroupId(samples[k]));
+    weight[k] = psc.getSequenceCount(samples[k]);
+  }
+  int alphabetSize = static_cast<int>(psc.getAlphabet()->getSize());
+
+  vector<unsigned int> first(nbGroups), second(nbGroups);
+  for (size_t i = 0; i < psc.getNumberOfSites(); ++i)
+  {
+    const Site& site = psc.site(i);
+    fill(first.begin(), first.end(), 0);
+    fill(second.begin(), second.end(), 0);
+    int a = -1, b = -1;
+    bool biallelic = true;
+    for (size_t k = 0; k < nbSamples && biallelic; ++k)
+    {
+      int state = site.getValue(samples[k]);
+      if (state < 0 || state >= alphabetSize)
+        continue;
+      if (a < 0)
+        a = state;
+      if (state == a)
+        first[groupIndex[k]] += weight[k];
+      else if (b < 0 || state == b)
+      {
+        b = state;
+        second[groupIndex[k]] += weight[k];
+      }
+      else
+        biallelic = false;
+    }
+    if (!biallelic || b < 0)
+      continue;
+
+    int firstIsDerived = -1;
+    if (ancestral)
+    {
+      int ancestralState = ancestral->getState(i);
+      if (ancestralState == a)
+        firstIsDerived = 0;
+      else if (ancestralState == b)
+        firstIsDerived = 1;
+      else
+        continue;
+    }
+    addSite_(i, first, second, firstIsDerived, a > b, minSampleSize);
+  }
+}
+
+/******************************************************************************/
+
+void AlleleFrequencyTable::addSite_(
+    size_t site,
+    const vector<unsigned int>& first,
+    const vector<unsigned int>& second,
+    int firstIsDerived,
+    bool firstIsHigher,
+    unsigned int minSampleSize)
+{
+  size_t nbFirst = 0, nbSecond = 0;
+  for (size_t g = 0; g < first.size(); ++g)
+  {
+    if (first[g] + second[g] < minSampleSize)
+      return;
+    nbFirst += first[g];
+    nbSecond += second[g];
+  }
+  bool derivedIsFirst;
+  if (firstIsDerived >= 0)
+    derivedIsFirst = (firstIsDerived == 1);
+  else if (nbFirst != nbSecond)
+    derivedIsFirst = (nbFirst < nbSecond);
+  else
+    derivedIsFirst = firstIsHigher;
+
+  sites_.push_back(site);
+  for (size_t g = 0; g < first.size(); ++g)
+  {
+    derived_.push_back(derivedIsFirst ? first[g] : second[g]);
+    sampleSizes_.push_back(first[g] + second[g]);
+  }
+}
+
+/******************************************************************************/
+
+size_t AlleleFrequencyTable::getGroupIndex(size_t groupId) const
+{
+  auto it = lower_bound(groupIds_.begin(), groupIds_.end(), groupId);
+  if (it == groupIds_.end() || *it != groupId)
+    throw GroupNotFoundException("AlleleFrequencyTable::getGroupIndex: group not found.", groupId);
+  return static_cast<size_t>(it - groupIds_.begin());
+}
+
+/******************************************************************************/
+
+size_t AlleleFrequencyTable::getSiteIndex(size_t site) const
+{
+  if (site >= sites_.size())
+    throw IndexOutOfBoundsException("AlleleFrequencyTable::getSiteIndex.", site, 0, sites_.size());
+  return sites_[site];
+}
+
+/******************************************************************************/
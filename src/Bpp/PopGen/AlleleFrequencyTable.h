@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _ALLELEFREQUENCYTABLE_H_
+#define _ALLELEFREQUENCYTABLE_H_
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Seq/Sequence.h>
+
+// From local
+#include "AncestralStates.h"
+#include "GeneralExceptions.h"
+#include "PolymorphismMultiGContainer.h"
+#include "PolymorphismSequenceContainer.h"
+
+// From the STL
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Per-group derived allele counts at biallelic sites.
+ *
+ * The table is built from a PolymorphismSequenceContainer, whose groups
+ * are given by getGroupId(), or from the loci of a
+ * PolymorphismMultiGContainer. Only the biallelic sites (exactly two
+ * states over all the groups, gaps and unknown characters excluded) are
+ * kept, and only when each group has at least minSampleSize sampled
+ * alleles.
+ *
+ * For each kept site and each group, the table stores the number of
+ * sampled alleles and the number of copies of the derived allele. The
+ * derived allele is given by ancestral states (see AncestralStates) or an
+ * ancestral sequence, or else is the minor
+ * allele over all the groups (the state with the highest code on a tie).
+ *
+ * Groups are indexed from 0 in the order of their increasing ids.
+ */
+class AlleleFrequencyTable
+{
+private:
+  std::vector<size_t> groupIds_;
+  std::vector<size_t> sites_;
+  std::vector<unsigned int> derived_;
+  std::vector<unsigned int> sampleSizes_;
+
+public:
+  /**
+   * @brief Build the table of a container, polarized by the minor allele.
+   *
+   * Each sequence is counted getSequenceCount() times.
+   *
+   * @param psc The sequences.
+   * @param minSampleSize The minimum number of sampled alleles in each group.
+   */
+  AlleleFrequencyTable(const PolymorphismSequenceContainer& psc, unsigned int minSampleSize = 2);
+
+  /**
+   * @brief Build the table of a container, polarized by an ancestral sequence.
+   *
+   * The sites where the ancestral state is not one of the two states are dropped.
+   *
+   * @param psc The sequences.
+   * @param ancestralSites The ancestral state of each site.
+   * @param minSampleSize The minimum number of sampled alleles in each group.
+   * @throw DimensionException if ancestralSites and psc don't have the same number of sites.
+   */
+  AlleleFrequencyTable(const PolymorphismSequenceContainer& psc, const Sequence& ancestralSites, unsigned int minSampleSize = 2);
+
+  /**
+   * @brief Build the table of a container, polarized by ancestral states.
+   *
+   * Only the ingroup sequences (see
+   * PolymorphismSequenceContainer::isIngroupMember()) are counted, so that
+   * the outgroups the states are inferred from are not sampled. The sites
+   * where the ancestral state is unknown or is not one of the two states
+   * are dropped.
+   *
+   * @param psc The sequences.
+   * @param ancestral The ancestral state of each site.
+   * @param minSampleSize The minimum number of sampled alleles in each group.
+   * @throw DimensionException if ancestral and psc don't have the same number of sites.
+   */
+  AlleleFrequencyTable(const PolymorphismSequenceContainer& psc, const AncestralStates& ancestral, unsigned int minSampleSize = 2);
+
+  /**
+   * @brief Build the table of the loci of a genotype container, polarized by the minor allele.
+   *
+   * Each allele of each genotype is counted, missing genotypes are skipped.
+   *
+   * @param pmgc The genotypes.
+   * @param minSampleSize The minimum number of sampled alleles in each group.
+   */
+  AlleleFrequencyTable(const PolymorphismMultiGContainer& pmgc, unsigned int minSampleSize = 2);
+
+  virtual ~AlleleFrequencyTable() {}
+
+public:
+  size_t getNumberOfGroups() const { return groupIds_.size(); }
+
+  size_t getNumberOfSites() const { return sites_.size(); }
+
+  const std::vector<size_t>& getGroupIds() const { return groupIds_; }
+
+  /**
+   * @brief Get the index of a group.
+   *
+   * @throw GroupNotFoundException if groupId is not found.
+   */
+  size_t getGroupIndex(size_t groupId) const;
+
+  /**
+   * @brief Get the index of a site in the source container (site or locus position).
+   *
+   * @throw IndexOutOfBoundsException if site excedes the number of sites.
+   */
+  size_t getSiteIndex(size_t site) const;
+
+  /**
+   * @brief Get the number of copies of the derived allele, without bounds checking.
+   */
+  unsigned int getDerivedCount(size_t site, size_t groupIndex) const
+  {
+    return derived_[site * groupIds_.size() + groupIndex];
+  }
+
+  /**
+   * @brief Get the number of sampled alleles, without bounds checking.
+   */
+  unsigned int getSampleSize(size_t site, size_t groupIndex) const
+  {
+    return sampleSizes_[site * groupIds_.size() + groupIndex];
+  }
+
+  /**
+   * @brief Get the frequency of the derived allele, without bounds checking.
+   */
+  double getFrequency(size_t site, size_t groupIndex) const
+  {
+    return static_cast<double>(getDerivedCount(site, groupIndex)) / static_cast<double>(getSampleSize(site, groupIndex));
+  }
+
+private:
+  /**
+   * @brief Keep the biallelic sites of a container.
+   *
+   * @param psc The sequences.
+   * @param ancestral The ancestral states, or nullptr to polarize by the minor allele.
+   * @param ingroupOnly Skip the outgroup sequences.
+   * @param minSampleSize The minimum number of sampled alleles in each group.
+   */
+  void build_(const PolymorphismSequenceContainer& psc, const AncestralStates* ancestral, bool ingroupOnly, unsigned int minSampleSize);
+
+  /**
+   * @brief Store a site given the per-group counts of its two states.
+   *
+   * @param site The index of the site in the source container.
+   * @param first The counts of the first state.
+   * @param second The counts of the second state.
+   * @param firstIsDerived 1 if the first state is derived, 0 if the second is, -1 to use the minor state.
+   * @param firstIsHigher Tell if the first state has the highest code, used on a tie.
+   * @param minSampleSize The minimum number of sampled alleles in each group.
+   */
+  void addSite_(
+      size_t site,
+      const std::vector<unsigned int>& first,
+      const std::vector<unsigned int>& second,
+      int firstIsDerived,
+      bool firstIsHigher,
+      unsigned int minSampleSize);
+};
+} // end of namespace bpp;
+
+#endif // _ALLELEFREQUENCYTABLE_H_
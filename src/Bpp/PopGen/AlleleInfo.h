@@ -10,6 +10,9 @@
 
 #include <Bpp/Clonable.h>
 
+// From local
+#include "GenotypeArena.h"
+
 namespace bpp
 {
 /**
@@ -21,7 +24,8 @@ namespace bpp
  * @author Sylvain Gaillard
  */
 class AlleleInfo :
-  public virtual Clonable
+  public virtual Clonable,
+  public ArenaAllocated
 {
 public:
   // Destructor
@@ -39,6 +43,14 @@ public:
    */
   virtual const std::string& getId() const = 0;
 
+  /**
+   * @brief Get the estimated number of bytes used by this allele.
+   */
+  virtual size_t memoryUsage() const
+  {
+    return sizeof(AlleleInfo) + getId().capacity() + 1;
+  }
+
   /**
    * @name The Clonable interface
    *
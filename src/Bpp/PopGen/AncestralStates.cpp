@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "AncestralStates.h"
+
+// From the STL
+#include <algorithm>
+#include <limits>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+AncestralStates::AncestralStates(const PolymorphismSequenceContainer& psc, Confidence minConfidence) :
+  states_(psc.getNumberOfSites(), -1),
+  confidences_(psc.getNumberOfSites(), UNKNOWN)
+{
+  vector<size_t> outgroups;
+  for (size_t i = 0; i < psc.getNumberOfSequences(); ++i)
+  {
+    if (!psc.isIngroupMember(i))
+      outgroups.push_back(i);
+  }
+  int alphabetSize = static_cast<int>(psc.getAlphabet()->getSize());
+  vector<unsigned int> counts(static_cast<size_t>(alphabetSize));
+  for (size_t k = 0; k < psc.getNumberOfSites(); ++k)
+  {
+    const Site& site = psc.site(k);
+    fill(counts.begin(), counts.end(), 0);
+    size_t nbResolved = 0;
+    for (size_t i : outgroups)
+    {
+      int state = site.getValue(i);
+      if (state >= 0 && state < alphabetSize)
+      {
+        counts[static_cast<size_t>(state)] += psc.getSequenceCount(i);
+        nbResolved++;
+      }
+    }
+    if (nbResolved == 0)
+      continue;
+
+    // The most frequent state, and the number of states
+    size_t best = 0, nbStates = 0;
+    bool tie = false;
+    for (size_t s = 0; s < counts.size(); ++s)
+    {
+      if (counts[s] == 0)
+        continue;
+      nbStates++;
+      if (counts[s] > counts[best])
+      {
+        best = s;
+        tie = false;
+      }
+      else if (s != best && counts[s] == counts[best])
+        tie = true;
+    }
+    Confidence confidence;
+    if (nbStates == 1)
+      confidence = nbResolved == outgroups.size() ? COMPLETE : UNANIMOUS;
+    else if (!tie)
+      confidence = MAJORITY;
+    else
+      continue;
+    confidences_[k] = static_cast<uint8_t>(confidence);
+    if (confidence >= minConfidence)
+      states_[k] = toByte_(static_cast<int>(best));
+  }
+}
+
+/******************************************************************************/
+
+AncestralStates::AncestralStates(const Sequence& ancestralSites) :
+  states_(ancestralSites.size(), -1),
+  confidences_(ancestralSites.size(), UNKNOWN)
+{
+  int alphabetSize = static_cast<int>(ancestralSites.getAlphabet()->getSize());
+  for (size_t k = 0; k < ancestralSites.size(); ++k)
+  {
+    int state = ancestralSites.getValue(k);
+    if (state >= 0 && state < alphabetSize)
+    {
+      states_[k] = toByte_(state);
+      confidences_[k] = COMPLETE;
+    }
+  }
+}
+
+/******************************************************************************/
+
+AncestralStates::Confidence AncestralStates::getConfidence(size_t site) const
+{
+  if (site >= states_.size())
+    throw IndexOutOfBoundsException("AncestralStates::getConfidence.", site, 0, states_.size());
+  return static_cast<Confidence>(confidences_[site]);
+}
+
+/******************************************************************************/
+
+size_t AncestralStates::getNumberOfKnownSites() const
+{
+  return static_cast<size_t>(count_if(states_.begin(), states_.end(), [](int8_t state) {
+          return state >= 0;
+        }));
+}
+
+/******************************************************************************/
+
+MemoryUsage AncestralStates::memoryUsage() const
+{
+  MemoryUsage usage;
+  usage.add(MemoryUsage::SITES, sizeof(*this) + MemoryUsage::ofVector(states_) + MemoryUsage::ofVector(confidences_));
+  return usage;
+}
+
+/******************************************************************************/
+
+shared_ptr<const AncestralStates> AncestralStates::fromOutgroups(const PolymorphismSequenceContainer& psc, Confidence minConfidence)
+{
+  return psc.getDerived<AncestralStates>("ancestralStates/" + TextTools::toString(static_cast<int>(minConfidence)), [&]() {
+        return make_shared<const AncestralStates>(psc, minConfidence);
+      });
+}
+
+/******************************************************************************/
+
+int8_t AncestralStates::toByte_(int state)
+{
+  if (state > numeric_limits<int8_t>::max())
+    throw BadIntegerException("AncestralStates: state does not fit in a byte.", state);
+  return static_cast<int8_t>(state);
+}
+
+/******************************************************************************/
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _ANCESTRALSTATES_H_
+#define _ANCESTRALSTATES_H_
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Seq/Sequence.h>
+
+// From local
+#include "MemoryUsage.h"
+#include "PolymorphismSequenceContainer.h"
+
+// From the STL
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Ancestral state of each site, used to polarize the unfolded statistics.
+ *
+ * The states are derived from the outgroup sequences of a container (see
+ * PolymorphismSequenceContainer::isIngroupMember()), each counted
+ * getSequenceCount() times, or taken from an ancestral sequence. The
+ * confidence of each site tells how its outgroup states agree:
+ * - UNKNOWN: no resolved outgroup state, or a tie between the most frequent ones,
+ * - MAJORITY: the outgroups disagree, the most frequent state is taken,
+ * - UNANIMOUS: the resolved outgroup states agree, some outgroups having a gap or an unresolved character,
+ * - COMPLETE: all the outgroups have the same resolved state.
+ *
+ * The state of the sites with a confidence lower than the required one is
+ * unknown (-1). States and confidences take one byte per site each.
+ *
+ * When the cache of a container is enabled (see
+ * PolymorphismSequenceContainer::setCacheEnabled()), fromOutgroups()
+ * computes the states of the container once and caches them, so that
+ * SequenceStatistics::fayWu2000(), SequenceStatistics::fuLiD(),
+ * SequenceStatistics::fuLiF(),
+ * SequenceStatistics::totalNumberOfMutationsOnExternalBranches(), the
+ * AlleleFrequencyTable (unfolded spectra) and the HaplotypeMatrix can share
+ * them. These consumers only count the ingroup sequences of the container,
+ * so the same container can hold the outgroups.
+ */
+class AncestralStates
+{
+public:
+  enum Confidence
+  {
+    UNKNOWN = 0,
+    MAJORITY = 1,
+    UNANIMOUS = 2,
+    COMPLETE = 3
+  };
+
+private:
+  std::vector<int8_t> states_;
+  std::vector<uint8_t> confidences_;
+
+public:
+  /**
+   * @brief Derive the ancestral states from the outgroup sequences of a container.
+   *
+   * @param psc The sequences.
+   * @param minConfidence The lowest confidence of the known states.
+   * @throw BadIntegerException if a state does not fit in a byte.
+   */
+  AncestralStates(const PolymorphismSequenceContainer& psc, Confidence minConfidence = UNANIMOUS);
+
+  /**
+   * @brief Take the ancestral states from a sequence.
+   *
+   * The resolved states are COMPLETE, the gaps and unresolved characters UNKNOWN.
+   *
+   * @param ancestralSites The ancestral state of each site.
+   * @throw BadIntegerException if a state does not fit in a byte.
+   */
+  AncestralStates(const Sequence& ancestralSites);
+
+  virtual ~AncestralStates() {}
+
+public:
+  size_t getNumberOfSites() const { return states_.size(); }
+
+  /**
+   * @brief Get the ancestral state of a site, -1 if unknown, without bounds checking.
+   */
+  int getState(size_t site) const { return states_[site]; }
+
+  bool isKnown(size_t site) const { return states_[site] >= 0; }
+
+  /**
+   * @brief Get the agreement of the outgroups at a site.
+   *
+   * @throw IndexOutOfBoundsException if the site is out of bounds.
+   */
+  Confidence getConfidence(size_t site) const;
+
+  /**
+   * @brief Get the number of sites with a known ancestral state.
+   */
+  size_t getNumberOfKnownSites() const;
+
+  /**
+   * @brief Get the estimated memory footprint, reported as MemoryUsage::SITES.
+   */
+  MemoryUsage memoryUsage() const;
+
+  /**
+   * @brief Get the ancestral states of the outgroups of a container.
+   *
+   * The states are cached in the container if its cache is enabled (see
+   * PolymorphismSequenceContainer::getDerived()).
+   *
+   * @param psc The sequences.
+   * @param minConfidence The lowest confidence of the known states.
+   */
+  static std::shared_ptr<const AncestralStates> fromOutgroups(
+      const PolymorphismSequenceContainer& psc,
+      Confidence minConfidence = UNANIMOUS);
+
+private:
+  static int8_t toByte_(int state);
+};
+} // end of namespace bpp;
+
+#endif // _ANCESTRALSTATES_H_
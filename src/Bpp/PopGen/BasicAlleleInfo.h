@@ -74,6 +74,11 @@ public:
    */
   void setId(const std::string& allele_id);
   const std::string& getId() const;
+
+  size_t memoryUsage() const
+  {
+    return sizeof(*this) + id_.capacity() + 1;
+  }
   /** @} */
 };
 } // end of namespace bpp;
@@ -11,14 +11,14 @@ using namespace std;
 
 BiAlleleMonolocusGenotype::BiAlleleMonolocusGenotype(
     size_t firstAlleleIndex,
-    size_t secondAlleleIndex) : alleleIndex_(vector<size_t>(2))
+    size_t secondAlleleIndex) : alleleIndex_()
 {
   alleleIndex_[0] = firstAlleleIndex;
   alleleIndex_[1] = secondAlleleIndex;
 }
 
 BiAlleleMonolocusGenotype::BiAlleleMonolocusGenotype(vector<size_t> alleleIndex) :
-  alleleIndex_(2)
+  alleleIndex_()
 {
   if (alleleIndex.size() != 2)
     throw BadSizeException("BiAlleleMonolocusGenotype::BiAlleleMonolocusGenotype: allele_index must contain two values.", alleleIndex.size(), 2);
@@ -27,34 +27,27 @@ BiAlleleMonolocusGenotype::BiAlleleMonolocusGenotype(vector<size_t> alleleIndex)
 }
 
 BiAlleleMonolocusGenotype::BiAlleleMonolocusGenotype(const BiAlleleMonolocusGenotype& bmg) :
-  alleleIndex_(2)
+  alleleIndex_()
 {
-  for (size_t i = 0; i < 2; ++i)
-  {
-    alleleIndex_[i] = bmg.getAlleleIndex()[i];
-  }
+  alleleIndex_[0] = bmg.alleleIndex_[0];
+  alleleIndex_[1] = bmg.alleleIndex_[1];
 }
 
 // ** Class destructor: ********************************************************/
 
-BiAlleleMonolocusGenotype::~BiAlleleMonolocusGenotype()
-{
-  alleleIndex_.clear();
-}
+BiAlleleMonolocusGenotype::~BiAlleleMonolocusGenotype() {}
 
 // ** Other methodes: **********************************************************/
 
 BiAlleleMonolocusGenotype& BiAlleleMonolocusGenotype::operator=(const BiAlleleMonolocusGenotype& bmg)
 {
-  for (size_t i = 0; i < 2; ++i)
-  {
-    alleleIndex_.push_back(bmg.getAlleleIndex()[i]);
-  }
+  alleleIndex_[0] = bmg.alleleIndex_[0];
+  alleleIndex_[1] = bmg.alleleIndex_[1];
   return *this;
 }
 
 bool BiAlleleMonolocusGenotype::operator==(const BiAlleleMonolocusGenotype& bmg) const
 {
-  return (alleleIndex_[0] == bmg.getAlleleIndex()[0] && alleleIndex_[1] == bmg.getAlleleIndex()[1])
-         || (alleleIndex_[0] == bmg.getAlleleIndex()[1] && alleleIndex_[1] == bmg.getAlleleIndex()[0]);
+  return (alleleIndex_[0] == bmg.alleleIndex_[0] && alleleIndex_[1] == bmg.alleleIndex_[1])
+         || (alleleIndex_[0] == bmg.alleleIndex_[1] && alleleIndex_[1] == bmg.alleleIndex_[0]);
 }
@@ -25,7 +25,8 @@ class BiAlleleMonolocusGenotype :
   public virtual MonolocusGenotypeInterface
 {
 private:
-  std::vector<size_t> alleleIndex_;
+  // Stored inline, so that a genotype is a single block of memory.
+  size_t alleleIndex_[2];
 
 public:
   // Constructors and destructor
@@ -92,7 +93,22 @@ public:
    */
   std::vector<size_t> getAlleleIndex() const override
   {
-    return alleleIndex_;
+    return std::vector<size_t>(alleleIndex_, alleleIndex_ + 2);
+  }
+
+  size_t getNumberOfAlleles() const override
+  {
+    return 2;
+  }
+
+  size_t getAlleleIndexAt(size_t position) const override
+  {
+    return alleleIndex_[position];
+  }
+
+  size_t memoryUsage() const override
+  {
+    return sizeof(*this);
   }
 
   /** @} */
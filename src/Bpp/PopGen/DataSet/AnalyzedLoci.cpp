@@ -4,6 +4,10 @@
 
 #include "AnalyzedLoci.h"
 
+// From STL
+#include <algorithm>
+#include <map>
+
 using namespace bpp;
 using namespace std;
 
@@ -14,7 +18,11 @@ void AnalyzedLoci::setLocusInfo(
     const LocusInfo& locus)
 {
   if (locusPosition < loci_.size())
+  {
+    std::lock_guard<std::mutex> lock(indexMutex_);
     loci_[locusPosition].reset(locus.clone());
+    indexUpToDate_ = false;
+  }
   else
     throw IndexOutOfBoundsException("AnalyzedLoci::setLocusInfo: locus_position out of bounds",
           locusPosition, 0, loci_.size());
@@ -143,3 +151,174 @@ unsigned int AnalyzedLoci::getPloidyByLocusPosition(size_t locusPosition) const
 }
 
 /******************************************************************************/
+
+MemoryUsage AnalyzedLoci::memoryUsage() const
+{
+  MemoryUsage usage;
+  usage.add(MemoryUsage::ALLELE_INFO, sizeof(*this) + MemoryUsage::ofVector(loci_));
+  for (const auto& locus : loci_)
+  {
+    if (locus)
+      usage += locus->memoryUsage();
+  }
+  return usage;
+}
+
+/******************************************************************************/
+
+vector<string> AnalyzedLoci::getChromosomes() const
+{
+  lock_guard<mutex> lock(indexMutex_);
+  updateIndex_();
+  return chromosomes_;
+}
+
+/******************************************************************************/
+
+vector<size_t> AnalyzedLoci::getSortedLoci() const
+{
+  lock_guard<mutex> lock(indexMutex_);
+  updateIndex_();
+  return index_;
+}
+
+/******************************************************************************/
+
+vector<size_t> AnalyzedLoci::getLociInRange(const string& chromosome, size_t start, size_t end) const
+{
+  lock_guard<mutex> lock(indexMutex_);
+  updateIndex_();
+  auto chr = find(chromosomes_.begin(), chromosomes_.end(), chromosome);
+  if (chr == chromosomes_.end() || start >= end)
+    return vector<size_t>();
+  pair<size_t, size_t> range = getChromosomeRange_(static_cast<size_t>(chr - chromosomes_.begin()));
+  auto byPosition = [&](size_t locus, size_t position) {
+        return loci_[locus]->getPosition() < position;
+      };
+  auto first = lower_bound(index_.begin() + static_cast<ptrdiff_t>(range.first), index_.begin() + static_cast<ptrdiff_t>(range.second), start, byPosition);
+  auto last = lower_bound(first, index_.begin() + static_cast<ptrdiff_t>(range.second), end, byPosition);
+  return vector<size_t>(first, last);
+}
+
+/******************************************************************************/
+
+vector<AnalyzedLoci::LocusWindow> AnalyzedLoci::getWindows(size_t windowSize, size_t step) const
+{
+  SlidingWindows sliding(windowSize, step);
+  lock_guard<mutex> lock(indexMutex_);
+  updateIndex_();
+  vector<LocusWindow> windows;
+  for (size_t locus : index_)
+  {
+    sliding.add(loci_[locus]->getChromosome(), loci_[locus]->getPosition(), locus, windows);
+  }
+  sliding.flush(windows);
+  return windows;
+}
+
+/******************************************************************************/
+
+AnalyzedLoci::SlidingWindows::SlidingWindows(size_t windowSize, size_t step) :
+  windowSize_(windowSize),
+  step_(step),
+  chromosome_(),
+  start_(0),
+  entries_()
+{
+  if (windowSize == 0)
+    throw BadIntegerException("AnalyzedLoci::SlidingWindows: windowSize must be greater than 0.", 0);
+  if (step == 0)
+    throw BadIntegerException("AnalyzedLoci::SlidingWindows: step must be greater than 0.", 0);
+}
+
+void AnalyzedLoci::SlidingWindows::add(const string& chromosome, size_t position, size_t locus, vector<LocusWindow>& windows)
+{
+  if (chromosome != chromosome_)
+  {
+    flush(windows);
+    chromosome_ = chromosome;
+    start_ = 0;
+  }
+  while (!entries_.empty() && start_ + windowSize_ <= position)
+  {
+    emit_(windows);
+    advance_();
+  }
+  if (entries_.empty())
+    start_ = max(start_, getFirstWindowStart(position, windowSize_, step_));
+  // With step > windowSize, a locus may fall between two windows.
+  if (position >= start_)
+    entries_.push_back(make_pair(position, locus));
+}
+
+void AnalyzedLoci::SlidingWindows::flush(vector<LocusWindow>& windows)
+{
+  while (!entries_.empty())
+  {
+    emit_(windows);
+    advance_();
+  }
+}
+
+void AnalyzedLoci::SlidingWindows::emit_(vector<LocusWindow>& windows) const
+{
+  LocusWindow window{chromosome_, start_, start_ + windowSize_, vector<size_t>()};
+  for (const auto& entry : entries_)
+  {
+    if (entry.first >= window.end)
+      break;
+    window.loci.push_back(entry.second);
+  }
+  windows.push_back(window);
+}
+
+void AnalyzedLoci::SlidingWindows::advance_()
+{
+  start_ += step_;
+  while (true)
+  {
+    while (!entries_.empty() && entries_.front().first < start_)
+    {
+      entries_.pop_front();
+    }
+    if (entries_.empty() || entries_.front().first < start_ + windowSize_)
+      return;
+    // Jump to the first window containing the next locus.
+    start_ = max(start_, getFirstWindowStart(entries_.front().first, windowSize_, step_));
+  }
+}
+
+/******************************************************************************/
+
+void AnalyzedLoci::updateIndex_() const
+{
+  if (indexUpToDate_)
+    return;
+  map<string, size_t> ranks;
+  chromosomes_.clear();
+  index_.clear();
+  for (size_t i = 0; i < loci_.size(); ++i)
+  {
+    if (!loci_[i] || !loci_[i]->hasCoordinates())
+      continue;
+    if (ranks.insert(make_pair(loci_[i]->getChromosome(), chromosomes_.size())).second)
+      chromosomes_.push_back(loci_[i]->getChromosome());
+    index_.push_back(i);
+  }
+  stable_sort(index_.begin(), index_.end(), [&](size_t i, size_t j) {
+        size_t rankI = ranks[loci_[i]->getChromosome()], rankJ = ranks[loci_[j]->getChromosome()];
+        if (rankI != rankJ)
+          return rankI < rankJ;
+        return loci_[i]->getPosition() < loci_[j]->getPosition();
+      });
+  chromosomeStarts_.assign(1, 0);
+  for (size_t k = 1; k < index_.size(); ++k)
+  {
+    if (loci_[index_[k]]->getChromosome() != loci_[index_[k - 1]]->getChromosome())
+      chromosomeStarts_.push_back(k);
+  }
+  chromosomeStarts_.push_back(index_.size());
+  indexUpToDate_ = true;
+}
+
+/******************************************************************************/
@@ -6,8 +6,11 @@
 #define _ANALYZEDLOCI_H_
 
 // From STL
+#include <deque>
 #include <vector>
 #include <string>
+#include <mutex>
+#include <utility>
 
 #include <Bpp/Exceptions.h>
 
@@ -24,26 +27,120 @@ namespace bpp
  * Its instanciation requires a number of locus wich is fixed
  * and can't be modified.
  *
+ * The loci with genomic coordinates (see LocusInfo::hasCoordinates()) are
+ * indexed by chromosome, in the order of the first locus of each
+ * chromosome, then by position. The index is built on the first query
+ * following a change of the loci, and is shared by the range and window
+ * queries.
+ *
  * @author Sylvain Gaillard
  */
 class AnalyzedLoci :
   public virtual Clonable
 {
+public:
+  /**
+   * @brief A window of positions on a chromosome and the loci it contains.
+   */
+  struct LocusWindow
+  {
+    std::string chromosome;
+    size_t start;
+    /**
+     * @brief The position after the last one of the window.
+     */
+    size_t end;
+    /**
+     * @brief The positions of the loci in the AnalyzedLoci, sorted by genomic position.
+     */
+    std::vector<size_t> loci;
+  };
+
+  /**
+   * @brief Enumerate the sliding windows of loci given one at a time.
+   *
+   * The loci are given sorted by chromosome and position, as in the index
+   * (see getSortedLoci()). The windows are those of getWindows(): on each
+   * chromosome, windows of windowSize positions starting at the multiples
+   * of step, from the first one containing the first locus, the windows
+   * without any locus being skipped. A window is complete, and given
+   * back, as soon as a locus is given after its end, or by flush().
+   *
+   * Only the loci of the current window are kept, so that the loci of a
+   * whole genome can be streamed.
+   */
+  class SlidingWindows
+  {
+  private:
+    size_t windowSize_;
+    size_t step_;
+    std::string chromosome_;
+    size_t start_;
+    std::deque<std::pair<size_t, size_t>> entries_;
+
+  public:
+    /**
+     * @param windowSize The number of positions in a window.
+     * @param step The number of positions between the starts of two windows.
+     * @throw BadIntegerException if windowSize or step is 0.
+     */
+    SlidingWindows(size_t windowSize, size_t step);
+
+  public:
+    /**
+     * @brief Give the next locus.
+     *
+     * @param chromosome The chromosome of the locus.
+     * @param position The position of the locus.
+     * @param locus The id of the locus, stored in the loci of the windows.
+     * @param windows The windows completed by this locus are appended to it.
+     */
+    void add(const std::string& chromosome, size_t position, size_t locus, std::vector<LocusWindow>& windows);
+
+    /**
+     * @brief Complete the remaining windows.
+     *
+     * @param windows The remaining windows are appended to it.
+     */
+    void flush(std::vector<LocusWindow>& windows);
+
+  private:
+    void emit_(std::vector<LocusWindow>& windows) const;
+    void advance_();
+  };
+
 private:
   std::vector<std::unique_ptr<LocusInfo>> loci_;
+  mutable std::mutex indexMutex_;
+  mutable bool indexUpToDate_;
+  mutable std::vector<size_t> index_;
+  mutable std::vector<std::string> chromosomes_;
+  mutable std::vector<size_t> chromosomeStarts_;
 
 public:
   // Constructors and Destructor
   /**
    * @brief Build a void AnalyzedLoci with a specific number of loci.
    */
-  AnalyzedLoci(size_t numberOfLoci) : loci_(numberOfLoci) {}
+  AnalyzedLoci(size_t numberOfLoci) :
+    loci_(numberOfLoci),
+    indexMutex_(),
+    indexUpToDate_(false),
+    index_(),
+    chromosomes_(),
+    chromosomeStarts_()
+  {}
 
   /**
    * @brief Copy constructor.
    */
   AnalyzedLoci(const AnalyzedLoci& analyzedLoci) :
-    loci_(analyzedLoci.loci_.size())
+    loci_(analyzedLoci.loci_.size()),
+    indexMutex_(),
+    indexUpToDate_(false),
+    index_(),
+    chromosomes_(),
+    chromosomeStarts_()
   {
     size_t i = 0;
     for (const auto& locus : analyzedLoci.loci_)
@@ -54,6 +151,8 @@ public:
 
   AnalyzedLoci& operator=(const AnalyzedLoci& analyzedLoci)
   {
+    std::lock_guard<std::mutex> lock(indexMutex_);
+    indexUpToDate_ = false;
     loci_.resize(analyzedLoci.loci_.size());
     size_t i = 0;
     for (const auto& locus : analyzedLoci.loci_)
@@ -142,6 +241,79 @@ public:
    * @throw IndexOutOfBoundsException if locus_position is out of bounds.
    */
   unsigned int getPloidyByLocusPosition(size_t locusPosition) const;
+
+  /**
+   * @brief Get the chromosomes of the loci with coordinates, in the order of the index.
+   */
+  std::vector<std::string> getChromosomes() const;
+
+  /**
+   * @brief Get the loci with coordinates, sorted by chromosome and position.
+   *
+   * @return The positions of the loci in the AnalyzedLoci.
+   */
+  std::vector<size_t> getSortedLoci() const;
+
+  /**
+   * @brief Get the loci of a chromosome in a range of positions.
+   *
+   * @param chromosome The chromosome.
+   * @param start The first position of the range.
+   * @param end The position after the last one of the range.
+   * @return The positions of the loci in the AnalyzedLoci, sorted by genomic position.
+   */
+  std::vector<size_t> getLociInRange(const std::string& chromosome, size_t start, size_t end) const;
+
+  /**
+   * @brief Get the sliding windows of positions containing at least one locus.
+   *
+   * On each chromosome, windows of windowSize positions start at every
+   * multiple of step. The windows without any locus are skipped, so that
+   * the number of windows does not depend on the length of the chromosomes.
+   *
+   * @param windowSize The number of positions in a window.
+   * @param step The number of positions between the starts of two windows.
+   * @return The windows, sorted by chromosome and start.
+   * @throw BadIntegerException if windowSize or step is 0.
+   */
+  std::vector<LocusWindow> getWindows(size_t windowSize, size_t step) const;
+
+  /**
+   * @brief Get the start of the first window containing a position.
+   *
+   * This is the smallest multiple of step greater than
+   * position - windowSize, or 0.
+   *
+   * @param position The position.
+   * @param windowSize The number of positions in a window.
+   * @param step The number of positions between the starts of two windows.
+   */
+  static size_t getFirstWindowStart(size_t position, size_t windowSize, size_t step)
+  {
+    if (position < windowSize)
+      return 0;
+    size_t minStart = position - windowSize + 1;
+    return ((minStart + step - 1) / step) * step;
+  }
+
+  /**
+   * @brief Get the estimated memory footprint of all the loci.
+   */
+  MemoryUsage memoryUsage() const;
+
+private:
+  /**
+   * @brief Build the index of the loci if needed. indexMutex_ must be locked.
+   */
+  void updateIndex_() const;
+
+  /**
+   * @brief Get the range of the index of a chromosome. indexMutex_ must be locked.
+   */
+  std::pair<size_t, size_t> getChromosomeRange_(size_t chromosome) const
+  {
+    return std::make_pair(chromosomeStarts_[chromosome], chromosomeStarts_[chromosome + 1]);
+  }
 };
 } // end of namespace bpp;
 
@@ -11,11 +11,14 @@ using namespace std;
 /******************************************************************************/
 
 DataSet::DataSet(const DataSet& ds) :
+  arena_(),
   analyzedLoci_(nullptr),
   sequenceAlphabet_(ds.sequenceAlphabet_),
   localities_(),
-  groups_()
+  groups_(),
+  trackedMemory_()
 {
+  GenotypeArena::Scope scope(arena_);
   if (ds.analyzedLoci_)
     analyzedLoci_.reset(ds.analyzedLoci_->clone());
   for (const auto& locality : ds.localities_)
@@ -26,12 +29,14 @@ DataSet::DataSet(const DataSet& ds) :
   {
     groups_.push_back(unique_ptr<Group>(group->clone()));
   }
+  reportMemoryUsage_();
 }
 
 /******************************************************************************/
 
 DataSet& DataSet::operator=(const DataSet& ds)
 {
+  GenotypeArena::Scope scope(arena_);
   if (ds.analyzedLoci_)
     analyzedLoci_.reset(ds.analyzedLoci_->clone());
   else
@@ -50,6 +55,7 @@ DataSet& DataSet::operator=(const DataSet& ds)
   {
     groups_.push_back(unique_ptr<Group>(group->clone()));
   }
+  reportMemoryUsage_();
 
   return *this;
 }
@@ -65,6 +71,7 @@ void DataSet::addLocality(const Locality<double>& locality)
       throw BadIdentifierException("DataSet::addLocality: locality name already in use.", locality.getName());
   }
   localities_.push_back(make_unique<Locality<double>>(locality));
+  trackedMemory_.report(MemoryUsage(), localityMemoryUsage_(locality));
 }
 
 /******************************************************************************/
@@ -131,6 +138,7 @@ void DataSet::deleteLocalityAtPosition(size_t localityPosition)
 {
   if (localityPosition >= localities_.size())
     throw IndexOutOfBoundsException("DataSet::deleteLocalityAtPosition: localityPosition out of bounds.", localityPosition, 0, localities_.size());
+  trackedMemory_.report(localityMemoryUsage_(*localities_[localityPosition]), MemoryUsage());
   localities_.erase(localities_.begin() + static_cast<ptrdiff_t>(localityPosition));
 }
 
@@ -153,12 +161,14 @@ void DataSet::deleteLocalityByName(const std::string& name)
 // Dealing with groups -------------------------------------
 void DataSet::addGroup(const Group& group)
 {
+  GenotypeArena::Scope scope(arena_);
   for (const auto& existingGroup : groups_)
   {
     if (group.getGroupId() == existingGroup->getGroupId())
       throw BadIdentifierException("DataSet::addGroup: group id already in use.", group.getGroupId());
   }
   groups_.push_back(make_unique<Group>(group));
+  trackedMemory_.report(MemoryUsage(), groupMemoryUsage_(groups_.size() - 1));
 }
 
 /******************************************************************************/
@@ -171,6 +181,7 @@ void DataSet::addEmptyGroup(size_t groupId)
       throw BadIdentifierException("DataSet::addEmptyGroup: groupId already in use.", groupId);
   }
   groups_.push_back(make_unique<Group>(groupId));
+  trackedMemory_.report(MemoryUsage(), groupMemoryUsage_(groups_.size() - 1));
 }
 
 /******************************************************************************/
@@ -243,6 +254,7 @@ void DataSet::deleteGroupAtPosition(size_t groupPosition)
 {
   if (groupPosition >= groups_.size())
     throw IndexOutOfBoundsException("DataSet::deleteGroup.", groupPosition, 0, groups_.size());
+  trackedMemory_.report(groupMemoryUsage_(groupPosition), MemoryUsage());
   groups_.erase(groups_.begin() + static_cast<ptrdiff_t>(groupPosition));
 }
 
@@ -277,10 +289,12 @@ void DataSet::mergeTwoGroups(size_t source_id, size_t target_id)
   // Emptie the source into the target
   size_t source_pos = getGroupPosition(source_id);
   size_t target_pos = getGroupPosition(target_id);
+  MemoryUsage before = groupMemoryUsage_(target_pos);
   for (size_t i = 0; i < groups_[source_pos]->getNumberOfIndividuals(); i++)
   {
     groups_[target_pos]->addIndividual(groups_[source_pos]->getIndividualAtPosition(i));
   }
+  trackedMemory_.report(before, groupMemoryUsage_(target_pos));
   deleteGroupAtPosition(source_pos);
 }
 
@@ -307,10 +321,12 @@ void DataSet::mergeGroups(std::vector<size_t>& groupIds)
   for (size_t i = 1; i < groupIds.size(); i++)
   {
     size_t pos_current = getGroupPosition(groupIds[i]);
+    MemoryUsage before = groupMemoryUsage_(pos_first);
     for (size_t j = 0; j < getGroupAtPosition(pos_current).getNumberOfIndividuals(); j++)
     {
       groups_[pos_first]->addIndividual(getGroupAtPosition(pos_current).getIndividualAtPosition(j));
     }
+    trackedMemory_.report(before, groupMemoryUsage_(pos_first));
     deleteGroupAtPosition(pos_current);
   }
 }
@@ -341,11 +357,13 @@ void DataSet::splitGroup(size_t groupId, vector<size_t> individualSelection)
     if (individualSelection[i] >= groups_[sourcePos]->getNumberOfIndividuals())
       throw IndexOutOfBoundsException("DataSet::splitGroup: individuals_selection excedes the number of individual in the group.", individualSelection[i], 0, groups_[sourcePos]->getNumberOfIndividuals());
   }
+  MemoryUsage before = groupMemoryUsage_(sourcePos);
   for (size_t i = 0; i < individualSelection.size(); i++)
   {
     newGroup.addIndividual(*groups_[sourcePos]->removeIndividualAtPosition(individualSelection[i]));
     groups_[sourcePos]->deleteIndividualAtPosition(individualSelection[i]);
   }
+  trackedMemory_.report(before, groupMemoryUsage_(sourcePos));
   addGroup(newGroup);
 }
 
@@ -355,11 +373,13 @@ void DataSet::splitGroup(size_t groupId, vector<size_t> individualSelection)
 
 void DataSet::addIndividualToGroup(size_t group, const Individual& individual)
 {
+  GenotypeArena::Scope scope(arena_);
   if (group >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::addIndividualToGroup: group out of bounds.", group, 0, getNumberOfGroups());
   try
   {
     groups_[group]->addIndividual(individual);
+    trackedMemory_.report(MemoryUsage(), individualMemoryUsage_(group, groups_[group]->getNumberOfIndividuals() - 1));
     if (individual.hasSequences())
       setAlphabet(individual.getSequenceAlphabet());
   }
@@ -373,11 +393,13 @@ void DataSet::addIndividualToGroup(size_t group, const Individual& individual)
 
 void DataSet::addEmptyIndividualToGroup(size_t group, const std::string& individual_id)
 {
+  GenotypeArena::Scope scope(arena_);
   if (group >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::addEmptyIndividual: group out of bounds.", group, 0, getNumberOfGroups());
   try
   {
     groups_[group]->addEmptyIndividual(individual_id);
+    trackedMemory_.report(MemoryUsage(), individualMemoryUsage_(group, groups_[group]->getNumberOfIndividuals() - 1));
   }
   catch (BadIdentifierException& bie)
   {
@@ -448,9 +470,11 @@ void DataSet::deleteIndividualAtPositionFromGroup(size_t groupPosition, size_t i
 {
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::deleteIndividualAtPositionFromGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = individualMemoryUsage_(groupPosition, individualPosition);
   try
   {
     groups_[groupPosition]->deleteIndividualAtPosition(individualPosition);
+    trackedMemory_.report(before, MemoryUsage());
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -466,7 +490,9 @@ void DataSet::deleteIndividualByIdFromGroup(size_t groupPosition, const std::str
     throw IndexOutOfBoundsException("DataSet::deleteIndividualByIdFromGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
   try
   {
+    MemoryUsage before = MemoryTracker::isTracking() ? individualMemoryUsage_(groupPosition, groups_[groupPosition]->getIndividualPosition(individual_id)) : MemoryUsage();
     groups_[groupPosition]->deleteIndividualById(individual_id);
+    trackedMemory_.report(before, MemoryUsage());
   }
   catch (IndividualNotFoundException& infe)
   {
@@ -512,9 +538,11 @@ void DataSet::setIndividualDateInGroup(size_t groupPosition, size_t individualPo
 {
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::setIndividualDateInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = individualMemoryUsage_(groupPosition, individualPosition);
   try
   {
     groups_[groupPosition]->setIndividualDateAtPosition(individualPosition, date);
+    trackedMemory_.report(before, individualMemoryUsage_(groupPosition, individualPosition));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -548,9 +576,11 @@ void DataSet::setIndividualCoordInGroup(size_t groupPosition, size_t individualP
 {
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::setIndividualCoordInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = individualMemoryUsage_(groupPosition, individualPosition);
   try
   {
     groups_[groupPosition]->setIndividualCoordAtPosition(individualPosition, coord);
+    trackedMemory_.report(before, individualMemoryUsage_(groupPosition, individualPosition));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -624,9 +654,11 @@ void DataSet::addIndividualSequenceInGroup(size_t groupPosition, size_t individu
 {
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::addIndividualSequenceInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = individualMemoryUsage_(groupPosition, individualPosition);
   try
   {
     groups_[groupPosition]->addIndividualSequenceAtPosition(individualPosition, sequence_position, sequence);
+    trackedMemory_.report(before, individualMemoryUsage_(groupPosition, individualPosition));
     setAlphabet(sequence->getAlphabet());
   }
   catch (IndexOutOfBoundsException& ioobe)
@@ -701,9 +733,11 @@ void DataSet::deleteIndividualSequenceByNameInGroup(size_t groupPosition, size_t
 {
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::deleteIndividualSequenceByNameInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = individualMemoryUsage_(groupPosition, individualPosition);
   try
   {
     groups_[groupPosition]->deleteIndividualSequenceByName(individualPosition, sequence_name);
+    trackedMemory_.report(before, individualMemoryUsage_(groupPosition, individualPosition));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -725,9 +759,11 @@ void DataSet::deleteIndividualSequenceAtPositionInGroup(size_t groupPosition, si
 {
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::deleteIndividualSequenceAtPositionInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = individualMemoryUsage_(groupPosition, individualPosition);
   try
   {
     groups_[groupPosition]->deleteIndividualSequenceAtPosition(individualPosition, sequence_position);
+    trackedMemory_.report(before, individualMemoryUsage_(groupPosition, individualPosition));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -811,11 +847,14 @@ size_t DataSet::getIndividualNumberOfSequencesInGroup(size_t groupPosition, size
 
 void DataSet::setIndividualGenotypeInGroup(size_t groupPosition, size_t individualPosition, const MultilocusGenotype& genotype)
 {
+  GenotypeArena::Scope scope(arena_);
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::setIndividualGenotypeInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = individualMemoryUsage_(groupPosition, individualPosition);
   try
   {
     groups_[groupPosition]->setIndividualGenotype(individualPosition, genotype);
+    trackedMemory_.report(before, individualMemoryUsage_(groupPosition, individualPosition));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -827,11 +866,14 @@ void DataSet::setIndividualGenotypeInGroup(size_t groupPosition, size_t individu
 
 void DataSet::initIndividualGenotypeInGroup(size_t groupPosition, size_t individualPosition)
 {
+  GenotypeArena::Scope scope(arena_);
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::initIndividualGenotypeInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = individualMemoryUsage_(groupPosition, individualPosition);
   try
   {
     groups_[groupPosition]->initIndividualGenotype(individualPosition, getNumberOfLoci());
+    trackedMemory_.report(before, individualMemoryUsage_(groupPosition, individualPosition));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -857,9 +899,11 @@ void DataSet::deleteIndividualGenotypeInGroup(size_t groupPosition, size_t indiv
 {
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::deleteIndividualGenotypeInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = individualMemoryUsage_(groupPosition, individualPosition);
   try
   {
     groups_[groupPosition]->deleteIndividualGenotype(individualPosition);
+    trackedMemory_.report(before, individualMemoryUsage_(groupPosition, individualPosition));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -875,11 +919,14 @@ void DataSet::setIndividualMonolocusGenotypeInGroup(
     size_t locusPosition,
     const MonolocusGenotypeInterface& monogen)
 {
+  GenotypeArena::Scope scope(arena_);
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::setIndividualMonolocusGenotypeInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = monolocusGenotypeMemoryUsage_(groupPosition, individualPosition, locusPosition);
   try
   {
     groups_[groupPosition]->setIndividualMonolocusGenotype(individualPosition, locusPosition, monogen);
+    trackedMemory_.report(before, monolocusGenotypeMemoryUsage_(groupPosition, individualPosition, locusPosition));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -899,11 +946,14 @@ void DataSet::setIndividualMonolocusGenotypeInGroup(
 
 void DataSet::setIndividualMonolocusGenotypeByAlleleKeyInGroup(size_t groupPosition, size_t individualPosition, size_t locus_position, const std::vector<size_t> allele_keys)
 {
+  GenotypeArena::Scope scope(arena_);
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::setIndividualMonolocusGenotypeByAlleleKeyInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
+  MemoryUsage before = monolocusGenotypeMemoryUsage_(groupPosition, individualPosition, locus_position);
   try
   {
     groups_[groupPosition]->setIndividualMonolocusGenotypeByAlleleKey(individualPosition, locus_position, allele_keys);
+    trackedMemory_.report(before, monolocusGenotypeMemoryUsage_(groupPosition, individualPosition, locus_position));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -927,12 +977,15 @@ void DataSet::setIndividualMonolocusGenotypeByAlleleKeyInGroup(size_t groupPosit
 
 void DataSet::setIndividualMonolocusGenotypeByAlleleIdInGroup(size_t groupPosition, size_t individualPosition, size_t locus_position, const std::vector<std::string> allele_id)
 {
+  GenotypeArena::Scope scope(arena_);
   if (groupPosition >= getNumberOfGroups())
     throw IndexOutOfBoundsException("DataSet::setIndividualMonolocusGenotypeByAlleleIdInGroup: groupPosition out of bounds.", groupPosition, 0, getNumberOfGroups());
   const LocusInfo& locus_info = getLocusInfoAtPosition(locus_position);
+  MemoryUsage before = monolocusGenotypeMemoryUsage_(groupPosition, individualPosition, locus_position);
   try
   {
     groups_[groupPosition]->setIndividualMonolocusGenotypeByAlleleId(individualPosition, locus_position, allele_id, locus_info);
+    trackedMemory_.report(before, monolocusGenotypeMemoryUsage_(groupPosition, individualPosition, locus_position));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -997,11 +1050,14 @@ void DataSet::setAlphabet(const std::string& alphaType)
 
 void DataSet::setLocusInfo(size_t locus_position, const LocusInfo& locus)
 {
+  GenotypeArena::Scope scope(arena_);
   if (analyzedLoci_ == 0)
     throw NullPointerException("DataSet::setLocusInfo: there's no AnalyzedLoci to setup.");
+  MemoryUsage before = locusMemoryUsage_(locus_position);
   try
   {
     analyzedLoci_->setLocusInfo(locus_position, locus);
+    trackedMemory_.report(before, locusMemoryUsage_(locus_position));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -1049,11 +1105,15 @@ const LocusInfo& DataSet::getLocusInfoAtPosition(size_t locus_position) const
 
 void DataSet::addAlleleInfoByLocusName(const std::string& locus_name, const AlleleInfo& allele)
 {
+  GenotypeArena::Scope scope(arena_);
   if (analyzedLoci_ == 0)
     throw NullPointerException("DataSet::addAlleleInfoByLocusName: there's no AnalyzedLoci.");
   try
   {
+    size_t locus_position = MemoryTracker::isTracking() ? analyzedLoci_->getLocusInfoPosition(locus_name) : 0;
+    MemoryUsage before = locusMemoryUsage_(locus_position);
     analyzedLoci_->addAlleleInfoByLocusName(locus_name, allele);
+    trackedMemory_.report(before, locusMemoryUsage_(locus_position));
   }
   catch (LocusNotFoundException& lnfe)
   {
@@ -1069,11 +1129,14 @@ void DataSet::addAlleleInfoByLocusName(const std::string& locus_name, const Alle
 
 void DataSet::addAlleleInfoByLocusPosition(size_t locus_position, const AlleleInfo& allele)
 {
+  GenotypeArena::Scope scope(arena_);
   if (analyzedLoci_ == 0)
     throw NullPointerException("DataSet::addAlleleInfoByLocusPosition: there's no AnalyzedLoci.");
+  MemoryUsage before = locusMemoryUsage_(locus_position);
   try
   {
     analyzedLoci_->addAlleleInfoByLocusPosition(locus_position, allele);
+    trackedMemory_.report(before, locusMemoryUsage_(locus_position));
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -1140,8 +1203,7 @@ unique_ptr<PolymorphismMultiGContainer> DataSet::getPolymorphismMultiGContainer(
       const auto& tmpInd = getIndividualAtPositionFromGroup(i, j);
       if (tmpInd.hasGenotype())
       {
-        auto tmpMg = unique_ptr<MultilocusGenotype>(tmpInd.getGenotype().clone());
-        pmgc->addMultilocusGenotype(tmpMg, i);
+        pmgc->addMultilocusGenotype(tmpInd.getGenotype(), i);
       }
     }
   }
@@ -1173,8 +1235,7 @@ unique_ptr<PolymorphismMultiGContainer> DataSet::getPolymorphismMultiGContainer(
         const auto& tmpInd = getIndividualAtPositionFromGroup(i, j);
         if (tmpInd.hasGenotype())
         {
-          auto tmpMg = unique_ptr<MultilocusGenotype>(tmpInd.getGenotype().clone());
-          pmgc->addMultilocusGenotype(tmpMg, i);
+          pmgc->addMultilocusGenotype(tmpInd.getGenotype(), i);
         }
       }
       catch (IndexOutOfBoundsException& ioobe)
@@ -1226,3 +1287,80 @@ unique_ptr<PolymorphismSequenceContainer> DataSet::getPolymorphismSequenceContai
 }
 
 /******************************************************************************/
+
+MemoryUsage DataSet::memoryUsage() const
+{
+  MemoryUsage usage;
+  usage.add(MemoryUsage::INDIVIDUALS, sizeof(*this) + MemoryUsage::ofVector(groups_) + MemoryUsage::ofVector(localities_));
+  for (const auto& locality : localities_)
+  {
+    usage += localityMemoryUsage_(*locality);
+  }
+  for (const auto& group : groups_)
+  {
+    usage += group->memoryUsage();
+  }
+  if (analyzedLoci_)
+    usage += analyzedLoci_->memoryUsage();
+  return usage;
+}
+
+/******************************************************************************/
+
+MemoryUsage DataSet::individualMemoryUsage_(size_t groupPosition, size_t individualPosition) const
+{
+  if (!MemoryTracker::isTracking() || groupPosition >= groups_.size() || individualPosition >= groups_[groupPosition]->getNumberOfIndividuals())
+    return MemoryUsage();
+  return groups_[groupPosition]->getIndividualAtPosition(individualPosition).memoryUsage();
+}
+
+/******************************************************************************/
+
+MemoryUsage DataSet::monolocusGenotypeMemoryUsage_(size_t groupPosition, size_t individualPosition, size_t locusPosition) const
+{
+  MemoryUsage usage;
+  if (!MemoryTracker::isTracking() || groupPosition >= groups_.size() || individualPosition >= groups_[groupPosition]->getNumberOfIndividuals())
+    return usage;
+  const Individual& individual = groups_[groupPosition]->getIndividualAtPosition(individualPosition);
+  if (individual.hasGenotype() && locusPosition < individual.getGenotype().size() && !individual.getGenotype().isMonolocusGenotypeMissing(locusPosition))
+    usage.add(MemoryUsage::GENOTYPES, individual.getGenotype().monolocusGenotype(locusPosition).memoryUsage());
+  return usage;
+}
+
+/******************************************************************************/
+
+MemoryUsage DataSet::groupMemoryUsage_(size_t groupPosition) const
+{
+  if (!MemoryTracker::isTracking() || groupPosition >= groups_.size())
+    return MemoryUsage();
+  return groups_[groupPosition]->memoryUsage();
+}
+
+/******************************************************************************/
+
+MemoryUsage DataSet::locusMemoryUsage_(size_t locusPosition) const
+{
+  if (!MemoryTracker::isTracking() || !analyzedLoci_ || locusPosition >= analyzedLoci_->getNumberOfLoci())
+    return MemoryUsage();
+  try
+  {
+    return analyzedLoci_->getLocusInfoAtPosition(locusPosition).memoryUsage();
+  }
+  catch (NullPointerException&)
+  {
+    // No locus defined at this position
+    return MemoryUsage();
+  }
+}
+
+/******************************************************************************/
+
+MemoryUsage DataSet::localityMemoryUsage_(const Locality<double>& locality)
+{
+  MemoryUsage usage;
+  usage.add(MemoryUsage::INDIVIDUALS, sizeof(Locality<double>));
+  usage.add(MemoryUsage::NAMES, MemoryUsage::ofString(locality.getName()));
+  return usage;
+}
+
+/******************************************************************************/
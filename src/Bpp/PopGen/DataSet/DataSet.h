@@ -19,6 +19,7 @@
 #include "Individual.h"
 #include "Locality.h"
 #include "../GeneralExceptions.h"
+#include "../GenotypeArena.h"
 #include "AnalyzedLoci.h"
 #include "../PolymorphismMultiGContainer.h"
 #include "../PolymorphismSequenceContainer.h"
@@ -31,15 +32,21 @@ namespace bpp
  * A DataSet the object that manage every data on which one can compute
  * some statistics.
  *
+ * Individuals, genotypes and allele informations created through the
+ * DataSet are allocated from its own GenotypeArena, so that loading and
+ * destroying a large data set does not cost one heap allocation per object.
+ *
  * @author Sylvain Gaillard
  */
 class DataSet
 {
 private:
+  GenotypeArena arena_;
   std::unique_ptr<AnalyzedLoci> analyzedLoci_;
   std::shared_ptr<const Alphabet> sequenceAlphabet_;
   std::vector<std::shared_ptr<Locality<double>>> localities_; // Localities can be shared
   std::vector<std::unique_ptr<Group>> groups_;
+  TrackedMemoryUsage trackedMemory_;
 
 public:
   // Constructor and destructor
@@ -47,17 +54,26 @@ public:
    * @brief Build a new void DataSet.
    */
   DataSet() :
+    arena_(),
     analyzedLoci_(nullptr),
     sequenceAlphabet_(nullptr),
     localities_(),
-    groups_()
-  {}
+    groups_(),
+    trackedMemory_()
+  {
+    reportMemoryUsage_();
+  }
 
 
   /**
    * @brief Destroy a DataSet.
    */
-  virtual ~DataSet() = default;
+  virtual ~DataSet()
+  {
+    GenotypeArena::Scope scope(arena_);
+    groups_.clear();
+    analyzedLoci_.reset();
+  }
 
   /**
    * @brief Copy constructor.
@@ -598,7 +614,9 @@ public:
    */
   void setAnalyzedLoci(const AnalyzedLoci& analyzedLoci)
   {
+    MemoryUsage before = analyzedLociMemoryUsage_();
     analyzedLoci_.reset(analyzedLoci.clone());
+    trackedMemory_.report(before, analyzedLociMemoryUsage_());
   }
 
   /**
@@ -611,6 +629,7 @@ public:
     if (analyzedLoci_)
       throw Exception("DataSet::initAnalyzedLoci: analyzedLoci_ already initialyzed.");
     analyzedLoci_ = std::make_unique<AnalyzedLoci>(numberOfLoci);
+    trackedMemory_.report(MemoryUsage(), analyzedLociMemoryUsage_());
   }
 
   /**
@@ -630,6 +649,7 @@ public:
    */
   void deleteAnalyzedLoci()
   {
+    trackedMemory_.report(analyzedLociMemoryUsage_(), MemoryUsage());
     if (analyzedLoci_) analyzedLoci_.reset(nullptr);
   }
 
@@ -709,6 +729,52 @@ public:
    * @brief Tell if there is alelelic data.
    */
   bool hasAlleleicData() const { return analyzedLoci_ != nullptr; }
+
+  // ** Memory usage ***********************************************************/
+  /**
+   * @brief Get the estimated memory footprint of the DataSet.
+   *
+   * The breakdown sums the groups and their individuals, the loci
+   * description and the localities (names as MemoryUsage::NAMES).
+   *
+   * When a MemoryTracker is installed, the DataSet reports the footprint
+   * of the localities, groups, individuals and loci added or removed,
+   * and the changes of the individuals and loci modified through its
+   * methods.
+   */
+  MemoryUsage memoryUsage() const;
+
+private:
+  /**
+   * @name Footprints reported to the global tracker.
+   *
+   * They are empty if no tracker is installed or if the object does not exist.
+   * @{
+   */
+  MemoryUsage individualMemoryUsage_(size_t groupPosition, size_t individualPosition) const;
+
+  MemoryUsage monolocusGenotypeMemoryUsage_(size_t groupPosition, size_t individualPosition, size_t locusPosition) const;
+
+  MemoryUsage groupMemoryUsage_(size_t groupPosition) const;
+
+  MemoryUsage locusMemoryUsage_(size_t locusPosition) const;
+
+  MemoryUsage analyzedLociMemoryUsage_() const
+  {
+    return MemoryTracker::isTracking() && analyzedLoci_ ? analyzedLoci_->memoryUsage() : MemoryUsage();
+  }
+
+  static MemoryUsage localityMemoryUsage_(const Locality<double>& locality);
+  /** @} */
+
+  /**
+   * @brief Report the whole footprint of the DataSet to the global tracker, if any.
+   */
+  void reportMemoryUsage_()
+  {
+    if (MemoryTracker::isTracking())
+      trackedMemory_.reportAll(memoryUsage());
+  }
 };
 } // end of namespace bpp;
 
@@ -530,3 +530,19 @@ size_t Group::getGroupSizeForSequence(size_t sequencePosition) const
   }
   return count;
 }
+
+/******************************************************************************/
+
+MemoryUsage Group::memoryUsage() const
+{
+  MemoryUsage usage;
+  usage.add(MemoryUsage::INDIVIDUALS, sizeof(*this) + MemoryUsage::ofVector(individuals_));
+  usage.add(MemoryUsage::NAMES, MemoryUsage::ofString(name_));
+  for (const auto& individual : individuals_)
+  {
+    usage += individual->memoryUsage();
+  }
+  return usage;
+}
+
+/******************************************************************************/
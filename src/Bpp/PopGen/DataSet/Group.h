@@ -498,6 +498,11 @@ public:
    * @brief Get the number of individual that have a sequence at the specified position.
    */
   size_t getGroupSizeForSequence(size_t sequencePosition) const;
+
+  /**
+   * @brief Get the estimated memory footprint of the group and its individuals.
+   */
+  MemoryUsage memoryUsage() const;
 };
 } // end of namespace bpp;
 
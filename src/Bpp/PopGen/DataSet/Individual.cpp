@@ -561,3 +561,29 @@ size_t Individual::countHeterozygousLoci() const
 }
 
 /******************************************************************************/
+
+MemoryUsage Individual::memoryUsage() const
+{
+  MemoryUsage usage;
+  size_t bytes = sizeof(*this) + MemoryUsage::ofString(id_);
+  if (date_)
+    bytes += sizeof(Date);
+  if (coord_)
+    bytes += sizeof(Point2D<double>);
+  usage.add(MemoryUsage::INDIVIDUALS, bytes);
+  if (sequences_)
+  {
+    usage.add(MemoryUsage::SEQUENCES, sizeof(VectorSequenceContainer));
+    for (size_t i = 0; i < sequences_->getNumberOfSequences(); ++i)
+    {
+      const Sequence& seq = sequences_->sequence(i);
+      usage.add(MemoryUsage::SEQUENCES, sizeof(Sequence) + seq.size() * sizeof(int));
+      usage.add(MemoryUsage::NAMES, MemoryUsage::ofString(seq.getName()));
+    }
+  }
+  if (genotype_)
+    usage += genotype_->memoryUsage();
+  return usage;
+}
+
+/******************************************************************************/
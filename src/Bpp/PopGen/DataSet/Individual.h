@@ -23,6 +23,7 @@
 #include "Date.h"
 #include "../MultilocusGenotype.h"
 #include "../GeneralExceptions.h"
+#include "../GenotypeArena.h"
 
 namespace bpp
 {
@@ -36,7 +37,8 @@ namespace bpp
  *
  * @author Sylvain Gaillard
  */
-class Individual
+class Individual :
+  public ArenaAllocated
 {
 protected:
   std::string id_;
@@ -466,6 +468,16 @@ public:
    * @throw NullPointerException if there is no genotype defined.
    */
   size_t countHeterozygousLoci() const;
+
+  /**
+   * @brief Get the estimated memory footprint of the individual.
+   *
+   * The individual's own data (id, date, coordinates) are reported as
+   * MemoryUsage::INDIVIDUALS, its sequences as MemoryUsage::SEQUENCES,
+   * their names as MemoryUsage::NAMES and its genotype as
+   * MemoryUsage::GENOTYPES. The shared locality is not counted.
+   */
+  MemoryUsage memoryUsage() const;
 };
 } // end of namespace bpp;
 
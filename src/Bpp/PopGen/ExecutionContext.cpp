@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "ExecutionContext.h"
+
+// From the STL
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <thread>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+/**
+ * @brief Set in worker threads, so that nested calls run sequentially.
+ */
+thread_local bool insideWorker = false;
+
+/**
+ * @brief Number of chunks per thread with an automatic grain size, for load balancing.
+ */
+const size_t CHUNKS_PER_THREAD = 4;
+
+/**
+ * @brief Number of chunks of the reductions with an automatic grain size.
+ */
+const size_t ORDERED_CHUNKS = 64;
+}
+
+/******************************************************************************/
+
+/**
+ * @brief Fixed set of worker threads consuming jobs from a shared queue.
+ */
+class ExecutionContext::ThreadPool_
+{
+private:
+  vector<thread> workers_;
+  deque<function<void()>> jobs_;
+  mutex mutex_;
+  condition_variable condition_;
+  bool stop_;
+
+public:
+  ThreadPool_(size_t nbWorkers) :
+    workers_(),
+    jobs_(),
+    mutex_(),
+    condition_(),
+    stop_(false)
+  {
+    for (size_t i = 0; i < nbWorkers; ++i)
+    {
+      workers_.emplace_back([this]() {
+            insideWorker = true;
+            while (true)
+            {
+              function<void()> job;
+              {
+                unique_lock<mutex> lock(mutex_);
+                condition_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+                if (stop_ && jobs_.empty())
+                  return;
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+              }
+              job();
+            }
+          });
+    }
+  }
+
+  ThreadPool_(const ThreadPool_&) = delete;
+  ThreadPool_& operator=(const ThreadPool_&) = delete;
+
+  ~ThreadPool_()
+  {
+    {
+      lock_guard<mutex> lock(mutex_);
+      stop_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_)
+    {
+      worker.join();
+    }
+  }
+
+  size_t getNumberOfWorkers() const { return workers_.size(); }
+
+  void submit(function<void()> job)
+  {
+    {
+      lock_guard<mutex> lock(mutex_);
+      jobs_.push_back(std::move(job));
+    }
+    condition_.notify_one();
+  }
+};
+
+/******************************************************************************/
+
+ExecutionContext::ExecutionContext(size_t numberOfThreads, size_t grainSize, bool deterministic) :
+  numberOfThreads_(numberOfThreads),
+  grainSize_(grainSize),
+  deterministic_(deterministic),
+  pool_()
+{
+  if (numberOfThreads_ == 0)
+    numberOfThreads_ = max(static_cast<size_t>(thread::hardware_concurrency()), static_cast<size_t>(1));
+  if (numberOfThreads_ > 1)
+    pool_.reset(new ThreadPool_(numberOfThreads_ - 1));
+}
+
+/******************************************************************************/
+
+ExecutionContext::~ExecutionContext() {}
+
+/******************************************************************************/
+
+const ExecutionContext& ExecutionContext::sequential()
+{
+  static const ExecutionContext context(1);
+  return context;
+}
+
+/******************************************************************************/
+
+size_t ExecutionContext::getNumberOfChunks_(size_t nbIndices, bool ordered) const
+{
+  if (grainSize_ > 0)
+    return (nbIndices + grainSize_ - 1) / grainSize_;
+  // Ordered chunks do not depend on the number of threads, so that deterministic
+  // reductions give the same result whatever the context.
+  if (ordered)
+    return min(nbIndices, ORDERED_CHUNKS);
+  return min(nbIndices, numberOfThreads_ * CHUNKS_PER_THREAD);
+}
+
+/******************************************************************************/
+
+void ExecutionContext::run_(size_t nbTasks, const function<void(size_t)>& task) const
+{
+  if (!pool_ || insideWorker || nbTasks < 2)
+  {
+    for (size_t t = 0; t < nbTasks; ++t)
+    {
+      task(t);
+    }
+    return;
+  }
+
+  // Tasks are pulled from a shared counter by the workers and the calling thread.
+  atomic<size_t> next(0);
+  mutex errorMutex;
+  exception_ptr error;
+  auto consume = [&]() {
+        size_t t;
+        while ((t = next++) < nbTasks)
+        {
+          try
+          {
+            task(t);
+          }
+          catch (...)
+          {
+            lock_guard<mutex> lock(errorMutex);
+            if (!error)
+              error = current_exception();
+            next = nbTasks;
+          }
+        }
+      };
+
+  size_t nbHelpers = min(pool_->getNumberOfWorkers(), nbTasks - 1);
+  mutex doneMutex;
+  condition_variable doneCondition;
+  size_t nbDone = 0;
+  for (size_t h = 0; h < nbHelpers; ++h)
+  {
+    pool_->submit([&]() {
+          consume();
+          lock_guard<mutex> lock(doneMutex);
+          ++nbDone;
+          doneCondition.notify_one();
+        });
+  }
+  consume();
+  {
+    unique_lock<mutex> lock(doneMutex);
+    doneCondition.wait(lock, [&]() { return nbDone == nbHelpers; });
+  }
+  if (error)
+    rethrow_exception(error);
+}
+
+/******************************************************************************/
@@ -0,0 +1,203 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _EXECUTIONCONTEXT_H_
+#define _EXECUTIONCONTEXT_H_
+
+#include <Bpp/Exceptions.h>
+
+// From the STL
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+namespace bpp
+{
+/**
+ * @brief Execution policy shared by the statistics methods of the library.
+ *
+ * An ExecutionContext owns a pool of worker threads which is reused by
+ * every method it is given to, so that an application can create one
+ * context and pass it to all the heavy computations (pairwise LD,
+ * distance matrices, permutation tests, ...) instead of letting each of
+ * them spawn its own threads.
+ *
+ * Work is split in chunks of at least grainSize consecutive indices.
+ * With the default grain size of 0, the chunk size is chosen from the
+ * number of indices: a few chunks per thread for parallelFor(), and a
+ * fixed number of chunks for parallelReduce(), so that small per-index
+ * tasks do not each pay for a dispatch.
+ * When the deterministic reduction option is set (the default), partial
+ * results are always combined in index order, and the chunks of a
+ * reduction never depend on the number of threads, so that floating point
+ * results do not depend on the number of threads nor on the scheduling.
+ *
+ * Calls made from inside a worker thread are run sequentially in the
+ * calling thread, so that nested parallel calls can not dead-lock the pool.
+ *
+ * The default context, returned by ExecutionContext::sequential(), has
+ * no worker thread and runs everything in the calling thread.
+ */
+class ExecutionContext
+{
+private:
+  class ThreadPool_;
+
+  size_t numberOfThreads_;
+  size_t grainSize_;
+  bool deterministic_;
+  std::unique_ptr<ThreadPool_> pool_;
+
+public:
+  /**
+   * @brief Build a new execution context.
+   *
+   * @param numberOfThreads The total number of threads used, including the calling one.
+   * 0 means as many threads as hardware cores.
+   * @param grainSize The minimum number of indices processed by a single task.
+   * 0 means a grain size chosen from the number of indices.
+   * @param deterministic Tell if partial results must be combined in index order.
+   */
+  ExecutionContext(size_t numberOfThreads = 0, size_t grainSize = 0, bool deterministic = true);
+
+  ExecutionContext(const ExecutionContext&) = delete;
+  ExecutionContext& operator=(const ExecutionContext&) = delete;
+
+  virtual ~ExecutionContext();
+
+  /**
+   * @brief Get the context running everything in the calling thread.
+   */
+  static const ExecutionContext& sequential();
+
+  /**
+   * @brief Get the total number of threads used by this context.
+   */
+  size_t getNumberOfThreads() const { return numberOfThreads_; }
+
+  /**
+   * @brief Get the minimum number of indices processed by a single task, 0 if it is automatic.
+   */
+  size_t getGrainSize() const { return grainSize_; }
+
+  /**
+   * @brief Set the minimum number of indices processed by a single task.
+   *
+   * @param grainSize The grain size, 0 for a grain size chosen from the number of indices.
+   */
+  void setGrainSize(size_t grainSize) { grainSize_ = grainSize; }
+
+  /**
+   * @brief Tell if partial results are combined in index order.
+   */
+  bool isDeterministic() const { return deterministic_; }
+
+  void setDeterministic(bool deterministic) { deterministic_ = deterministic; }
+
+  /**
+   * @brief Tell if this context actually runs tasks concurrently.
+   */
+  bool isParallel() const { return numberOfThreads_ > 1; }
+
+  /**
+   * @brief Call f(i) for every i in [begin, end).
+   *
+   * The calls for different i may be run concurrently, so f must only
+   * write to memory specific to index i.
+   * The first exception thrown by f is rethrown once all the tasks are over.
+   *
+   * @param begin The first index.
+   * @param end The index after the last one.
+   * @param f The function to call.
+   */
+  template<class Function>
+  void parallelFor(size_t begin, size_t end, Function f) const
+  {
+    if (end <= begin)
+      return;
+    size_t nbChunks = getNumberOfChunks_(end - begin, false);
+    size_t chunkSize = (end - begin + nbChunks - 1) / nbChunks;
+    run_(nbChunks, [&](size_t chunk) {
+          size_t first = begin + chunk * chunkSize;
+          size_t last = std::min(end, first + chunkSize);
+          for (size_t i = first; i < last; ++i)
+          {
+            f(i);
+          }
+        });
+  }
+
+  /**
+   * @brief Map every index of [begin, end) to a value and reduce the values.
+   *
+   * @param begin The first index.
+   * @param end The index after the last one.
+   * @param identity The neutral element of the reduction.
+   * @param map The function computing the value of index i.
+   * @param reduce The binary function combining two values.
+   * @return The reduction of identity and of all the mapped values.
+   */
+  template<class T, class Map, class Reduce>
+  T parallelReduce(size_t begin, size_t end, T identity, Map map, Reduce reduce) const
+  {
+    if (end <= begin)
+      return identity;
+    size_t nbChunks = getNumberOfChunks_(end - begin, deterministic_);
+    size_t chunkSize = (end - begin + nbChunks - 1) / nbChunks;
+    if (deterministic_)
+    {
+      std::vector<T> partials(nbChunks, identity);
+      run_(nbChunks, [&](size_t chunk) {
+            size_t first = begin + chunk * chunkSize;
+            size_t last = std::min(end, first + chunkSize);
+            for (size_t i = first; i < last; ++i)
+            {
+              partials[chunk] = reduce(partials[chunk], map(i));
+            }
+          });
+      T result = identity;
+      for (size_t chunk = 0; chunk < nbChunks; ++chunk)
+      {
+        result = reduce(result, partials[chunk]);
+      }
+      return result;
+    }
+    else
+    {
+      T result = identity;
+      std::mutex resultMutex;
+      run_(nbChunks, [&](size_t chunk) {
+            size_t first = begin + chunk * chunkSize;
+            size_t last = std::min(end, first + chunkSize);
+            T partial = identity;
+            for (size_t i = first; i < last; ++i)
+            {
+              partial = reduce(partial, map(i));
+            }
+            std::lock_guard<std::mutex> lock(resultMutex);
+            result = reduce(result, partial);
+          });
+      return result;
+    }
+  }
+
+private:
+  /**
+   * @brief Get the number of chunks of nbIndices indices.
+   *
+   * @param nbIndices The number of indices.
+   * @param ordered Tell if the chunks must not depend on the number of threads.
+   */
+  size_t getNumberOfChunks_(size_t nbIndices, bool ordered) const;
+
+  /**
+   * @brief Run task(0), ..., task(nbTasks - 1) on the pool and wait for them.
+   */
+  void run_(size_t nbTasks, const std::function<void(size_t)>& task) const;
+};
+} // end of namespace bpp;
+
+#endif // _EXECUTIONCONTEXT_H_
@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "FStatistics.h"
+
+// From the STL
+#include <cmath>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+FStatistics::FStatistics(
+    const AlleleFrequencyTable& table,
+    size_t blockLength,
+    const ExecutionContext& context) :
+  table_(table),
+  nbGroups_(table.getNumberOfGroups()),
+  blockStarts_(),
+  sums_()
+{
+  if (blockLength == 0)
+    throw BadIntegerException("FStatistics::FStatistics: blockLength must be > 0.", 0);
+  size_t nbSites = table.getNumberOfSites();
+  for (size_t s = 0; s < nbSites; ++s)
+  {
+    if (s == 0 || table.getSiteIndex(s) / blockLength != table.getSiteIndex(s - 1) / blockLength)
+      blockStarts_.push_back(s);
+  }
+  blockStarts_.push_back(nbSites);
+
+  size_t nbBlocks = getNumberOfBlocks();
+  sums_.assign(nbBlocks * nbGroups_ * nbGroups_, 0.);
+  context.parallelFor(0, nbBlocks, [&](size_t block) {
+        double* sums = &sums_[block * nbGroups_ * nbGroups_];
+        vector<double> p(nbGroups_);
+        for (size_t s = blockStarts_[block]; s < blockStarts_[block + 1]; ++s)
+        {
+          for (size_t i = 0; i < nbGroups_; ++i)
+          {
+            p[i] = table_.getFrequency(s, i);
+          }
+          for (size_t i = 0; i < nbGroups_; ++i)
+          {
+            double n = static_cast<double>(table_.getSampleSize(s, i));
+            double correction = n > 1. ? p[i] * (1. - p[i]) / (n - 1.) : 0.;
+            sums[i * nbGroups_ + i] += p[i] * p[i] - correction;
+            for (size_t j = i + 1; j < nbGroups_; ++j)
+            {
+              sums[i * nbGroups_ + j] += p[i] * p[j];
+            }
+          }
+        }
+        for (size_t i = 0; i < nbGroups_; ++i)
+        {
+          for (size_t j = 0; j < i; ++j)
+          {
+            sums[i * nbGroups_ + j] = sums[j * nbGroups_ + i];
+          }
+        }
+      });
+}
+
+/******************************************************************************/
+
+FStatistics::Estimate FStatistics::f2(size_t a, size_t b) const
+{
+  size_t i = table_.getGroupIndex(a);
+  size_t j = table_.getGroupIndex(b);
+  size_t nbBlocks = getNumberOfBlocks();
+  vector<double> numerators(nbBlocks), denominators(nbBlocks);
+  for (size_t block = 0; block < nbBlocks; ++block)
+  {
+    numerators[block] = blockSum_(block, i, i) + blockSum_(block, j, j) - 2. * blockSum_(block, i, j);
+    denominators[block] = static_cast<double>(blockStarts_[block + 1] - blockStarts_[block]);
+  }
+  return jackknife_(numerators, denominators);
+}
+
+/******************************************************************************/
+
+FStatistics::Estimate FStatistics::f3(size_t c, size_t a, size_t b) const
+{
+  size_t k = table_.getGroupIndex(c);
+  size_t i = table_.getGroupIndex(a);
+  size_t j = table_.getGroupIndex(b);
+  size_t nbBlocks = getNumberOfBlocks();
+  vector<double> numerators(nbBlocks), denominators(nbBlocks);
+  for (size_t block = 0; block < nbBlocks; ++block)
+  {
+    numerators[block] = blockSum_(block, k, k) - blockSum_(block, k, i) - blockSum_(block, k, j) + blockSum_(block, i, j);
+    denominators[block] = static_cast<double>(blockStarts_[block + 1] - blockStarts_[block]);
+  }
+  return jackknife_(numerators, denominators);
+}
+
+/******************************************************************************/
+
+FStatistics::Estimate FStatistics::f4(size_t a, size_t b, size_t c, size_t d) const
+{
+  size_t i = table_.getGroupIndex(a);
+  size_t j = table_.getGroupIndex(b);
+  size_t k = table_.getGroupIndex(c);
+  size_t l = table_.getGroupIndex(d);
+  size_t nbBlocks = getNumberOfBlocks();
+  vector<double> numerators(nbBlocks), denominators(nbBlocks);
+  for (size_t block = 0; block < nbBlocks; ++block)
+  {
+    numerators[block] = blockSum_(block, i, k) - blockSum_(block, i, l) - blockSum_(block, j, k) + blockSum_(block, j, l);
+    denominators[block] = static_cast<double>(blockStarts_[block + 1] - blockStarts_[block]);
+  }
+  return jackknife_(numerators, denominators);
+}
+
+/******************************************************************************/
+
+FStatistics::Estimate FStatistics::dStatistic(size_t a, size_t b, size_t c, size_t d) const
+{
+  array<size_t, 4> indices = {{ table_.getGroupIndex(a), table_.getGroupIndex(b), table_.getGroupIndex(c), table_.getGroupIndex(d) }};
+  vector<double> numerators, denominators;
+  dBlocks_(indices, numerators, denominators);
+  return jackknife_(numerators, denominators);
+}
+
+/******************************************************************************/
+
+vector<FStatistics::Estimate> FStatistics::f3(
+    const vector< array<size_t, 3> >& triples,
+    const ExecutionContext& context) const
+{
+  for (const auto& triple : triples)
+  {
+    for (size_t id : triple)
+    {
+      table_.getGroupIndex(id);
+    }
+  }
+  vector<Estimate> estimates(triples.size());
+  context.parallelFor(0, triples.size(), [&](size_t t) {
+        estimates[t] = f3(triples[t][0], triples[t][1], triples[t][2]);
+      });
+  return estimates;
+}
+
+/******************************************************************************/
+
+vector<FStatistics::Estimate> FStatistics::f4(
+    const vector< array<size_t, 4> >& quartets,
+    const ExecutionContext& context) const
+{
+  for (const auto& quartet : quartets)
+  {
+    for (size_t id : quartet)
+    {
+      table_.getGroupIndex(id);
+    }
+  }
+  vector<Estimate> estimates(quartets.size());
+  context.parallelFor(0, quartets.size(), [&](size_t q) {
+        estimates[q] = f4(quartets[q][0], quartets[q][1], quartets[q][2], quartets[q][3]);
+      });
+  return estimates;
+}
+
+/******************************************************************************/
+
+vector<FStatistics::Estimate> FStatistics::dStatistic(
+    const vector< array<size_t, 4> >& quartets,
+    const ExecutionContext& context) const
+{
+  for (const auto& quartet : quartets)
+  {
+    for (size_t id : quartet)
+    {
+      table_.getGroupIndex(id);
+    }
+  }
+  vector<Estimate> estimates(quartets.size());
+  context.parallelFor(0, quartets.size(), [&](size_t q) {
+        estimates[q] = dStatistic(quartets[q][0], quartets[q][1], quartets[q][2], quartets[q][3]);
+      });
+  return estimates;
+}
+
+/******************************************************************************/
+
+void FStatistics::dBlocks_(
+    const array<size_t, 4>& indices,
+    vector<double>& numerators,
+    vector<double>& denominators) const
+{
+  size_t i = indices[0], j = indices[1], k = indices[2], l = indices[3];
+  size_t nbBlocks = getNumberOfBlocks();
+  numerators.resize(nbBlocks);
+  denominators.resize(nbBlocks);
+  for (size_t block = 0; block < nbBlocks; ++block)
+  {
+    numerators[block] = blockSum_(block, i, k) - blockSum_(block, i, l) - blockSum_(block, j, k) + blockSum_(block, j, l);
+    double denominator = 0.;
+    for (size_t s = blockStarts_[block]; s < blockStarts_[block + 1]; ++s)
+    {
+      double pa = table_.getFrequency(s, i);
+      double pb = table_.getFrequency(s, j);
+      double pc = table_.getFrequency(s, k);
+      double pd = table_.getFrequency(s, l);
+      denominator += (pa + pb - 2. * pa * pb) * (pc + pd - 2. * pc * pd);
+    }
+    denominators[block] = denominator;
+  }
+}
+
+/******************************************************************************/
+
+FStatistics::Estimate FStatistics::jackknife_(
+    const vector<double>& numerators,
+    const vector<double>& denominators) const
+{
+  size_t nbBlocks = numerators.size();
+  double sumNumerators = 0., sumDenominators = 0.;
+  for (size_t block = 0; block < nbBlocks; ++block)
+  {
+    sumNumerators += numerators[block];
+    sumDenominators += denominators[block];
+  }
+  Estimate estimate;
+  estimate.value = sumNumerators / sumDenominators;
+  estimate.standardError = NAN;
+  estimate.zScore = NAN;
+  if (nbBlocks < 2)
+    return estimate;
+
+  double nbSites = static_cast<double>(blockStarts_.back());
+  double g = static_cast<double>(nbBlocks);
+  vector<double> h(nbBlocks), partial(nbBlocks);
+  double jackknife = g * estimate.value;
+  for (size_t block = 0; block < nbBlocks; ++block)
+  {
+    double m = static_cast<double>(blockStarts_[block + 1] - blockStarts_[block]);
+    h[block] = nbSites / m;
+    partial[block] = (sumNumerators - numerators[block]) / (sumDenominators - denominators[block]);
+    jackknife -= (1. - m / nbSites) * partial[block];
+  }
+  double variance = 0.;
+  for (size_t block = 0; block < nbBlocks; ++block)
+  {
+    double pseudoValue = h[block] * estimate.value - (h[block] - 1.) * partial[block];
+    variance += (pseudoValue - jackknife) * (pseudoValue - jackknife) / (h[block] - 1.);
+  }
+  variance /= g;
+  estimate.standardError = sqrt(variance);
+  estimate.zScore = estimate.value / estimate.standardError;
+  return estimate;
+}
+
+/******************************************************************************/
@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _FSTATISTICS_H_
+#define _FSTATISTICS_H_
+
+#include <Bpp/Exceptions.h>
+
+// From local
+#include "AlleleFrequencyTable.h"
+#include "ExecutionContext.h"
+
+// From the STL
+#include <array>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Patterson's D and f-statistics with block jackknife standard errors.
+ *
+ * The sites of an AlleleFrequencyTable are split in blocks of consecutive
+ * sites, block k holding the sites whose index in the source container is
+ * in [k * blockLength, (k + 1) * blockLength). Empty blocks are dropped.
+ *
+ * For each block, the sums over its sites of the products of the derived
+ * allele frequencies of every pair of groups are computed once, when the
+ * object is built. The squared frequency of a group is corrected for the
+ * sampling bias (p^2 - p(1-p)/(n-1), Patterson et al. 2012). Every f2, f3
+ * and f4 statistic is then a linear combination of these sums:
+ * - f2(A, B) = mean of (pA - pB)^2,
+ * - f3(C; A, B) = mean of (pC - pA)(pC - pB),
+ * - f4(A, B; C, D) = mean of (pA - pB)(pC - pD).
+ *
+ * Patterson's D(A, B; C, D) is the sum of (pA - pB)(pC - pD) divided by
+ * the sum of (pA + pB - 2 pA pB)(pC + pD - 2 pC pD). Its numerator comes
+ * from the block sums, its denominator needs a pass over the sites of the
+ * four groups.
+ *
+ * Standard errors are computed with the weighted block jackknife of Busing
+ * et al. 1999, each block being weighted by its number of sites. They are
+ * NaN with less than two blocks.
+ *
+ * Groups are given by their ids.
+ *
+ * References:
+ * - Busing et al. 1999, Statistics and Computing 9:3-8.
+ * - Patterson et al. 2012, Genetics 192:1065-1093.
+ */
+class FStatistics
+{
+public:
+  /**
+   * @brief A statistic with its jackknife standard error.
+   */
+  struct Estimate
+  {
+    double value;
+    double standardError;
+    double zScore;
+  };
+
+private:
+  const AlleleFrequencyTable& table_;
+  size_t nbGroups_;
+  std::vector<size_t> blockStarts_;
+  std::vector<double> sums_;
+
+public:
+  /**
+   * @brief Compute the block sums.
+   *
+   * @param table The allele frequencies, which must outlive this object.
+   * @param blockLength The length of a block, in sites of the source container.
+   * @param context The ExecutionContext used to compute the blocks.
+   * @throw BadIntegerException if blockLength is 0.
+   */
+  FStatistics(
+      const AlleleFrequencyTable& table,
+      size_t blockLength,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  virtual ~FStatistics() {}
+
+public:
+  size_t getNumberOfBlocks() const { return blockStarts_.size() - 1; }
+
+  /**
+   * @throw GroupNotFoundException if a group is not found.
+   */
+  Estimate f2(size_t a, size_t b) const;
+
+  /**
+   * @brief Compute f3(c; a, b).
+   *
+   * @throw GroupNotFoundException if a group is not found.
+   */
+  Estimate f3(size_t c, size_t a, size_t b) const;
+
+  /**
+   * @throw GroupNotFoundException if a group is not found.
+   */
+  Estimate f4(size_t a, size_t b, size_t c, size_t d) const;
+
+  /**
+   * @brief Compute Patterson's D(a, b; c, d).
+   *
+   * @throw GroupNotFoundException if a group is not found.
+   */
+  Estimate dStatistic(size_t a, size_t b, size_t c, size_t d) const;
+
+  /**
+   * @brief Compute f3 for a set of triples (c, a, b).
+   *
+   * @param triples The group ids of each combination.
+   * @param context The ExecutionContext used to scan the combinations.
+   * @throw GroupNotFoundException if a group is not found.
+   */
+  std::vector<Estimate> f3(
+      const std::vector< std::array<size_t, 3> >& triples,
+      const ExecutionContext& context = ExecutionContext::sequential()) const;
+
+  /**
+   * @brief Compute f4 for a set of quartets.
+   *
+   * @param quartets The group ids of each combination.
+   * @param context The ExecutionContext used to scan the combinations.
+   * @throw GroupNotFoundException if a group is not found.
+   */
+  std::vector<Estimate> f4(
+      const std::vector< std::array<size_t, 4> >& quartets,
+      const ExecutionContext& context = ExecutionContext::sequential()) const;
+
+  /**
+   * @brief Compute Patterson's D for a set of quartets.
+   *
+   * @param quartets The group ids of each combination.
+   * @param context The ExecutionContext used to scan the combinations.
+   * @throw GroupNotFoundException if a group is not found.
+   */
+  std::vector<Estimate> dStatistic(
+      const std::vector< std::array<size_t, 4> >& quartets,
+      const ExecutionContext& context = ExecutionContext::sequential()) const;
+
+private:
+  /**
+   * @brief Get the sum of the products of the frequencies of two groups in a block.
+   */
+  double blockSum_(size_t block, size_t i, size_t j) const
+  {
+    return sums_[(block * nbGroups_ + i) * nbGroups_ + j];
+  }
+
+  /**
+   * @brief Compute (sum of f4 numerators, sum of D denominators) in each block.
+   *
+   * @param indices The indices of the four groups.
+   * @param numerators Receives the numerator of each block.
+   * @param denominators Receives the denominator of each block.
+   */
+  void dBlocks_(
+      const std::array<size_t, 4>& indices,
+      std::vector<double>& numerators,
+      std::vector<double>& denominators) const;
+
+  /**
+   * @brief Compute the ratio of the sums and its weighted block jackknife standard error.
+   *
+   * @param numerators The numerator of each block.
+   * @param denominators The denominator of each block.
+   */
+  Estimate jackknife_(
+      const std::vector<double>& numerators,
+      const std::vector<double>& denominators) const;
+};
+} // end of namespace bpp;
+
+#endif // _FSTATISTICS_H_
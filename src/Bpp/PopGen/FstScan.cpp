@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "FstScan.h"
+
+// From the STL
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+typedef MultilocusGenotypeStatistics::VarComp VarComp;
+
+VarComp zeroVarComp_()
+{
+  VarComp zero;
+  zero.a = zero.b = zero.c = 0.;
+  return zero;
+}
+
+double fst_(const VarComp& v)
+{
+  double total = v.a + v.b + v.c;
+  return total != 0. ? v.a / total : NAN;
+}
+
+/**
+ * @brief Keep the k rows of highest Fst in a min-heap.
+ */
+template<class Row>
+void keepTop_(vector<Row>& heap, size_t k, const Row& row)
+{
+  if (k == 0 || std::isnan(row.Fst))
+    return;
+  auto greater = [](const Row& x, const Row& y) {
+        return x.Fst > y.Fst;
+      };
+  if (heap.size() < k)
+  {
+    heap.push_back(row);
+    push_heap(heap.begin(), heap.end(), greater);
+  }
+  else if (row.Fst > heap.front().Fst)
+  {
+    pop_heap(heap.begin(), heap.end(), greater);
+    heap.back() = row;
+    push_heap(heap.begin(), heap.end(), greater);
+  }
+}
+
+template<class Row>
+vector<Row> sortTop_(vector<Row> rows)
+{
+  stable_sort(rows.begin(), rows.end(), [](const Row& x, const Row& y) {
+        return x.Fst > y.Fst;
+      });
+  return rows;
+}
+
+/**
+ * @brief Give the windows completed by the last loci to the sink.
+ *
+ * The loci of the windows are their ranks in the scan. The components of
+ * the loci from the rank firstPending are in pending; those before the
+ * first locus of the last window are dropped, no later window containing
+ * them.
+ */
+void addWindows_(
+    vector<AnalyzedLoci::LocusWindow>& windows,
+    deque<VarComp>& pending,
+    size_t& firstPending,
+    FstScan::Sink& sink)
+{
+  for (const auto& window : windows)
+  {
+    FstScan::WindowRow row{window.chromosome, window.start, window.end, window.loci.size(), zeroVarComp_(), NAN};
+    for (size_t rank : window.loci)
+    {
+      const VarComp& varComp = pending[rank - firstPending];
+      row.varComp.a += varComp.a;
+      row.varComp.b += varComp.b;
+      row.varComp.c += varComp.c;
+    }
+    row.Fst = fst_(row.varComp);
+    sink.addWindow(row);
+    while (firstPending < window.loci.front())
+    {
+      pending.pop_front();
+      firstPending++;
+    }
+  }
+  windows.clear();
+}
+} // end of anonymous namespace
+
+/******************************************************************************/
+
+void FstScan::TextSink::addLocus(const LocusRow& row)
+{
+  *out_ << "locus\t" << row.chromosome << "\t" << row.position << "\t" << row.locus << "\t"
+        << row.varComp.a << "\t" << row.varComp.b << "\t" << row.varComp.c << "\t" << row.Fst << "\n";
+}
+
+/******************************************************************************/
+
+void FstScan::TextSink::addWindow(const WindowRow& row)
+{
+  *out_ << "window\t" << row.chromosome << "\t" << row.start << "\t" << row.end << "\t" << row.nbLoci << "\t"
+        << row.varComp.a << "\t" << row.varComp.b << "\t" << row.varComp.c << "\t" << row.Fst << "\n";
+}
+
+/******************************************************************************/
+
+void FstScan::TopOutliers::addLocus(const LocusRow& row)
+{
+  keepTop_(loci_, k_, row);
+}
+
+/******************************************************************************/
+
+void FstScan::TopOutliers::addWindow(const WindowRow& row)
+{
+  keepTop_(windows_, k_, row);
+}
+
+/******************************************************************************/
+
+vector<FstScan::LocusRow> FstScan::TopOutliers::getLoci() const
+{
+  return sortTop_(loci_);
+}
+
+/******************************************************************************/
+
+vector<FstScan::WindowRow> FstScan::TopOutliers::getWindows() const
+{
+  return sortTop_(windows_);
+}
+
+/******************************************************************************/
+
+size_t FstScan::scan(
+    const PolymorphismMultiGContainer& pmgc,
+    const AnalyzedLoci& loci,
+    const set<size_t>& groups,
+    size_t windowSize,
+    size_t step,
+    Sink& sink,
+    const ExecutionContext& context,
+    size_t batchSize)
+{
+  return scan(pmgc, loci, groups, vector<bool>(), vector<bool>(), windowSize, step, sink, context, batchSize);
+}
+
+/******************************************************************************/
+
+size_t FstScan::scan(
+    const PolymorphismMultiGContainer& pmgc,
+    const AnalyzedLoci& loci,
+    const set<size_t>& groups,
+    const vector<bool>& locusMask,
+    const vector<bool>& individualMask,
+    size_t windowSize,
+    size_t step,
+    Sink& sink,
+    const ExecutionContext& context,
+    size_t batchSize)
+{
+  if (windowSize == 0)
+    throw BadIntegerException("FstScan::scan: windowSize must be greater than 0.", 0);
+  if (step == 0)
+    throw BadIntegerException("FstScan::scan: step must be greater than 0.", 0);
+  if (batchSize == 0)
+    throw BadIntegerException("FstScan::scan: batchSize must be greater than 0.", 0);
+  if (!locusMask.empty() && locusMask.size() != loci.getNumberOfLoci())
+    throw DimensionException("FstScan::scan: wrong size of the locus mask.", locusMask.size(), loci.getNumberOfLoci());
+  vector<size_t> sortedLoci = loci.getSortedLoci();
+  if (!locusMask.empty())
+  {
+    sortedLoci.erase(remove_if(sortedLoci.begin(), sortedLoci.end(), [&](size_t locus) {
+            return !locusMask[locus];
+          }), sortedLoci.end());
+  }
+  AnalyzedLoci::SlidingWindows sliding(windowSize, step);
+  vector<AnalyzedLoci::LocusWindow> windows;
+  deque<VarComp> pending;
+  size_t firstPending = 0;
+  vector<LocusRow> batch;
+  for (size_t first = 0; first < sortedLoci.size(); first += batchSize)
+  {
+    size_t nb = min(batchSize, sortedLoci.size() - first);
+    batch.resize(nb, LocusRow{0, string(), 0, zeroVarComp_(), NAN});
+    context.parallelFor(0, nb, [&](size_t i) {
+          size_t locus = sortedLoci[first + i];
+          const LocusInfo& info = loci.getLocusInfoAtPosition(locus);
+          LocusRow& row = batch[i];
+          row.locus = locus;
+          row.chromosome = info.getChromosome();
+          row.position = info.getPosition();
+          row.varComp = MultilocusGenotypeStatistics::getLocusVarianceComponents(pmgc.locusView(locus, individualMask), groups);
+          row.Fst = fst_(row.varComp);
+        });
+    for (size_t i = 0; i < nb; ++i)
+    {
+      const LocusRow& row = batch[i];
+      sink.addLocus(row);
+      pending.push_back(row.varComp);
+      sliding.add(row.chromosome, row.position, first + i, windows);
+      addWindows_(windows, pending, firstPending, sink);
+    }
+  }
+  sliding.flush(windows);
+  addWindows_(windows, pending, firstPending, sink);
+  return sortedLoci.size();
+}
+
+/******************************************************************************/
+
+MultilocusGenotypeStatistics::VarComp FstScan::getVarianceComponents(
+    const PolymorphismMultiGContainer& pmgc,
+    size_t locusPosition,
+    const set<size_t>& groups,
+    const vector<bool>& individualMask)
+{
+  return MultilocusGenotypeStatistics::getLocusVarianceComponents(pmgc.locusView(locusPosition, individualMask), groups);
+}
+
+/******************************************************************************/
@@ -0,0 +1,235 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _FSTSCAN_H_
+#define _FSTSCAN_H_
+
+#include <Bpp/Exceptions.h>
+
+// From local
+#include "DataSet/AnalyzedLoci.h"
+#include "ExecutionContext.h"
+#include "MultilocusGenotypeStatistics.h"
+#include "PolymorphismMultiGContainer.h"
+
+// From the STL
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Genome scan of the Weir and Cockerham Fst, locus by locus and in sliding windows.
+ *
+ * The loci are scanned in the order of the index of an AnalyzedLoci (see
+ * AnalyzedLoci::getSortedLoci()), the loci of the AnalyzedLoci being those
+ * of the container, in the same order. The loci without coordinates are
+ * not scanned.
+ *
+ * The variance components a, b and c of a locus (Weir and Cockerham
+ * 1984) are those of
+ * MultilocusGenotypeStatistics::getLocusVarianceComponents(). A locus
+ * whose components are null has a NaN Fst.
+ *
+ * The loci are computed in parallel by batches, and each row is given to
+ * a Sink in the order of the scan, so that the results of the whole
+ * genome never have to be stored. The windows are enumerated by
+ * AnalyzedLoci::SlidingWindows, as in AnalyzedLoci::getWindows(), over
+ * the scanned loci. The Fst of a window is the ratio of the sums of the
+ * components of its loci.
+ *
+ * Reference:
+ * - Weir and Cockerham 1984, Evolution 38:1358-1370.
+ */
+class FstScan
+{
+public:
+  struct LocusRow
+  {
+    /**
+     * @brief The position of the locus in the container.
+     */
+    size_t locus;
+    std::string chromosome;
+    size_t position;
+    MultilocusGenotypeStatistics::VarComp varComp;
+    double Fst;
+  };
+
+  struct WindowRow
+  {
+    std::string chromosome;
+    size_t start;
+    /**
+     * @brief The position after the last one of the window.
+     */
+    size_t end;
+    size_t nbLoci;
+    MultilocusGenotypeStatistics::VarComp varComp;
+    double Fst;
+  };
+
+  /**
+   * @brief The receiver of the rows of a scan.
+   *
+   * The rows are given from a single thread, the loci in the order of the
+   * scan, each window as soon as its last locus has been given.
+   */
+  class Sink
+  {
+  public:
+    virtual ~Sink() {}
+
+  public:
+    virtual void addLocus(const LocusRow& row) = 0;
+    virtual void addWindow(const WindowRow& row) = 0;
+  };
+
+  /**
+   * @brief A Sink writing the rows as tab-separated lines.
+   *
+   * The locus rows start with "locus", the window rows with "window".
+   */
+  class TextSink :
+    public Sink
+  {
+  private:
+    std::ostream* out_;
+
+  public:
+    TextSink(std::ostream& out) : out_(&out) {}
+
+    TextSink(const TextSink&) = delete;
+    TextSink& operator=(const TextSink&) = delete;
+
+  public:
+    void addLocus(const LocusRow& row) override;
+    void addWindow(const WindowRow& row) override;
+  };
+
+  /**
+   * @brief A Sink keeping only the loci and the windows of highest Fst.
+   *
+   * The rows are kept in a heap of size k, so that the memory does not
+   * depend on the number of rows. The rows with a NaN Fst are ignored.
+   */
+  class TopOutliers :
+    public Sink
+  {
+  private:
+    size_t k_;
+    std::vector<LocusRow> loci_;
+    std::vector<WindowRow> windows_;
+
+  public:
+    /**
+     * @param k The number of loci and of windows kept.
+     */
+    TopOutliers(size_t k) :
+      k_(k),
+      loci_(),
+      windows_()
+    {}
+
+  public:
+    void addLocus(const LocusRow& row) override;
+    void addWindow(const WindowRow& row) override;
+
+    /**
+     * @brief Get the loci kept, by decreasing Fst.
+     */
+    std::vector<LocusRow> getLoci() const;
+
+    /**
+     * @brief Get the windows kept, by decreasing Fst.
+     */
+    std::vector<WindowRow> getWindows() const;
+  };
+
+public:
+  // Class destructor
+  virtual ~FstScan() {}
+
+  /**
+   * @brief Scan the loci of a container.
+   *
+   * @param pmgc The genotypes.
+   * @param loci The coordinates of the loci.
+   * @param groups The groups compared.
+   * @param windowSize The number of positions in a window.
+   * @param step The number of positions between the starts of two windows.
+   * @param sink The receiver of the rows.
+   * @param context The ExecutionContext used to compute a batch of loci.
+   * @param batchSize The number of loci computed together.
+   * @return The number of loci scanned.
+   * @throw BadIntegerException if windowSize, step or batchSize is 0.
+   * @throw IndexOutOfBoundsException if a locus of the AnalyzedLoci excedes the number of loci of the container.
+   */
+  static size_t scan(
+      const PolymorphismMultiGContainer& pmgc,
+      const AnalyzedLoci& loci,
+      const std::set<size_t>& groups,
+      size_t windowSize,
+      size_t step,
+      Sink& sink,
+      const ExecutionContext& context = ExecutionContext::sequential(),
+      size_t batchSize = 1024);
+
+  /**
+   * @brief Scan the loci and the individuals of a container kept by masks (see GenotypeQc).
+   *
+   * The loci hidden by the locus mask are not scanned, the genotypes of
+   * the individuals hidden by the individual mask are read as missing
+   * (see PolymorphismMultiGContainer::LocusView).
+   *
+   * @param pmgc The genotypes.
+   * @param loci The coordinates of the loci.
+   * @param groups The groups compared.
+   * @param locusMask For each locus, true if it is scanned. An empty mask keeps all the loci.
+   * @param individualMask For each individual, true if it is kept. An empty mask keeps all the individuals.
+   * @param windowSize The number of positions in a window.
+   * @param step The number of positions between the starts of two windows.
+   * @param sink The receiver of the rows.
+   * @param context The ExecutionContext used to compute a batch of loci.
+   * @param batchSize The number of loci computed together.
+   * @return The number of loci scanned.
+   * @throw BadIntegerException if windowSize, step or batchSize is 0.
+   * @throw DimensionException if a mask is not empty and does not have one element per locus or per individual.
+   * @throw IndexOutOfBoundsException if a locus of the AnalyzedLoci excedes the number of loci of the container.
+   */
+  static size_t scan(
+      const PolymorphismMultiGContainer& pmgc,
+      const AnalyzedLoci& loci,
+      const std::set<size_t>& groups,
+      const std::vector<bool>& locusMask,
+      const std::vector<bool>& individualMask,
+      size_t windowSize,
+      size_t step,
+      Sink& sink,
+      const ExecutionContext& context = ExecutionContext::sequential(),
+      size_t batchSize = 1024);
+
+  /**
+   * @brief Compute the variance components of a locus, summed over its alleles.
+   *
+   * See MultilocusGenotypeStatistics::getLocusVarianceComponents().
+   *
+   * @param pmgc The genotypes.
+   * @param locusPosition The locus.
+   * @param groups The groups compared.
+   * @param individualMask For each individual, true if it is kept. An empty mask keeps all the individuals.
+   * @throw IndexOutOfBoundsException if locusPosition excedes the number of loci.
+   * @throw DimensionException if the mask is not empty and does not have one element per individual.
+   */
+  static MultilocusGenotypeStatistics::VarComp getVarianceComponents(
+      const PolymorphismMultiGContainer& pmgc,
+      size_t locusPosition,
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
+};
+} // end of namespace bpp;
+
+#endif // _FSTSCAN_H_
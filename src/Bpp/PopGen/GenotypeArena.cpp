@@ -0,0 +1,348 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "GenotypeArena.h"
+
+// From the STL
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+thread_local GenotypeArena* currentArena = nullptr;
+
+const size_t ALIGNMENT = alignof(max_align_t);
+}
+
+const size_t GenotypeArena::DEFAULT_SLAB_SIZE = 64 * 1024;
+const size_t GenotypeArena::MAX_BLOCK_SIZE = 256;
+
+/******************************************************************************/
+
+/**
+ * @brief The slabs and free lists, shared by the arena and the blocks allocated from it.
+ *
+ * While the arena is active in a thread, that thread allocates and frees
+ * its blocks through a thread-local Cache, without locking: the mutex is
+ * only taken to get a new slab, to reuse the blocks freed elsewhere, and
+ * when the scope ends.
+ *
+ * The state is deleted when the arena, all its blocks and all the caches
+ * bound to it are gone.
+ */
+class GenotypeArena::State_
+{
+public:
+  /**
+   * @brief Stored in front of every block.
+   */
+  struct Header
+  {
+    State_* state;
+    size_t sizeClass;
+  };
+
+  static const size_t HEADER_SIZE = (sizeof(Header) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+private:
+  /**
+   * @brief Freed blocks are chained through their first bytes.
+   */
+  struct FreeBlock
+  {
+    FreeBlock* next;
+  };
+
+public:
+  /**
+   * @brief The part of a state used by a single thread, while the arena is active in it.
+   */
+  struct Cache
+  {
+    State_* state;
+    char* cursor;
+    size_t remaining;
+    std::vector<FreeBlock*> freeLists;
+    std::vector<FreeBlock*> freeTails;
+  };
+
+  static thread_local Cache cache;
+
+private:
+  mutex mutex_;
+  vector<unique_ptr<char[]>> slabs_;
+  vector<FreeBlock*> freeLists_;
+  char* cursor_;
+  size_t remaining_;
+  size_t slabSize_;
+  size_t reservedBytes_;
+  size_t nbCaches_;
+  atomic<size_t> references_;
+
+public:
+  State_(size_t slabSize) :
+    mutex_(),
+    slabs_(),
+    freeLists_(MAX_BLOCK_SIZE / ALIGNMENT + 1, nullptr),
+    cursor_(nullptr),
+    remaining_(0),
+    slabSize_(max(slabSize, HEADER_SIZE + MAX_BLOCK_SIZE)),
+    reservedBytes_(0),
+    nbCaches_(0),
+    references_(1)
+  {}
+
+  State_(const State_&) = delete;
+  State_& operator=(const State_&) = delete;
+
+  size_t getNumberOfLiveBlocks()
+  {
+    lock_guard<mutex> lock(mutex_);
+    return references_ - 1 - nbCaches_;
+  }
+
+  size_t getReservedBytes()
+  {
+    lock_guard<mutex> lock(mutex_);
+    return reservedBytes_;
+  }
+
+  /**
+   * @brief Make the cache of the current thread work for this state.
+   */
+  void bind()
+  {
+    if (cache.state)
+      cache.state->unbind();
+    cache.freeLists.assign(freeLists_.size(), nullptr);
+    cache.freeTails.assign(freeLists_.size(), nullptr);
+    lock_guard<mutex> lock(mutex_);
+    cache.state = this;
+    cache.cursor = cursor_;
+    cache.remaining = remaining_;
+    cursor_ = nullptr;
+    remaining_ = 0;
+    ++nbCaches_;
+    ++references_;
+  }
+
+  /**
+   * @brief Give back the blocks of the cache of the current thread.
+   */
+  void unbind() noexcept
+  {
+    {
+      lock_guard<mutex> lock(mutex_);
+      for (size_t sizeClass = 0; sizeClass < freeLists_.size(); ++sizeClass)
+      {
+        if (!cache.freeLists[sizeClass])
+          continue;
+        cache.freeTails[sizeClass]->next = freeLists_[sizeClass];
+        freeLists_[sizeClass] = cache.freeLists[sizeClass];
+      }
+      // Another thread may have taken a new slab in the meantime: keep the largest remainder.
+      if (cache.remaining > remaining_)
+      {
+        cursor_ = cache.cursor;
+        remaining_ = cache.remaining;
+      }
+      --nbCaches_;
+    }
+    cache.state = nullptr;
+    release();
+  }
+
+  /**
+   * @brief Allocate a block with the cache of the current thread, which must be bound to this state.
+   */
+  void* allocate(size_t size)
+  {
+    // Class 0 is never used, so that every block can hold a FreeBlock.
+    size_t sizeClass = max((size + ALIGNMENT - 1) / ALIGNMENT, static_cast<size_t>(1));
+    size_t blockSize = HEADER_SIZE + sizeClass * ALIGNMENT;
+    if (!cache.freeLists[sizeClass] && cache.remaining < blockSize)
+      refill_(sizeClass);
+    char* block;
+    FreeBlock*& freeBlock = cache.freeLists[sizeClass];
+    if (freeBlock)
+    {
+      block = reinterpret_cast<char*>(freeBlock) - HEADER_SIZE;
+      freeBlock = freeBlock->next;
+    }
+    else
+    {
+      block = cache.cursor;
+      cache.cursor += blockSize;
+      cache.remaining -= blockSize;
+    }
+    ++references_;
+    Header* header = reinterpret_cast<Header*>(block);
+    header->state = this;
+    header->sizeClass = sizeClass;
+    return block + HEADER_SIZE;
+  }
+
+  /**
+   * @brief Free a block, in the cache of the current thread if it is bound to this state.
+   */
+  void deallocate(Header* header) noexcept
+  {
+    FreeBlock* freeBlock = reinterpret_cast<FreeBlock*>(reinterpret_cast<char*>(header) + HEADER_SIZE);
+    if (cache.state == this)
+    {
+      freeBlock->next = cache.freeLists[header->sizeClass];
+      if (!freeBlock->next)
+        cache.freeTails[header->sizeClass] = freeBlock;
+      cache.freeLists[header->sizeClass] = freeBlock;
+    }
+    else
+    {
+      lock_guard<mutex> lock(mutex_);
+      freeBlock->next = freeLists_[header->sizeClass];
+      freeLists_[header->sizeClass] = freeBlock;
+    }
+    release();
+  }
+
+  /**
+   * @brief Drop one reference, and delete the state with the last one.
+   */
+  void release() noexcept
+  {
+    if (--references_ == 0)
+      delete this;
+  }
+
+private:
+  /**
+   * @brief Get the blocks freed outside of the cache, or else a new slab.
+   */
+  void refill_(size_t sizeClass)
+  {
+    lock_guard<mutex> lock(mutex_);
+    if (freeLists_[sizeClass])
+    {
+      FreeBlock* tail = freeLists_[sizeClass];
+      while (tail->next)
+      {
+        tail = tail->next;
+      }
+      cache.freeLists[sizeClass] = freeLists_[sizeClass];
+      cache.freeTails[sizeClass] = tail;
+      freeLists_[sizeClass] = nullptr;
+      return;
+    }
+    slabs_.emplace_back(new char[slabSize_]);
+    cache.cursor = slabs_.back().get();
+    cache.remaining = slabSize_;
+    reservedBytes_ += slabSize_;
+  }
+};
+
+thread_local GenotypeArena::State_::Cache GenotypeArena::State_::cache = {
+  nullptr, nullptr, 0, vector<GenotypeArena::State_::FreeBlock*>(), vector<GenotypeArena::State_::FreeBlock*>()
+};
+
+/******************************************************************************/
+
+GenotypeArena::Scope::Scope(GenotypeArena& arena) :
+  previous_(currentArena)
+{
+  if (State_::cache.state)
+    State_::cache.state->unbind();
+  currentArena = &arena;
+}
+
+GenotypeArena::Scope::~Scope()
+{
+  if (State_::cache.state)
+    State_::cache.state->unbind();
+  currentArena = previous_;
+}
+
+/******************************************************************************/
+
+GenotypeArena::GenotypeArena(size_t slabSize) :
+  state_(new State_(slabSize))
+{}
+
+/******************************************************************************/
+
+GenotypeArena::~GenotypeArena()
+{
+  state_->release();
+}
+
+/******************************************************************************/
+
+size_t GenotypeArena::getNumberOfLiveBlocks() const
+{
+  return state_->getNumberOfLiveBlocks();
+}
+
+size_t GenotypeArena::getReservedBytes() const
+{
+  return state_->getReservedBytes();
+}
+
+/******************************************************************************/
+
+GenotypeArena* GenotypeArena::getCurrent()
+{
+  return currentArena;
+}
+
+/******************************************************************************/
+
+void* GenotypeArena::allocate(size_t size)
+{
+  if (currentArena && size <= MAX_BLOCK_SIZE)
+  {
+    if (State_::cache.state != currentArena->state_)
+      currentArena->state_->bind();
+    return currentArena->state_->allocate(size);
+  }
+
+  char* block = static_cast<char*>(::operator new(State_::HEADER_SIZE + size));
+  State_::Header* header = reinterpret_cast<State_::Header*>(block);
+  header->state = nullptr;
+  header->sizeClass = 0;
+  return block + State_::HEADER_SIZE;
+}
+
+/******************************************************************************/
+
+void GenotypeArena::deallocate(void* ptr) noexcept
+{
+  if (!ptr)
+    return;
+  State_::Header* header = reinterpret_cast<State_::Header*>(static_cast<char*>(ptr) - State_::HEADER_SIZE);
+  if (header->state)
+  {
+    // Blocks freed while their arena is active go to the cache of the thread.
+    if (currentArena && currentArena->state_ == header->state && State_::cache.state != header->state)
+    {
+      try
+      {
+        header->state->bind();
+      }
+      catch (...)
+      {
+        // The block is then freed under the lock of the arena.
+      }
+    }
+    header->state->deallocate(header);
+  }
+  else
+    ::operator delete(header);
+}
+
+/******************************************************************************/
@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _GENOTYPEARENA_H_
+#define _GENOTYPEARENA_H_
+
+// From the STL
+#include <cstddef>
+
+namespace bpp
+{
+/**
+ * @brief Pool of memory for the small objects of the library.
+ *
+ * Genotypes, individuals and allele informations are numerous and small.
+ * When a GenotypeArena::Scope is active in the current thread, these
+ * objects are carved from large slabs of the arena instead of being
+ * allocated one by one on the heap. While the scope is active, the thread
+ * allocates and frees the blocks of the arena without locking it, the
+ * lock being only taken for a new slab and when the scope ends. Freed
+ * blocks are recycled by the arena.
+ *
+ * The objects are still destroyed one by one, as they own other buffers,
+ * but their memory is not returned to the heap: all the slabs are
+ * released at once when the arena and the last object allocated from it
+ * are destroyed.
+ *
+ * An object allocated from an arena may safely outlive its container
+ * (e.g. after PolymorphismMultiGContainer::removeMultilocusGenotype()):
+ * the slabs are kept until the object is deleted.
+ *
+ * Objects created outside of any scope, or larger than MAX_BLOCK_SIZE,
+ * are allocated on the heap as usual.
+ *
+ * DataSet and PolymorphismMultiGContainer own an arena and activate it
+ * when they create or destroy objects.
+ */
+class GenotypeArena
+{
+public:
+  static const size_t DEFAULT_SLAB_SIZE;
+  static const size_t MAX_BLOCK_SIZE;
+
+  /**
+   * @brief Make an arena the source of the allocations of the current thread.
+   *
+   * Scopes can be nested, the previous arena is restored when the scope ends.
+   */
+  class Scope
+  {
+  private:
+    GenotypeArena* previous_;
+
+  public:
+    Scope(GenotypeArena& arena);
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope();
+  };
+
+private:
+  class State_;
+
+  State_* state_;
+
+public:
+  /**
+   * @brief Build a new empty arena.
+   *
+   * @param slabSize The number of bytes reserved at once.
+   */
+  GenotypeArena(size_t slabSize = DEFAULT_SLAB_SIZE);
+
+  GenotypeArena(const GenotypeArena&) = delete;
+  GenotypeArena& operator=(const GenotypeArena&) = delete;
+
+  virtual ~GenotypeArena();
+
+public:
+  /**
+   * @brief Get the number of objects allocated from this arena and not yet deleted.
+   */
+  size_t getNumberOfLiveBlocks() const;
+
+  /**
+   * @brief Get the number of bytes reserved in slabs.
+   */
+  size_t getReservedBytes() const;
+
+  /**
+   * @brief Get the arena active in the current thread, or nullptr.
+   */
+  static GenotypeArena* getCurrent();
+
+  /**
+   * @brief Allocate from the current arena, or from the heap if there is none.
+   *
+   * @throw std::bad_alloc if memory is exhausted.
+   */
+  static void* allocate(size_t size);
+
+  /**
+   * @brief Free a block obtained from allocate().
+   */
+  static void deallocate(void* ptr) noexcept;
+};
+
+/**
+ * @brief Base class of the objects allocated from the current GenotypeArena.
+ */
+class ArenaAllocated
+{
+public:
+  static void* operator new(size_t size)
+  {
+    return GenotypeArena::allocate(size);
+  }
+
+  static void operator delete(void* ptr) noexcept
+  {
+    GenotypeArena::deallocate(ptr);
+  }
+
+protected:
+  ~ArenaAllocated() = default;
+};
+} // end of namespace bpp;
+
+#endif // _GENOTYPEARENA_H_
@@ -0,0 +1,254 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "GenotypeQc.h"
+
+// From the STL
+#include <algorithm>
+#include <cmath>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+GenotypeQc::GenotypeQc(
+    const PolymorphismMultiGContainer& pmgc,
+    const ExecutionContext& context) :
+  loci_(pmgc.size() > 0 ? pmgc.getNumberOfLoci() : 0),
+  individuals_(pmgc.size())
+{
+  size_t nbLoci = loci_.size();
+  size_t nbIndividuals = individuals_.size();
+  size_t nbRanges = min(nbLoci, max(static_cast<size_t>(1), context.getNumberOfThreads()));
+
+  // For each range of loci and each individual: genotyped, diploid and heterozygous loci.
+  vector< vector<size_t> > rangeCounts(nbRanges);
+  context.parallelFor(0, nbRanges, [&](size_t range) {
+        vector<size_t>& counts = rangeCounts[range];
+        counts.assign(3 * nbIndividuals, 0);
+        vector<size_t> alleles, alleleCounts, homozygous;
+        for (size_t locus = range * nbLoci / nbRanges; locus < (range + 1) * nbLoci / nbRanges; ++locus)
+        {
+          PolymorphismMultiGContainer::LocusView view = pmgc.locusView(locus);
+          size_t nbGenotyped = 0, nbDiploids = 0, nbHeterozygous = 0, nbGametes = 0;
+          alleles.clear();
+          alleleCounts.clear();
+          homozygous.clear();
+          for (size_t i = 0; i < nbIndividuals; ++i)
+          {
+            const MonolocusGenotypeInterface* genotype = view[i].genotype;
+            if (!genotype)
+              continue;
+            nbGenotyped++;
+            counts[3 * i]++;
+            vector<size_t> genotypeAlleles = genotype->getAlleleIndex();
+            vector<size_t> keys;
+            for (size_t allele : genotypeAlleles)
+            {
+              size_t key = static_cast<size_t>(find(alleles.begin(), alleles.end(), allele) - alleles.begin());
+              if (key == alleles.size())
+              {
+                alleles.push_back(allele);
+                alleleCounts.push_back(0);
+                homozygous.push_back(0);
+              }
+              alleleCounts[key]++;
+              nbGametes++;
+              keys.push_back(key);
+            }
+            if (keys.size() != 2)
+              continue;
+            nbDiploids++;
+            counts[3 * i + 1]++;
+            if (keys[0] != keys[1])
+            {
+              nbHeterozygous++;
+              counts[3 * i + 2]++;
+            }
+            else
+              homozygous[keys[0]]++;
+          }
+
+          LocusMetrics& metrics = loci_[locus];
+          metrics.nbGenotyped = nbGenotyped;
+          metrics.missingRate = nbIndividuals > 0 ? static_cast<double>(nbIndividuals - nbGenotyped) / static_cast<double>(nbIndividuals) : NAN;
+          metrics.nbAlleles = alleles.size();
+          metrics.maf = nbGametes > 0 ? 1. - static_cast<double>(*max_element(alleleCounts.begin(), alleleCounts.end())) / static_cast<double>(nbGametes) : NAN;
+          metrics.heterozygosity = nbDiploids > 0 ? static_cast<double>(nbHeterozygous) / static_cast<double>(nbDiploids) : NAN;
+          metrics.hweP = alleles.size() == 2 ? hweExactTest(nbHeterozygous, homozygous[0], homozygous[1]) : NAN;
+        }
+      });
+
+  for (size_t i = 0; i < nbIndividuals; ++i)
+  {
+    size_t nbGenotyped = 0, nbDiploids = 0, nbHeterozygous = 0;
+    for (const auto& counts : rangeCounts)
+    {
+      nbGenotyped += counts[3 * i];
+      nbDiploids += counts[3 * i + 1];
+      nbHeterozygous += counts[3 * i + 2];
+    }
+    IndividualMetrics& metrics = individuals_[i];
+    metrics.nbGenotyped = nbGenotyped;
+    metrics.missingRate = nbLoci > 0 ? static_cast<double>(nbLoci - nbGenotyped) / static_cast<double>(nbLoci) : NAN;
+    metrics.heterozygosity = nbDiploids > 0 ? static_cast<double>(nbHeterozygous) / static_cast<double>(nbDiploids) : NAN;
+  }
+}
+
+/******************************************************************************/
+
+const GenotypeQc::LocusMetrics& GenotypeQc::getLocusMetrics(size_t locusPosition) const
+{
+  if (locusPosition >= loci_.size())
+    throw IndexOutOfBoundsException("GenotypeQc::getLocusMetrics.", locusPosition, 0, loci_.size());
+  return loci_[locusPosition];
+}
+
+/******************************************************************************/
+
+const GenotypeQc::IndividualMetrics& GenotypeQc::getIndividualMetrics(size_t position) const
+{
+  if (position >= individuals_.size())
+    throw IndexOutOfBoundsException("GenotypeQc::getIndividualMetrics.", position, 0, individuals_.size());
+  return individuals_[position];
+}
+
+/******************************************************************************/
+
+vector<bool> GenotypeQc::getLocusMask(const LocusFilter& filter) const
+{
+  vector<bool> mask(loci_.size());
+  for (size_t i = 0; i < loci_.size(); ++i)
+  {
+    mask[i] = filter(loci_[i]);
+  }
+  return mask;
+}
+
+/******************************************************************************/
+
+vector<bool> GenotypeQc::getIndividualMask(const IndividualFilter& filter) const
+{
+  vector<bool> mask(individuals_.size());
+  for (size_t i = 0; i < individuals_.size(); ++i)
+  {
+    mask[i] = filter(individuals_[i]);
+  }
+  return mask;
+}
+
+/******************************************************************************/
+
+vector<size_t> GenotypeQc::getPositions(const vector<bool>& mask)
+{
+  vector<size_t> positions;
+  for (size_t i = 0; i < mask.size(); ++i)
+  {
+    if (mask[i])
+      positions.push_back(i);
+  }
+  return positions;
+}
+
+/******************************************************************************/
+
+GenotypeQc::LocusFilter GenotypeQc::minMaf(double minMaf)
+{
+  return LocusFilter([minMaf](const LocusMetrics& metrics) {
+          return !(metrics.maf < minMaf);
+        });
+}
+
+/******************************************************************************/
+
+GenotypeQc::LocusFilter GenotypeQc::maxLocusMissingRate(double maxMissingRate)
+{
+  return LocusFilter([maxMissingRate](const LocusMetrics& metrics) {
+          return !(metrics.missingRate > maxMissingRate);
+        });
+}
+
+/******************************************************************************/
+
+GenotypeQc::LocusFilter GenotypeQc::minHweP(double minP)
+{
+  return LocusFilter([minP](const LocusMetrics& metrics) {
+          return !(metrics.hweP < minP);
+        });
+}
+
+/******************************************************************************/
+
+GenotypeQc::LocusFilter GenotypeQc::numberOfAlleles(size_t minAlleles, size_t maxAlleles)
+{
+  return LocusFilter([minAlleles, maxAlleles](const LocusMetrics& metrics) {
+          return metrics.nbAlleles >= minAlleles && metrics.nbAlleles <= maxAlleles;
+        });
+}
+
+/******************************************************************************/
+
+GenotypeQc::IndividualFilter GenotypeQc::maxIndividualMissingRate(double maxMissingRate)
+{
+  return IndividualFilter([maxMissingRate](const IndividualMetrics& metrics) {
+          return !(metrics.missingRate > maxMissingRate);
+        });
+}
+
+/******************************************************************************/
+
+GenotypeQc::IndividualFilter GenotypeQc::heterozygosity(double minHeterozygosity, double maxHeterozygosity)
+{
+  return IndividualFilter([minHeterozygosity, maxHeterozygosity](const IndividualMetrics& metrics) {
+          return !(metrics.heterozygosity < minHeterozygosity || metrics.heterozygosity > maxHeterozygosity);
+        });
+}
+
+/******************************************************************************/
+
+double GenotypeQc::hweExactTest(size_t nbHeterozygous, size_t nbHomozygous1, size_t nbHomozygous2)
+{
+  size_t nbGenotypes = nbHeterozygous + nbHomozygous1 + nbHomozygous2;
+  if (nbGenotypes == 0)
+    return NAN;
+  size_t rare = 2 * min(nbHomozygous1, nbHomozygous2) + nbHeterozygous;
+
+  // Probabilities of the numbers of heterozygous genotypes, up to a constant, from the most likely one.
+  vector<double> probs(rare + 1, 0.);
+  size_t mid = rare * (2 * nbGenotypes - rare) / (2 * nbGenotypes);
+  if ((rare & 1) != (mid & 1))
+    mid++;
+  probs[mid] = 1.;
+  double sum = 1.;
+  size_t homR = (rare - mid) / 2, homC = nbGenotypes - mid - homR;
+  for (size_t het = mid; het > 1; het -= 2)
+  {
+    probs[het - 2] = probs[het] * static_cast<double>(het) * static_cast<double>(het - 1) / (4. * static_cast<double>(homR + 1) * static_cast<double>(homC + 1));
+    sum += probs[het - 2];
+    homR++;
+    homC++;
+  }
+  homR = (rare - mid) / 2;
+  homC = nbGenotypes - mid - homR;
+  for (size_t het = mid; het + 2 <= rare; het += 2)
+  {
+    probs[het + 2] = probs[het] * 4. * static_cast<double>(homR) * static_cast<double>(homC) / (static_cast<double>(het + 2) * static_cast<double>(het + 1));
+    sum += probs[het + 2];
+    homR--;
+    homC--;
+  }
+
+  // The tolerance keeps the configurations as likely as the observed one despite rounding.
+  double observed = probs[nbHeterozygous] * (1. + 1e-8);
+  double p = 0.;
+  for (double prob : probs)
+  {
+    if (prob <= observed)
+      p += prob;
+  }
+  return min(1., p / sum);
+}
+
+/******************************************************************************/
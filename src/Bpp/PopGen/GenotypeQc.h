@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _GENOTYPEQC_H_
+#define _GENOTYPEQC_H_
+
+#include <Bpp/Exceptions.h>
+
+// From local
+#include "ExecutionContext.h"
+#include "PolymorphismMultiGContainer.h"
+
+// From the STL
+#include <functional>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Quality control of the loci and of the individuals of a PolymorphismMultiGContainer.
+ *
+ * The metrics of all the loci and of all the individuals are computed in
+ * a single pass over the genotypes: the loci are split in one range per
+ * thread of an ExecutionContext, each range counting the genotypes of
+ * the individuals on its own, and the counts of the ranges are summed.
+ *
+ * Filters are predicates on the metrics, built with the static methods
+ * and combined with &, | and !. They are only evaluated when a mask is
+ * requested, with getLocusMask() or getIndividualMask(). The masks are
+ * given directly to the statistics, without copying the genotypes: the
+ * individual mask to MultilocusGenotypeStatistics, FstScan and
+ * PolymorphismMultiGContainer::locusView(), and the locus mask to FstScan
+ * or, through getPositions(), to the methods taking a set of locus
+ * positions.
+ *
+ * A metric that is not defined is NaN, and never removes a locus or an
+ * individual.
+ *
+ * Reference:
+ * - Wigginton, Cutler and Abecasis 2005, American Journal of Human Genetics 76:887-893.
+ */
+class GenotypeQc
+{
+public:
+  struct LocusMetrics
+  {
+    size_t nbGenotyped;
+    double missingRate;
+    size_t nbAlleles;
+    /**
+     * @brief The frequency of all the alleles but the most frequent one.
+     */
+    double maf;
+    /**
+     * @brief The proportion of heterozygous genotypes among the diploid ones.
+     */
+    double heterozygosity;
+    /**
+     * @brief The p-value of the exact test of Hardy-Weinberg equilibrium, for the diploid genotypes of a biallelic locus.
+     */
+    double hweP;
+  };
+
+  struct IndividualMetrics
+  {
+    size_t nbGenotyped;
+    double missingRate;
+    /**
+     * @brief The proportion of heterozygous genotypes among the diploid ones.
+     */
+    double heterozygosity;
+  };
+
+  /**
+   * @brief A predicate on the metrics of a locus or of an individual, true if it is kept.
+   */
+  template<class Metrics>
+  class Filter
+  {
+  private:
+    std::function<bool(const Metrics&)> predicate_;
+
+  public:
+    Filter(const std::function<bool(const Metrics&)>& predicate) :
+      predicate_(predicate)
+    {}
+
+  public:
+    bool operator()(const Metrics& metrics) const { return predicate_(metrics); }
+
+    Filter operator&(const Filter& filter) const
+    {
+      std::function<bool(const Metrics&)> first = predicate_, second = filter.predicate_;
+      return Filter([first, second](const Metrics& metrics) {
+            return first(metrics) && second(metrics);
+          });
+    }
+
+    Filter operator|(const Filter& filter) const
+    {
+      std::function<bool(const Metrics&)> first = predicate_, second = filter.predicate_;
+      return Filter([first, second](const Metrics& metrics) {
+            return first(metrics) || second(metrics);
+          });
+    }
+
+    Filter operator!() const
+    {
+      std::function<bool(const Metrics&)> predicate = predicate_;
+      return Filter([predicate](const Metrics& metrics) {
+            return !predicate(metrics);
+          });
+    }
+  };
+
+  typedef Filter<LocusMetrics> LocusFilter;
+  typedef Filter<IndividualMetrics> IndividualFilter;
+
+private:
+  std::vector<LocusMetrics> loci_;
+  std::vector<IndividualMetrics> individuals_;
+
+public:
+  /**
+   * @brief Compute the metrics of a container.
+   *
+   * @param pmgc The genotypes.
+   * @param context The ExecutionContext used to scan the loci.
+   * @throw Exception if the MultilocusGenotypes are not aligned.
+   */
+  GenotypeQc(
+      const PolymorphismMultiGContainer& pmgc,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  virtual ~GenotypeQc() {}
+
+public:
+  size_t getNumberOfLoci() const { return loci_.size(); }
+
+  size_t getNumberOfIndividuals() const { return individuals_.size(); }
+
+  /**
+   * @throw IndexOutOfBoundsException if locusPosition excedes the number of loci.
+   */
+  const LocusMetrics& getLocusMetrics(size_t locusPosition) const;
+
+  /**
+   * @throw IndexOutOfBoundsException if position excedes the number of individuals.
+   */
+  const IndividualMetrics& getIndividualMetrics(size_t position) const;
+
+  /**
+   * @brief Get the mask of the loci kept by a filter.
+   */
+  std::vector<bool> getLocusMask(const LocusFilter& filter) const;
+
+  /**
+   * @brief Get the mask of the individuals kept by a filter.
+   */
+  std::vector<bool> getIndividualMask(const IndividualFilter& filter) const;
+
+  /**
+   * @brief Get the positions of the elements of a mask which are true.
+   */
+  static std::vector<size_t> getPositions(const std::vector<bool>& mask);
+
+  /**
+   * @brief Keep the loci whose minor allele frequency is at least minMaf.
+   */
+  static LocusFilter minMaf(double minMaf);
+
+  /**
+   * @brief Keep the loci with a proportion of missing genotypes of at most maxMissingRate.
+   */
+  static LocusFilter maxLocusMissingRate(double maxMissingRate);
+
+  /**
+   * @brief Keep the loci with a Hardy-Weinberg p-value of at least minP.
+   */
+  static LocusFilter minHweP(double minP);
+
+  /**
+   * @brief Keep the loci with between minAlleles and maxAlleles alleles observed.
+   */
+  static LocusFilter numberOfAlleles(size_t minAlleles, size_t maxAlleles);
+
+  /**
+   * @brief Keep the individuals with a proportion of missing genotypes of at most maxMissingRate.
+   */
+  static IndividualFilter maxIndividualMissingRate(double maxMissingRate);
+
+  /**
+   * @brief Keep the individuals with a heterozygosity between minHeterozygosity and maxHeterozygosity.
+   */
+  static IndividualFilter heterozygosity(double minHeterozygosity, double maxHeterozygosity);
+
+  /**
+   * @brief Compute the p-value of the exact test of Hardy-Weinberg equilibrium of a biallelic locus.
+   *
+   * @param nbHeterozygous The number of heterozygous genotypes.
+   * @param nbHomozygous1 The number of homozygous genotypes for the first allele.
+   * @param nbHomozygous2 The number of homozygous genotypes for the second allele.
+   * @return The probability of the configurations no more likely than the one observed, NaN without genotype.
+   */
+  static double hweExactTest(size_t nbHeterozygous, size_t nbHomozygous1, size_t nbHomozygous2);
+};
+} // end of namespace bpp;
+
+#endif // _GENOTYPEQC_H_
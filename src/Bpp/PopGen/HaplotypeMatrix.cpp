@@ -0,0 +1,246 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "HaplotypeMatrix.h"
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+HaplotypeMatrix::HaplotypeMatrix(size_t nbHaplotypes) :
+  nbHaplotypes_(nbHaplotypes),
+  nbWords_((nbHaplotypes + 63) / 64),
+  bits_(),
+  sites_(),
+  positions_()
+{}
+
+HaplotypeMatrix::HaplotypeMatrix(const PolymorphismSequenceContainer& psc) :
+  nbHaplotypes_(psc.getNumberOfSequences()),
+  nbWords_((psc.getNumberOfSequences() + 63) / 64),
+  bits_(),
+  sites_(),
+  positions_()
+{
+  build_(psc, nullptr, false);
+}
+
+HaplotypeMatrix::HaplotypeMatrix(const PolymorphismSequenceContainer& psc, const Sequence& ancestralSites) :
+  nbHaplotypes_(psc.getNumberOfSequences()),
+  nbWords_((psc.getNumberOfSequences() + 63) / 64),
+  bits_(),
+  sites_(),
+  positions_()
+{
+  if (psc.getNumberOfSites() != ancestralSites.size())
+    throw DimensionException("HaplotypeMatrix::HaplotypeMatrix: ancestralSites and psc don't have the same size.", ancestralSites.size(), psc.getNumberOfSites());
+  AncestralStates ancestral(ancestralSites);
+  build_(psc, &ancestral, false);
+}
+
+HaplotypeMatrix::HaplotypeMatrix(const PolymorphismSequenceContainer& psc, const AncestralStates& ancestral) :
+  nbHaplotypes_(psc.getNumberOfSequences()),
+  nbWords_((psc.getNumberOfSequences() + 63) / 64),
+  bits_(),
+  sites_(),
+  positions_()
+{
+  if (psc.getNumberOfSites() != ancestral.getNumberOfSites())
+    throw DimensionException("HaplotypeMatrix::HaplotypeMatrix: ancestral and psc don't have the same size.", ancestral.getNumberOfSites(), psc.getNumberOfSites());
+  build_(psc, &ancestral, true);
+}
+
+/******************************************************************************/
+
+void HaplotypeMatrix::build_(const PolymorphismSequenceContainer& psc, const AncestralStates* ancestral, bool ingroupOnly)
+{
+  // The sequences kept as haplotypes
+  vector<size_t> haplotypes;
+  for (size_t j = 0; j < psc.getNumberOfSequences(); ++j)
+  {
+    if (!ingroupOnly || psc.isIngroupMember(j))
+      haplotypes.push_back(j);
+  }
+  nbHaplotypes_ = haplotypes.size();
+  nbWords_ = (nbHaplotypes_ + 63) / 64;
+  if (nbHaplotypes_ == 0)
+    return;
+
+  int alphabetSize = static_cast<int>(psc.getAlphabet()->getSize());
+  vector<uint64_t> col(nbWords_);
+  for (size_t i = 0; i < psc.getNumberOfSites(); ++i)
+  {
+    const Site& site = psc.site(i);
+
+    // The two states and their counts, over complete biallelic sites only
+    int first = site.getValue(haplotypes[0]);
+    int second = first;
+    size_t nbFirst = 0;
+    bool biallelic = true;
+    for (size_t j : haplotypes)
+    {
+      int state = site.getValue(j);
+      if (state < 0 || state >= alphabetSize)
+        biallelic = false;
+      else if (state == first)
+        nbFirst++;
+      else if (second == first || state == second)
+        second = state;
+      else
+        biallelic = false;
+      if (!biallelic)
+        break;
+    }
+    if (!biallelic || second == first)
+      continue;
+
+    int derived;
+    if (ancestral)
+    {
+      int ancestralState = ancestral->getState(i);
+      if (ancestralState == first)
+        derived = second;
+      else if (ancestralState == second)
+        derived = first;
+      else
+        continue;
+    }
+    else
+    {
+      // Minor allele, or the highest state when both are equally frequent
+      size_t nbSecond = nbHaplotypes_ - nbFirst;
+      if (nbFirst < nbSecond)
+        derived = first;
+      else if (nbSecond < nbFirst)
+        derived = second;
+      else
+        derived = max(first, second);
+    }
+
+    fill(col.begin(), col.end(), 0);
+    for (size_t k = 0; k < nbHaplotypes_; ++k)
+    {
+      if (site.getValue(haplotypes[k]) == derived)
+        col[k / 64] |= static_cast<uint64_t>(1) << (k % 64);
+    }
+    bits_.insert(bits_.end(), col.begin(), col.end());
+    sites_.push_back(i);
+    positions_.push_back(static_cast<double>(i));
+  }
+}
+
+/******************************************************************************/
+
+void HaplotypeMatrix::reset(size_t nbHaplotypes)
+{
+  nbHaplotypes_ = nbHaplotypes;
+  nbWords_ = (nbHaplotypes + 63) / 64;
+  bits_.clear();
+  sites_.clear();
+  positions_.clear();
+}
+
+uint64_t* HaplotypeMatrix::addSnp(double position)
+{
+  if (!positions_.empty() && position < positions_.back())
+    throw Exception("HaplotypeMatrix::addSnp: positions must be sorted.");
+  sites_.push_back(sites_.size());
+  positions_.push_back(position);
+  bits_.resize(bits_.size() + nbWords_, 0);
+  return bits_.data() + bits_.size() - nbWords_;
+}
+
+/******************************************************************************/
+
+size_t HaplotypeMatrix::getSiteIndex(size_t snp) const
+{
+  if (snp >= getNumberOfSnps())
+    throw IndexOutOfBoundsException("HaplotypeMatrix::getSiteIndex.", snp, 0, getNumberOfSnps());
+  return sites_[snp];
+}
+
+double HaplotypeMatrix::getPosition(size_t snp) const
+{
+  if (snp >= getNumberOfSnps())
+    throw IndexOutOfBoundsException("HaplotypeMatrix::getPosition.", snp, 0, getNumberOfSnps());
+  return positions_[snp];
+}
+
+/******************************************************************************/
+
+void HaplotypeMatrix::setPositions(const vector<double>& positions)
+{
+  if (positions.size() != getNumberOfSnps())
+    throw DimensionException("HaplotypeMatrix::setPositions: one position is needed per SNP.", positions.size(), getNumberOfSnps());
+  for (size_t i = 1; i < positions.size(); ++i)
+  {
+    if (positions[i] < positions[i - 1])
+      throw Exception("HaplotypeMatrix::setPositions: positions must be sorted.");
+  }
+  positions_ = positions;
+}
+
+/******************************************************************************/
+
+bool HaplotypeMatrix::isDerived(size_t haplotype, size_t snp) const
+{
+  if (haplotype >= nbHaplotypes_)
+    throw IndexOutOfBoundsException("HaplotypeMatrix::isDerived: haplotype out of bounds.", haplotype, 0, nbHaplotypes_);
+  if (snp >= getNumberOfSnps())
+    throw IndexOutOfBoundsException("HaplotypeMatrix::isDerived: snp out of bounds.", snp, 0, getNumberOfSnps());
+  return (column(snp)[haplotype / 64] >> (haplotype % 64)) & 1;
+}
+
+/******************************************************************************/
+
+size_t HaplotypeMatrix::getDerivedCount(size_t snp) const
+{
+  if (snp >= getNumberOfSnps())
+    throw IndexOutOfBoundsException("HaplotypeMatrix::getDerivedCount.", snp, 0, getNumberOfSnps());
+  return popCount(column(snp), nbWords_);
+}
+
+double HaplotypeMatrix::getDerivedFrequency(size_t snp) const
+{
+  if (nbHaplotypes_ == 0)
+    throw ZeroDivisionException("HaplotypeMatrix::getDerivedFrequency.");
+  return static_cast<double>(getDerivedCount(snp)) / static_cast<double>(nbHaplotypes_);
+}
+
+/******************************************************************************/
+
+vector<uint64_t> HaplotypeMatrix::getMask(const vector<size_t>& haplotypes) const
+{
+  vector<uint64_t> mask;
+  getMask(haplotypes, mask);
+  return mask;
+}
+
+void HaplotypeMatrix::getMask(const vector<size_t>& haplotypes, vector<uint64_t>& mask) const
+{
+  mask.assign(nbWords_, 0);
+  for (size_t haplotype : haplotypes)
+  {
+    if (haplotype >= nbHaplotypes_)
+      throw IndexOutOfBoundsException("HaplotypeMatrix::getMask.", haplotype, 0, nbHaplotypes_);
+    mask[haplotype / 64] |= static_cast<uint64_t>(1) << (haplotype % 64);
+  }
+}
+
+vector<uint64_t> HaplotypeMatrix::getFullMask() const
+{
+  vector<uint64_t> mask;
+  getFullMask(mask);
+  return mask;
+}
+
+void HaplotypeMatrix::getFullMask(vector<uint64_t>& mask) const
+{
+  mask.assign(nbWords_, ~static_cast<uint64_t>(0));
+  if (nbHaplotypes_ % 64)
+    mask.back() = (static_cast<uint64_t>(1) << (nbHaplotypes_ % 64)) - 1;
+}
+
+/******************************************************************************/
@@ -0,0 +1,253 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _HAPLOTYPEMATRIX_H_
+#define _HAPLOTYPEMATRIX_H_
+
+#include <Bpp/Exceptions.h>
+
+// From the bpp-seq library
+#include <Bpp/Seq/Sequence.h>
+
+// From local
+#include "AncestralStates.h"
+#include "PolymorphismSequenceContainer.h"
+
+// From the STL
+#include <cstdint>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Bit-packed matrix of biallelic haplotypes.
+ *
+ * Only the complete sites with exactly two states of a
+ * PolymorphismSequenceContainer are kept (the SNPs). Each SNP is stored
+ * as a column of bits, one per haplotype, packed in 64 bits words, so that
+ * haplotypes can be compared or counted a word at a time.
+ *
+ * A bit is set when the haplotype carries the derived allele. Without an
+ * ancestral sequence, the minor allele is taken as the derived one.
+ *
+ * The position of a SNP is its index in the source alignment, unless
+ * other positions (e.g. from a genetic map) are given with setPositions().
+ *
+ * A matrix can also be filled SNP by SNP with addSnp(), e.g. from the
+ * output of a simulator. reset() empties it but keeps its memory, so that
+ * the same matrix can be reused for many replicates.
+ */
+class HaplotypeMatrix
+{
+private:
+  size_t nbHaplotypes_;
+  size_t nbWords_;
+  std::vector<uint64_t> bits_;
+  std::vector<size_t> sites_;
+  std::vector<double> positions_;
+
+public:
+  /**
+   * @brief Build an empty matrix.
+   *
+   * @param nbHaplotypes The number of haplotypes.
+   */
+  HaplotypeMatrix(size_t nbHaplotypes = 0);
+
+  /**
+   * @brief Build the matrix of a container, polarized by the minor allele.
+   *
+   * @param psc The haplotypes.
+   */
+  HaplotypeMatrix(const PolymorphismSequenceContainer& psc);
+
+  /**
+   * @brief Build the matrix of a container, polarized by an ancestral sequence.
+   *
+   * The SNPs where the ancestral state is unknown or is not one of the two
+   * states are dropped.
+   *
+   * @param psc The haplotypes.
+   * @param ancestralSites The ancestral state of each site.
+   * @throw DimensionException if ancestralSites and psc don't have the same number of sites.
+   */
+  HaplotypeMatrix(const PolymorphismSequenceContainer& psc, const Sequence& ancestralSites);
+
+  /**
+   * @brief Build the matrix of a container, polarized by ancestral states.
+   *
+   * Only the ingroup sequences (see
+   * PolymorphismSequenceContainer::isIngroupMember()) are haplotypes, so
+   * that the outgroups the states are inferred from are not sampled. The
+   * SNPs where the ancestral state is unknown or is not one of the two
+   * states are dropped.
+   *
+   * @param psc The haplotypes.
+   * @param ancestral The ancestral state of each site.
+   * @throw DimensionException if ancestral and psc don't have the same number of sites.
+   */
+  HaplotypeMatrix(const PolymorphismSequenceContainer& psc, const AncestralStates& ancestral);
+
+  virtual ~HaplotypeMatrix() {}
+
+public:
+  /**
+   * @brief Remove all the SNPs and set the number of haplotypes.
+   *
+   * The memory already allocated is kept.
+   */
+  void reset(size_t nbHaplotypes);
+
+  /**
+   * @brief Add a SNP at the end of the matrix.
+   *
+   * The site index of the SNP is its index in the matrix.
+   *
+   * @param position The position of the SNP.
+   * @return The bits of the new SNP, all 0, to be set by the caller.
+   * The pointer is invalidated by the next call to addSnp().
+   * @throw Exception if position is lower than the position of the last SNP.
+   */
+  uint64_t* addSnp(double position);
+
+  size_t getNumberOfHaplotypes() const { return nbHaplotypes_; }
+
+  size_t getNumberOfSnps() const { return sites_.size(); }
+
+  /**
+   * @brief Get the number of 64 bits words of a column.
+   */
+  size_t getNumberOfWords() const { return nbWords_; }
+
+  /**
+   * @brief Get the index of a SNP in the source alignment.
+   *
+   * @throw IndexOutOfBoundsException if snp excedes the number of SNPs.
+   */
+  size_t getSiteIndex(size_t snp) const;
+
+  /**
+   * @brief Get the position of a SNP.
+   *
+   * @throw IndexOutOfBoundsException if snp excedes the number of SNPs.
+   */
+  double getPosition(size_t snp) const;
+
+  const std::vector<double>& getPositions() const { return positions_; }
+
+  /**
+   * @brief Set the positions of the SNPs.
+   *
+   * @throw DimensionException if the number of positions is not the number of SNPs.
+   * @throw Exception if the positions are decreasing.
+   */
+  void setPositions(const std::vector<double>& positions);
+
+  /**
+   * @brief Tell if a haplotype carries the derived allele of a SNP.
+   *
+   * @throw IndexOutOfBoundsException if haplotype or snp are out of bounds.
+   */
+  bool isDerived(size_t haplotype, size_t snp) const;
+
+  /**
+   * @brief Get the bits of a SNP, without bounds checking.
+   *
+   * The unused bits of the last word are 0, and must be kept so when the bits are modified.
+   */
+  const uint64_t* column(size_t snp) const
+  {
+    return &bits_[snp * nbWords_];
+  }
+
+  uint64_t* column(size_t snp)
+  {
+    return &bits_[snp * nbWords_];
+  }
+
+  /**
+   * @brief Get the number of haplotypes carrying the derived allele of a SNP.
+   *
+   * @throw IndexOutOfBoundsException if snp excedes the number of SNPs.
+   */
+  size_t getDerivedCount(size_t snp) const;
+
+  /**
+   * @brief Get the frequency of the derived allele of a SNP.
+   *
+   * @throw IndexOutOfBoundsException if snp excedes the number of SNPs.
+   */
+  double getDerivedFrequency(size_t snp) const;
+
+  /**
+   * @brief Build a mask with the bits of a set of haplotypes.
+   *
+   * @throw IndexOutOfBoundsException if a haplotype is out of bounds.
+   */
+  std::vector<uint64_t> getMask(const std::vector<size_t>& haplotypes) const;
+
+  /**
+   * @brief Build a mask with the bits of a set of haplotypes, in an existing vector.
+   *
+   * @param haplotypes The haplotypes.
+   * @param mask The vector receiving the mask, whose storage is reused.
+   * @throw IndexOutOfBoundsException if a haplotype is out of bounds.
+   */
+  void getMask(const std::vector<size_t>& haplotypes, std::vector<uint64_t>& mask) const;
+
+  /**
+   * @brief Build a mask with the bits of all the haplotypes.
+   */
+  std::vector<uint64_t> getFullMask() const;
+
+  /**
+   * @brief Build a mask with the bits of all the haplotypes, in an existing vector.
+   *
+   * @param mask The vector receiving the mask, whose storage is reused.
+   */
+  void getFullMask(std::vector<uint64_t>& mask) const;
+
+  /**
+   * @brief Count the bits set in a word.
+   */
+  static unsigned int popCount(uint64_t word)
+  {
+#if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_popcountll(word));
+#else
+    unsigned int count = 0;
+    for ( ; word; ++count)
+    {
+      word &= word - 1;
+    }
+    return count;
+#endif
+  }
+
+  /**
+   * @brief Count the bits set in a bit vector.
+   */
+  static size_t popCount(const uint64_t* words, size_t nbWords)
+  {
+    size_t count = 0;
+    for (size_t w = 0; w < nbWords; ++w)
+    {
+      count += popCount(words[w]);
+    }
+    return count;
+  }
+
+private:
+  /**
+   * @brief Keep the SNPs of a container.
+   *
+   * @param psc The haplotypes.
+   * @param ancestral The ancestral states, or nullptr to polarize by the minor allele.
+   * @param ingroupOnly Skip the outgroup sequences.
+   */
+  void build_(const PolymorphismSequenceContainer& psc, const AncestralStates* ancestral, bool ingroupOnly);
+};
+} // end of namespace bpp;
+
+#endif // _HAPLOTYPEMATRIX_H_
@@ -0,0 +1,414 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "HaplotypeNetwork.h"
+#include "SequenceStatistics.h"
+
+// From the STL
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <map>
+#include <set>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+HaplotypeNetwork::HaplotypeNetwork(
+    const PolymorphismSequenceContainer& psc,
+    Method method,
+    unsigned int epsilon,
+    const ExecutionContext& context) :
+  alphabetSize_(static_cast<int>(psc.getAlphabet()->getSize())),
+  sites_(),
+  states_(),
+  nbHaplotypes_(0),
+  weights_(),
+  sequences_(),
+  haplotypeOfSequence_(),
+  distances_(),
+  edges_()
+{
+  size_t nbSequences = psc.getNumberOfSequences();
+  for (size_t k = 0; k < psc.getNumberOfSites(); ++k)
+  {
+    const Site& site = psc.site(k);
+    for (size_t i = 1; i < nbSequences; ++i)
+    {
+      if (site.getValue(i) != site.getValue(0))
+      {
+        sites_.push_back(k);
+        break;
+      }
+    }
+  }
+
+  // Unique haplotypes, in order of first occurrence
+  vector< vector<int> > states(nbSequences, vector<int>(sites_.size()));
+  for (size_t k = 0; k < sites_.size(); ++k)
+  {
+    const Site& site = psc.site(sites_[k]);
+    for (size_t i = 0; i < nbSequences; ++i)
+    {
+      states[i][k] = site.getValue(i);
+    }
+  }
+  map<vector<int>, size_t> haplotypes;
+  vector<size_t> representatives;
+  haplotypeOfSequence_.resize(nbSequences);
+  for (size_t i = 0; i < nbSequences; ++i)
+  {
+    auto it = haplotypes.insert(make_pair(states[i], states_.size()));
+    if (it.second)
+    {
+      states_.push_back(states[i]);
+      weights_.push_back(0.);
+      sequences_.push_back(vector<size_t>());
+      representatives.push_back(i);
+    }
+    size_t h = it.first->second;
+    haplotypeOfSequence_[i] = h;
+    weights_[h] += static_cast<double>(psc.getSequenceCount(i));
+    sequences_[h].push_back(i);
+  }
+  nbHaplotypes_ = states_.size();
+
+  auto matrix = SequenceStatistics::pairwiseDifferences(psc, representatives, false, context);
+  distances_.resize(nbHaplotypes_);
+  for (size_t i = 0; i < nbHaplotypes_; ++i)
+  {
+    distances_[i].resize(i);
+    for (size_t j = 0; j < i; ++j)
+    {
+      distances_[i][j] = static_cast<unsigned int>((*matrix)(i, j));
+    }
+  }
+  matrix.reset();
+
+  if (method == MEDIAN_JOINING)
+    medianJoining_(epsilon);
+  else
+    edges_ = feasibleLinks_(epsilon);
+}
+
+/******************************************************************************/
+
+const vector<int>& HaplotypeNetwork::getStates(size_t vertex) const
+{
+  if (vertex >= getNumberOfVertices())
+    throw IndexOutOfBoundsException("HaplotypeNetwork::getStates.", vertex, 0, getNumberOfVertices());
+  return states_[vertex];
+}
+
+/******************************************************************************/
+
+double HaplotypeNetwork::getWeight(size_t vertex) const
+{
+  if (vertex >= getNumberOfVertices())
+    throw IndexOutOfBoundsException("HaplotypeNetwork::getWeight.", vertex, 0, getNumberOfVertices());
+  return weights_[vertex];
+}
+
+/******************************************************************************/
+
+const vector<size_t>& HaplotypeNetwork::getSequences(size_t vertex) const
+{
+  if (vertex >= getNumberOfVertices())
+    throw IndexOutOfBoundsException("HaplotypeNetwork::getSequences.", vertex, 0, getNumberOfVertices());
+  return sequences_[vertex];
+}
+
+/******************************************************************************/
+
+size_t HaplotypeNetwork::getHaplotype(size_t sequence) const
+{
+  if (sequence >= haplotypeOfSequence_.size())
+    throw IndexOutOfBoundsException("HaplotypeNetwork::getHaplotype.", sequence, 0, haplotypeOfSequence_.size());
+  return haplotypeOfSequence_[sequence];
+}
+
+/******************************************************************************/
+
+unsigned int HaplotypeNetwork::getDistance(size_t vertex1, size_t vertex2) const
+{
+  if (vertex1 >= getNumberOfVertices())
+    throw IndexOutOfBoundsException("HaplotypeNetwork::getDistance.", vertex1, 0, getNumberOfVertices());
+  if (vertex2 >= getNumberOfVertices())
+    throw IndexOutOfBoundsException("HaplotypeNetwork::getDistance.", vertex2, 0, getNumberOfVertices());
+  return distance_(vertex1, vertex2);
+}
+
+/******************************************************************************/
+
+unsigned int HaplotypeNetwork::compare_(const vector<int>& a, const vector<int>& b) const
+{
+  unsigned int differences = 0;
+  for (size_t k = 0; k < a.size(); ++k)
+  {
+    if (a[k] != b[k] && a[k] >= 0 && a[k] < alphabetSize_ && b[k] >= 0 && b[k] < alphabetSize_)
+      differences++;
+  }
+  return differences;
+}
+
+/******************************************************************************/
+
+int HaplotypeNetwork::median_(int x, int y, int z) const
+{
+  bool xResolved = (x >= 0 && x < alphabetSize_);
+  bool yResolved = (y >= 0 && y < alphabetSize_);
+  if (xResolved && (x == y || x == z))
+    return x;
+  if (yResolved && y == z)
+    return y;
+  if (xResolved)
+    return x;
+  if (yResolved)
+    return y;
+  return z;
+}
+
+/******************************************************************************/
+
+void HaplotypeNetwork::addMedian_(const vector<int>& states)
+{
+  vector<unsigned int> row(states_.size());
+  for (size_t j = 0; j < states_.size(); ++j)
+  {
+    row[j] = compare_(states, states_[j]);
+  }
+  states_.push_back(states);
+  weights_.push_back(0.);
+  sequences_.push_back(vector<size_t>());
+  distances_.push_back(row);
+}
+
+/******************************************************************************/
+
+void HaplotypeNetwork::keepVertices_(const vector<bool>& keep)
+{
+  vector<size_t> kept;
+  for (size_t i = 0; i < keep.size(); ++i)
+  {
+    if (keep[i])
+      kept.push_back(i);
+  }
+  vector< vector<unsigned int> > distances(kept.size());
+  for (size_t i = 0; i < kept.size(); ++i)
+  {
+    distances[i].resize(i);
+    for (size_t j = 0; j < i; ++j)
+    {
+      distances[i][j] = distance_(kept[i], kept[j]);
+    }
+  }
+  distances_.swap(distances);
+  for (size_t i = 0; i < kept.size(); ++i)
+  {
+    states_[i].swap(states_[kept[i]]);
+    weights_[i] = weights_[kept[i]];
+    sequences_[i].swap(sequences_[kept[i]]);
+  }
+  states_.resize(kept.size());
+  weights_.resize(kept.size());
+  sequences_.resize(kept.size());
+}
+
+/******************************************************************************/
+
+vector<HaplotypeNetwork::Edge> HaplotypeNetwork::feasibleLinks_(unsigned int epsilon) const
+{
+  size_t n = getNumberOfVertices();
+  vector<Edge> links;
+  if (n < 2)
+    return links;
+
+  // Bottleneck of the minimum spanning tree (Prim)
+  vector<unsigned int> best(n, numeric_limits<unsigned int>::max());
+  vector<bool> inTree(n, false);
+  unsigned int bottleneck = 0;
+  best[0] = 0;
+  for (size_t k = 0; k < n; ++k)
+  {
+    size_t u = n;
+    for (size_t v = 0; v < n; ++v)
+    {
+      if (!inTree[v] && (u == n || best[v] < best[u]))
+        u = v;
+    }
+    inTree[u] = true;
+    bottleneck = max(bottleneck, best[u]);
+    for (size_t v = 0; v < n; ++v)
+    {
+      if (!inTree[v])
+        best[v] = min(best[v], distance_(u, v));
+    }
+  }
+
+  // Buckets of the pairs at distance <= bottleneck + epsilon
+  size_t limit = static_cast<size_t>(bottleneck) + epsilon;
+  vector<size_t> offsets(limit + 2, 0);
+  for (size_t i = 1; i < n; ++i)
+  {
+    for (size_t j = 0; j < i; ++j)
+    {
+      if (distances_[i][j] <= limit)
+        offsets[distances_[i][j] + 1]++;
+    }
+  }
+  for (size_t d = 1; d < offsets.size(); ++d)
+  {
+    offsets[d] += offsets[d - 1];
+  }
+  vector<Edge> buckets(offsets.back());
+  vector<size_t> next(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 1; i < n; ++i)
+  {
+    for (size_t j = 0; j < i; ++j)
+    {
+      unsigned int d = distances_[i][j];
+      if (d <= limit)
+      {
+        Edge& edge = buckets[next[d]++];
+        edge.first = j;
+        edge.second = i;
+        edge.length = d;
+      }
+    }
+  }
+
+  // A link of length d is feasible if its ends are not connected by the
+  // feasible links shorter than d - epsilon.
+  vector<size_t> parent(n);
+  for (size_t v = 0; v < n; ++v)
+  {
+    parent[v] = v;
+  }
+  auto find = [&](size_t v) {
+        while (parent[v] != v)
+        {
+          parent[v] = parent[parent[v]];
+          v = parent[v];
+        }
+        return v;
+      };
+  size_t merged = 0;
+  for (size_t d = 0; d <= limit; ++d)
+  {
+    for ( ; merged < links.size() && links[merged].length + epsilon < d; ++merged)
+    {
+      parent[find(links[merged].first)] = find(links[merged].second);
+    }
+    for (size_t e = offsets[d]; e < offsets[d + 1]; ++e)
+    {
+      if (find(buckets[e].first) != find(buckets[e].second))
+        links.push_back(buckets[e]);
+    }
+  }
+  return links;
+}
+
+/******************************************************************************/
+
+void HaplotypeNetwork::medianJoining_(unsigned int epsilon)
+{
+  set< vector<int> > known(states_.begin(), states_.end());
+  bool added = true;
+  while (added)
+  {
+    edges_ = feasibleLinks_(epsilon);
+    size_t n = getNumberOfVertices();
+    vector< vector<size_t> > neighbours(n);
+    for (const Edge& edge : edges_)
+    {
+      neighbours[edge.first].push_back(edge.second);
+      neighbours[edge.second].push_back(edge.first);
+    }
+
+    // Triplets with at least two links
+    set< array<size_t, 3> > triplets;
+    for (size_t u = 0; u < n; ++u)
+    {
+      for (size_t a = 0; a < neighbours[u].size(); ++a)
+      {
+        for (size_t b = a + 1; b < neighbours[u].size(); ++b)
+        {
+          array<size_t, 3> triplet = {{ u, neighbours[u][a], neighbours[u][b] }};
+          sort(triplet.begin(), triplet.end());
+          triplets.insert(triplet);
+        }
+      }
+    }
+
+    // Median vectors and their connection costs
+    vector< pair<unsigned int, vector<int> > > candidates;
+    unsigned int minCost = numeric_limits<unsigned int>::max();
+    for (const auto& triplet : triplets)
+    {
+      const vector<int>& x = states_[triplet[0]];
+      const vector<int>& y = states_[triplet[1]];
+      const vector<int>& z = states_[triplet[2]];
+      vector<int> median(x.size());
+      for (size_t k = 0; k < x.size(); ++k)
+      {
+        median[k] = median_(x[k], y[k], z[k]);
+      }
+      if (known.count(median))
+        continue;
+      unsigned int cost = compare_(median, x) + compare_(median, y) + compare_(median, z);
+      minCost = min(minCost, cost);
+      candidates.push_back(make_pair(cost, median));
+    }
+
+    added = false;
+    for (const auto& candidate : candidates)
+    {
+      if (candidate.first > minCost + epsilon || !known.insert(candidate.second).second)
+        continue;
+      // With missing data, a median may only differ from a vertex by unresolved sites.
+      bool redundant = false;
+      for (size_t v = 0; v < getNumberOfVertices() && !redundant; ++v)
+      {
+        redundant = (compare_(candidate.second, states_[v]) == 0);
+      }
+      if (!redundant)
+      {
+        addMedian_(candidate.second);
+        added = true;
+      }
+    }
+  }
+
+  // Obsolete medians
+  bool removed = true;
+  while (removed)
+  {
+    size_t n = getNumberOfVertices();
+    vector<size_t> degrees(n, 0);
+    for (const Edge& edge : edges_)
+    {
+      degrees[edge.first]++;
+      degrees[edge.second]++;
+    }
+    vector<bool> keep(n, true);
+    removed = false;
+    for (size_t v = nbHaplotypes_; v < n; ++v)
+    {
+      if (degrees[v] < 3)
+      {
+        keep[v] = false;
+        removed = true;
+      }
+    }
+    if (removed)
+    {
+      keepVertices_(keep);
+      edges_ = feasibleLinks_(epsilon);
+    }
+  }
+}
+
+/******************************************************************************/
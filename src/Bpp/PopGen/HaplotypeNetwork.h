@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _HAPLOTYPENETWORK_H_
+#define _HAPLOTYPENETWORK_H_
+
+#include <Bpp/Exceptions.h>
+
+// From local
+#include "ExecutionContext.h"
+#include "PolymorphismSequenceContainer.h"
+
+// From the STL
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Haplotype network of the sequences of a container.
+ *
+ * The sequences are first collapsed into unique haplotypes: two sequences
+ * belong to the same haplotype when they have the same character, gaps and
+ * unresolved characters included, at every site. Each haplotype is weighted
+ * by the sum of the counts of its sequences (see
+ * PolymorphismSequenceContainer::getSequenceCount()). Only the variable
+ * sites are kept, and the distance between two vertices is their number of
+ * differences on the sites where both are resolved. The distances between
+ * haplotypes are computed with SequenceStatistics::pairwiseDifferences().
+ *
+ * The minimum spanning network (Bandelt et al. 1999) is the union of all
+ * the minimum spanning trees: the links are processed by increasing length,
+ * and a link of length d is kept if its ends are not connected by the links
+ * shorter than d. With a relaxation parameter epsilon > 0, the ends must not
+ * be connected by the links shorter than d - epsilon. The links are not
+ * sorted: the bottleneck of the minimum spanning tree B is first computed
+ * with Prim's algorithm, then only the pairs at distance <= B + epsilon are
+ * put in buckets indexed by their length.
+ *
+ * The median-joining network (Bandelt et al. 1999) adds median vectors to
+ * the haplotypes. For every triplet of vertices with two links in the
+ * relaxed minimum spanning network, the median vector (majority resolved
+ * state at each site, or the first resolved state when they all differ) is
+ * computed. The new medians whose connection cost is within epsilon of the
+ * smallest one, and which are not at distance 0 of a vertex, are added,
+ * and the process is repeated until no median is added. The medians linked
+ * to less than three vertices are then removed, until none remains. The
+ * vertices of the medians follow those of the haplotypes, and carry no
+ * sequence. The number of medians can grow quickly with epsilon.
+ *
+ * References:
+ * - Bandelt, Forster and Röhl 1999, Molecular Biology and Evolution 16:37-48.
+ */
+class HaplotypeNetwork
+{
+public:
+  enum Method
+  {
+    MINIMUM_SPANNING,
+    MEDIAN_JOINING
+  };
+
+  /**
+   * @brief A link between two vertices, first < second.
+   */
+  struct Edge
+  {
+    size_t first;
+    size_t second;
+    unsigned int length;
+  };
+
+private:
+  int alphabetSize_;
+  std::vector<size_t> sites_;
+  std::vector< std::vector<int> > states_;
+  size_t nbHaplotypes_;
+  std::vector<double> weights_;
+  std::vector< std::vector<size_t> > sequences_;
+  std::vector<size_t> haplotypeOfSequence_;
+  std::vector< std::vector<unsigned int> > distances_;
+  std::vector<Edge> edges_;
+
+public:
+  /**
+   * @brief Build the network.
+   *
+   * @param psc The sequences.
+   * @param method The kind of network to build.
+   * @param epsilon The relaxation parameter.
+   * @param context The ExecutionContext used to compute the distances between haplotypes.
+   */
+  HaplotypeNetwork(
+      const PolymorphismSequenceContainer& psc,
+      Method method = MINIMUM_SPANNING,
+      unsigned int epsilon = 0,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  virtual ~HaplotypeNetwork() {}
+
+public:
+  size_t getNumberOfHaplotypes() const { return nbHaplotypes_; }
+
+  /**
+   * @brief Get the number of vertices, haplotypes and medians.
+   */
+  size_t getNumberOfVertices() const { return states_.size(); }
+
+  bool isMedian(size_t vertex) const { return vertex >= nbHaplotypes_; }
+
+  /**
+   * @brief Get the indices of the variable sites in the container.
+   */
+  const std::vector<size_t>& getSites() const { return sites_; }
+
+  /**
+   * @brief Get the states of a vertex at the variable sites.
+   *
+   * @throw IndexOutOfBoundsException if the vertex is out of bounds.
+   */
+  const std::vector<int>& getStates(size_t vertex) const;
+
+  /**
+   * @brief Get the weight of a vertex, 0 for a median.
+   *
+   * @throw IndexOutOfBoundsException if the vertex is out of bounds.
+   */
+  double getWeight(size_t vertex) const;
+
+  /**
+   * @brief Get the indices of the sequences of a vertex, none for a median.
+   *
+   * @throw IndexOutOfBoundsException if the vertex is out of bounds.
+   */
+  const std::vector<size_t>& getSequences(size_t vertex) const;
+
+  /**
+   * @brief Get the haplotype of a sequence.
+   *
+   * @throw IndexOutOfBoundsException if the sequence is out of bounds.
+   */
+  size_t getHaplotype(size_t sequence) const;
+
+  /**
+   * @throw IndexOutOfBoundsException if a vertex is out of bounds.
+   */
+  unsigned int getDistance(size_t vertex1, size_t vertex2) const;
+
+  /**
+   * @brief Get the links of the network, sorted by length.
+   */
+  const std::vector<Edge>& getEdges() const { return edges_; }
+
+private:
+  unsigned int distance_(size_t i, size_t j) const
+  {
+    if (i == j)
+      return 0;
+    return i > j ? distances_[i][j] : distances_[j][i];
+  }
+
+  /**
+   * @brief Count the differences between two state vectors, on the sites where both are resolved.
+   */
+  unsigned int compare_(const std::vector<int>& a, const std::vector<int>& b) const;
+
+  /**
+   * @brief Get the median of three states, unresolved states being ignored.
+   */
+  int median_(int x, int y, int z) const;
+
+  /**
+   * @brief Add a median vertex.
+   */
+  void addMedian_(const std::vector<int>& states);
+
+  /**
+   * @brief Keep only some vertices.
+   *
+   * @param keep Whether each vertex is kept.
+   */
+  void keepVertices_(const std::vector<bool>& keep);
+
+  /**
+   * @brief Compute the links of the relaxed minimum spanning network of the current vertices.
+   */
+  std::vector<Edge> feasibleLinks_(unsigned int epsilon) const;
+
+  /**
+   * @brief Add the median vectors, then remove the obsolete ones.
+   */
+  void medianJoining_(unsigned int epsilon);
+};
+} // end of namespace bpp;
+
+#endif // _HAPLOTYPENETWORK_H_
@@ -0,0 +1,235 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "HaplotypeStatistics.h"
+
+// From the STL
+#include <cmath>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+Vdouble HaplotypeStatistics::ehh(const HaplotypeMatrix& hm, size_t core, bool derived)
+{
+  if (core >= hm.getNumberOfSnps())
+    throw IndexOutOfBoundsException("HaplotypeStatistics::ehh: core out of bounds.", core, 0, hm.getNumberOfSnps());
+  vector<uint64_t> haplotypes = hm.getFullMask();
+  const uint64_t* col = hm.column(core);
+  for (size_t w = 0; w < haplotypes.size(); ++w)
+  {
+    haplotypes[w] &= derived ? col[w] : ~col[w];
+  }
+  size_t n = HaplotypeMatrix::popCount(haplotypes.data(), haplotypes.size());
+  if (n < 2)
+    throw BadSizeException("HaplotypeStatistics::ehh: less than two haplotypes carry the allele.", n, 2);
+
+  Vdouble curve(hm.getNumberOfSnps(), 0.);
+  curve[core] = 1.;
+  integrateEhh_(hm, core, false, haplotypes, 0., false, false, &curve);
+  integrateEhh_(hm, core, true, haplotypes, 0., false, false, &curve);
+  return curve;
+}
+
+/******************************************************************************/
+
+Vdouble HaplotypeStatistics::iHS(
+    const HaplotypeMatrix& hm,
+    double cutoff,
+    double minMaf,
+    bool discardAtBorder,
+    const ExecutionContext& context)
+{
+  Vdouble values(hm.getNumberOfSnps());
+  context.parallelFor(0, hm.getNumberOfSnps(), [&](size_t core) {
+        values[core] = allelicIhhRatio_(hm, core, cutoff, minMaf, false, discardAtBorder);
+      });
+  return values;
+}
+
+/******************************************************************************/
+
+Vdouble HaplotypeStatistics::nSL(
+    const HaplotypeMatrix& hm,
+    double minMaf,
+    const ExecutionContext& context)
+{
+  Vdouble values(hm.getNumberOfSnps());
+  context.parallelFor(0, hm.getNumberOfSnps(), [&](size_t core) {
+        values[core] = allelicIhhRatio_(hm, core, 0., minMaf, true, false);
+      });
+  return values;
+}
+
+/******************************************************************************/
+
+Vdouble HaplotypeStatistics::xpEHH(
+    const HaplotypeMatrix& hm,
+    const vector<size_t>& population1,
+    const vector<size_t>& population2,
+    double cutoff,
+    bool discardAtBorder,
+    const ExecutionContext& context)
+{
+  vector<uint64_t> mask1 = hm.getMask(population1);
+  vector<uint64_t> mask2 = hm.getMask(population2);
+  Vdouble values(hm.getNumberOfSnps());
+  context.parallelFor(0, hm.getNumberOfSnps(), [&](size_t core) {
+        double ihh1 = integrateEhh_(hm, core, false, mask1, cutoff, false, discardAtBorder)
+                      + integrateEhh_(hm, core, true, mask1, cutoff, false, discardAtBorder);
+        double ihh2 = integrateEhh_(hm, core, false, mask2, cutoff, false, discardAtBorder)
+                      + integrateEhh_(hm, core, true, mask2, cutoff, false, discardAtBorder);
+        values[core] = (ihh1 > 0. && ihh2 > 0.) ? log(ihh1 / ihh2) : NAN;
+      });
+  return values;
+}
+
+/******************************************************************************/
+
+Vdouble HaplotypeStatistics::standardize(
+    const Vdouble& scores,
+    const HaplotypeMatrix& hm,
+    unsigned int nbBins)
+{
+  if (scores.size() != hm.getNumberOfSnps())
+    throw DimensionException("HaplotypeStatistics::standardize: one score per SNP is needed.", scores.size(), hm.getNumberOfSnps());
+  if (nbBins == 0)
+    throw BadIntegerException("HaplotypeStatistics::standardize: nbBins must be > 0.", 0);
+
+  vector<size_t> bins(scores.size());
+  vector<double> sums(nbBins, 0.), squares(nbBins, 0.);
+  vector<size_t> counts(nbBins, 0);
+  for (size_t i = 0; i < scores.size(); ++i)
+  {
+    bins[i] = min(static_cast<size_t>(hm.getDerivedFrequency(i) * nbBins), static_cast<size_t>(nbBins - 1));
+    if (std::isnan(scores[i]))
+      continue;
+    sums[bins[i]] += scores[i];
+    squares[bins[i]] += scores[i] * scores[i];
+    counts[bins[i]]++;
+  }
+
+  Vdouble standardized(scores.size(), NAN);
+  for (size_t i = 0; i < scores.size(); ++i)
+  {
+    size_t b = bins[i];
+    if (std::isnan(scores[i]) || counts[b] < 2)
+      continue;
+    double n = static_cast<double>(counts[b]);
+    double mean = sums[b] / n;
+    double var = (squares[b] - n * mean * mean) / (n - 1.);
+    if (var > 0.)
+      standardized[i] = (scores[i] - mean) / sqrt(var);
+  }
+  return standardized;
+}
+
+/******************************************************************************/
+
+double HaplotypeStatistics::integrateEhh_(
+    const HaplotypeMatrix& hm,
+    size_t core,
+    bool forward,
+    const vector<uint64_t>& haplotypes,
+    double cutoff,
+    bool unitDistance,
+    bool discardAtBorder,
+    Vdouble* curve)
+{
+  size_t nbWords = hm.getNumberOfWords();
+  size_t nbSnps = hm.getNumberOfSnps();
+  double n = static_cast<double>(HaplotypeMatrix::popCount(haplotypes.data(), nbWords));
+  if (n < 2.)
+    return NAN;
+  double pairs = n * (n - 1.);
+
+  // Classes of identical haplotypes, stored one after the other.
+  // Classes of less than two haplotypes are dropped.
+  vector<uint64_t> classes, refined;
+  vector<uint64_t> in(nbWords), out(nbWords);
+  double homozygosity = 0.;
+  auto split = [&](const uint64_t* cls, const uint64_t* col) {
+        size_t nIn = 0, nOut = 0;
+        for (size_t w = 0; w < nbWords; ++w)
+        {
+          in[w] = cls[w] & col[w];
+          out[w] = cls[w] & ~col[w];
+          nIn += HaplotypeMatrix::popCount(in[w]);
+          nOut += HaplotypeMatrix::popCount(out[w]);
+        }
+        if (nIn >= 2)
+        {
+          refined.insert(refined.end(), in.begin(), in.end());
+          homozygosity += static_cast<double>(nIn) * static_cast<double>(nIn - 1);
+        }
+        if (nOut >= 2)
+        {
+          refined.insert(refined.end(), out.begin(), out.end());
+          homozygosity += static_cast<double>(nOut) * static_cast<double>(nOut - 1);
+        }
+      };
+
+  split(haplotypes.data(), hm.column(core));
+  classes.swap(refined);
+  double previous = homozygosity / pairs;
+  double area = 0.;
+  size_t snp = core;
+  while (!classes.empty())
+  {
+    if (forward ? snp + 1 >= nbSnps : snp == 0)
+      return discardAtBorder ? NAN : area;
+    size_t next = forward ? snp + 1 : snp - 1;
+    const uint64_t* col = hm.column(next);
+    refined.clear();
+    homozygosity = 0.;
+    for (size_t k = 0; k < classes.size(); k += nbWords)
+    {
+      split(&classes[k], col);
+    }
+    classes.swap(refined);
+
+    double current = homozygosity / pairs;
+    double distance = unitDistance ? 1. : fabs(hm.getPositions()[next] - hm.getPositions()[snp]);
+    area += (previous + current) / 2. * distance;
+    if (curve)
+      (*curve)[next] = current;
+    if (current < cutoff)
+      break;
+    previous = current;
+    snp = next;
+  }
+  return area;
+}
+
+/******************************************************************************/
+
+double HaplotypeStatistics::allelicIhhRatio_(
+    const HaplotypeMatrix& hm,
+    size_t core,
+    double cutoff,
+    double minMaf,
+    bool unitDistance,
+    bool discardAtBorder)
+{
+  double freq = hm.getDerivedFrequency(core);
+  if (min(freq, 1. - freq) < minMaf)
+    return NAN;
+
+  vector<uint64_t> ancestral = hm.getFullMask();
+  vector<uint64_t> derived(hm.column(core), hm.column(core) + hm.getNumberOfWords());
+  for (size_t w = 0; w < ancestral.size(); ++w)
+  {
+    ancestral[w] &= ~derived[w];
+  }
+  double ihhA = integrateEhh_(hm, core, false, ancestral, cutoff, unitDistance, discardAtBorder)
+                + integrateEhh_(hm, core, true, ancestral, cutoff, unitDistance, discardAtBorder);
+  double ihhD = integrateEhh_(hm, core, false, derived, cutoff, unitDistance, discardAtBorder)
+                + integrateEhh_(hm, core, true, derived, cutoff, unitDistance, discardAtBorder);
+  if (!(ihhA > 0.) || !(ihhD > 0.))
+    return NAN;
+  return log(ihhA / ihhD);
+}
+
+/******************************************************************************/
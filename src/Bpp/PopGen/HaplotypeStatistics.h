@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _HAPLOTYPESTATISTICS_H_
+#define _HAPLOTYPESTATISTICS_H_
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/VectorTools.h>
+
+// From local
+#include "HaplotypeMatrix.h"
+#include "ExecutionContext.h"
+
+// From the STL
+#include <cstdint>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Extended haplotype homozygosity (EHH) based statistics.
+ *
+ * The statistics are computed on a HaplotypeMatrix. For each core SNP,
+ * the haplotypes are split in classes of identical haplotypes, refined
+ * one SNP at a time while walking away from the core on each side. The
+ * EHH at a SNP is the probability that two haplotypes drawn without
+ * replacement are identical from the core to this SNP. Classes of a single
+ * haplotype are dropped as soon as they appear, since they no longer
+ * contribute to the EHH.
+ *
+ * The integrated EHH (iHH) is the area under the EHH curve, computed with
+ * the trapezoidal rule. The walk on one side stops at the first SNP where
+ * the EHH falls below a cutoff. When the end of the data is reached first,
+ * the core SNP is discarded (NaN) if discardAtBorder is set, otherwise the
+ * area computed so far is used.
+ *
+ * The scans run in parallel over core SNPs according to the given
+ * ExecutionContext. The values are not standardized, see standardize().
+ *
+ * References:
+ * - Sabeti et al. 2002, Nature 419:832-837 (EHH).
+ * - Voight et al. 2006, PLoS Biology 4:e72 (iHS).
+ * - Sabeti et al. 2007, Nature 449:913-918 (XP-EHH).
+ * - Ferrer-Admetlla et al. 2014, Molecular Biology and Evolution 31:1275-1291 (nSL).
+ */
+class HaplotypeStatistics
+{
+public:
+  // Class destructor
+  virtual ~HaplotypeStatistics() {}
+
+  /**
+   * @brief Compute the EHH decay around a core SNP.
+   *
+   * @param hm The haplotypes.
+   * @param core The core SNP.
+   * @param derived Use the haplotypes carrying the derived (true) or the ancestral (false) allele of the core.
+   * @return The EHH at each SNP of the matrix (1 at the core).
+   * @throw IndexOutOfBoundsException if core excedes the number of SNPs.
+   * @throw BadSizeException if less than two haplotypes carry the allele.
+   */
+  static Vdouble ehh(
+      const HaplotypeMatrix& hm,
+      size_t core,
+      bool derived);
+
+  /**
+   * @brief Compute the unstandardized iHS of every SNP.
+   *
+   * iHS = ln(iHH_ancestral / iHH_derived).
+   *
+   * @param hm The haplotypes.
+   * @param cutoff The EHH value stopping the integration.
+   * @param minMaf The SNPs with a lower minor allele frequency are skipped (NaN).
+   * @param discardAtBorder Tell if a SNP is discarded when the integration reaches the end of the data.
+   * @param context The ExecutionContext used to scan the core SNPs.
+   * @return One value per SNP, NaN where the statistic is not defined.
+   */
+  static Vdouble iHS(
+      const HaplotypeMatrix& hm,
+      double cutoff = 0.05,
+      double minMaf = 0.05,
+      bool discardAtBorder = true,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Compute the unstandardized nSL of every SNP.
+   *
+   * nSL is computed as iHS with the distance between consecutive SNPs set
+   * to 1, without cutoff: the integrated EHH is then the mean length, in
+   * number of SNPs, of the segments shared by two haplotypes.
+   *
+   * @param hm The haplotypes.
+   * @param minMaf The SNPs with a lower minor allele frequency are skipped (NaN).
+   * @param context The ExecutionContext used to scan the core SNPs.
+   * @return One value per SNP, NaN where the statistic is not defined.
+   */
+  static Vdouble nSL(
+      const HaplotypeMatrix& hm,
+      double minMaf = 0.05,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Compute the unstandardized XP-EHH of every SNP between two populations.
+   *
+   * XP-EHH = ln(iHH_1 / iHH_2), where iHH_i is integrated from the EHH of
+   * all the haplotypes of population i. Each population stops its walk
+   * at its own cutoff.
+   *
+   * @param hm The haplotypes of both populations.
+   * @param population1 The indices of the haplotypes of the first population.
+   * @param population2 The indices of the haplotypes of the second population.
+   * @param cutoff The EHH value stopping the integration.
+   * @param discardAtBorder Tell if a SNP is discarded when the integration reaches the end of the data.
+   * @param context The ExecutionContext used to scan the core SNPs.
+   * @return One value per SNP, NaN where the statistic is not defined.
+   * @throw IndexOutOfBoundsException if a haplotype index is out of bounds.
+   */
+  static Vdouble xpEHH(
+      const HaplotypeMatrix& hm,
+      const std::vector<size_t>& population1,
+      const std::vector<size_t>& population2,
+      double cutoff = 0.05,
+      bool discardAtBorder = true,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Standardize scores within bins of derived allele frequency.
+   *
+   * Each value is centered and reduced with the mean and standard deviation
+   * of the values of its bin. NaN values are ignored and kept.
+   * Use one bin for a genome-wide standardization (e.g. XP-EHH).
+   *
+   * @param scores One value per SNP of hm.
+   * @param hm The haplotypes the scores were computed on.
+   * @param nbBins The number of frequency bins.
+   * @throw DimensionException if scores does not have one value per SNP.
+   * @throw BadIntegerException if nbBins is 0.
+   */
+  static Vdouble standardize(
+      const Vdouble& scores,
+      const HaplotypeMatrix& hm,
+      unsigned int nbBins = 20);
+
+private:
+  /**
+   * @brief Integrate the EHH of a set of haplotypes on one side of a core SNP.
+   *
+   * @param hm The haplotypes.
+   * @param core The core SNP.
+   * @param forward Walk towards the higher (true) or lower (false) SNPs.
+   * @param haplotypes The mask of the haplotypes used.
+   * @param cutoff The EHH value stopping the integration.
+   * @param unitDistance Use a distance of 1 between consecutive SNPs.
+   * @param discardAtBorder Return NaN if the end of the data is reached before the cutoff.
+   * @param curve If not nullptr, receives the EHH at each SNP visited.
+   * @return The area under the EHH curve, or NaN.
+   */
+  static double integrateEhh_(
+      const HaplotypeMatrix& hm,
+      size_t core,
+      bool forward,
+      const std::vector<uint64_t>& haplotypes,
+      double cutoff,
+      bool unitDistance,
+      bool discardAtBorder,
+      Vdouble* curve = nullptr);
+
+  /**
+   * @brief Compute ln(iHH_ancestral / iHH_derived) at a core SNP.
+   */
+  static double allelicIhhRatio_(
+      const HaplotypeMatrix& hm,
+      size_t core,
+      double cutoff,
+      double minMaf,
+      bool unitDistance,
+      bool discardAtBorder);
+};
+} // end of namespace bpp;
+
+#endif // _HAPLOTYPESTATISTICS_H_
@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "HaplotypeWindowStatistics.h"
+
+// From the STL
+#include <algorithm>
+#include <utility>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+/**
+ * @brief Odd multiplier of the polynomial hash, computed modulo 2^64.
+ */
+const uint64_t HASH_BASE = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * @brief Get the bit of a haplotype at a SNP.
+ */
+uint64_t haplotypeBit(const HaplotypeMatrix& hm, size_t snp, size_t h)
+{
+  return (hm.column(snp)[h / 64] >> (h % 64)) & 1;
+}
+}
+
+/******************************************************************************/
+
+vector<HaplotypeWindowStatistics::Window> HaplotypeWindowStatistics::scan(
+    const PolymorphismSequenceContainer& psc,
+    size_t windowSize,
+    size_t step)
+{
+  HaplotypeMatrix hm(psc);
+  vector<size_t> weights(psc.getNumberOfSequences());
+  for (size_t i = 0; i < weights.size(); ++i)
+  {
+    weights[i] = psc.getSequenceCount(i);
+  }
+  return scan(hm, weights, windowSize, step);
+}
+
+/******************************************************************************/
+
+vector<HaplotypeWindowStatistics::Window> HaplotypeWindowStatistics::scan(
+    const HaplotypeMatrix& hm,
+    const vector<size_t>& weights,
+    size_t windowSize,
+    size_t step)
+{
+  if (windowSize == 0)
+    throw BadIntegerException("HaplotypeWindowStatistics::scan: windowSize must be > 0.", 0);
+  if (step == 0)
+    throw BadIntegerException("HaplotypeWindowStatistics::scan: step must be > 0.", 0);
+  size_t nbHaplotypes = hm.getNumberOfHaplotypes();
+  if (weights.size() != nbHaplotypes)
+    throw DimensionException("HaplotypeWindowStatistics::scan: one weight per haplotype is needed.", weights.size(), nbHaplotypes);
+
+  vector<Window> windows;
+  size_t nbSnps = hm.getNumberOfSnps();
+  if (nbSnps < windowSize)
+    return windows;
+
+  // The hash of a haplotype over SNPs [first, last] is
+  // sum of bit(s) * HASH_BASE^(last - s), modulo 2^64.
+  uint64_t leadingPower = 1;
+  for (size_t i = 1; i < windowSize; ++i)
+  {
+    leadingPower *= HASH_BASE;
+  }
+  Workspace workspace;
+  vector<uint64_t>& hashes = workspace.hashes;
+  hashes.assign(nbHaplotypes, 0);
+  auto push = [&](size_t snp) {
+        for (size_t h = 0; h < nbHaplotypes; ++h)
+        {
+          hashes[h] = hashes[h] * HASH_BASE + haplotypeBit(hm, snp, h);
+        }
+      };
+  auto pop = [&](size_t snp) {
+        for (size_t h = 0; h < nbHaplotypes; ++h)
+        {
+          hashes[h] -= haplotypeBit(hm, snp, h) * leadingPower;
+        }
+      };
+
+  for (size_t first = 0; first + windowSize <= nbSnps; first += step)
+  {
+    size_t last = first + windowSize - 1;
+    if (first == 0 || step >= windowSize)
+    {
+      fill(hashes.begin(), hashes.end(), 0);
+      for (size_t snp = first; snp <= last; ++snp)
+      {
+        push(snp);
+      }
+    }
+    else
+    {
+      for (size_t snp = last - step + 1; snp <= last; ++snp)
+      {
+        pop(snp - windowSize);
+        push(snp);
+      }
+    }
+
+    Window window;
+    window.firstSnp = first;
+    window.lastSnp = last;
+    window.start = hm.getPositions()[first];
+    window.end = hm.getPositions()[last];
+    countHaplotypes_(hm, first, last, weights, workspace);
+    window.stats = SequenceStatistics::haplotypeFrequencyStatistics(workspace.counts, workspace.frequencies);
+    windows.push_back(window);
+  }
+  return windows;
+}
+
+/******************************************************************************/
+
+SequenceStatistics::HaplotypeFrequencyStats HaplotypeWindowStatistics::windowStatistics(
+    const HaplotypeMatrix& hm,
+    const vector<size_t>& weights,
+    size_t firstSnp,
+    size_t lastSnp,
+    Workspace& workspace)
+{
+  if (lastSnp >= hm.getNumberOfSnps())
+    throw IndexOutOfBoundsException("HaplotypeWindowStatistics::windowStatistics: lastSnp out of bounds.", lastSnp, 0, hm.getNumberOfSnps());
+  if (firstSnp > lastSnp)
+    throw BadIntegerException("HaplotypeWindowStatistics::windowStatistics: firstSnp must be <= lastSnp.", static_cast<int>(firstSnp));
+  size_t nbHaplotypes = hm.getNumberOfHaplotypes();
+  if (!weights.empty() && weights.size() != nbHaplotypes)
+    throw DimensionException("HaplotypeWindowStatistics::windowStatistics: one weight per haplotype is needed.", weights.size(), nbHaplotypes);
+
+  vector<uint64_t>& hashes = workspace.hashes;
+  hashes.assign(nbHaplotypes, 0);
+  for (size_t snp = firstSnp; snp <= lastSnp; ++snp)
+  {
+    for (size_t h = 0; h < nbHaplotypes; ++h)
+    {
+      hashes[h] = hashes[h] * HASH_BASE + haplotypeBit(hm, snp, h);
+    }
+  }
+  countHaplotypes_(hm, firstSnp, lastSnp, weights, workspace);
+  return SequenceStatistics::haplotypeFrequencyStatistics(workspace.counts, workspace.frequencies);
+}
+
+/******************************************************************************/
+
+void HaplotypeWindowStatistics::countHaplotypes_(
+    const HaplotypeMatrix& hm,
+    size_t first,
+    size_t last,
+    const vector<size_t>& weights,
+    Workspace& workspace)
+{
+  const vector<uint64_t>& hashes = workspace.hashes;
+  vector<size_t>& order = workspace.order;
+  order.resize(hashes.size());
+  for (size_t h = 0; h < order.size(); ++h)
+  {
+    order[h] = h;
+  }
+  sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return hashes[a] < hashes[b];
+      });
+  auto sameHaplotype = [&](size_t a, size_t b) {
+        for (size_t snp = first; snp <= last; ++snp)
+        {
+          if (haplotypeBit(hm, snp, a) != haplotypeBit(hm, snp, b))
+            return false;
+        }
+        return true;
+      };
+  vector<size_t>& counts = workspace.counts;
+  counts.clear();
+  // The distinct haplotypes with the current hash, and the index of their count.
+  // There is more than one only in the case of a hash collision.
+  vector< pair<size_t, size_t> >& distinct = workspace.distinct;
+  for (size_t k = 0; k < order.size(); ++k)
+  {
+    size_t h = order[k];
+    if (k == 0 || hashes[h] != hashes[order[k - 1]])
+      distinct.clear();
+    auto it = find_if(distinct.begin(), distinct.end(), [&](const pair<size_t, size_t>& d) {
+          return sameHaplotype(d.first, h);
+        });
+    if (it == distinct.end())
+    {
+      distinct.push_back(make_pair(h, counts.size()));
+      counts.push_back(0);
+      it = distinct.end() - 1;
+    }
+    counts[it->second] += weights.empty() ? 1 : weights[h];
+  }
+}
+
+/******************************************************************************/
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _HAPLOTYPEWINDOWSTATISTICS_H_
+#define _HAPLOTYPEWINDOWSTATISTICS_H_
+
+#include <Bpp/Exceptions.h>
+
+// From local
+#include "HaplotypeMatrix.h"
+#include "PolymorphismSequenceContainer.h"
+#include "SequenceStatistics.h"
+
+// From the STL
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Haplotype frequency statistics in sliding windows of SNPs.
+ *
+ * Windows are made of windowSize consecutive SNPs of a HaplotypeMatrix,
+ * and start every step SNPs. Only full windows are reported.
+ *
+ * In each window, the haplotypes are identified by a polynomial hash of
+ * their bits, updated when the window slides by removing the leaving SNPs
+ * and adding the entering ones, so that the cost of a move does not depend
+ * on the window size. Hashes are 64 bits wide, and the haplotypes sharing
+ * a hash are compared bit by bit, so that a collision does not merge two
+ * distinct haplotypes.
+ *
+ * The statistics of each window (number of haplotypes, haplotype diversity,
+ * H1, H12 and H2/H1) are computed from the haplotype counts as in
+ * SequenceStatistics::haplotypeFrequencyStatistics().
+ */
+class HaplotypeWindowStatistics
+{
+public:
+  /**
+   * @brief The statistics of a window.
+   */
+  struct Window
+  {
+    size_t firstSnp;
+    size_t lastSnp;
+    double start;
+    double end;
+    SequenceStatistics::HaplotypeFrequencyStats stats;
+  };
+
+  /**
+   * @brief The buffers of a scan, reused from one call to the next.
+   */
+  struct Workspace
+  {
+    std::vector<uint64_t> hashes;
+    std::vector<size_t> order;
+    std::vector<size_t> counts;
+    // The distinct haplotypes sharing a hash, and the index of their count.
+    std::vector< std::pair<size_t, size_t> > distinct;
+    std::vector<double> frequencies;
+
+    Workspace() : hashes(), order(), counts(), distinct(), frequencies() {}
+  };
+
+public:
+  // Class destructor
+  virtual ~HaplotypeWindowStatistics() {}
+
+  /**
+   * @brief Scan the SNPs of an alignment.
+   *
+   * The SNPs are the complete biallelic sites, each sequence is weighted by its count.
+   *
+   * @param psc a PolymorphismSequenceContainer
+   * @param windowSize the number of SNPs in a window
+   * @param step the number of SNPs between the starts of two windows
+   * @throw BadIntegerException if windowSize or step is 0.
+   */
+  static std::vector<Window> scan(
+      const PolymorphismSequenceContainer& psc,
+      size_t windowSize,
+      size_t step);
+
+  /**
+   * @brief Scan the SNPs of a HaplotypeMatrix.
+   *
+   * @param hm the haplotypes
+   * @param weights the number of copies of each haplotype
+   * @param windowSize the number of SNPs in a window
+   * @param step the number of SNPs between the starts of two windows
+   * @throw BadIntegerException if windowSize or step is 0.
+   * @throw DimensionException if there is not one weight per haplotype.
+   */
+  static std::vector<Window> scan(
+      const HaplotypeMatrix& hm,
+      const std::vector<size_t>& weights,
+      size_t windowSize,
+      size_t step);
+
+  /**
+   * @brief Compute the statistics of a single window of a HaplotypeMatrix, with given buffers.
+   *
+   * @param hm the haplotypes
+   * @param weights the number of copies of each haplotype, or an empty vector for one copy each
+   * @param firstSnp the first SNP of the window
+   * @param lastSnp the last SNP of the window (included)
+   * @param workspace the buffers, which can be reused for another window or matrix
+   * @throw IndexOutOfBoundsException if lastSnp excedes the number of SNPs.
+   * @throw BadIntegerException if firstSnp > lastSnp.
+   * @throw DimensionException if weights is neither empty nor has one weight per haplotype.
+   */
+  static SequenceStatistics::HaplotypeFrequencyStats windowStatistics(
+      const HaplotypeMatrix& hm,
+      const std::vector<size_t>& weights,
+      size_t firstSnp,
+      size_t lastSnp,
+      Workspace& workspace);
+
+private:
+  /**
+   * @brief Count the copies of each distinct haplotype over SNPs [first, last].
+   *
+   * The haplotypes are grouped by the hashes of the workspace, then compared
+   * bit by bit within each group. The counts are stored in the workspace.
+   * An empty weights vector gives one copy to each haplotype.
+   */
+  static void countHaplotypes_(
+      const HaplotypeMatrix& hm,
+      size_t first,
+      size_t last,
+      const std::vector<size_t>& weights,
+      Workspace& workspace);
+};
+} // end of namespace bpp;
+
+#endif // _HAPLOTYPEWINDOWSTATISTICS_H_
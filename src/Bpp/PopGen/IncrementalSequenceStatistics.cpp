@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "IncrementalSequenceStatistics.h"
+
+// From the STL
+#include <algorithm>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+IncrementalSequenceStatistics::IncrementalSequenceStatistics(shared_ptr<const Alphabet> alphabet, size_t nbSites) :
+  alphabetSize_(alphabet->getSize()),
+  nbSequences_(0),
+  counts_(nbSites * alphabet->getSize(), 0),
+  sampleSizes_(nbSites, 0),
+  nbStates_(nbSites, 0),
+  identicalPairs_(nbSites, 0),
+  sampleSizeHistogram_(1, static_cast<unsigned int>(nbSites)),
+  polymorphicSites_(1, 0),
+  polymorphicIdenticalPairs_(1, 0),
+  spectra_(1, vector<unsigned int>(1, 0)),
+  nbPolymorphicSites_(0)
+{}
+
+/******************************************************************************/
+
+IncrementalSequenceStatistics::IncrementalSequenceStatistics(const PolymorphismSequenceContainer& psc) :
+  IncrementalSequenceStatistics(psc.getAlphabet(), psc.getNumberOfSites())
+{
+  for (size_t i = 0; i < psc.getNumberOfSequences(); ++i)
+  {
+    addSequence(psc.sequence(i), psc.getSequenceCount(i));
+  }
+}
+
+/******************************************************************************/
+
+void IncrementalSequenceStatistics::addSequence(const Sequence& sequence, unsigned int count)
+{
+  if (sequence.size() != getNumberOfSites())
+    throw DimensionException("IncrementalSequenceStatistics::addSequence: wrong number of sites.", sequence.size(), getNumberOfSites());
+  if (count == 0)
+    return;
+  for (unsigned int c = 0; c < count; ++c)
+  {
+    nbSequences_++;
+    sampleSizeHistogram_.push_back(0);
+    polymorphicSites_.push_back(0);
+    polymorphicIdenticalPairs_.push_back(0);
+    spectra_.push_back(vector<unsigned int>(nbSequences_ / 2 + 1, 0));
+  }
+  int alphabetSize = static_cast<int>(alphabetSize_);
+  for (size_t k = 0; k < getNumberOfSites(); ++k)
+  {
+    int state = sequence.getValue(k);
+    if (state >= 0 && state < alphabetSize)
+      updateSite_(k, state, count, true);
+  }
+}
+
+/******************************************************************************/
+
+void IncrementalSequenceStatistics::removeSequence(const Sequence& sequence, unsigned int count)
+{
+  if (sequence.size() != getNumberOfSites())
+    throw DimensionException("IncrementalSequenceStatistics::removeSequence: wrong number of sites.", sequence.size(), getNumberOfSites());
+  if (count == 0)
+    return;
+  if (count > nbSequences_)
+    throw Exception("IncrementalSequenceStatistics::removeSequence: the sample has less than count sequences.");
+  // The aggregates are indexed by the sample size, up to the number of
+  // sequences: no site may be left with more resolved states than that.
+  size_t nbSequences = nbSequences_ - count;
+  int alphabetSize = static_cast<int>(alphabetSize_);
+  for (size_t k = 0; k < getNumberOfSites(); ++k)
+  {
+    int state = sequence.getValue(k);
+    size_t n = sampleSizes_[k];
+    if (state >= 0 && state < alphabetSize)
+    {
+      if (counts_[k * alphabetSize_ + static_cast<size_t>(state)] < count)
+        throw Exception("IncrementalSequenceStatistics::removeSequence: the sequence is not in the sample.");
+      n -= count;
+    }
+    if (n > nbSequences)
+      throw Exception("IncrementalSequenceStatistics::removeSequence: the sequence is not in the sample.");
+  }
+  for (size_t k = 0; k < getNumberOfSites(); ++k)
+  {
+    int state = sequence.getValue(k);
+    if (state >= 0 && state < alphabetSize)
+      updateSite_(k, state, count, false);
+  }
+  nbSequences_ = nbSequences;
+  sampleSizeHistogram_.resize(nbSequences_ + 1);
+  polymorphicSites_.resize(nbSequences_ + 1);
+  polymorphicIdenticalPairs_.resize(nbSequences_ + 1);
+  spectra_.resize(nbSequences_ + 1);
+}
+
+/******************************************************************************/
+
+unsigned int IncrementalSequenceStatistics::getCount(size_t site, int state) const
+{
+  if (site >= getNumberOfSites())
+    throw IndexOutOfBoundsException("IncrementalSequenceStatistics::getCount: site out of bounds.", site, 0, getNumberOfSites());
+  if (state < 0 || state >= static_cast<int>(alphabetSize_))
+    throw IndexOutOfBoundsException("IncrementalSequenceStatistics::getCount: state out of bounds.", static_cast<size_t>(state), 0, alphabetSize_);
+  return counts_[site * alphabetSize_ + static_cast<size_t>(state)];
+}
+
+/******************************************************************************/
+
+unsigned int IncrementalSequenceStatistics::getSampleSize(size_t site) const
+{
+  if (site >= getNumberOfSites())
+    throw IndexOutOfBoundsException("IncrementalSequenceStatistics::getSampleSize.", site, 0, getNumberOfSites());
+  return sampleSizes_[site];
+}
+
+/******************************************************************************/
+
+const vector<unsigned int>& IncrementalSequenceStatistics::getSiteFrequencySpectrum(size_t sampleSize) const
+{
+  if (sampleSize > nbSequences_)
+    throw IndexOutOfBoundsException("IncrementalSequenceStatistics::getSiteFrequencySpectrum.", sampleSize, 0, nbSequences_);
+  return spectra_[sampleSize];
+}
+
+/******************************************************************************/
+
+SequenceStatistics::SiteSampleSizeSummary IncrementalSequenceStatistics::getSummary() const
+{
+  return SequenceStatistics::siteSampleSizeSummary(sampleSizeHistogram_, polymorphicSites_, polymorphicIdenticalPairs_);
+}
+
+/******************************************************************************/
+
+vector<SequenceStatistics::SiteSampleSizeSummary> IncrementalSequenceStatistics::leaveOneOut(const PolymorphismSequenceContainer& psc)
+{
+  IncrementalSequenceStatistics stats(psc);
+  vector<SequenceStatistics::SiteSampleSizeSummary> summaries;
+  for (size_t i = 0; i < psc.getNumberOfSequences(); ++i)
+  {
+    const Sequence& sequence = psc.sequence(i);
+    unsigned int count = psc.getSequenceCount(i);
+    stats.removeSequence(sequence, count);
+    summaries.push_back(stats.getSummary());
+    stats.addSequence(sequence, count);
+  }
+  return summaries;
+}
+
+/******************************************************************************/
+
+void IncrementalSequenceStatistics::updateAggregates_(size_t site, int sign)
+{
+  size_t n = sampleSizes_[site];
+  if (sign > 0)
+    sampleSizeHistogram_[n]++;
+  else
+    sampleSizeHistogram_[n]--;
+  if (nbStates_[site] < 2)
+    return;
+  if (sign > 0)
+  {
+    nbPolymorphicSites_++;
+    polymorphicSites_[n]++;
+    polymorphicIdenticalPairs_[n] += identicalPairs_[site];
+  }
+  else
+  {
+    nbPolymorphicSites_--;
+    polymorphicSites_[n]--;
+    polymorphicIdenticalPairs_[n] -= identicalPairs_[site];
+  }
+  if (nbStates_[site] == 2)
+  {
+    auto first = counts_.begin() + static_cast<ptrdiff_t>(site * alphabetSize_);
+    size_t minor = n - *max_element(first, first + static_cast<ptrdiff_t>(alphabetSize_));
+    if (sign > 0)
+      spectra_[n][minor]++;
+    else
+      spectra_[n][minor]--;
+  }
+}
+
+/******************************************************************************/
+
+void IncrementalSequenceStatistics::updateSite_(size_t site, int state, size_t count, bool add)
+{
+  updateAggregates_(site, -1);
+  unsigned int& k = counts_[site * alphabetSize_ + static_cast<size_t>(state)];
+  unsigned int c = static_cast<unsigned int>(count);
+  // The sum of k(k - 1) changes by c(2k + c - 1) when k goes to k + c.
+  if (add)
+  {
+    identicalPairs_[site] += count * (2 * k + c - 1);
+    if (k == 0)
+      nbStates_[site]++;
+    k += c;
+    sampleSizes_[site] += c;
+  }
+  else
+  {
+    k -= c;
+    identicalPairs_[site] -= count * (2 * k + c - 1);
+    if (k == 0)
+      nbStates_[site]--;
+    sampleSizes_[site] -= c;
+  }
+  updateAggregates_(site, 1);
+}
+
+/******************************************************************************/
@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _INCREMENTALSEQUENCESTATISTICS_H_
+#define _INCREMENTALSEQUENCESTATISTICS_H_
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Seq/Sequence.h>
+
+// From local
+#include "PolymorphismSequenceContainer.h"
+#include "SequenceStatistics.h"
+
+// From the STL
+#include <memory>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Diversity statistics updated as sequences are added or removed.
+ *
+ * The counts of each resolved state at each site are kept, together with
+ * aggregates by sample size (the number of resolved states of a site): the
+ * number of sites, the number of polymorphic sites, the sum over the
+ * polymorphic sites of k(k - 1) for the count k of each state, and the
+ * folded site frequency spectrum of the biallelic sites. Adding or removing
+ * a sequence updates them in O(L); the spectrum of a sample size is then
+ * available in O(1), and pi, theta W and Tajima's D with the sample size of
+ * each site (see SequenceStatistics::siteSampleSizeSummary()) in a time
+ * depending only on the sample sizes observed.
+ *
+ * Gaps and unresolved characters are not counted. As in
+ * SequenceStatistics::siteSampleSizeSummary(), a sequence can stand for
+ * several copies (see PolymorphismSequenceContainer::getSequenceCount()),
+ * which are all added or removed at once, and counted in the sample sizes
+ * and in the state counts.
+ *
+ * The object does not observe a container: to follow one, the sequences
+ * added to or removed from it must also be added to or removed from the
+ * object. leaveOneOut() uses this to compute the statistics without each
+ * sequence in O(nL) instead of O(n^2 L).
+ */
+class IncrementalSequenceStatistics
+{
+private:
+  size_t alphabetSize_;
+  size_t nbSequences_;
+  std::vector<unsigned int> counts_;
+  std::vector<unsigned int> sampleSizes_;
+  std::vector<unsigned int> nbStates_;
+  std::vector<size_t> identicalPairs_;
+  std::vector<unsigned int> sampleSizeHistogram_;
+  std::vector<unsigned int> polymorphicSites_;
+  std::vector<size_t> polymorphicIdenticalPairs_;
+  std::vector< std::vector<unsigned int> > spectra_;
+  unsigned int nbPolymorphicSites_;
+
+public:
+  /**
+   * @brief Build an empty sample.
+   *
+   * @param alphabet The alphabet of the sequences.
+   * @param nbSites The number of sites of the sequences.
+   */
+  IncrementalSequenceStatistics(std::shared_ptr<const Alphabet> alphabet, size_t nbSites);
+
+  /**
+   * @brief Build the sample of the sequences of a container.
+   *
+   * @param psc The sequences, each with its number of copies.
+   */
+  IncrementalSequenceStatistics(const PolymorphismSequenceContainer& psc);
+
+  virtual ~IncrementalSequenceStatistics() {}
+
+public:
+  /**
+   * @brief Get the number of sequences of the sample, each counted as many times as its number of copies.
+   */
+  size_t getNumberOfSequences() const { return nbSequences_; }
+
+  size_t getNumberOfSites() const { return sampleSizes_.size(); }
+
+  /**
+   * @brief Get the number of sites with at least two resolved states.
+   */
+  unsigned int getNumberOfPolymorphicSites() const { return nbPolymorphicSites_; }
+
+  /**
+   * @brief Add a sequence to the sample.
+   *
+   * @param sequence The sequence.
+   * @param count The number of copies of the sequence.
+   * @throw DimensionException if the sequence does not have the number of sites of the sample.
+   */
+  void addSequence(const Sequence& sequence, unsigned int count = 1);
+
+  /**
+   * @brief Remove a sequence previously added to the sample.
+   *
+   * @param sequence The sequence.
+   * @param count The number of copies of the sequence.
+   * @throw DimensionException if the sequence does not have the number of sites of the sample.
+   * @throw Exception if the copies are not in the sample: a state of the
+   * sequence has less than count copies at a site, or a site would be left
+   * with more resolved states than sequences. The sample is then unchanged.
+   */
+  void removeSequence(const Sequence& sequence, unsigned int count = 1);
+
+  /**
+   * @brief Get the number of copies of a state at a site.
+   *
+   * @throw IndexOutOfBoundsException if the site or the state is out of bounds.
+   */
+  unsigned int getCount(size_t site, int state) const;
+
+  /**
+   * @brief Get the number of resolved states at a site.
+   *
+   * @throw IndexOutOfBoundsException if the site is out of bounds.
+   */
+  unsigned int getSampleSize(size_t site) const;
+
+  /**
+   * @brief Get the folded site frequency spectrum of the biallelic sites with a given sample size.
+   *
+   * @param sampleSize The number of resolved states of the sites.
+   * @return The number of sites for each count of the minor state, from 0 to sampleSize / 2.
+   * @throw IndexOutOfBoundsException if the sample size excedes the number of sequences.
+   */
+  const std::vector<unsigned int>& getSiteFrequencySpectrum(size_t sampleSize) const;
+
+  /**
+   * @brief Get the folded site frequency spectrum of the biallelic sites without gap nor unresolved character.
+   */
+  const std::vector<unsigned int>& getSiteFrequencySpectrum() const
+  {
+    return getSiteFrequencySpectrum(nbSequences_);
+  }
+
+  /**
+   * @brief Compute pi, theta W and Tajima's D with the sample size of each site.
+   *
+   * @see SequenceStatistics::siteSampleSizeSummary
+   */
+  SequenceStatistics::SiteSampleSizeSummary getSummary() const;
+
+  /**
+   * @brief Compute the statistics of the sample without each of its sequences.
+   *
+   * All the copies of a sequence are left out together, as when the
+   * sequence is removed from the container.
+   *
+   * @param psc The sequences, each with its number of copies.
+   * @return The summary without each sequence, in the order of the container.
+   */
+  static std::vector<SequenceStatistics::SiteSampleSizeSummary> leaveOneOut(const PolymorphismSequenceContainer& psc);
+
+private:
+  /**
+   * @brief Remove (sign = -1) or add (sign = 1) the contribution of a site to the aggregates.
+   */
+  void updateAggregates_(size_t site, int sign);
+
+  /**
+   * @brief Add (add = true) or remove (add = false) count copies of a state at a site.
+   */
+  void updateSite_(size_t site, int state, size_t count, bool add);
+};
+} // end of namespace bpp;
+
+#endif // _INCREMENTALSEQUENCESTATISTICS_H_
@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "JointSfs.h"
+
+// From the STL
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+/**
+ * @brief Hypergeometric projection of a site: probabilities of first, first + 1, ... derived copies.
+ */
+struct Projection
+{
+  size_t first;
+  vector<double> probabilities;
+
+  Projection() :
+    first(0),
+    probabilities()
+  {}
+};
+
+/**
+ * @brief Number of sites processed by a task, and maximum number of tasks.
+ */
+const size_t CHUNK_SIZE = 1024;
+const size_t MAX_NUMBER_OF_CHUNKS = 32;
+}
+
+const size_t JointSfs::MAX_DENSE_CELLS = 1 << 18;
+
+/******************************************************************************/
+
+JointSfs::JointSfs(
+    const AlleleFrequencyTable& table,
+    const vector<size_t>& groupIds,
+    const vector<unsigned int>& sampleSizes,
+    const ExecutionContext& context) :
+  groupIds_(groupIds),
+  sampleSizes_(sampleSizes),
+  strides_(),
+  nbCells_(0),
+  sparse_(false),
+  dense_(),
+  sparseCells_(),
+  nbSites_(0.)
+{
+  if (groupIds.size() != sampleSizes.size())
+    throw DimensionException("JointSfs::JointSfs: one sample size is needed per group.", sampleSizes.size(), groupIds.size());
+  build_(table, context);
+}
+
+JointSfs::JointSfs(
+    const PolymorphismSequenceContainer& psc,
+    const vector<size_t>& groupIds,
+    const vector<unsigned int>& sampleSizes,
+    const ExecutionContext& context) :
+  groupIds_(groupIds),
+  sampleSizes_(sampleSizes),
+  strides_(),
+  nbCells_(0),
+  sparse_(false),
+  dense_(),
+  sparseCells_(),
+  nbSites_(0.)
+{
+  if (groupIds.size() != sampleSizes.size())
+    throw DimensionException("JointSfs::JointSfs: one sample size is needed per group.", sampleSizes.size(), groupIds.size());
+  AlleleFrequencyTable table(psc, 0);
+  build_(table, context);
+}
+
+/******************************************************************************/
+
+void JointSfs::build_(
+    const AlleleFrequencyTable& table,
+    const ExecutionContext& context)
+{
+  size_t nbDimensions = groupIds_.size();
+  vector<size_t> groupIndices(nbDimensions);
+  strides_.resize(nbDimensions);
+  nbCells_ = 1;
+  for (size_t i = nbDimensions; i > 0; --i)
+  {
+    groupIndices[i - 1] = table.getGroupIndex(groupIds_[i - 1]);
+    strides_[i - 1] = nbCells_;
+    nbCells_ *= sampleSizes_[i - 1] + 1;
+  }
+  sparse_ = (nbCells_ > MAX_DENSE_CELLS);
+
+  // Sites with enough sampled alleles in every dimension
+  size_t nbSites = table.getNumberOfSites();
+  vector<size_t> sites;
+  for (size_t s = 0; s < nbSites; ++s)
+  {
+    bool ok = true;
+    for (size_t i = 0; i < nbDimensions && ok; ++i)
+    {
+      ok = (table.getSampleSize(s, groupIndices[i]) >= sampleSizes_[i]);
+    }
+    if (ok)
+      sites.push_back(s);
+  }
+  nbSites_ = static_cast<double>(sites.size());
+
+  // Projections of every observed sample size, in every dimension
+  unsigned int maxSampleSize = 0;
+  for (size_t s : sites)
+  {
+    for (size_t i = 0; i < nbDimensions; ++i)
+    {
+      maxSampleSize = max(maxSampleSize, table.getSampleSize(s, groupIndices[i]));
+    }
+  }
+  vector<double> logFactorials(maxSampleSize + 1, 0.);
+  for (size_t k = 1; k <= maxSampleSize; ++k)
+  {
+    logFactorials[k] = logFactorials[k - 1] + log(static_cast<double>(k));
+  }
+  auto logBinomial = [&](size_t n, size_t k) {
+        return logFactorials[n] - logFactorials[k] - logFactorials[n - k];
+      };
+  vector< vector< vector<Projection> > > projections(nbDimensions);
+  for (size_t s : sites)
+  {
+    for (size_t i = 0; i < nbDimensions; ++i)
+    {
+      size_t n = table.getSampleSize(s, groupIndices[i]);
+      size_t m = sampleSizes_[i];
+      if (projections[i].size() <= n)
+        projections[i].resize(n + 1);
+      if (!projections[i][n].empty())
+        continue;
+      projections[i][n].resize(n + 1);
+      for (size_t x = 0; x <= n; ++x)
+      {
+        Projection& projection = projections[i][n][x];
+        projection.first = m + x > n ? m + x - n : 0;
+        size_t last = min(x, m);
+        for (size_t k = projection.first; k <= last; ++k)
+        {
+          projection.probabilities.push_back(exp(logBinomial(x, k) + logBinomial(n - x, m - k) - logBinomial(n, m)));
+        }
+      }
+    }
+  }
+
+  // Spectra of the chunks
+  size_t nbChunks = min(MAX_NUMBER_OF_CHUNKS, (sites.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+  size_t chunkSize = nbChunks > 0 ? (sites.size() + nbChunks - 1) / nbChunks : 0;
+  vector< vector<double> > denseChunks(sparse_ ? 0 : nbChunks);
+  vector< unordered_map<size_t, double> > sparseChunks(sparse_ ? nbChunks : 0);
+  context.parallelFor(0, nbChunks, [&](size_t chunk) {
+        if (!sparse_)
+          denseChunks[chunk].assign(nbCells_, 0.);
+        vector<const Projection*> siteProjections(nbDimensions);
+        vector<size_t> k(nbDimensions);
+        size_t end = min(sites.size(), (chunk + 1) * chunkSize);
+        for (size_t c = chunk * chunkSize; c < end; ++c)
+        {
+          size_t s = sites[c];
+          for (size_t i = 0; i < nbDimensions; ++i)
+          {
+            siteProjections[i] = &projections[i][table.getSampleSize(s, groupIndices[i])][table.getDerivedCount(s, groupIndices[i])];
+          }
+          fill(k.begin(), k.end(), 0);
+          bool more = true;
+          while (more)
+          {
+            double weight = 1.;
+            size_t cell = 0;
+            for (size_t i = 0; i < nbDimensions; ++i)
+            {
+              weight *= siteProjections[i]->probabilities[k[i]];
+              cell += (siteProjections[i]->first + k[i]) * strides_[i];
+            }
+            if (sparse_)
+              sparseChunks[chunk][cell] += weight;
+            else
+              denseChunks[chunk][cell] += weight;
+
+            // Next combination, the last dimension varying fastest
+            more = false;
+            for (size_t i = nbDimensions; i > 0 && !more; --i)
+            {
+              if (++k[i - 1] < siteProjections[i - 1]->probabilities.size())
+                more = true;
+              else
+                k[i - 1] = 0;
+            }
+          }
+        }
+      });
+
+  // Merge, in chunk order
+  if (sparse_)
+  {
+    for (const auto& chunk : sparseChunks)
+    {
+      vector< pair<size_t, double> > cells(chunk.begin(), chunk.end());
+      sort(cells.begin(), cells.end());
+      for (const auto& cell : cells)
+      {
+        sparseCells_[cell.first] += cell.second;
+      }
+    }
+  }
+  else
+  {
+    dense_.assign(nbCells_, 0.);
+    for (const auto& chunk : denseChunks)
+    {
+      for (size_t cell = 0; cell < nbCells_; ++cell)
+      {
+        dense_[cell] += chunk[cell];
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+double JointSfs::getValue(const vector<unsigned int>& counts) const
+{
+  if (counts.size() != groupIds_.size())
+    throw DimensionException("JointSfs::getValue: one count is needed per dimension.", counts.size(), groupIds_.size());
+  size_t cell = 0;
+  for (size_t i = 0; i < counts.size(); ++i)
+  {
+    if (counts[i] > sampleSizes_[i])
+      throw IndexOutOfBoundsException("JointSfs::getValue: count out of bounds.", counts[i], 0, sampleSizes_[i]);
+    cell += counts[i] * strides_[i];
+  }
+  if (!sparse_)
+    return dense_[cell];
+  auto it = sparseCells_.find(cell);
+  return it == sparseCells_.end() ? 0. : it->second;
+}
+
+/******************************************************************************/
+
+vector<double> JointSfs::getDenseValues() const
+{
+  if (!sparse_)
+    return dense_;
+  vector<double> values(nbCells_, 0.);
+  for (const auto& cell : sparseCells_)
+  {
+    values[cell.first] = cell.second;
+  }
+  return values;
+}
+
+/******************************************************************************/
+
+vector< pair<size_t, double> > JointSfs::getNonZeroValues() const
+{
+  vector< pair<size_t, double> > values;
+  if (sparse_)
+    values.assign(sparseCells_.begin(), sparseCells_.end());
+  else
+  {
+    for (size_t cell = 0; cell < nbCells_; ++cell)
+    {
+      if (dense_[cell] != 0.)
+        values.push_back(make_pair(cell, dense_[cell]));
+    }
+  }
+  return values;
+}
+
+/******************************************************************************/
@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _JOINTSFS_H_
+#define _JOINTSFS_H_
+
+#include <Bpp/Exceptions.h>
+
+// From local
+#include "AlleleFrequencyTable.h"
+#include "ExecutionContext.h"
+#include "PolymorphismSequenceContainer.h"
+
+// From the STL
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Joint site frequency spectrum of several groups.
+ *
+ * The spectrum has one dimension per group, the groups being given by
+ * their ids (see PolymorphismSequenceContainer::getGroupId()). Cell
+ * (k_1, ..., k_d) holds the number of sites where k_i copies of the
+ * derived allele are found in a sample of m_i alleles of group i. The
+ * sites and the polarization are those of an AlleleFrequencyTable.
+ *
+ * Each group is projected down to the sample size m_i with the
+ * hypergeometric distribution (Marth et al. 2004; Gutenkunst et al. 2009),
+ * so that sites with missing data can be used: a site with x derived
+ * alleles among n >= m_i sampled alleles adds
+ * C(x, k) C(n - x, m_i - k) / C(n, m_i) to the cells with k copies in this
+ * dimension. Sites with less than m_i sampled alleles in a group are
+ * dropped. The binomial coefficients come from a table of log-factorials,
+ * and the projection of each (n, x) pair is computed only once.
+ *
+ * The sites are processed in parallel by chunks whose spectra are then
+ * summed in chunk order, so that the result does not depend on the
+ * number of threads. The spectrum is stored densely when it has less than
+ * MAX_DENSE_CELLS cells, and as a sparse map of its non-zero cells
+ * otherwise.
+ *
+ * References:
+ * - Marth et al. 2004, Genetics 166:351-372.
+ * - Gutenkunst et al. 2009, PLoS Genetics 5:e1000695.
+ */
+class JointSfs
+{
+public:
+  static const size_t MAX_DENSE_CELLS;
+
+private:
+  std::vector<size_t> groupIds_;
+  std::vector<unsigned int> sampleSizes_;
+  std::vector<size_t> strides_;
+  size_t nbCells_;
+  bool sparse_;
+  std::vector<double> dense_;
+  std::map<size_t, double> sparseCells_;
+  double nbSites_;
+
+public:
+  /**
+   * @brief Build the spectrum from an allele frequency table.
+   *
+   * @param table The per-group derived allele counts.
+   * @param groupIds The id of the group of each dimension.
+   * @param sampleSizes The projected sample size of each dimension.
+   * @param context The ExecutionContext used to scan the sites.
+   * @throw DimensionException if groupIds and sampleSizes don't have the same size.
+   * @throw GroupNotFoundException if a group is not found.
+   */
+  JointSfs(
+      const AlleleFrequencyTable& table,
+      const std::vector<size_t>& groupIds,
+      const std::vector<unsigned int>& sampleSizes,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Build the spectrum of the biallelic sites of a container, polarized by the minor allele.
+   *
+   * @param psc The sequences.
+   * @param groupIds The id of the group of each dimension.
+   * @param sampleSizes The projected sample size of each dimension.
+   * @param context The ExecutionContext used to scan the sites.
+   * @throw DimensionException if groupIds and sampleSizes don't have the same size.
+   * @throw GroupNotFoundException if a group is not found.
+   */
+  JointSfs(
+      const PolymorphismSequenceContainer& psc,
+      const std::vector<size_t>& groupIds,
+      const std::vector<unsigned int>& sampleSizes,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  virtual ~JointSfs() {}
+
+public:
+  size_t getNumberOfDimensions() const { return groupIds_.size(); }
+
+  const std::vector<size_t>& getGroupIds() const { return groupIds_; }
+
+  const std::vector<unsigned int>& getSampleSizes() const { return sampleSizes_; }
+
+  /**
+   * @brief Get the number of cells, product of the (m_i + 1).
+   */
+  size_t getNumberOfCells() const { return nbCells_; }
+
+  bool isSparse() const { return sparse_; }
+
+  /**
+   * @brief Get the total number of sites in the spectrum.
+   */
+  double getNumberOfSites() const { return nbSites_; }
+
+  /**
+   * @brief Get the value of a cell.
+   *
+   * @param counts The number of derived alleles in each dimension.
+   * @throw DimensionException if counts does not have one value per dimension.
+   * @throw IndexOutOfBoundsException if a count excedes the sample size.
+   */
+  double getValue(const std::vector<unsigned int>& counts) const;
+
+  /**
+   * @brief Get all the cells, the last dimension varying fastest.
+   */
+  std::vector<double> getDenseValues() const;
+
+  /**
+   * @brief Get the non-zero cells, as (linear index, value) pairs sorted by index.
+   *
+   * The linear index is the index of the cell in getDenseValues().
+   */
+  std::vector< std::pair<size_t, double> > getNonZeroValues() const;
+
+private:
+  /**
+   * @brief Compute the spectrum.
+   */
+  void build_(
+      const AlleleFrequencyTable& table,
+      const ExecutionContext& context);
+};
+} // end of namespace bpp;
+
+#endif // _JOINTSFS_H_
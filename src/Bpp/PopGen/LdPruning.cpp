@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "LdPruning.h"
+
+// From the STL
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+/**
+ * @brief Check the window parameters and the segment ids, and return one id per SNP.
+ */
+vector<size_t> checkSegments_(
+    const string& method,
+    size_t windowSize,
+    size_t step,
+    const vector<size_t>& segments,
+    size_t size)
+{
+  if (windowSize < 2)
+    throw BadIntegerException(method + ": windowSize must be at least 2.", static_cast<int>(windowSize));
+  if (step == 0)
+    throw BadIntegerException(method + ": step must be greater than 0.", 0);
+  if (segments.empty())
+    return vector<size_t>(size, 0);
+  if (segments.size() != size)
+    throw DimensionException(method + ": wrong number of segment ids.", segments.size(), size);
+  return segments;
+}
+
+/**
+ * @brief Prune the SNPs of each segment, given their minor allele frequency and a function computing r^2.
+ */
+template<class R2>
+vector<bool> prune_(
+    const vector<size_t>& segments,
+    const vector<double>& maf,
+    size_t windowSize,
+    size_t step,
+    double r2Threshold,
+    const ExecutionContext& context,
+    R2 r2)
+{
+  size_t nbSnps = segments.size();
+  vector<size_t> starts(1, 0);
+  for (size_t k = 1; k < nbSnps; ++k)
+  {
+    if (segments[k] != segments[k - 1])
+      starts.push_back(k);
+  }
+  starts.push_back(nbSnps);
+
+  // One byte per SNP, so that the segments can be written concurrently.
+  vector<uint8_t> kept(nbSnps, 1);
+  context.parallelFor(0, starts.size() - 1, [&](size_t segment) {
+        size_t end = starts[segment + 1];
+        // Two SNPs kept before tested have already been tested against each other.
+        size_t tested = starts[segment];
+        for (size_t start = starts[segment]; start < end; start += step)
+        {
+          size_t stop = min(end, start + windowSize);
+          for (size_t i = start; i < stop; ++i)
+          {
+            for (size_t j = max(i + 1, tested); j < stop && kept[i]; ++j)
+            {
+              if (!kept[j] || !(r2(i, j) > r2Threshold))
+                continue;
+              if (maf[i] < maf[j])
+                kept[i] = 0;
+              else
+                kept[j] = 0;
+            }
+          }
+          tested = stop;
+          if (stop == end)
+            break;
+        }
+      });
+  return vector<bool>(kept.begin(), kept.end());
+}
+} // end of anonymous namespace
+
+/******************************************************************************/
+
+vector<bool> LdPruning::indepPairwise(
+    const HaplotypeMatrix& hm,
+    size_t windowSize,
+    size_t step,
+    double r2Threshold,
+    const vector<size_t>& segments,
+    const ExecutionContext& context)
+{
+  size_t nbSnps = hm.getNumberOfSnps();
+  vector<size_t> snpSegments = checkSegments_("LdPruning::indepPairwise", windowSize, step, segments, nbSnps);
+  size_t nbWords = hm.getNumberOfWords();
+  double n = static_cast<double>(hm.getNumberOfHaplotypes());
+  vector<double> freqs(nbSnps), maf(nbSnps);
+  for (size_t k = 0; k < nbSnps; ++k)
+  {
+    size_t count = HaplotypeMatrix::popCount(hm.column(k), nbWords);
+    freqs[k] = static_cast<double>(count) / n;
+    // From the counts, so that ties are exact.
+    maf[k] = static_cast<double>(min(count, hm.getNumberOfHaplotypes() - count)) / n;
+  }
+  return prune_(snpSegments, maf, windowSize, step, r2Threshold, context, [&](size_t i, size_t j) {
+          const uint64_t* colI = hm.column(i);
+          const uint64_t* colJ = hm.column(j);
+          size_t both = 0;
+          for (size_t w = 0; w < nbWords; ++w)
+          {
+            both += HaplotypeMatrix::popCount(colI[w] & colJ[w]);
+          }
+          double denominator = freqs[i] * (1. - freqs[i]) * freqs[j] * (1. - freqs[j]);
+          if (denominator <= 0.)
+            return 0.;
+          double d = static_cast<double>(both) / n - freqs[i] * freqs[j];
+          return d * d / denominator;
+        });
+}
+
+/******************************************************************************/
+
+vector<bool> LdPruning::indepPairwise(
+    const PolymorphismSequenceContainer& psc,
+    size_t windowSize,
+    size_t step,
+    double r2Threshold,
+    const vector<size_t>& segments,
+    const ExecutionContext& context)
+{
+  size_t nbSites = psc.getNumberOfSites();
+  vector<size_t> siteSegments = checkSegments_("LdPruning::indepPairwise", windowSize, step, segments, nbSites);
+  HaplotypeMatrix hm(psc);
+  vector<size_t> snpSegments(hm.getNumberOfSnps());
+  for (size_t k = 0; k < snpSegments.size(); ++k)
+  {
+    snpSegments[k] = siteSegments[hm.getSiteIndex(k)];
+  }
+  vector<bool> kept = indepPairwise(hm, windowSize, step, r2Threshold, snpSegments, context);
+  vector<bool> mask(nbSites, false);
+  for (size_t k = 0; k < kept.size(); ++k)
+  {
+    mask[hm.getSiteIndex(k)] = kept[k];
+  }
+  return mask;
+}
+
+/******************************************************************************/
+
+vector<bool> LdPruning::indepPairwise(
+    const PolymorphismMultiGContainer& pmgc,
+    size_t windowSize,
+    size_t step,
+    double r2Threshold,
+    const vector<size_t>& segments,
+    const ExecutionContext& context)
+{
+  size_t nbLoci = pmgc.size() > 0 ? pmgc.getNumberOfLoci() : 0;
+  vector<size_t> locusSegments = checkSegments_("LdPruning::indepPairwise", windowSize, step, segments, nbLoci);
+
+  // The allele counted in the dosages, or npos if the locus does not have two alleles.
+  const size_t npos = numeric_limits<size_t>::max();
+  vector<size_t> alleles(nbLoci, npos);
+  context.parallelFor(0, nbLoci, [&](size_t locus) {
+        size_t first = npos, second = npos;
+        for (const auto& entry : pmgc.locusView(locus))
+        {
+          if (!entry.genotype)
+            continue;
+          for (size_t allele : entry.genotype->getAlleleIndex())
+          {
+            if (first == npos || allele == first)
+              first = allele;
+            else if (second == npos || allele == second)
+              second = allele;
+            else
+              return;
+          }
+        }
+        if (second != npos)
+          alleles[locus] = min(first, second);
+      });
+  vector<size_t> snps;
+  for (size_t locus = 0; locus < nbLoci; ++locus)
+  {
+    if (alleles[locus] != npos)
+      snps.push_back(locus);
+  }
+
+  // Dosage d of each individual as the bits d & 1 (low) and d >> 1 (high).
+  size_t nbSnps = snps.size();
+  size_t nbWords = (pmgc.size() + 63) / 64;
+  vector<uint64_t> genotyped(nbSnps * nbWords, 0), low(nbSnps * nbWords, 0), high(nbSnps * nbWords, 0);
+  vector<double> maf(nbSnps);
+  vector<size_t> snpSegments(nbSnps);
+  context.parallelFor(0, nbSnps, [&](size_t k) {
+        size_t allele = alleles[snps[k]];
+        size_t nbCopies = 0, nbAlleles = 0;
+        PolymorphismMultiGContainer::LocusView view = pmgc.locusView(snps[k]);
+        for (size_t i = 0; i < view.size(); ++i)
+        {
+          const MonolocusGenotypeInterface* genotype = view[i].genotype;
+          if (!genotype)
+            continue;
+          vector<size_t> genotypeAlleles = genotype->getAlleleIndex();
+          size_t dosage = static_cast<size_t>(count(genotypeAlleles.begin(), genotypeAlleles.end(), allele));
+          if (dosage > 2)
+            throw BadIntegerException("LdPruning::indepPairwise: dosages above 2 are not supported.", static_cast<int>(dosage));
+          uint64_t bit = uint64_t(1) << (i % 64);
+          size_t word = k * nbWords + i / 64;
+          genotyped[word] |= bit;
+          if (dosage & 1)
+            low[word] |= bit;
+          if (dosage & 2)
+            high[word] |= bit;
+          nbCopies += dosage;
+          nbAlleles += genotypeAlleles.size();
+        }
+        maf[k] = static_cast<double>(min(nbCopies, nbAlleles - nbCopies)) / static_cast<double>(nbAlleles);
+        snpSegments[k] = locusSegments[snps[k]];
+      });
+
+  vector<bool> kept = prune_(snpSegments, maf, windowSize, step, r2Threshold, context, [&](size_t i, size_t j) {
+          size_t n = 0, lowI = 0, highI = 0, lowJ = 0, highJ = 0, lowLow = 0, crossed = 0, highHigh = 0;
+          for (size_t w = 0; w < nbWords; ++w)
+          {
+            size_t wI = i * nbWords + w, wJ = j * nbWords + w;
+            uint64_t both = genotyped[wI] & genotyped[wJ];
+            n += HaplotypeMatrix::popCount(both);
+            lowI += HaplotypeMatrix::popCount(low[wI] & both);
+            highI += HaplotypeMatrix::popCount(high[wI] & both);
+            lowJ += HaplotypeMatrix::popCount(low[wJ] & both);
+            highJ += HaplotypeMatrix::popCount(high[wJ] & both);
+            lowLow += HaplotypeMatrix::popCount(low[wI] & low[wJ]);
+            crossed += HaplotypeMatrix::popCount(low[wI] & high[wJ]) + HaplotypeMatrix::popCount(high[wI] & low[wJ]);
+            highHigh += HaplotypeMatrix::popCount(high[wI] & high[wJ]);
+          }
+          double nd = static_cast<double>(n);
+          double sumI = static_cast<double>(lowI + 2 * highI), sumJ = static_cast<double>(lowJ + 2 * highJ);
+          double sumII = static_cast<double>(lowI + 4 * highI), sumJJ = static_cast<double>(lowJ + 4 * highJ);
+          double sumIJ = static_cast<double>(lowLow + 2 * crossed + 4 * highHigh);
+          double varI = nd * sumII - sumI * sumI, varJ = nd * sumJJ - sumJ * sumJ;
+          if (varI <= 0. || varJ <= 0.)
+            return 0.;
+          double cov = nd * sumIJ - sumI * sumJ;
+          return cov * cov / (varI * varJ);
+        });
+  vector<bool> mask(nbLoci, false);
+  for (size_t k = 0; k < nbSnps; ++k)
+  {
+    mask[snps[k]] = kept[k];
+  }
+  return mask;
+}
+
+/******************************************************************************/
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _LDPRUNING_H_
+#define _LDPRUNING_H_
+
+#include <Bpp/Exceptions.h>
+
+// From local
+#include "ExecutionContext.h"
+#include "HaplotypeMatrix.h"
+#include "PolymorphismMultiGContainer.h"
+#include "PolymorphismSequenceContainer.h"
+
+// From the STL
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Pruning of the SNPs in linkage disequilibrium, in sliding windows.
+ *
+ * The SNPs are pruned as with the indep-pairwise option of PLINK: in a
+ * window of windowSize consecutive SNPs, each pair of SNPs still kept with
+ * r^2 greater than the threshold loses the SNP of lower minor allele
+ * frequency (the second one in case of a tie). The window then moves by
+ * step SNPs. The pairs of two SNPs kept from the previous window have
+ * already been tested and are not tested again.
+ *
+ * The SNPs may be split in independent segments (e.g. chromosomes) by
+ * giving a segment id for each of them: windows never span two
+ * consecutive SNPs with different ids. The segments are pruned
+ * concurrently with an ExecutionContext, the windows of a segment one
+ * after the other.
+ *
+ * - On a HaplotypeMatrix, r^2 is computed from the haplotype counts, given
+ *   by the population count of the AND of two bit columns.
+ * - On a PolymorphismMultiGContainer, r^2 is the squared correlation of
+ *   the allele dosages of the individuals genotyped at both loci. The
+ *   dosages are packed in two bit planes plus a bit plane of the genotyped
+ *   individuals, so that the sums of the correlation are also population
+ *   counts.
+ */
+class LdPruning
+{
+public:
+  // Class destructor
+  virtual ~LdPruning() {}
+
+  /**
+   * @brief Prune the SNPs of a HaplotypeMatrix.
+   *
+   * @param hm The haplotypes.
+   * @param windowSize The number of SNPs in a window.
+   * @param step The number of SNPs between the starts of two windows.
+   * @param r2Threshold The highest r^2 allowed between two SNPs kept.
+   * @param segments The segment id of each SNP, or empty for a single segment.
+   * @param context The ExecutionContext used to prune the segments.
+   * @return For each SNP, true if it is kept.
+   * @throw BadIntegerException if windowSize < 2 or step is 0.
+   * @throw DimensionException if segments does not have one id per SNP.
+   */
+  static std::vector<bool> indepPairwise(
+      const HaplotypeMatrix& hm,
+      size_t windowSize,
+      size_t step,
+      double r2Threshold,
+      const std::vector<size_t>& segments = std::vector<size_t>(),
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Prune the sites of a PolymorphismSequenceContainer, with haplotype r^2.
+   *
+   * Only the complete biallelic sites (see HaplotypeMatrix) are SNPs, the
+   * windows are counted in SNPs.
+   *
+   * @param psc The sequences.
+   * @param windowSize The number of SNPs in a window.
+   * @param step The number of SNPs between the starts of two windows.
+   * @param r2Threshold The highest r^2 allowed between two SNPs kept.
+   * @param segments The segment id of each site, or empty for a single segment.
+   * @param context The ExecutionContext used to prune the segments.
+   * @return For each site, true if it is a SNP and is kept.
+   * @throw BadIntegerException if windowSize < 2 or step is 0.
+   * @throw DimensionException if segments does not have one id per site.
+   */
+  static std::vector<bool> indepPairwise(
+      const PolymorphismSequenceContainer& psc,
+      size_t windowSize,
+      size_t step,
+      double r2Threshold,
+      const std::vector<size_t>& segments = std::vector<size_t>(),
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Prune the loci of a PolymorphismMultiGContainer, with genotype r^2.
+   *
+   * Only the loci with exactly two alleles observed are SNPs, the windows
+   * are counted in SNPs. The dosage of an individual is its number of
+   * copies of the allele of lower index, missing genotypes are skipped.
+   *
+   * @param pmgc The genotypes.
+   * @param windowSize The number of SNPs in a window.
+   * @param step The number of SNPs between the starts of two windows.
+   * @param r2Threshold The highest r^2 allowed between two SNPs kept.
+   * @param segments The segment id of each locus, or empty for a single segment.
+   * @param context The ExecutionContext used to pack the dosages and prune the segments.
+   * @return For each locus, true if it is a SNP and is kept.
+   * @throw Exception if the MultilocusGenotypes are not aligned.
+   * @throw BadIntegerException if windowSize < 2 or step is 0, or if a genotype has more than two copies of an allele.
+   * @throw DimensionException if segments does not have one id per locus.
+   */
+  static std::vector<bool> indepPairwise(
+      const PolymorphismMultiGContainer& pmgc,
+      size_t windowSize,
+      size_t step,
+      double r2Threshold,
+      const std::vector<size_t>& segments = std::vector<size_t>(),
+      const ExecutionContext& context = ExecutionContext::sequential());
+};
+} // end of namespace bpp;
+
+#endif // _LDPRUNING_H_
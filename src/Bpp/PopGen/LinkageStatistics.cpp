@@ -0,0 +1,258 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "LinkageStatistics.h"
+
+// From the STL
+#include <algorithm>
+#include <cmath>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+LinkageStatistics::LdTests LinkageStatistics::ldTests(const HaplotypeMatrix& hm)
+{
+  Workspace workspace;
+  return ldTests_(hm, 0, hm.getNumberOfSnps(), workspace);
+}
+
+/******************************************************************************/
+
+LinkageStatistics::LdTests LinkageStatistics::ldTests(const HaplotypeMatrix& hm, Workspace& workspace)
+{
+  return ldTests_(hm, 0, hm.getNumberOfSnps(), workspace);
+}
+
+/******************************************************************************/
+
+LinkageStatistics::LdTests LinkageStatistics::ldTests(
+    const HaplotypeMatrix& hm,
+    size_t firstSnp,
+    size_t lastSnp)
+{
+  if (lastSnp >= hm.getNumberOfSnps())
+    throw IndexOutOfBoundsException("LinkageStatistics::ldTests: lastSnp out of bounds.", lastSnp, 0, hm.getNumberOfSnps());
+  if (firstSnp > lastSnp)
+    throw BadIntegerException("LinkageStatistics::ldTests: firstSnp must be <= lastSnp.", static_cast<int>(firstSnp));
+  Workspace workspace;
+  return ldTests_(hm, firstSnp, lastSnp - firstSnp + 1, workspace);
+}
+
+/******************************************************************************/
+
+vector<LinkageStatistics::LdTests> LinkageStatistics::ldTestsInWindows(
+    const HaplotypeMatrix& hm,
+    size_t windowSize,
+    size_t step,
+    const ExecutionContext& context)
+{
+  if (windowSize == 0)
+    throw BadIntegerException("LinkageStatistics::ldTestsInWindows: windowSize must be > 0.", 0);
+  if (step == 0)
+    throw BadIntegerException("LinkageStatistics::ldTestsInWindows: step must be > 0.", 0);
+  size_t nbSnps = hm.getNumberOfSnps();
+  size_t nbWindows = nbSnps < windowSize ? 0 : (nbSnps - windowSize) / step + 1;
+  vector<LdTests> windows(nbWindows);
+  context.parallelFor(0, nbWindows, [&](size_t i) {
+        Workspace workspace;
+        windows[i] = ldTests_(hm, i * step, windowSize, workspace);
+      });
+  return windows;
+}
+
+/******************************************************************************/
+
+vector<LinkageStatistics::LdTests> LinkageStatistics::ldTests(
+    const vector<HaplotypeMatrix>& replicates,
+    const ExecutionContext& context)
+{
+  vector<LdTests> results(replicates.size());
+  context.parallelFor(0, replicates.size(), [&](size_t i) {
+        Workspace workspace;
+        results[i] = ldTests_(replicates[i], 0, replicates[i].getNumberOfSnps(), workspace);
+      });
+  return results;
+}
+
+/******************************************************************************/
+
+vector< pair<size_t, size_t> > LinkageStatistics::fourGameteTest(
+    const HaplotypeMatrix& hm,
+    double maxDistance,
+    const ExecutionContext& context)
+{
+  size_t nbSnps = hm.getNumberOfSnps();
+  size_t nbWords = hm.getNumberOfWords();
+  size_t nbHaplotypes = hm.getNumberOfHaplotypes();
+  const vector<double>& positions = hm.getPositions();
+  vector<size_t> derived(nbSnps);
+  for (size_t i = 0; i < nbSnps; ++i)
+  {
+    derived[i] = HaplotypeMatrix::popCount(hm.column(i), nbWords);
+  }
+
+  vector< vector<size_t> > partners(nbSnps);
+  context.parallelFor(0, nbSnps, [&](size_t i) {
+        const uint64_t* colI = hm.column(i);
+        for (size_t j = i + 1; j < nbSnps && positions[j] - positions[i] <= maxDistance; ++j)
+        {
+          const uint64_t* colJ = hm.column(j);
+          size_t n11 = 0;
+          for (size_t w = 0; w < nbWords; ++w)
+          {
+            n11 += HaplotypeMatrix::popCount(colI[w] & colJ[w]);
+          }
+          // n10, n01 and n00 follow from n11 and the derived counts.
+          if (n11 > 0 && n11 < derived[i] && n11 < derived[j] && derived[i] + derived[j] - n11 < nbHaplotypes)
+            partners[i].push_back(j);
+        }
+      });
+
+  vector< pair<size_t, size_t> > incompatiblePairs;
+  for (size_t i = 0; i < nbSnps; ++i)
+  {
+    for (size_t j : partners[i])
+    {
+      incompatiblePairs.push_back(make_pair(i, j));
+    }
+  }
+  return incompatiblePairs;
+}
+
+/******************************************************************************/
+
+unsigned int LinkageStatistics::rm(
+    const HaplotypeMatrix& hm,
+    double maxDistance,
+    const ExecutionContext& context)
+{
+  return rm(fourGameteTest(hm, maxDistance, context));
+}
+
+/******************************************************************************/
+
+unsigned int LinkageStatistics::rm(const vector< pair<size_t, size_t> >& incompatiblePairs)
+{
+  vector< pair<size_t, size_t> > intervals(incompatiblePairs);
+  sort(intervals.begin(), intervals.end(),
+      [](const pair<size_t, size_t>& a, const pair<size_t, size_t>& b) {
+        return a.second < b.second;
+      });
+  unsigned int count = 0;
+  bool any = false;
+  size_t lastEnd = 0;
+  for (const auto& interval : intervals)
+  {
+    if (!any || interval.first >= lastEnd)
+    {
+      count++;
+      lastEnd = interval.second;
+      any = true;
+    }
+  }
+  return count;
+}
+
+/******************************************************************************/
+
+LinkageStatistics::LdTests LinkageStatistics::ldTests_(
+    const HaplotypeMatrix& hm,
+    size_t firstSnp,
+    size_t nbSnps,
+    Workspace& workspace)
+{
+  LdTests tests;
+  tests.firstSnp = firstSnp;
+  tests.lastSnp = nbSnps > 0 ? firstSnp + nbSnps - 1 : firstSnp;
+  tests.ZnS = NAN;
+  tests.ZA = NAN;
+  tests.wallB = NAN;
+  tests.wallQ = NAN;
+  if (nbSnps == 0)
+    return tests;
+
+  size_t nbWords = hm.getNumberOfWords();
+  size_t nbHaplotypes = hm.getNumberOfHaplotypes();
+  double n = static_cast<double>(nbHaplotypes);
+  vector<size_t>& derived = workspace.derived;
+  derived.resize(nbSnps);
+  for (size_t i = 0; i < nbSnps; ++i)
+  {
+    derived[i] = HaplotypeMatrix::popCount(hm.column(firstSnp + i), nbWords);
+  }
+
+  // Partitions defined by the congruent adjacent pairs, complemented so that
+  // the first haplotype is never in the derived group.
+  vector<uint64_t>& partitions = workspace.partitions;
+  partitions.clear();
+  vector<uint64_t>& fullMask = workspace.fullMask;
+  hm.getFullMask(fullMask);
+  double sumR2 = 0., sumAdjacentR2 = 0.;
+  size_t nbCongruent = 0;
+  for (size_t i = 0; i < nbSnps; ++i)
+  {
+    const uint64_t* colI = hm.column(firstSnp + i);
+    double pI = static_cast<double>(derived[i]) / n;
+    for (size_t j = i + 1; j < nbSnps; ++j)
+    {
+      const uint64_t* colJ = hm.column(firstSnp + j);
+      size_t both = 0;
+      for (size_t w = 0; w < nbWords; ++w)
+      {
+        both += HaplotypeMatrix::popCount(colI[w] & colJ[w]);
+      }
+      double pJ = static_cast<double>(derived[j]) / n;
+      double d = static_cast<double>(both) / n - pI * pJ;
+      double r2 = d * d / (pI * (1. - pI) * pJ * (1. - pJ));
+      sumR2 += r2;
+      if (j == i + 1)
+      {
+        sumAdjacentR2 += r2;
+        bool same = (both == derived[i] && both == derived[j]);
+        bool complementary = (both == 0 && derived[i] + derived[j] == nbHaplotypes);
+        if (same || complementary)
+        {
+          nbCongruent++;
+          bool complement = nbWords > 0 && (colI[0] & 1) != 0;
+          for (size_t w = 0; w < nbWords; ++w)
+          {
+            partitions.push_back(complement ? ~colI[w] & fullMask[w] : colI[w]);
+          }
+        }
+      }
+    }
+  }
+  // Count the distinct partitions, sorted by their words.
+  vector<size_t>& order = workspace.order;
+  order.resize(nbCongruent);
+  for (size_t k = 0; k < nbCongruent; ++k)
+  {
+    order[k] = k;
+  }
+  auto partition = [&](size_t k) {
+        return partitions.begin() + static_cast<ptrdiff_t>(k * nbWords);
+      };
+  sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return lexicographical_compare(partition(a), partition(a + 1), partition(b), partition(b + 1));
+      });
+  size_t nbPartitions = 0;
+  for (size_t k = 0; k < nbCongruent; ++k)
+  {
+    if (k == 0 || !equal(partition(order[k]), partition(order[k] + 1), partition(order[k - 1])))
+      nbPartitions++;
+  }
+
+  double s = static_cast<double>(nbSnps);
+  tests.wallQ = (static_cast<double>(nbCongruent) + static_cast<double>(nbPartitions)) / s;
+  if (nbSnps < 2)
+    return tests;
+  tests.ZnS = 2. * sumR2 / (s * (s - 1.));
+  tests.ZA = sumAdjacentR2 / (s - 1.);
+  tests.wallB = static_cast<double>(nbCongruent) / (s - 1.);
+  return tests;
+}
+
+/******************************************************************************/
@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _LINKAGESTATISTICS_H_
+#define _LINKAGESTATISTICS_H_
+
+#include <Bpp/Exceptions.h>
+
+// From local
+#include "HaplotypeMatrix.h"
+#include "ExecutionContext.h"
+
+// From the STL
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Neutrality tests based on linkage disequilibrium.
+ *
+ * The tests are computed on a range of SNPs of a HaplotypeMatrix, in a
+ * single pass over the pairs of SNPs of the range. For each pair, the
+ * haplotype counts come from the population count of the AND of both
+ * bit columns.
+ *
+ * - ZnS is the mean r^2 over all the pairs of SNPs (Kelly 1997).
+ * - ZA is the mean r^2 over the pairs of adjacent SNPs (Rozas et al. 2001).
+ * - Wall's B is the proportion of congruent pairs among the pairs of
+ *   adjacent SNPs, two SNPs being congruent when they split the haplotypes
+ *   in the same two groups (Wall 1999).
+ * - Wall's Q is (B' + A) / S, where B' is the number of congruent adjacent
+ *   pairs, A the number of distinct partitions of the haplotypes defined
+ *   by these pairs and S the number of SNPs (Wall 1999).
+ *
+ * A statistic that is not defined (less than two SNPs, or no SNP for Q)
+ * is set to NaN.
+ *
+ * The class also provides the minimum number of recombination events Rm,
+ * from the four-gamete test of the pairs of SNPs (Hudson and Kaplan 1985).
+ *
+ * References:
+ * - Hudson and Kaplan 1985, Genetics 111:147-164.
+ * - Kelly 1997, Genetics 146:1197-1206.
+ * - Rozas et al. 2001, Genetics 158:1147-1155.
+ * - Wall 1999, Genetical Research 74:65-79.
+ */
+class LinkageStatistics
+{
+public:
+  /**
+   * @brief The tests computed on a range of SNPs.
+   */
+  struct LdTests
+  {
+    size_t firstSnp;
+    size_t lastSnp;
+    double ZnS;
+    double ZA;
+    double wallB;
+    double wallQ;
+  };
+
+  /**
+   * @brief The buffers of the tests, reused from one call to the next.
+   */
+  struct Workspace
+  {
+    std::vector<size_t> derived;
+    std::vector<uint64_t> fullMask;
+    // The partitions of the congruent pairs, one after the other.
+    std::vector<uint64_t> partitions;
+    std::vector<size_t> order;
+
+    Workspace() : derived(), fullMask(), partitions(), order() {}
+  };
+
+public:
+  // Class destructor
+  virtual ~LinkageStatistics() {}
+
+  /**
+   * @brief Compute the tests on all the SNPs of a HaplotypeMatrix.
+   *
+   * @param hm The haplotypes.
+   */
+  static LdTests ldTests(const HaplotypeMatrix& hm);
+
+  /**
+   * @brief Compute the tests on all the SNPs of a HaplotypeMatrix, with given buffers.
+   *
+   * @param hm The haplotypes.
+   * @param workspace The buffers, which can be reused for another matrix.
+   */
+  static LdTests ldTests(const HaplotypeMatrix& hm, Workspace& workspace);
+
+  /**
+   * @brief Compute the tests on a range of SNPs.
+   *
+   * @param hm The haplotypes.
+   * @param firstSnp The first SNP of the range.
+   * @param lastSnp The last SNP of the range (included).
+   * @throw IndexOutOfBoundsException if lastSnp excedes the number of SNPs.
+   * @throw BadIntegerException if firstSnp > lastSnp.
+   */
+  static LdTests ldTests(
+      const HaplotypeMatrix& hm,
+      size_t firstSnp,
+      size_t lastSnp);
+
+  /**
+   * @brief Compute the tests in sliding windows of SNPs.
+   *
+   * Windows are made of windowSize consecutive SNPs and start every step
+   * SNPs. Only full windows are computed.
+   *
+   * @param hm The haplotypes.
+   * @param windowSize The number of SNPs in a window.
+   * @param step The number of SNPs between the starts of two windows.
+   * @param context The ExecutionContext used to scan the windows.
+   * @throw BadIntegerException if windowSize or step is 0.
+   */
+  static std::vector<LdTests> ldTestsInWindows(
+      const HaplotypeMatrix& hm,
+      size_t windowSize,
+      size_t step,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Compute the tests on all the SNPs of each of a set of replicates.
+   *
+   * @param replicates The haplotypes of each replicate.
+   * @param context The ExecutionContext used to scan the replicates.
+   */
+  static std::vector<LdTests> ldTests(
+      const std::vector<HaplotypeMatrix>& replicates,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Find the pairs of SNPs failing the four-gamete test.
+   *
+   * A pair fails the test when the four haplotypes 00, 01, 10 and 11 are
+   * all observed, which requires at least one recombination event between
+   * the two SNPs under the infinite sites model.
+   *
+   * @param hm The haplotypes.
+   * @param maxDistance Only the pairs of SNPs whose positions differ by at most maxDistance are tested.
+   * @param context The ExecutionContext used to scan the SNPs.
+   * @return The incompatible pairs (i, j), with i < j, sorted.
+   */
+  static std::vector< std::pair<size_t, size_t> > fourGameteTest(
+      const HaplotypeMatrix& hm,
+      double maxDistance = std::numeric_limits<double>::infinity(),
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Compute the minimum number of recombination events Rm.
+   *
+   * @param hm The haplotypes.
+   * @param maxDistance Only the pairs of SNPs whose positions differ by at most maxDistance are tested.
+   * @param context The ExecutionContext used to scan the SNPs.
+   * @see fourGameteTest()
+   */
+  static unsigned int rm(
+      const HaplotypeMatrix& hm,
+      double maxDistance = std::numeric_limits<double>::infinity(),
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Compute Rm from the incompatible pairs of SNPs.
+   *
+   * Rm is the maximum number of disjoint intervals among the incompatible
+   * pairs, found with the greedy algorithm: the intervals are taken by
+   * increasing right end, each one that starts at or after the right end
+   * of the last one kept is kept.
+   *
+   * @param incompatiblePairs The incompatible pairs (i, j), with i < j.
+   */
+  static unsigned int rm(
+      const std::vector< std::pair<size_t, size_t> >& incompatiblePairs);
+
+private:
+  /**
+   * @brief Compute the tests on nbSnps SNPs from firstSnp, without checking them.
+   */
+  static LdTests ldTests_(
+      const HaplotypeMatrix& hm,
+      size_t firstSnp,
+      size_t nbSnps,
+      Workspace& workspace);
+};
+} // end of namespace bpp;
+
+#endif // _LINKAGESTATISTICS_H_
@@ -55,3 +55,16 @@ unsigned int LocusInfo::getAlleleInfoKey(const std::string& id) const
   }
   throw AlleleNotFoundException("LocusInfo::getAlleleInfoKey: AlleleInfo id not found.", id);
 }
+
+MemoryUsage LocusInfo::memoryUsage() const
+{
+  MemoryUsage usage;
+  usage.add(MemoryUsage::NAMES, MemoryUsage::ofString(name_) + MemoryUsage::ofString(chromosome_));
+  size_t bytes = sizeof(*this) + MemoryUsage::ofVector(alleles_);
+  for (size_t i = 0; i < alleles_.size(); ++i)
+  {
+    bytes += alleles_[i]->memoryUsage();
+  }
+  usage.add(MemoryUsage::ALLELE_INFO, bytes);
+  return usage;
+}
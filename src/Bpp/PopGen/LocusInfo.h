@@ -13,6 +13,7 @@
 // From local bpp-popgen
 #include "AlleleInfo.h"
 #include "GeneralExceptions.h"
+#include "MemoryUsage.h"
 
 #include <Bpp/Exceptions.h>
 
@@ -24,6 +25,11 @@ namespace bpp
  * This is an AlleleInfo container with additionnal data like a name,
  * the ploidy and some comments.
  *
+ * A locus may also have genomic coordinates, a chromosome and a position
+ * on it, so that loci can be ordered and grouped in windows (see
+ * AnalyzedLoci::getWindows()). A locus without chromosome has no
+ * coordinates.
+ *
  * @author Sylvain Gaillard
  */
 class LocusInfo :
@@ -33,6 +39,8 @@ private:
   std::string name_;
   unsigned int ploidy_;
   std::vector<std::unique_ptr<AlleleInfo>> alleles_;
+  std::string chromosome_;
+  size_t position_;
 
 public:
   static unsigned int HAPLODIPLOID;
@@ -51,7 +59,9 @@ public:
   LocusInfo(const std::string& name, const unsigned int ploidy = DIPLOID) :
     name_(name),
     ploidy_(ploidy),
-    alleles_()
+    alleles_(),
+    chromosome_(),
+    position_(0)
   {}
 
   /**
@@ -60,7 +70,9 @@ public:
   LocusInfo(const LocusInfo& locusInfo) :
     name_(locusInfo.name_),
     ploidy_(locusInfo.ploidy_),
-    alleles_(locusInfo.getNumberOfAlleles())
+    alleles_(locusInfo.getNumberOfAlleles()),
+    chromosome_(locusInfo.chromosome_),
+    position_(locusInfo.position_)
   {
     for (unsigned int i = 0; i < locusInfo.getNumberOfAlleles(); ++i)
     {
@@ -72,6 +84,8 @@ public:
   {
     name_ = locusInfo.name_;
     ploidy_ = locusInfo.ploidy_;
+    chromosome_ = locusInfo.chromosome_;
+    position_ = locusInfo.position_;
     alleles_.resize(locusInfo.getNumberOfAlleles());
     for (unsigned int i = 0; i < locusInfo.getNumberOfAlleles(); ++i)
     {
@@ -100,6 +114,33 @@ public:
    */
   unsigned int getPloidy() const { return ploidy_; }
 
+  /**
+   * @brief Tell if the locus has genomic coordinates.
+   */
+  bool hasCoordinates() const { return !chromosome_.empty(); }
+
+  /**
+   * @brief Get the chromosome of the locus, empty if unknown.
+   */
+  const std::string& getChromosome() const { return chromosome_; }
+
+  /**
+   * @brief Get the position of the locus on its chromosome.
+   */
+  size_t getPosition() const { return position_; }
+
+  /**
+   * @brief Set the genomic coordinates of the locus.
+   *
+   * @param chromosome The chromosome, or an empty string to remove the coordinates.
+   * @param position The position on the chromosome.
+   */
+  void setCoordinates(const std::string& chromosome, size_t position)
+  {
+    chromosome_ = chromosome;
+    position_ = chromosome.empty() ? 0 : position;
+  }
+
   /**
    * @brief Add an AlleleInfo to the LocusInfo.
    *
@@ -137,6 +178,14 @@ public:
    * @brief Delete all alleles from the locus.
    */
   void clear() { alleles_.clear(); }
+
+  /**
+   * @brief Get the estimated memory footprint of this locus.
+   *
+   * The locus name is reported as MemoryUsage::NAMES, the rest as
+   * MemoryUsage::ALLELE_INFO.
+   */
+  MemoryUsage memoryUsage() const;
 };
 } // end of namespace bpp;
 
@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "MemoryUsage.h"
+
+#include <algorithm>
+
+using namespace bpp;
+using namespace std;
+
+const string MemoryUsage::SEQUENCES = "sequences";
+const string MemoryUsage::SITES = "sites";
+const string MemoryUsage::GENOTYPES = "genotypes";
+const string MemoryUsage::ALLELE_INFO = "allele info";
+const string MemoryUsage::NAMES = "names";
+const string MemoryUsage::INDIVIDUALS = "individuals";
+
+atomic<MemoryTracker*> MemoryTracker::globalTracker_(nullptr);
+
+/******************************************************************************/
+
+size_t MemoryUsage::get(const string& component) const
+{
+  auto it = components_.find(component);
+  return it == components_.end() ? 0 : it->second;
+}
+
+/******************************************************************************/
+
+vector<string> MemoryUsage::getComponents() const
+{
+  vector<string> names;
+  for (const auto& it : components_)
+  {
+    names.push_back(it.first);
+  }
+  return names;
+}
+
+/******************************************************************************/
+
+size_t MemoryUsage::getTotal() const
+{
+  size_t total = 0;
+  for (const auto& it : components_)
+  {
+    total += it.second;
+  }
+  return total;
+}
+
+/******************************************************************************/
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& usage)
+{
+  for (const auto& it : usage.components_)
+  {
+    components_[it.first] += it.second;
+  }
+  return *this;
+}
+
+/******************************************************************************/
+
+MemoryUsage& MemoryUsage::operator-=(const MemoryUsage& usage)
+{
+  for (const auto& it : usage.components_)
+  {
+    size_t& bytes = components_[it.first];
+    bytes -= min(it.second, bytes);
+  }
+  return *this;
+}
+
+/******************************************************************************/
+
+void MemoryTracker::allocate(const MemoryUsage& usage)
+{
+  lock_guard<mutex> lock(mutex_);
+  for (const auto& component : usage.getComponents())
+  {
+    size_t bytes = usage.get(component);
+    size_t& current = current_[component];
+    current += bytes;
+    size_t& peak = peak_[component];
+    if (current > peak)
+      peak = current;
+    currentTotal_ += bytes;
+  }
+  if (currentTotal_ > peakTotal_)
+    peakTotal_ = currentTotal_;
+}
+
+/******************************************************************************/
+
+void MemoryTracker::release(const MemoryUsage& usage)
+{
+  lock_guard<mutex> lock(mutex_);
+  for (const auto& component : usage.getComponents())
+  {
+    size_t& current = current_[component];
+    size_t bytes = min(usage.get(component), current);
+    current -= bytes;
+    currentTotal_ -= bytes;
+  }
+}
+
+/******************************************************************************/
+
+size_t MemoryTracker::getCurrent() const
+{
+  lock_guard<mutex> lock(mutex_);
+  return currentTotal_;
+}
+
+size_t MemoryTracker::getCurrent(const string& component) const
+{
+  lock_guard<mutex> lock(mutex_);
+  auto it = current_.find(component);
+  return it == current_.end() ? 0 : it->second;
+}
+
+/******************************************************************************/
+
+size_t MemoryTracker::getPeak() const
+{
+  lock_guard<mutex> lock(mutex_);
+  return peakTotal_;
+}
+
+size_t MemoryTracker::getPeak(const string& component) const
+{
+  lock_guard<mutex> lock(mutex_);
+  auto it = peak_.find(component);
+  return it == peak_.end() ? 0 : it->second;
+}
+
+/******************************************************************************/
+
+void MemoryTracker::resetPeak()
+{
+  lock_guard<mutex> lock(mutex_);
+  peak_ = current_;
+  peakTotal_ = currentTotal_;
+}
+
+/******************************************************************************/
+
+void TrackedMemoryUsage::report(const MemoryUsage& released, const MemoryUsage& allocated)
+{
+  if (!MemoryTracker::isTracking())
+    return;
+  // Only what has been reported can be released, for instance if the
+  // tracker was installed after the released object was added.
+  MemoryUsage freed;
+  for (const auto& component : released.getComponents())
+  {
+    freed.add(component, min(released.get(component), reported_.get(component)));
+  }
+  MemoryTracker::notifyRelease(freed);
+  MemoryTracker::notifyAllocation(allocated);
+  reported_ -= freed;
+  reported_ += allocated;
+}
+
+/******************************************************************************/
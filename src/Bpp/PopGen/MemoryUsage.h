@@ -0,0 +1,258 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _MEMORYUSAGE_H_
+#define _MEMORYUSAGE_H_
+
+// From the STL
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Estimated memory footprint of a data structure, by component.
+ *
+ * Values are numbers of bytes, estimated from the size of the objects
+ * and the capacity of their buffers. The overhead of the memory
+ * allocator is not taken into account.
+ */
+class MemoryUsage
+{
+public:
+  static const std::string SEQUENCES;
+  static const std::string SITES;
+  static const std::string GENOTYPES;
+  static const std::string ALLELE_INFO;
+  static const std::string NAMES;
+  static const std::string INDIVIDUALS;
+
+private:
+  std::map<std::string, size_t> components_;
+
+public:
+  MemoryUsage() : components_() {}
+
+public:
+  /**
+   * @brief Add a number of bytes to a component.
+   */
+  void add(const std::string& component, size_t bytes)
+  {
+    components_[component] += bytes;
+  }
+
+  /**
+   * @brief Get the number of bytes of a component (0 if absent).
+   */
+  size_t get(const std::string& component) const;
+
+  /**
+   * @brief Get the names of the components.
+   */
+  std::vector<std::string> getComponents() const;
+
+  /**
+   * @brief Get the sum over all the components.
+   */
+  size_t getTotal() const;
+
+  MemoryUsage& operator+=(const MemoryUsage& usage);
+
+  /**
+   * @brief Remove the bytes of another usage, components never going below 0.
+   */
+  MemoryUsage& operator-=(const MemoryUsage& usage);
+
+  /**
+   * @brief Estimated footprint of the buffer of a string.
+   */
+  static size_t ofString(const std::string& str)
+  {
+    return str.capacity() + 1;
+  }
+
+  /**
+   * @brief Estimated footprint of the buffer of a vector.
+   */
+  template<class T>
+  static size_t ofVector(const std::vector<T>& vect)
+  {
+    return vect.capacity() * sizeof(T);
+  }
+
+  static size_t ofVector(const std::vector<bool>& vect)
+  {
+    return (vect.capacity() + 7) / 8;
+  }
+};
+
+/**
+ * @brief Records the current and peak memory footprint of the library containers.
+ *
+ * A tracker can be fed explicitly with allocate() and release(), or
+ * installed as the global tracker with setGlobalTracker().
+ *
+ * The following containers notify the global tracker:
+ * - the PolymorphismMultiGContainer reports the footprint of each
+ *   MultilocusGenotype when it is added to or removed from the container;
+ * - the PolymorphismSequenceContainer reports the footprint of each
+ *   sequence when it is added or removed, and its whole footprint when it
+ *   is built, assigned or cleared;
+ * - the DataSet reports the groups, individuals and loci when they are
+ *   added, removed or modified through its methods.
+ *
+ * Changes made in place to an object already in a container (a genotype
+ * of a PolymorphismMultiGContainer, the sites of a
+ * PolymorphismSequenceContainer, ...) are not reported. The other
+ * structures have to give their memoryUsage() to allocate() and
+ * release() explicitly.
+ *
+ * All methods are thread-safe.
+ */
+class MemoryTracker
+{
+private:
+  mutable std::mutex mutex_;
+  std::map<std::string, size_t> current_;
+  std::map<std::string, size_t> peak_;
+  size_t currentTotal_;
+  size_t peakTotal_;
+
+  static std::atomic<MemoryTracker*> globalTracker_;
+
+public:
+  MemoryTracker() :
+    mutex_(),
+    current_(),
+    peak_(),
+    currentTotal_(0),
+    peakTotal_(0)
+  {}
+
+  MemoryTracker(const MemoryTracker&) = delete;
+  MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+  virtual ~MemoryTracker() {}
+
+public:
+  /**
+   * @brief Record new memory, and update the peaks.
+   */
+  void allocate(const MemoryUsage& usage);
+
+  /**
+   * @brief Record freed memory.
+   *
+   * Components never go below 0.
+   */
+  void release(const MemoryUsage& usage);
+
+  size_t getCurrent() const;
+  size_t getCurrent(const std::string& component) const;
+
+  /**
+   * @brief Get the highest total recorded since construction or last resetPeak().
+   */
+  size_t getPeak() const;
+
+  /**
+   * @brief Get the highest value recorded for a component.
+   */
+  size_t getPeak(const std::string& component) const;
+
+  /**
+   * @brief Set the peaks to the current values.
+   */
+  void resetPeak();
+
+  /**
+   * @brief Install the tracker notified by the containers.
+   *
+   * The tracker is not owned, and must be uninstalled (with nullptr)
+   * before it is destroyed.
+   */
+  static void setGlobalTracker(MemoryTracker* tracker) { globalTracker_ = tracker; }
+
+  static MemoryTracker* getGlobalTracker() { return globalTracker_; }
+
+  /**
+   * @brief Forward an allocation to the global tracker, if any.
+   */
+  static void notifyAllocation(const MemoryUsage& usage)
+  {
+    MemoryTracker* tracker = globalTracker_;
+    if (tracker)
+      tracker->allocate(usage);
+  }
+
+  /**
+   * @brief Forward a release to the global tracker, if any.
+   */
+  static void notifyRelease(const MemoryUsage& usage)
+  {
+    MemoryTracker* tracker = globalTracker_;
+    if (tracker)
+      tracker->release(usage);
+  }
+
+  /**
+   * @brief Tell if a global tracker is installed.
+   *
+   * Containers use it to avoid computing footprints when nobody listens.
+   */
+  static bool isTracking() { return globalTracker_ != nullptr; }
+};
+
+/**
+ * @brief The footprint that a container has reported to the global tracker.
+ *
+ * A container reports the changes of its footprint with report(), and
+ * what it has reported is released when it is destroyed, so that the
+ * tracker balances even if the estimates of the changes drift. A copy
+ * starts with nothing reported.
+ */
+class TrackedMemoryUsage
+{
+private:
+  MemoryUsage reported_;
+
+public:
+  TrackedMemoryUsage() : reported_() {}
+
+  TrackedMemoryUsage(const TrackedMemoryUsage&) : reported_() {}
+
+  TrackedMemoryUsage& operator=(const TrackedMemoryUsage&) { return *this; }
+
+  virtual ~TrackedMemoryUsage() { MemoryTracker::notifyRelease(reported_); }
+
+public:
+  /**
+   * @brief Report a change of footprint to the global tracker, if any.
+   *
+   * The released bytes are limited to what has been reported.
+   *
+   * @param released The bytes freed by the change.
+   * @param allocated The bytes used by the change.
+   */
+  void report(const MemoryUsage& released, const MemoryUsage& allocated);
+
+  /**
+   * @brief Report a change replacing all what has been reported so far.
+   *
+   * @param allocated The new footprint of the container.
+   */
+  void reportAll(const MemoryUsage& allocated)
+  {
+    report(MemoryUsage(reported_), allocated);
+  }
+
+  const MemoryUsage& getReported() const { return reported_; }
+};
+} // end of namespace bpp;
+
+#endif // _MEMORYUSAGE_H_
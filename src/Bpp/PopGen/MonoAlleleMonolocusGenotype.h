@@ -61,6 +61,21 @@ public:
    * @{
    */
   std::vector<size_t> getAlleleIndex() const override;
+
+  size_t getNumberOfAlleles() const override
+  {
+    return 1;
+  }
+
+  size_t getAlleleIndexAt(size_t /* position */) const override
+  {
+    return alleleIndex_;
+  }
+
+  size_t memoryUsage() const override
+  {
+    return sizeof(*this);
+  }
   /** @} */
 
   /**
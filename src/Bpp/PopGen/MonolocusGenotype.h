@@ -10,6 +10,9 @@
 
 #include <Bpp/Clonable.h>
 
+// From local
+#include "GenotypeArena.h"
+
 namespace bpp
 {
 /**
@@ -22,7 +25,8 @@ namespace bpp
  * @author Sylvain Gaillard
  */
 class MonolocusGenotypeInterface :
-  public virtual Clonable
+  public virtual Clonable,
+  public ArenaAllocated
 {
 public:
   MonolocusGenotypeInterface* clone() const override = 0;
@@ -39,6 +43,32 @@ public:
    * The size of the vector corresponds to the number of alleles at this locus.
    */
   virtual std::vector<size_t> getAlleleIndex() const = 0;
+
+  /**
+   * @brief Get the number of alleles, without building the index vector.
+   */
+  virtual size_t getNumberOfAlleles() const
+  {
+    return getAlleleIndex().size();
+  }
+
+  /**
+   * @brief Get the index of one allele, without building the index vector.
+   *
+   * The position is not checked: it must be lower than getNumberOfAlleles().
+   */
+  virtual size_t getAlleleIndexAt(size_t position) const
+  {
+    return getAlleleIndex()[position];
+  }
+
+  /**
+   * @brief Get the estimated number of bytes used by this genotype.
+   */
+  virtual size_t memoryUsage() const
+  {
+    return sizeof(MonolocusGenotypeInterface) + getAlleleIndex().size() * sizeof(size_t);
+  }
 };
 } // end of namespace bpp;
 
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "MsReplicateReader.h"
+
+// From the STL
+#include <cstdlib>
+#include <sstream>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+MsReplicateReader::MsReplicateReader(istream& input, size_t nbHaplotypes, double sequenceLength) :
+  input_(input),
+  nbHaplotypes_(nbHaplotypes),
+  sequenceLength_(sequenceLength),
+  nbReplicates_(0),
+  firstLine_(true),
+  pending_(false),
+  line_(),
+  positions_(),
+  rows_()
+{}
+
+/******************************************************************************/
+
+bool MsReplicateReader::readLine_()
+{
+  if (pending_)
+  {
+    pending_ = false;
+    return true;
+  }
+  if (!getline(input_, line_))
+    return false;
+  if (firstLine_)
+  {
+    firstLine_ = false;
+    // Command line: program nsam nreps ...
+    if (nbHaplotypes_ == 0 && line_.compare(0, 2, "//") != 0)
+    {
+      istringstream iss(line_);
+      string program;
+      long nsam = 0;
+      if (iss >> program >> nsam && nsam > 0)
+        nbHaplotypes_ = static_cast<size_t>(nsam);
+    }
+  }
+  return true;
+}
+
+/******************************************************************************/
+
+bool MsReplicateReader::nextReplicate(HaplotypeMatrix& replicate)
+{
+  // Start of the replicate
+  do
+  {
+    if (!readLine_())
+      return false;
+  }
+  while (line_.compare(0, 2, "//") != 0);
+
+  do
+  {
+    if (!readLine_())
+      throw IOException("MsReplicateReader::nextReplicate: missing 'segsites:' line.");
+  }
+  while (line_.compare(0, 9, "segsites:") != 0);
+  long nbSnps = strtol(line_.c_str() + 9, nullptr, 10);
+  if (nbSnps < 0)
+    throw IOException("MsReplicateReader::nextReplicate: bad number of segregating sites.");
+  size_t s = static_cast<size_t>(nbSnps);
+
+  if (s == 0)
+  {
+    replicate.reset(nbHaplotypes_);
+    nbReplicates_++;
+    return true;
+  }
+
+  do
+  {
+    if (!readLine_())
+      throw IOException("MsReplicateReader::nextReplicate: missing 'positions:' line.");
+  }
+  while (line_.compare(0, 10, "positions:") != 0);
+  positions_.resize(s);
+  const char* cursor = line_.c_str() + 10;
+  for (size_t i = 0; i < s; ++i)
+  {
+    char* end;
+    positions_[i] = strtod(cursor, &end) * sequenceLength_;
+    if (end == cursor)
+      throw IOException("MsReplicateReader::nextReplicate: missing positions.");
+    cursor = end;
+  }
+
+  // Haplotypes
+  size_t n = 0;
+  while (nbHaplotypes_ == 0 || n < nbHaplotypes_)
+  {
+    if (n == rows_.size())
+      rows_.resize(n + 1);
+    if (!getline(input_, rows_[n]))
+      break;
+    if (rows_[n].empty())
+      break;
+    if (rows_[n].compare(0, 2, "//") == 0)
+    {
+      line_ = rows_[n];
+      pending_ = true;
+      break;
+    }
+    n++;
+  }
+  if (nbHaplotypes_ == 0)
+    nbHaplotypes_ = n;
+  else if (n < nbHaplotypes_)
+    throw IOException("MsReplicateReader::nextReplicate: missing haplotypes.");
+
+  replicate.reset(n);
+  for (size_t i = 0; i < s; ++i)
+  {
+    replicate.addSnp(positions_[i]);
+  }
+  for (size_t h = 0; h < n; ++h)
+  {
+    const string& row = rows_[h];
+    if (row.size() < s)
+      throw IOException("MsReplicateReader::nextReplicate: haplotype line too short.");
+    uint64_t bit = static_cast<uint64_t>(1) << (h % 64);
+    size_t word = h / 64;
+    for (size_t i = 0; i < s; ++i)
+    {
+      if (row[i] == '1')
+        replicate.column(i)[word] |= bit;
+      else if (row[i] != '0')
+        throw IOException("MsReplicateReader::nextReplicate: bad character in haplotype line.");
+    }
+  }
+  nbReplicates_++;
+  return true;
+}
+
+/******************************************************************************/
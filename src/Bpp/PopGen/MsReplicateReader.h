@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _MSREPLICATEREADER_H_
+#define _MSREPLICATEREADER_H_
+
+#include <Bpp/Exceptions.h>
+
+// From local
+#include "ReplicateSource.h"
+
+// From the STL
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Streaming reader for the output of ms-like coalescent simulators.
+ *
+ * Each replicate of the ms format (Hudson 2002) starts with a line
+ * beginning with "//", followed by a "segsites:" line, a "positions:" line
+ * and one line of 0 and 1 per haplotype. Other lines (command line, seeds,
+ * "time:" or "prob:" lines) are ignored. The same format is written by
+ * msms, mspms (msprime), discoal and others.
+ *
+ * The replicates are read one at a time, directly into a HaplotypeMatrix,
+ * without building any Sequence or Site object. The 1 state is taken as
+ * the derived allele. The positions of the SNPs are the positions of the
+ * ms output multiplied by a sequence length.
+ *
+ * The number of haplotypes is taken from the constructor, or else from
+ * the second field of the command line (first line of the stream), or
+ * else from the number of haplotype lines of each replicate.
+ *
+ * Reference:
+ * - Hudson 2002, Bioinformatics 18:337-338.
+ */
+class MsReplicateReader :
+  public virtual ReplicateSource
+{
+private:
+  std::istream& input_;
+  size_t nbHaplotypes_;
+  double sequenceLength_;
+  size_t nbReplicates_;
+  bool firstLine_;
+  bool pending_;
+  std::string line_;
+  std::vector<double> positions_;
+  std::vector<std::string> rows_;
+
+public:
+  /**
+   * @brief Build a new reader.
+   *
+   * @param input The stream to read, which must outlive the reader.
+   * @param nbHaplotypes The number of haplotypes per replicate, 0 if unknown.
+   * @param sequenceLength The factor applied to the positions.
+   */
+  MsReplicateReader(std::istream& input, size_t nbHaplotypes = 0, double sequenceLength = 1.);
+
+  MsReplicateReader(const MsReplicateReader&) = delete;
+  MsReplicateReader& operator=(const MsReplicateReader&) = delete;
+
+  virtual ~MsReplicateReader() {}
+
+public:
+  /**
+   * @brief Read the next replicate.
+   *
+   * @param replicate The matrix receiving the replicate.
+   * @return false at the end of the stream.
+   * @throw IOException if the replicate is malformed.
+   */
+  bool nextReplicate(HaplotypeMatrix& replicate);
+
+  /**
+   * @brief Get the number of replicates read so far.
+   */
+  size_t getNumberOfReplicatesRead() const { return nbReplicates_; }
+
+  /**
+   * @brief Get the number of haplotypes per replicate, 0 if still unknown.
+   */
+  size_t getNumberOfHaplotypes() const { return nbHaplotypes_; }
+
+private:
+  /**
+   * @brief Read the next line in line_, or take the pending one.
+   *
+   * @return false at the end of the stream.
+   */
+  bool readLine_();
+};
+} // end of namespace bpp;
+
+#endif // _MSREPLICATEREADER_H_
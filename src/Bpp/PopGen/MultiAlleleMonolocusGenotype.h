@@ -74,6 +74,21 @@ public:
     return alleleIndex_;
   }
 
+  size_t getNumberOfAlleles() const override
+  {
+    return alleleIndex_.size();
+  }
+
+  size_t getAlleleIndexAt(size_t position) const override
+  {
+    return alleleIndex_[position];
+  }
+
+  size_t memoryUsage() const override
+  {
+    return sizeof(*this) + alleleIndex_.capacity() * sizeof(size_t);
+  }
+
   /** @} */
 
   /**
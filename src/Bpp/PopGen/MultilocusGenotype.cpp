@@ -163,3 +163,16 @@ size_t MultilocusGenotype::countHeterozygousLoci() const
   }
   return count;
 }
+
+MemoryUsage MultilocusGenotype::memoryUsage() const
+{
+  MemoryUsage usage;
+  size_t bytes = sizeof(*this) + MemoryUsage::ofVector(loci_);
+  for (size_t i = 0; i < loci_.size(); i++)
+  {
+    if (loci_[i])
+      bytes += loci_[i]->memoryUsage();
+  }
+  usage.add(MemoryUsage::GENOTYPES, bytes);
+  return usage;
+}
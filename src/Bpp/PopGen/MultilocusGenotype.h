@@ -18,6 +18,8 @@
 #include "BiAlleleMonolocusGenotype.h"
 #include "MonoAlleleMonolocusGenotype.h"
 #include "LocusInfo.h"
+#include "MemoryUsage.h"
+#include "GenotypeArena.h"
 
 namespace bpp
 {
@@ -29,7 +31,8 @@ namespace bpp
  * @author Sylvain Gaillard
  */
 class MultilocusGenotype :
-  public virtual Clonable
+  public virtual Clonable,
+  public ArenaAllocated
 {
 private:
   std::vector<std::unique_ptr<MonolocusGenotypeInterface>> loci_;
@@ -102,6 +105,18 @@ public:
    */
   const MonolocusGenotypeInterface& monolocusGenotype(size_t locusPosition) const;
 
+  /**
+   * @brief Get a MonolocusGenotype without bounds checking.
+   *
+   * Intended for loops which already checked that locusPosition < size().
+   *
+   * @return A pointer to the MonolocusGenotype, or nullptr if it is missing.
+   */
+  const MonolocusGenotypeInterface* monolocusGenotypeUnchecked(size_t locusPosition) const
+  {
+    return loci_[locusPosition].get();
+  }
+
   /**
    * @brief Count the number of loci.
    *
@@ -123,6 +138,13 @@ public:
    * @brief Count the number of heterozygous MonolocusGenotype.
    */
   size_t countHeterozygousLoci() const;
+
+  /**
+   * @brief Get the estimated memory footprint of this genotype.
+   *
+   * Everything is reported as MemoryUsage::GENOTYPES.
+   */
+  MemoryUsage memoryUsage() const;
 };
 } // end of namespace bpp;
 
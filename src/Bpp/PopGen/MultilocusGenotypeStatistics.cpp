@@ -15,6 +15,8 @@
 #include "MultilocusGenotypeStatistics.h"
 #include "PolymorphismMultiGContainerTools.h"
 
+#include <Bpp/Numeric/Random/RandomTools.h>
+
 using namespace bpp;
 
 // From STL
@@ -25,12 +27,12 @@ using namespace bpp;
 
 using namespace std;
 
-vector<size_t> MultilocusGenotypeStatistics::getAllelesIdsForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+vector<size_t> MultilocusGenotypeStatistics::getAllelesIdsForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   map<size_t, size_t> tmp_alleles;
   try
   {
-    tmp_alleles = getAllelesMapForGroups(pmgc, locusPosition, groups);
+    tmp_alleles = getAllelesMapForGroups(pmgc, locusPosition, groups, individualMask);
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -39,13 +41,13 @@ vector<size_t> MultilocusGenotypeStatistics::getAllelesIdsForGroups(const Polymo
   return MapTools::getKeys(tmp_alleles);
 }
 
-size_t MultilocusGenotypeStatistics::countGametesForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+size_t MultilocusGenotypeStatistics::countGametesForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   map<size_t, size_t> allele_count;
   size_t nb_tot_allele = 0;
   try
   {
-    allele_count = getAllelesMapForGroups(pmgc, locusPosition, groups);
+    allele_count = getAllelesMapForGroups(pmgc, locusPosition, groups, individualMask);
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -59,39 +61,30 @@ size_t MultilocusGenotypeStatistics::countGametesForGroups(const PolymorphismMul
   return nb_tot_allele;
 }
 
-map<size_t, size_t> MultilocusGenotypeStatistics::getAllelesMapForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+map<size_t, size_t> MultilocusGenotypeStatistics::getAllelesMapForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   map<size_t, size_t> alleles_count;
-  for (size_t i = 0; i < pmgc.size(); i++)
+  for (const auto& entry : locusView_(pmgc, locusPosition, "getAllelesMapForGroups", individualMask))
   {
-    try
+    if (entry.genotype && groups.find(entry.groupId) != groups.end())
     {
-      if (!pmgc.multilocusGenotype(i).isMonolocusGenotypeMissing(locusPosition) &&  (groups.find(pmgc.getGroupId(i)) != groups.end()) )
+      for (size_t j = 0; j < entry.genotype->getNumberOfAlleles(); j++)
       {
-        // if (! pmgc.getMultilocusGenotype(i)->isMonolocusGenotypeMissing(locusPosition) &&  (find(groups.begin(), groups.end(), pmgc.getGroupId(i)) != groups.end()) ) {
-        vector<size_t> tmp_alleles = pmgc.multilocusGenotype(i).monolocusGenotype(locusPosition).getAlleleIndex();
-        for (size_t j = 0; j < tmp_alleles.size(); j++)
-        {
-          alleles_count[tmp_alleles[j]]++;
-        }
+        alleles_count[entry.genotype->getAlleleIndexAt(j)]++;
       }
     }
-    catch (IndexOutOfBoundsException& ioobe)
-    {
-      throw IndexOutOfBoundsException("MultilocusGenotypeStatistics::getAllelesMapForGroups: locusPosition out of bounds.", ioobe.getBadIndex(), ioobe.getBounds()[0], ioobe.getBounds()[1]);
-    }
   }
   return alleles_count;
 }
 
-map<size_t, double> MultilocusGenotypeStatistics::getAllelesFrqForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+map<size_t, double> MultilocusGenotypeStatistics::getAllelesFrqForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   map<size_t, double> alleles_frq;
   size_t nb_tot_allele = 0;
   map<size_t, size_t> tmp_alleles;
   try
   {
-    tmp_alleles = getAllelesMapForGroups(pmgc, locusPosition, groups);
+    tmp_alleles = getAllelesMapForGroups(pmgc, locusPosition, groups, individualMask);
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -111,105 +104,64 @@ map<size_t, double> MultilocusGenotypeStatistics::getAllelesFrqForGroups(const P
   return alleles_frq;
 }
 
-size_t MultilocusGenotypeStatistics::countNonMissingForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+size_t MultilocusGenotypeStatistics::countNonMissingForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   size_t counter = 0;
-  for (size_t i = 0; i < pmgc.size(); i++)
+  for (const auto& entry : locusView_(pmgc, locusPosition, "countNonMissing", individualMask))
   {
-    try
-    {
-      // if (! pmgc.getMultilocusGenotype(i)->isMonolocusGenotypeMissing(locusPosition) &&  (find(groups.begin(), groups.end(), pmgc.getGroupId(i)) != groups.end()) )
-      if (!pmgc.multilocusGenotype(i).isMonolocusGenotypeMissing(locusPosition) &&  (groups.find(pmgc.getGroupId(i) ) != groups.end()) )
-        counter++;
-    }
-    catch (IndexOutOfBoundsException& ioobe)
-    {
-      throw IndexOutOfBoundsException("MultilocusGenotypeStatistics::countNonMissing: locusPosition out of bounds.", ioobe.getBadIndex(), ioobe.getBounds()[0], ioobe.getBounds()[1]);
-    }
+    if (entry.genotype && groups.find(entry.groupId) != groups.end())
+      counter++;
   }
   return counter;
 }
 
-size_t MultilocusGenotypeStatistics::countBiAllelicForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+size_t MultilocusGenotypeStatistics::countBiAllelicForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   size_t counter = 0;
-  for (size_t i = 0; i < pmgc.size(); i++)
+  for (const auto& entry : locusView_(pmgc, locusPosition, "countBiAllelic", individualMask))
   {
-    try
-    {
-      // if (! pmgc.getMultilocusGenotype(i)->isMonolocusGenotypeMissing(locusPosition) && (find(groups.begin(), groups.end(), pmgc.getGroupId(i)) != groups.end()) )
-      if (!pmgc.multilocusGenotype(i).isMonolocusGenotypeMissing(locusPosition) && (groups.find(pmgc.getGroupId(i)) != groups.end()) )
-        if ((pmgc.multilocusGenotype(i).monolocusGenotype(locusPosition).getAlleleIndex()).size() == 2)
-          counter++;
-    }
-    catch (IndexOutOfBoundsException& ioobe)
-    {
-      throw IndexOutOfBoundsException("MultilocusGenotypeStatistics::countBiAllelic: locusPosition out of bounds.", ioobe.getBadIndex(), ioobe.getBounds()[0], ioobe.getBounds()[1]);
-    }
+    if (entry.genotype && groups.find(entry.groupId) != groups.end() && entry.genotype->getNumberOfAlleles() == 2)
+      counter++;
   }
   return counter;
 }
 
-map<size_t, size_t> MultilocusGenotypeStatistics::countHeterozygousForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+map<size_t, size_t> MultilocusGenotypeStatistics::countHeterozygousForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   map<size_t, size_t> counter;
-  for (size_t i = 0; i < pmgc.size(); i++)
+  for (const auto& entry : locusView_(pmgc, locusPosition, "countHeterozygous", individualMask))
   {
-    try
+    if (entry.genotype && groups.find(entry.groupId) != groups.end() && entry.genotype->getNumberOfAlleles() == 2)
     {
-      if (!pmgc.multilocusGenotype(i).isMonolocusGenotypeMissing(locusPosition) && (groups.find(pmgc.getGroupId(i)) != groups.end() ))
+      size_t first = entry.genotype->getAlleleIndexAt(0);
+      size_t second = entry.genotype->getAlleleIndexAt(1);
+      if (first != second)
       {
-        const auto& tmpMg = pmgc.multilocusGenotype(i).monolocusGenotype(locusPosition);
-        if ((tmpMg.getAlleleIndex()).size() == 2)
-        {
-          if (!dynamic_cast<const BiAlleleMonolocusGenotype&>(tmpMg).isHomozygous())
-          {
-            vector<size_t> tmpAlleles = tmpMg.getAlleleIndex();
-            for (size_t j = 0; j < tmpAlleles.size(); j++)
-            {
-              counter[tmpAlleles[j]]++;
-            }
-          }
-        }
+        counter[first]++;
+        counter[second]++;
       }
     }
-    catch (IndexOutOfBoundsException& ioobe)
-    {
-      throw IndexOutOfBoundsException("MultilocusGenotypeStatistics::countHeterozygous: locusPosition out of bounds.", ioobe.getBadIndex(), ioobe.getBounds()[0], ioobe.getBounds()[1]);
-    }
   }
   return counter;
 }
 
-map<size_t, double> MultilocusGenotypeStatistics::getHeterozygousFrqForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+map<size_t, double> MultilocusGenotypeStatistics::getHeterozygousFrqForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   map<size_t, double> freq;
   size_t counter = 0;
-  for (size_t i = 0; i < pmgc.size(); i++)
+  for (const auto& entry : locusView_(pmgc, locusPosition, "getHeterozygousFrqForGroups", individualMask))
   {
-    try
+    if (entry.genotype && groups.find(entry.groupId) != groups.end() && entry.genotype->getNumberOfAlleles() == 2)
     {
-      if (!pmgc.multilocusGenotype(i).isMonolocusGenotypeMissing(locusPosition) && (groups.find(pmgc.getGroupId(i)) != groups.end()) )
+      counter++;
+      size_t first = entry.genotype->getAlleleIndexAt(0);
+      size_t second = entry.genotype->getAlleleIndexAt(1);
+      if (first != second)
       {
-        const auto& tmpMg = pmgc.multilocusGenotype(i).monolocusGenotype(locusPosition);
-        if ((tmpMg.getAlleleIndex()).size() == 2)
-        {
-          counter++;
-          if (!dynamic_cast<const BiAlleleMonolocusGenotype&>(tmpMg).isHomozygous())
-          {
-            vector<size_t> tmpAlleles = tmpMg.getAlleleIndex();
-            for (size_t j = 0; j < tmpAlleles.size(); j++)
-            {
-              freq[tmpAlleles[j]]++;
-            }
-          }
-        }
+        freq[first]++;
+        freq[second]++;
       }
     }
-    catch (IndexOutOfBoundsException& ioobe)
-    {
-      throw IndexOutOfBoundsException("MultilocusGenotypeStatistics::getHeterozygousFrqForGroups: locusPosition out of bounds.", ioobe.getBadIndex(), ioobe.getBounds()[0], ioobe.getBounds()[1]);
-    }
   }
   if (counter == 0)
     throw ZeroDivisionException("MultilocusGenotypeStatistics::getHeterozygousFrqForGroups.");
@@ -220,13 +172,13 @@ map<size_t, double> MultilocusGenotypeStatistics::getHeterozygousFrqForGroups(co
   return freq;
 }
 
-double MultilocusGenotypeStatistics::getHobsForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+double MultilocusGenotypeStatistics::getHobsForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   map<size_t, double> heterozygous_frq;
   double frq = 0.;
   try
   {
-    heterozygous_frq = getHeterozygousFrqForGroups(pmgc, locusPosition, groups);
+    heterozygous_frq = getHeterozygousFrqForGroups(pmgc, locusPosition, groups, individualMask);
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -243,13 +195,13 @@ double MultilocusGenotypeStatistics::getHobsForGroups(const PolymorphismMultiGCo
   return frq / static_cast<double>(heterozygous_frq.size());
 }
 
-double MultilocusGenotypeStatistics::getHexpForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+double MultilocusGenotypeStatistics::getHexpForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   map<size_t, double> allele_frq;
   double frqsqr = 0.;
   try
   {
-    allele_frq = getAllelesFrqForGroups(pmgc, locusPosition, groups);
+    allele_frq = getAllelesFrqForGroups(pmgc, locusPosition, groups, individualMask);
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -266,14 +218,14 @@ double MultilocusGenotypeStatistics::getHexpForGroups(const PolymorphismMultiGCo
   return 1 - frqsqr;
 }
 
-double MultilocusGenotypeStatistics::getHnbForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+double MultilocusGenotypeStatistics::getHnbForGroups(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   size_t nb_alleles;
   double Hexp;
   try
   {
-    nb_alleles = countGametesForGroups(pmgc, locusPosition, groups);
-    Hexp = getHexpForGroups(pmgc, locusPosition, groups);
+    nb_alleles = countGametesForGroups(pmgc, locusPosition, groups, individualMask);
+    Hexp = getHexpForGroups(pmgc, locusPosition, groups, individualMask);
   }
   catch (IndexOutOfBoundsException& ioobe)
   {
@@ -286,7 +238,7 @@ double MultilocusGenotypeStatistics::getHnbForGroups(const PolymorphismMultiGCon
   return 2 * static_cast<double>(nb_alleles) * Hexp  / static_cast<double>((2 * nb_alleles) - 1);
 }
 
-double MultilocusGenotypeStatistics::getDnei72(const PolymorphismMultiGContainer& pmgc, vector<size_t> locusPositions, size_t grp1, size_t grp2)
+double MultilocusGenotypeStatistics::getDnei72(const PolymorphismMultiGContainer& pmgc, vector<size_t> locusPositions, size_t grp1, size_t grp2, const vector<bool>& individualMask)
 {
   map<size_t, double> allele_frq1, allele_frq2;
   vector<size_t> allele_ids;
@@ -307,9 +259,9 @@ double MultilocusGenotypeStatistics::getDnei72(const PolymorphismMultiGContainer
     allele_frq2.clear();
     try
     {
-      allele_ids = getAllelesIdsForGroups(pmgc, locusPositions[i], groups_id);
-      allele_frq1 = getAllelesFrqForGroups(pmgc, locusPositions[i], group1_id);
-      allele_frq2 = getAllelesFrqForGroups(pmgc, locusPositions[i], group2_id);
+      allele_ids = getAllelesIdsForGroups(pmgc, locusPositions[i], groups_id, individualMask);
+      allele_frq1 = getAllelesFrqForGroups(pmgc, locusPositions[i], group1_id, individualMask);
+      allele_frq2 = getAllelesFrqForGroups(pmgc, locusPositions[i], group2_id, individualMask);
     }
     catch (Exception& e)
     {
@@ -331,7 +283,7 @@ double MultilocusGenotypeStatistics::getDnei72(const PolymorphismMultiGContainer
   return -log(Jxy / sqrt(Jx * Jy));
 }
 
-double MultilocusGenotypeStatistics::getDnei78(const PolymorphismMultiGContainer& pmgc, vector<size_t> locusPositions, size_t grp1, size_t grp2)
+double MultilocusGenotypeStatistics::getDnei78(const PolymorphismMultiGContainer& pmgc, vector<size_t> locusPositions, size_t grp1, size_t grp2, const vector<bool>& individualMask)
 {
   map<size_t, double> allele_frq1, allele_frq2;
   vector<size_t> allele_ids;
@@ -353,11 +305,11 @@ double MultilocusGenotypeStatistics::getDnei78(const PolymorphismMultiGContainer
     allele_frq2.clear();
     try
     {
-      allele_ids = getAllelesIdsForGroups(pmgc, locusPositions[i], groups_id);
-      allele_frq1 = getAllelesFrqForGroups(pmgc, locusPositions[i], group1_id);
-      allele_frq2 = getAllelesFrqForGroups(pmgc, locusPositions[i], group2_id);
-      nx = countBiAllelicForGroups(pmgc, locusPositions[i], group1_id);
-      ny = countBiAllelicForGroups(pmgc, locusPositions[i], group2_id);
+      allele_ids = getAllelesIdsForGroups(pmgc, locusPositions[i], groups_id, individualMask);
+      allele_frq1 = getAllelesFrqForGroups(pmgc, locusPositions[i], group1_id, individualMask);
+      allele_frq2 = getAllelesFrqForGroups(pmgc, locusPositions[i], group2_id, individualMask);
+      nx = countBiAllelicForGroups(pmgc, locusPositions[i], group1_id, individualMask);
+      ny = countBiAllelicForGroups(pmgc, locusPositions[i], group2_id, individualMask);
     }
     catch (Exception& e)
     {
@@ -454,13 +406,13 @@ map<size_t, double> MultilocusGenotypeStatistics::getAllelesFis(const Polymorphi
   return Fis;
 }
 
-map<size_t, MultilocusGenotypeStatistics::VarComp> MultilocusGenotypeStatistics::getVarianceComponents(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups)
+map<size_t, MultilocusGenotypeStatistics::VarComp> MultilocusGenotypeStatistics::getVarianceComponents(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const set<size_t>& groups, const vector<bool>& individualMask)
 {
   map<size_t, MultilocusGenotypeStatistics::VarComp> values;
   // Base values computation
   double nbar = 0.;
   double nc = 0.;
-  vector<size_t> ids = getAllelesIdsForGroups(pmgc, locusPosition, groups);
+  vector<size_t> ids = getAllelesIdsForGroups(pmgc, locusPosition, groups, individualMask);
   map<size_t, double> pbar;
   map<size_t, double> s2;
   map<size_t, double> hbar;
@@ -474,11 +426,11 @@ map<size_t, MultilocusGenotypeStatistics::VarComp> MultilocusGenotypeStatistics:
   for (set<size_t>::iterator set_it = groups.begin(); set_it != groups.end(); set_it++)
   {
     size_t i  = (*set_it);
-    double ni = static_cast<double>(pmgc.getLocusGroupSize(i, locusPosition));
     set<size_t> group_id;
     group_id.insert( i );
-    map<size_t, double> pi = getAllelesFrqForGroups(pmgc, locusPosition, group_id);
-    map<size_t, double> hi = getHeterozygousFrqForGroups(pmgc, locusPosition, group_id);
+    double ni = static_cast<double>(countNonMissingForGroups(pmgc, locusPosition, group_id, individualMask));
+    map<size_t, double> pi = getAllelesFrqForGroups(pmgc, locusPosition, group_id, individualMask);
+    map<size_t, double> hi = getHeterozygousFrqForGroups(pmgc, locusPosition, group_id, individualMask);
     nbar += ni;
     if (r > 1)
       nc += ni * ni;
@@ -498,7 +450,7 @@ map<size_t, MultilocusGenotypeStatistics::VarComp> MultilocusGenotypeStatistics:
   if (nbar <= 1)
     throw ZeroDivisionException("MultilocusGenotypeStatistics::getVarianceComponents.");
   if (r > 1)
-    nc = (r * nbar) - (nc / (r * nbar)) / (r - 1.);
+    nc = ((r * nbar) - (nc / (r * nbar))) / (r - 1.);
   for (map<size_t, double>::iterator it = pbar.begin(); it != pbar.end(); it++)
   {
     it->second = it->second / (r * nbar);
@@ -511,10 +463,10 @@ map<size_t, MultilocusGenotypeStatistics::VarComp> MultilocusGenotypeStatistics:
   for (set<size_t>::iterator set_it = groups.begin(); set_it != groups.end(); set_it++)
   {
     size_t i  = (*set_it);
-    double ni = static_cast<double>(pmgc.getLocusGroupSize( i, locusPosition));
     set<size_t> group_id;
     group_id.insert( i );
-    map<size_t, double> pi = getAllelesFrqForGroups(pmgc, locusPosition, group_id);
+    double ni = static_cast<double>(countNonMissingForGroups(pmgc, locusPosition, group_id, individualMask));
+    map<size_t, double> pi = getAllelesFrqForGroups(pmgc, locusPosition, group_id, individualMask);
     for (size_t j = 0; j < ids.size(); j++)
     {
       pi[ids[j]];
@@ -545,177 +497,294 @@ map<size_t, MultilocusGenotypeStatistics::VarComp> MultilocusGenotypeStatistics:
   return values;
 }
 
-double MultilocusGenotypeStatistics::getWCMultilocusFst(const PolymorphismMultiGContainer& pmgc, vector<size_t> locusPositions, const set<size_t>& groups)
+MultilocusGenotypeStatistics::VarComp MultilocusGenotypeStatistics::getLocusVarianceComponents(const PolymorphismMultiGContainer::LocusView& view, const set<size_t>& groups)
 {
-  double A, B, C;
-  A = B = C = 0.0;
-  for (size_t i = 0; i < locusPositions.size(); i++)
+  VarComp sums;
+  sums.a = sums.b = sums.c = 0.;
+  vector<size_t> groupIds(groups.begin(), groups.end());
+  size_t nbGroups = groupIds.size();
+  auto groupIndex = [&](size_t groupId) {
+        auto it = lower_bound(groupIds.begin(), groupIds.end(), groupId);
+        return it != groupIds.end() && *it == groupId ? static_cast<size_t>(it - groupIds.begin()) : nbGroups;
+      };
+
+  // Alleles of the locus in the groups
+  vector<size_t> alleles;
+  for (const auto& entry : view)
   {
-    // count total number of individuals without missing data
-    size_t ni = 0;
-    for (set<size_t>::iterator setIt = groups.begin(); setIt != groups.end(); setIt++)
+    if (!entry.genotype || groupIndex(entry.groupId) == nbGroups)
+      continue;
+    for (size_t allele : entry.genotype->getAlleleIndex())
     {
-      ni += pmgc.getLocusGroupSize( (*setIt), i);
+      if (find(alleles.begin(), alleles.end(), allele) == alleles.end())
+        alleles.push_back(allele);
     }
+  }
+  size_t nbAlleles = alleles.size();
+  if (nbAlleles < 2)
+    return sums;
+  auto alleleIndex = [&](size_t allele) {
+        return static_cast<size_t>(find(alleles.begin(), alleles.end(), allele) - alleles.begin());
+      };
 
-    // reduce computation for polymorphic loci for that groups
-    vector<size_t> ids = getAllelesIdsForGroups(pmgc, i, groups);
-    if (ids.size() >= 2 && ni >= 1)
+  // Count cube: individuals, gametes and diploids per group, alleles and heterozygous genotypes per group and allele.
+  vector<size_t> individuals(nbGroups, 0), gametes(nbGroups, 0), diploids(nbGroups, 0);
+  vector<size_t> counts(nbGroups * nbAlleles, 0), heterozygous(nbGroups * nbAlleles, 0);
+  for (const auto& entry : view)
+  {
+    if (!entry.genotype)
+      continue;
+    size_t g = groupIndex(entry.groupId);
+    if (g == nbGroups)
+      continue;
+    vector<size_t> genotype = entry.genotype->getAlleleIndex();
+    individuals[g]++;
+    gametes[g] += genotype.size();
+    for (size_t allele : genotype)
     {
-      map<size_t, MultilocusGenotypeStatistics::VarComp> values = getVarianceComponents(pmgc, locusPositions[i], groups);
-      for (map<size_t, MultilocusGenotypeStatistics::VarComp>::iterator it = values.begin(); it != values.end(); it++)
+      counts[g * nbAlleles + alleleIndex(allele)]++;
+    }
+    if (genotype.size() == 2)
+    {
+      diploids[g]++;
+      if (genotype[0] != genotype[1])
       {
-        A += it->second.a;
-        B += it->second.b;
-        C += it->second.c;
+        heterozygous[g * nbAlleles + alleleIndex(genotype[0])]++;
+        heterozygous[g * nbAlleles + alleleIndex(genotype[1])]++;
       }
     }
   }
-  if ((A + B + C) == 0)
-    throw ZeroDivisionException("MultilocusGenotypeStatistics::getWCMultilocusFst.");
-  return A / (A + B + C);
-}
 
-double MultilocusGenotypeStatistics::getWCMultilocusFis(const PolymorphismMultiGContainer& pmgc, vector<size_t> locusPositions, const set<size_t>& groups)
-{
-  double B, C;
-  B = C = 0.0;
-  for (size_t i = 0; i < locusPositions.size(); i++)
+  double r = 0., nTotal = 0., nSquares = 0.;
+  for (size_t g = 0; g < nbGroups; ++g)
+  {
+    if (individuals[g] == 0)
+      continue;
+    double n = static_cast<double>(individuals[g]);
+    r++;
+    nTotal += n;
+    nSquares += n * n;
+  }
+  if (r < 2.)
+    return sums;
+  double nbar = nTotal / r;
+  if (nbar <= 1.)
+    return sums;
+  double nc = (nTotal - nSquares / nTotal) / (r - 1.);
+
+  for (size_t u = 0; u < nbAlleles; ++u)
   {
-    // count total number of individuals without missing data
-    size_t ni = 0;
-    for (set<size_t>::iterator setIt = groups.begin(); setIt != groups.end(); setIt++)
+    double pbar = 0., hbar = 0., s2 = 0.;
+    for (size_t g = 0; g < nbGroups; ++g)
     {
-      ni += pmgc.getLocusGroupSize( (*setIt), i);
+      if (individuals[g] == 0)
+        continue;
+      double n = static_cast<double>(individuals[g]);
+      pbar += n * static_cast<double>(counts[g * nbAlleles + u]) / static_cast<double>(gametes[g]);
+      if (diploids[g] > 0)
+        hbar += n * static_cast<double>(heterozygous[g * nbAlleles + u]) / static_cast<double>(diploids[g]);
     }
-
-    // reduce computation for polymorphic loci for that groups
-    vector<size_t> ids = getAllelesIdsForGroups(pmgc, i, groups);
-    if (ids.size() >= 2 && ni >= 1)
+    pbar /= nTotal;
+    hbar /= nTotal;
+    for (size_t g = 0; g < nbGroups; ++g)
     {
-      map<size_t, MultilocusGenotypeStatistics::VarComp> values = getVarianceComponents(pmgc, locusPositions[i], groups);
-      for (map<size_t, MultilocusGenotypeStatistics::VarComp>::iterator it = values.begin(); it != values.end(); it++)
-      {
-        B += it->second.b;
-        C += it->second.c;
-      }
+      if (individuals[g] == 0)
+        continue;
+      double p = static_cast<double>(counts[g * nbAlleles + u]) / static_cast<double>(gametes[g]);
+      s2 += static_cast<double>(individuals[g]) * (p - pbar) * (p - pbar);
     }
+    s2 /= (r - 1.) * nbar;
+    double common = pbar * (1. - pbar) - s2 * (r - 1.) / r;
+    sums.a += (nbar / nc) * (s2 - (common - hbar / 4.) / (nbar - 1.));
+    sums.b += (nbar / (nbar - 1.)) * (common - ((2. * nbar - 1.) / (4. * nbar)) * hbar);
+    sums.c += hbar / 2.;
   }
+  return sums;
+}
+
+double MultilocusGenotypeStatistics::getWCMultilocusFst(const PolymorphismMultiGContainer& pmgc, vector<size_t> locusPositions, const set<size_t>& groups, const ExecutionContext& context, const vector<bool>& individualMask)
+{
+  VarComp sums = getWCMultilocusVarComp_(pmgc, locusPositions, groups, context, individualMask);
+  double A = sums.a;
+  double B = sums.b;
+  double C = sums.c;
+  if ((A + B + C) == 0)
+    throw ZeroDivisionException("MultilocusGenotypeStatistics::getWCMultilocusFst.");
+  return A / (A + B + C);
+}
+
+double MultilocusGenotypeStatistics::getWCMultilocusFis(const PolymorphismMultiGContainer& pmgc, vector<size_t> locusPositions, const set<size_t>& groups, const ExecutionContext& context, const vector<bool>& individualMask)
+{
+  VarComp sums = getWCMultilocusVarComp_(pmgc, locusPositions, groups, context, individualMask);
+  double B = sums.b;
+  double C = sums.c;
   if ((B + C) == 0)
     throw ZeroDivisionException("MultilocusGenotypeStatistics::getWCMultilocusFis.");
   return 1.0 - C / (B + C);
 }
 
+MultilocusGenotypeStatistics::VarComp MultilocusGenotypeStatistics::getWCMultilocusVarComp_(const PolymorphismMultiGContainer& pmgc, const vector<size_t>& locusPositions, const set<size_t>& groups, const ExecutionContext& context, const vector<bool>& individualMask)
+{
+  VarComp zero;
+  zero.a = zero.b = zero.c = 0.0;
+  return context.parallelReduce(0, locusPositions.size(), zero,
+      [&](size_t i) {
+        return getLocusVarianceComponents(locusView_(pmgc, locusPositions[i], "getWCMultilocusVarComp_", individualMask), groups);
+      },
+      [](const VarComp& x, const VarComp& y) {
+        VarComp sum;
+        sum.a = x.a + y.a;
+        sum.b = x.b + y.b;
+        sum.c = x.c + y.c;
+        return sum;
+      });
+}
+
 MultilocusGenotypeStatistics::PermResults MultilocusGenotypeStatistics::getWCMultilocusFstAndPerm(
     const PolymorphismMultiGContainer& pmgc,
     vector<size_t> locusPositions,
     set<size_t> groups,
-    unsigned int nbPerm)
+    unsigned int nbPerm,
+    const ExecutionContext& context,
+    const vector<bool>& individualMask)
 {
-  // extract a PolymorphismMultiGContainer with only those groups
-  auto subPmgc = PolymorphismMultiGContainerTools::extractGroups(pmgc, groups);
-  double nbSup = 0.0;
-  double nbInf = 0.0;
+  // extract a PolymorphismMultiGContainer with only those groups and individuals
+  auto subPmgc = PolymorphismMultiGContainerTools::extractGroups(pmgc, groups, individualMask);
   PermResults results;
-  results.statistic = getWCMultilocusFst(*subPmgc, locusPositions, groups);
-  if (nbPerm > 0)
+  results.statistic = getWCMultilocusFst(*subPmgc, locusPositions, groups, context);
+  vector<double> permuted = runPermutations_(nbPerm, context,
+      [&](std::mt19937* generator) {
+        auto permutedPmgc = generator
+            ? PolymorphismMultiGContainerTools::permuteMultiG(*subPmgc, *generator)
+            : PolymorphismMultiGContainerTools::permuteMultiG(*subPmgc);
+        return getWCMultilocusFst(*permutedPmgc, locusPositions, groups);
+      });
+  setPermutationPercents_(results, permuted);
+  return results;
+}
+
+MultilocusGenotypeStatistics::PermResults MultilocusGenotypeStatistics::getWCMultilocusFisAndPerm(
+    const PolymorphismMultiGContainer& pmgc,
+    vector<size_t> locusPositions,
+    set<size_t> groups,
+    unsigned int nbPerm,
+    const ExecutionContext& context,
+    const vector<bool>& individualMask)
+{
+  // extract a PolymorphismMultiGContainer with only those groups and individuals
+  auto subPmgc =  PolymorphismMultiGContainerTools::extractGroups(pmgc, groups, individualMask);
+  PermResults results;
+  results.statistic =  getWCMultilocusFis(*subPmgc, locusPositions, groups, context);
+  vector<double> permuted = runPermutations_(nbPerm, context,
+      [&](std::mt19937* generator) {
+        auto permutedPmgc = generator
+            ? PolymorphismMultiGContainerTools::permuteIntraGroupAlleles(*subPmgc, groups, *generator)
+            : PolymorphismMultiGContainerTools::permuteIntraGroupAlleles(*subPmgc, groups);
+        return getWCMultilocusFis(*permutedPmgc, locusPositions, groups);
+      });
+  setPermutationPercents_(results, permuted);
+  return results;
+}
+
+vector<double> MultilocusGenotypeStatistics::runPermutations_(
+    unsigned int nbPerm,
+    const ExecutionContext& context,
+    const std::function<double(std::mt19937*)>& statistic)
+{
+  vector<double> values(nbPerm);
+  if (!context.isParallel())
   {
+    // Same random draws as the sequential implementation
     for (size_t i = 0; i < nbPerm; ++i)
     {
-      auto permutedPmgc = PolymorphismMultiGContainerTools::permuteMultiG(*subPmgc);
-      double FstPerm = getWCMultilocusFst(*permutedPmgc, locusPositions, groups);
-      // cout << Fst_perm << endl;
-      if (FstPerm > results.statistic)
-        nbSup++;
-      if (FstPerm < results.statistic)
-        nbInf++;
+      values[i] = statistic(nullptr);
     }
-
-    nbSup /= static_cast<double>(nbPerm);
-    nbInf /= static_cast<double>(nbPerm);
+    return values;
   }
 
-  results.percentSup = nbSup;
-  results.percentInf = nbInf;
-  return results;
+  // Seeds are drawn sequentially so that the results do not depend on the scheduling
+  vector<std::mt19937::result_type> seeds(nbPerm);
+  for (size_t i = 0; i < nbPerm; ++i)
+  {
+    seeds[i] = static_cast<std::mt19937::result_type>(RandomTools::DEFAULT_GENERATOR());
+  }
+  context.parallelFor(0, nbPerm, [&](size_t i) {
+        std::mt19937 generator(seeds[i]);
+        values[i] = statistic(&generator);
+      });
+  return values;
 }
 
-MultilocusGenotypeStatistics::PermResults MultilocusGenotypeStatistics::getWCMultilocusFisAndPerm(
-    const PolymorphismMultiGContainer& pmgc,
-    vector<size_t> locusPositions,
-    set<size_t> groups,
-    unsigned int nbPerm)
+void MultilocusGenotypeStatistics::setPermutationPercents_(PermResults& results, const vector<double>& permuted)
 {
-  // extract a PolymorphismMultiGContainer with only those groups
-  auto subPmgc =  PolymorphismMultiGContainerTools::extractGroups(pmgc, groups);
   double nbSup = 0.0;
   double nbInf = 0.0;
-  PermResults results;
-  results.statistic =  getWCMultilocusFis(*subPmgc, locusPositions, groups);
-  if (nbPerm > 0)
+  if (permuted.size() > 0)
   {
-    for (unsigned int i = 0; i < nbPerm; ++i)
+    for (size_t i = 0; i < permuted.size(); ++i)
     {
-      auto permutedPmgc = PolymorphismMultiGContainerTools::permuteIntraGroupAlleles(*subPmgc, groups);
-      double FisPerm = getWCMultilocusFis(*permutedPmgc, locusPositions, groups);
-
-      if (FisPerm > results.statistic)
+      if (permuted[i] > results.statistic)
         nbSup++;
-      if (FisPerm < results.statistic)
+      if (permuted[i] < results.statistic)
         nbInf++;
     }
 
-    nbSup /= static_cast<double>(nbPerm);
-    nbInf /= static_cast<double>(nbPerm);
+    nbSup /= static_cast<double>(permuted.size());
+    nbInf /= static_cast<double>(permuted.size());
   }
 
   results.percentSup = nbSup;
   results.percentInf = nbInf;
-  return results;
 }
 
 double MultilocusGenotypeStatistics::getRHMultilocusFst(
     const PolymorphismMultiGContainer& pmgc,
     vector<size_t> locusPositions,
-    const set<size_t>& groups)
+    const set<size_t>& groups,
+    const ExecutionContext& context,
+    const vector<bool>& individualMask)
 {
-  double Au, Bu, Cu;
-  double RH = 0.0;
-  int nb_alleles = 0;
-  int total_alleles = 0;
-
-  for (size_t i = 0; i < locusPositions.size(); i++)
-  {
-    // reduce computation for polymorphic loci for that groups
-    vector<size_t> ids = getAllelesIdsForGroups(pmgc, i, groups);
-    if (ids.size() >= 2)
-    {
-      nb_alleles = 0;
-      // mean allelic frequencies
-      map< size_t, double > P = MultilocusGenotypeStatistics::getAllelesFrqForGroups (pmgc, locusPositions[i], groups);
-      // variance components from W&C
-      map<size_t, MultilocusGenotypeStatistics::VarComp> values = getVarianceComponents(pmgc, locusPositions[i], groups);
-      for (map<size_t, MultilocusGenotypeStatistics::VarComp>::iterator it = values.begin(); it != values.end(); it++)
-      {
-        Au = it->second.a;
-        Bu = it->second.b;
-        Cu = it->second.c;
-        if ((Au + Bu + Cu) != 0)
+  typedef pair<double, int> RHSums;
+  RHSums sums = context.parallelReduce(0, locusPositions.size(), RHSums(0.0, 0),
+      [&](size_t i) {
+        double Au, Bu, Cu;
+        RHSums locusSums(0.0, 0);
+        // reduce computation for polymorphic loci for that groups
+        vector<size_t> ids = getAllelesIdsForGroups(pmgc, locusPositions[i], groups, individualMask);
+        if (ids.size() >= 2)
         {
-          double Pu = P[it->first]; // it->first is the allele number
-          RH += (1 - Pu) * Au / (Au + Bu + Cu);
-          nb_alleles++;
+          int nb_alleles = 0;
+          // mean allelic frequencies
+          map< size_t, double > P = MultilocusGenotypeStatistics::getAllelesFrqForGroups (pmgc, locusPositions[i], groups, individualMask);
+          // variance components from W&C
+          map<size_t, MultilocusGenotypeStatistics::VarComp> values = getVarianceComponents(pmgc, locusPositions[i], groups, individualMask);
+          for (map<size_t, MultilocusGenotypeStatistics::VarComp>::iterator it = values.begin(); it != values.end(); it++)
+          {
+            Au = it->second.a;
+            Bu = it->second.b;
+            Cu = it->second.c;
+            if ((Au + Bu + Cu) != 0)
+            {
+              double Pu = P[it->first]; // it->first is the allele number
+              locusSums.first += (1 - Pu) * Au / (Au + Bu + Cu);
+              nb_alleles++;
+            }
+          }
+          locusSums.second += (nb_alleles - 1);
         }
-      }
-      total_alleles += (nb_alleles - 1);
-    }
-  }
+        return locusSums;
+      },
+      [](const RHSums& x, const RHSums& y) {
+        return RHSums(x.first + y.first, x.second + y.second);
+      });
+  double RH = sums.first;
+  int total_alleles = sums.second;
   if (total_alleles == 0)
     throw ZeroDivisionException("MultilocusGenotypeStatistics::getRHMultilocusFst.");
   return RH / double(total_alleles);
 }
 
-std::unique_ptr<DistanceMatrix> MultilocusGenotypeStatistics::getDistanceMatrix(const PolymorphismMultiGContainer& pmgc, vector<size_t> locusPositions, const set<size_t>& groups, string distance_methode)
+std::unique_ptr<DistanceMatrix> MultilocusGenotypeStatistics::getDistanceMatrix(const PolymorphismMultiGContainer& pmgc, vector<size_t> locusPositions, const set<size_t>& groups, string distance_methode, const ExecutionContext& context, const vector<bool>& individualMask)
 {
   vector<string> names = pmgc.getAllGroupsNames();
   vector<size_t> grp_ids_vect;
@@ -730,36 +799,35 @@ std::unique_ptr<DistanceMatrix> MultilocusGenotypeStatistics::getDistanceMatrix(
     (*_dist)(i, i) = 0;
   }
 
-  set<size_t> pairwise_grp;
-
-  for (size_t j = 0; j < groups.size () - 1; j++)
-  {
+  // Each task fills distinct cells of the matrix
+  context.parallelFor(0, groups.size () - 1, [&](size_t j) {
+    set<size_t> pairwise_grp;
     for (size_t k = j + 1; k < groups.size (); k++)
     {
       double distance = 0;
       if (distance_methode ==  "nei72")
-        distance = MultilocusGenotypeStatistics::getDnei72( pmgc, locusPositions, grp_ids_vect[j], grp_ids_vect[k] );
+        distance = MultilocusGenotypeStatistics::getDnei72( pmgc, locusPositions, grp_ids_vect[j], grp_ids_vect[k], individualMask);
       else if  (distance_methode == "nei78")
-        distance = MultilocusGenotypeStatistics::getDnei78( pmgc, locusPositions, grp_ids_vect[j], grp_ids_vect[k] );
+        distance = MultilocusGenotypeStatistics::getDnei78( pmgc, locusPositions, grp_ids_vect[j], grp_ids_vect[k], individualMask);
       else if (distance_methode == "WC") // Fst multilocus selon W&C
       {
         pairwise_grp.insert(grp_ids_vect[j] );
         pairwise_grp.insert(grp_ids_vect[k] );
-        distance = MultilocusGenotypeStatistics::getWCMultilocusFst( pmgc, locusPositions, pairwise_grp);
+        distance = MultilocusGenotypeStatistics::getWCMultilocusFst( pmgc, locusPositions, pairwise_grp, ExecutionContext::sequential(), individualMask);
         pairwise_grp.clear();
       }
       else if (distance_methode == "RH") // Fst multilocus selon ponderation Robertson & Hill
       {
         pairwise_grp.insert(grp_ids_vect[j] );
         pairwise_grp.insert(grp_ids_vect[k] );
-        distance = MultilocusGenotypeStatistics::getRHMultilocusFst( pmgc, locusPositions, pairwise_grp);
+        distance = MultilocusGenotypeStatistics::getRHMultilocusFst( pmgc, locusPositions, pairwise_grp, ExecutionContext::sequential(), individualMask);
         pairwise_grp.clear();
       }
       else if (distance_methode == "Nm") // Nm déduit des Fst multilocus selon W&C modèle en îles Fst = 1/(1+4Nm)
       {
         pairwise_grp.insert(grp_ids_vect[j] );
         pairwise_grp.insert(grp_ids_vect[k] );
-        distance = MultilocusGenotypeStatistics::getWCMultilocusFst( pmgc, locusPositions, pairwise_grp);
+        distance = MultilocusGenotypeStatistics::getWCMultilocusFst( pmgc, locusPositions, pairwise_grp, ExecutionContext::sequential(), individualMask);
         if (distance != 0)
           distance = 0.25 * (1 - distance) / distance;
         else
@@ -770,7 +838,7 @@ std::unique_ptr<DistanceMatrix> MultilocusGenotypeStatistics::getDistanceMatrix(
       {
         pairwise_grp.insert(grp_ids_vect[j] );
         pairwise_grp.insert(grp_ids_vect[k] );
-        distance = MultilocusGenotypeStatistics::getWCMultilocusFst( pmgc, locusPositions, pairwise_grp);
+        distance = MultilocusGenotypeStatistics::getWCMultilocusFst( pmgc, locusPositions, pairwise_grp, ExecutionContext::sequential(), individualMask);
         if (distance != 1)
           distance =  -log(1 - distance);
         else
@@ -781,7 +849,7 @@ std::unique_ptr<DistanceMatrix> MultilocusGenotypeStatistics::getDistanceMatrix(
       {
         pairwise_grp.insert(grp_ids_vect[j] );
         pairwise_grp.insert(grp_ids_vect[k] );
-        distance = MultilocusGenotypeStatistics::getWCMultilocusFst( pmgc, locusPositions, pairwise_grp);
+        distance = MultilocusGenotypeStatistics::getWCMultilocusFst( pmgc, locusPositions, pairwise_grp, ExecutionContext::sequential(), individualMask);
         if (distance != 1)
           distance = distance / (1 - distance);
         else
@@ -792,7 +860,179 @@ std::unique_ptr<DistanceMatrix> MultilocusGenotypeStatistics::getDistanceMatrix(
       (*_dist)(k, j) =  distance;
       (*_dist)(j, k) =  distance;
     } // for k
-  } // for j
+  }); // for j
 
   return _dist;
 }
+
+vector<MultilocusGenotypeStatistics::LocusComponents> MultilocusGenotypeStatistics::getLocusComponents(
+    const PolymorphismMultiGContainer& pmgc,
+    const vector<size_t>& locusPositions,
+    const set<size_t>& groups,
+    const ExecutionContext& context,
+    const vector<bool>& individualMask)
+{
+  vector<LocusComponents> components(locusPositions.size());
+  context.parallelFor(0, locusPositions.size(), [&](size_t i) {
+        size_t locusPosition = locusPositions[i];
+        LocusComponents& locus = components[i];
+        locus.varComp.a = locus.varComp.b = locus.varComp.c = 0.;
+        locus.nbAlleles = locus.nbDiploids = locus.nbHeterozygous = 0;
+        locus.Ht = locus.Hs = 0.;
+        PolymorphismMultiGContainer::LocusView view = locusView_(pmgc, locusPosition, "getLocusComponents", individualMask);
+        for (const auto& entry : view)
+        {
+          if (!entry.genotype || groups.find(entry.groupId) == groups.end())
+            continue;
+          locus.nbAlleles += entry.genotype->getNumberOfAlleles();
+          if (entry.genotype->getNumberOfAlleles() == 2)
+          {
+            locus.nbDiploids++;
+            if (entry.genotype->getAlleleIndexAt(0) != entry.genotype->getAlleleIndexAt(1))
+              locus.nbHeterozygous++;
+          }
+        }
+        if (locus.nbAlleles == 0)
+          return;
+        locus.Ht = getHexpForGroups(pmgc, locusPosition, groups, individualMask);
+        size_t nbGroups = 0;
+        for (size_t group : groups)
+        {
+          set<size_t> groupId;
+          groupId.insert(group);
+          try
+          {
+            locus.Hs += getHexpForGroups(pmgc, locusPosition, groupId, individualMask);
+            nbGroups++;
+          }
+          catch (ZeroDivisionException&)
+          {
+            // No allele in this group
+          }
+        }
+        locus.Hs /= static_cast<double>(nbGroups);
+        locus.varComp = getLocusVarianceComponents(view, groups);
+      });
+  return components;
+}
+
+MultilocusGenotypeStatistics::WindowStatistics MultilocusGenotypeStatistics::sumLocusComponents(
+    const vector<LocusComponents>& components,
+    size_t first,
+    size_t last)
+{
+  if (last > components.size())
+    throw IndexOutOfBoundsException("MultilocusGenotypeStatistics::sumLocusComponents: last out of bounds.", last, 0, components.size());
+  if (first > last)
+    throw BadIntegerException("MultilocusGenotypeStatistics::sumLocusComponents: first must not excede last.", static_cast<int>(first));
+  LocusComponents sums;
+  sums.varComp.a = sums.varComp.b = sums.varComp.c = 0.;
+  sums.nbAlleles = sums.nbDiploids = sums.nbHeterozygous = 0;
+  sums.Ht = sums.Hs = 0.;
+  size_t nbTypedLoci = 0;
+  for (size_t i = first; i < last; ++i)
+  {
+    addLocusComponents_(sums, components[i]);
+    if (components[i].nbAlleles > 0)
+      nbTypedLoci++;
+  }
+  return getStatisticsFromSums_(sums, last - first, nbTypedLoci);
+}
+
+vector<MultilocusGenotypeStatistics::WindowStatistics> MultilocusGenotypeStatistics::getWindowStatistics(
+    const PolymorphismMultiGContainer& pmgc,
+    const AnalyzedLoci& loci,
+    const set<size_t>& groups,
+    size_t windowSize,
+    size_t step,
+    const ExecutionContext& context,
+    const vector<bool>& individualMask)
+{
+  vector<AnalyzedLoci::LocusWindow> windows = loci.getWindows(windowSize, step);
+  vector<size_t> sortedLoci = loci.getSortedLoci();
+  vector<LocusComponents> components = getLocusComponents(pmgc, sortedLoci, groups, context, individualMask);
+
+  // Prefix sums of the components, in the order of the index
+  vector<size_t> ranks(loci.getNumberOfLoci());
+  vector<LocusComponents> prefixSums(sortedLoci.size() + 1);
+  vector<size_t> prefixTypedLoci(sortedLoci.size() + 1, 0);
+  LocusComponents& zero = prefixSums[0];
+  zero.varComp.a = zero.varComp.b = zero.varComp.c = 0.;
+  zero.nbAlleles = zero.nbDiploids = zero.nbHeterozygous = 0;
+  zero.Ht = zero.Hs = 0.;
+  for (size_t k = 0; k < sortedLoci.size(); ++k)
+  {
+    ranks[sortedLoci[k]] = k;
+    prefixSums[k + 1] = prefixSums[k];
+    addLocusComponents_(prefixSums[k + 1], components[k]);
+    prefixTypedLoci[k + 1] = prefixTypedLoci[k] + (components[k].nbAlleles > 0 ? 1 : 0);
+  }
+
+  vector<WindowStatistics> statistics;
+  statistics.reserve(windows.size());
+  for (const auto& window : windows)
+  {
+    // The loci of a window are consecutive in the index.
+    size_t first = ranks[window.loci.front()];
+    size_t last = first + window.loci.size();
+    LocusComponents sums = prefixSums[last];
+    sums.varComp.a -= prefixSums[first].varComp.a;
+    sums.varComp.b -= prefixSums[first].varComp.b;
+    sums.varComp.c -= prefixSums[first].varComp.c;
+    sums.nbAlleles -= prefixSums[first].nbAlleles;
+    sums.nbDiploids -= prefixSums[first].nbDiploids;
+    sums.nbHeterozygous -= prefixSums[first].nbHeterozygous;
+    sums.Ht -= prefixSums[first].Ht;
+    sums.Hs -= prefixSums[first].Hs;
+    WindowStatistics windowStatistics = getStatisticsFromSums_(sums, window.loci.size(), prefixTypedLoci[last] - prefixTypedLoci[first]);
+    windowStatistics.chromosome = window.chromosome;
+    windowStatistics.start = window.start;
+    windowStatistics.end = window.end;
+    statistics.push_back(windowStatistics);
+  }
+  return statistics;
+}
+
+void MultilocusGenotypeStatistics::addLocusComponents_(LocusComponents& sums, const LocusComponents& locus)
+{
+  sums.varComp.a += locus.varComp.a;
+  sums.varComp.b += locus.varComp.b;
+  sums.varComp.c += locus.varComp.c;
+  sums.nbAlleles += locus.nbAlleles;
+  sums.nbDiploids += locus.nbDiploids;
+  sums.nbHeterozygous += locus.nbHeterozygous;
+  sums.Ht += locus.Ht;
+  sums.Hs += locus.Hs;
+}
+
+MultilocusGenotypeStatistics::WindowStatistics MultilocusGenotypeStatistics::getStatisticsFromSums_(
+    const LocusComponents& sums,
+    size_t nbLoci,
+    size_t nbTypedLoci)
+{
+  const VarComp& v = sums.varComp;
+  WindowStatistics statistics{string(), 0, 0, nbLoci, NAN, NAN, NAN, NAN, NAN};
+  if (v.a + v.b + v.c != 0.)
+    statistics.Fst = v.a / (v.a + v.b + v.c);
+  if (v.b + v.c != 0.)
+    statistics.Fis = 1. - v.c / (v.b + v.c);
+  if (sums.nbDiploids > 0)
+    statistics.Hobs = static_cast<double>(sums.nbHeterozygous) / static_cast<double>(sums.nbDiploids);
+  if (nbTypedLoci > 0)
+    statistics.Hexp = sums.Ht / static_cast<double>(nbTypedLoci);
+  if (sums.Ht != 0.)
+    statistics.Gst = 1. - sums.Hs / sums.Ht;
+  return statistics;
+}
+
+PolymorphismMultiGContainer::LocusView MultilocusGenotypeStatistics::locusView_(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const string& method, const vector<bool>& individualMask)
+{
+  try
+  {
+    return pmgc.locusView(locusPosition, individualMask);
+  }
+  catch (IndexOutOfBoundsException& ioobe)
+  {
+    throw IndexOutOfBoundsException("MultilocusGenotypeStatistics::" + method + ": locusPosition out of bounds.", ioobe.getBadIndex(), ioobe.getBounds()[0], ioobe.getBounds()[1]);
+  }
+}
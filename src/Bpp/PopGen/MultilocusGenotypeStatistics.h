@@ -11,6 +11,8 @@
 #include <map>
 #include <set>
 #include <memory>
+#include <functional>
+#include <random>
 
 #include <Bpp/Exceptions.h>
 
@@ -21,6 +23,8 @@
 #include "PolymorphismMultiGContainer.h"
 #include "MultilocusGenotype.h"
 #include "GeneralExceptions.h"
+#include "ExecutionContext.h"
+#include "DataSet/AnalyzedLoci.h"
 
 namespace bpp
 {
@@ -29,6 +33,12 @@ namespace bpp
  *
  * This class is a set of static method for PolymorphismMultiGContainer.
  *
+ * The methods taking an individualMask read the genotypes of the
+ * individuals whose element of the mask is false as missing (see
+ * PolymorphismMultiGContainer::locusView() and GenotypeQc). An empty mask
+ * keeps all the individuals, and a mask which is not empty must have one
+ * element per individual, or a DimensionException is thrown.
+ *
  * @author Sylvain Gaillard
  */
 class MultilocusGenotypeStatistics
@@ -55,6 +65,51 @@ public:
     double percentInf;
   };
 
+  /**
+   * @brief The terms of one locus summed by the multilocus and window statistics.
+   */
+  struct LocusComponents
+  {
+    /**
+     * @brief The Weir and Cockerham variance components summed over the alleles, zero for a monomorphic locus.
+     */
+    VarComp varComp;
+    size_t nbAlleles;
+    size_t nbDiploids;
+    size_t nbHeterozygous;
+    /**
+     * @brief The expected heterozygosity of the pooled groups, zero without any allele.
+     */
+    double Ht;
+    /**
+     * @brief The mean expected heterozygosity within the groups, zero without any allele.
+     */
+    double Hs;
+  };
+
+  /**
+   * @brief The statistics of a window of loci.
+   *
+   * - Fst and Fis are the Weir and Cockerham multilocus estimates.
+   * - Hobs is the proportion of heterozygous genotypes among the diploid ones.
+   * - Hexp is the mean of Ht over the loci with at least one allele.
+   * - Gst is 1 - Hs / Ht, Hs and Ht summed over the loci (Nei 1973).
+   *
+   * A statistic with a null denominator is NaN.
+   */
+  struct WindowStatistics
+  {
+    std::string chromosome;
+    size_t start;
+    size_t end;
+    size_t nbLoci;
+    double Fst;
+    double Fis;
+    double Hobs;
+    double Hexp;
+    double Gst;
+  };
+
   /**
    * @brief Get the alleles' id at one locus for a set of groups.
    *
@@ -63,7 +118,8 @@ public:
   static std::vector<size_t> getAllelesIdsForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Count the number of allele (gametes) at a locus for a set of groups.
@@ -73,7 +129,8 @@ public:
   static size_t countGametesForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Get a map of allele count for a set of groups.
@@ -83,7 +140,8 @@ public:
   static std::map<size_t, size_t> getAllelesMapForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Get the alleles frequencies at one locus for a set of groups.
@@ -94,7 +152,8 @@ public:
   static std::map<size_t, double> getAllelesFrqForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Count the number of non-missing data at a given locus for a set of groups.
@@ -104,7 +163,8 @@ public:
   static size_t countNonMissingForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Counr the number of bi-allelic MonolocusGenotype at a given locus for a set of groups.
@@ -114,7 +174,8 @@ public:
   static size_t countBiAllelicForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Count how many times each allele is found in an heterozygous MonolocusGenotype in a set of groups.
@@ -124,7 +185,8 @@ public:
   static std::map<size_t, size_t> countHeterozygousForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Get the heterozygous frequencies for each allele at a locus in a set of groups.
@@ -135,7 +197,8 @@ public:
   static std::map<size_t, double> getHeterozygousFrqForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Compute the observed heterozygosity for one locus.
@@ -147,7 +210,8 @@ public:
   static double getHobsForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Compute the expected heterozygosity for one locus.
@@ -163,7 +227,8 @@ public:
   static double getHexpForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Compute the expected non biased heterozygosity for one locus.
@@ -179,7 +244,8 @@ public:
   static double getHnbForGroups(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Compute the Nei distance between two groups at one locus.
@@ -198,7 +264,8 @@ public:
       const PolymorphismMultiGContainer& pmgc,
       std::vector<size_t> locusPositions,
       size_t grp1,
-      size_t grp2);
+      size_t grp2,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Compute the Nei unbiased distance between two groups at a given number of loci.
@@ -224,7 +291,8 @@ public:
       const PolymorphismMultiGContainer& pmgc,
       std::vector<size_t> locusPositions,
       size_t grp1,
-      size_t grp2);
+      size_t grp2,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Compute the three F statistics of Weir and Cockerham for each allele of a given locus.
@@ -264,70 +332,225 @@ public:
   static std::map<size_t, VarComp> getVarianceComponents(
       const PolymorphismMultiGContainer& pmgc,
       size_t locusPosition,
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
+
+  /**
+   * @brief Get the variance components a, b and c of a locus, summed over its alleles.
+   *
+   * The components are computed from a single pass over the genotypes of
+   * the locus, which fills a cube of counts (group x allele, for the
+   * alleles and for the heterozygous genotypes) shared by all the alleles.
+   * Only the groups with at least one genotype at the locus are compared.
+   * A locus with less than two alleles or two such groups, or with less
+   * than two individuals per group on average, has null components.
+   *
+   * @param view The genotypes of the locus.
+   * @param groups The groups compared.
+   */
+  static VarComp getLocusVarianceComponents(
+      const PolymorphismMultiGContainer::LocusView& view,
       const std::set<size_t>& groups);
 
   /**
    * @brief Compute the Weir and Cockerham @f$\theta{wc}@f$ on a set of groups for a given set of loci.
    * The variance componenets for each allele are calculated and then combined over loci using Weir and Cockerham weighting.
+   * The components of a locus are those of getLocusVarianceComponents().
+   * Loci are processed concurrently according to the given ExecutionContext.
    */
   static double getWCMultilocusFst(
       const PolymorphismMultiGContainer& pmgc,
       std::vector<size_t> locusPositions,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const ExecutionContext& context = ExecutionContext::sequential(),
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Compute the Weir and Cockerham Fis on a set of groups for a given set of loci.
    * The variance componenets for each allele are calculated and then combined over loci using Weir and Cockerham weighting.
+   * The components of a locus are those of getLocusVarianceComponents().
+   * Loci are processed concurrently according to the given ExecutionContext.
    */
   static double getWCMultilocusFis(
       const PolymorphismMultiGContainer& pmgc,
       std::vector<size_t> locusPositions,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const ExecutionContext& context = ExecutionContext::sequential(),
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Compute the Weir and Cockerham @f$\theta_{wc}@f$ on a set of groups for a given set of loci and make a permutation test.
    * Multilocus @f$\theta@f$ is calculated as in getWCMultilocusFst on the original data set and on nb_perm data sets obtained after
    * a permutation of individuals between the different groups.
    * Return values are theta, % of values > theta and % of values < theta.
+   * The individuals hidden by the mask are left out of the permutations.
+   *
+   * Permutations are run concurrently if the given ExecutionContext is parallel.
+   * Each of them then uses its own generator, seeded from RandomTools::DEFAULT_GENERATOR
+   * before any permutation is made, so that results do not depend on the number of threads.
+   * With a sequential context, all the permutations use RandomTools::DEFAULT_GENERATOR.
    */
   static PermResults getWCMultilocusFstAndPerm(
       const PolymorphismMultiGContainer& pmgc,
       std::vector<size_t> locusPositions,
       std::set<size_t> groups,
-      unsigned int nb_perm);
+      unsigned int nb_perm,
+      const ExecutionContext& context = ExecutionContext::sequential(),
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Compute the Weir and Cockerham Fis on a set of groups for a given set of loci and make a permutation test.
    * Multilocus Fis is calculated as in getWCMultilocusFis on the original data set and on nb_perm data sets obtained after
    * a permutation of alleles between individual of each group.
    * Return values are Fis, % of values > Fis and % of values < Fis.
+   * The individuals hidden by the mask are left out of the permutations.
+   *
+   * Permutations are run concurrently as in getWCMultilocusFstAndPerm.
    */
   static PermResults getWCMultilocusFisAndPerm(
       const PolymorphismMultiGContainer& pmgc,
       std::vector<size_t> locusPositions,
       std::set<size_t> groups,
-      unsigned int nbPerm);
+      unsigned int nbPerm,
+      const ExecutionContext& context = ExecutionContext::sequential(),
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
 
   /**
    * @brief Compute the @f$\theta_{RH}@f$ on a set of groups for a given set of loci.
    * The variance componenets for each allele are calculated and then combined over loci using RH weighting with alleles frequency.
+   * Loci are processed concurrently according to the given ExecutionContext.
    */
   static double getRHMultilocusFst(
       const PolymorphismMultiGContainer& pmgc,
       std::vector<size_t> locusPositions,
-      const std::set<size_t>& groups);
+      const std::set<size_t>& groups,
+      const ExecutionContext& context = ExecutionContext::sequential(),
+      const std::vector<bool>& individualMask = std::vector<bool>());
 
   /**
    * @brief Compute pairwise distances on a set of groups for a given set of loci.
    * distance is either Nei72, Nei78, Fst W&C or Fst Robertson & Hill, Nm,
    * D=-ln(1-Fst) of Reynolds et al. 1983, Rousset 1997 Fst/(1-Fst)
+   * Pairs of groups are processed concurrently according to the given ExecutionContext.
+   * The individuals hidden by the mask are left out of all the distances.
    */
   static std::unique_ptr<DistanceMatrix> getDistanceMatrix(
       const PolymorphismMultiGContainer& pmgc,
       std::vector<size_t> locusPositions,
       const std::set<size_t>& groups,
-      std::string distance_method);
+      std::string distance_method,
+      const ExecutionContext& context = ExecutionContext::sequential(),
+      const std::vector<bool>& individualMask = std::vector<bool>());
+
+  /**
+   * @brief Compute the components of each of a set of loci.
+   *
+   * The variance components are those of getLocusVarianceComponents().
+   * Loci are processed concurrently according to the given ExecutionContext.
+   *
+   * @throw IndexOutOfBoundsException if a locus position excedes the number of loci.
+   */
+  static std::vector<LocusComponents> getLocusComponents(
+      const PolymorphismMultiGContainer& pmgc,
+      const std::vector<size_t>& locusPositions,
+      const std::set<size_t>& groups,
+      const ExecutionContext& context = ExecutionContext::sequential(),
+      const std::vector<bool>& individualMask = std::vector<bool>());
+
+  /**
+   * @brief Compute the statistics of a set of loci from their components.
+   *
+   * @param components The components of the loci.
+   * @param first The first locus of the set.
+   * @param last The locus after the last one of the set.
+   */
+  static WindowStatistics sumLocusComponents(
+      const std::vector<LocusComponents>& components,
+      size_t first,
+      size_t last);
+
+  /**
+   * @brief Compute the statistics in sliding windows of genomic positions.
+   *
+   * The windows are those of AnalyzedLoci::getWindows(), the loci of the
+   * AnalyzedLoci being those of the container, in the same order. The
+   * components of each locus are computed once and summed with prefix sums,
+   * so that the cost of a window does not depend on its number of loci.
+   *
+   * @param pmgc The genotypes.
+   * @param loci The coordinates of the loci.
+   * @param groups The groups compared.
+   * @param windowSize The number of positions in a window.
+   * @param step The number of positions between the starts of two windows.
+   * @param context The ExecutionContext used to compute the components.
+   * @param individualMask For each individual, true if it is kept. An empty mask keeps all the individuals.
+   * @throw BadIntegerException if windowSize or step is 0.
+   * @throw IndexOutOfBoundsException if a locus of the AnalyzedLoci excedes the number of loci of the container.
+   */
+  static std::vector<WindowStatistics> getWindowStatistics(
+      const PolymorphismMultiGContainer& pmgc,
+      const AnalyzedLoci& loci,
+      const std::set<size_t>& groups,
+      size_t windowSize,
+      size_t step,
+      const ExecutionContext& context = ExecutionContext::sequential(),
+      const std::vector<bool>& individualMask = std::vector<bool>());
+
+private:
+  /**
+   * @brief Sum the Weir and Cockerham variance components over alleles and loci.
+   */
+  static VarComp getWCMultilocusVarComp_(
+      const PolymorphismMultiGContainer& pmgc,
+      const std::vector<size_t>& locusPositions,
+      const std::set<size_t>& groups,
+      const ExecutionContext& context,
+      const std::vector<bool>& individualMask);
+
+  /**
+   * @brief Compute a statistic on nbPerm permuted data sets.
+   *
+   * @param nbPerm The number of permutations.
+   * @param context The ExecutionContext used to run the permutations.
+   * @param statistic The function permuting the data with the given generator and computing the statistic.
+   * The generator is nullptr if RandomTools::DEFAULT_GENERATOR must be used.
+   * @return The values of the statistic, in the order of the permutations.
+   */
+  static std::vector<double> runPermutations_(
+      unsigned int nbPerm,
+      const ExecutionContext& context,
+      const std::function<double(std::mt19937*)>& statistic);
+
+  /**
+   * @brief Set the percentages of permuted values above and below the observed statistic.
+   */
+  static void setPermutationPercents_(PermResults& results, const std::vector<double>& permuted);
+
+  /**
+   * @brief Add the components of a locus to a sum.
+   */
+  static void addLocusComponents_(LocusComponents& sums, const LocusComponents& locus);
+
+  /**
+   * @brief Compute the statistics from the sums of the components of nbLoci loci, nbTypedLoci of them having at least one allele.
+   */
+  static WindowStatistics getStatisticsFromSums_(
+      const LocusComponents& sums,
+      size_t nbLoci,
+      size_t nbTypedLoci);
+
+  /**
+   * @brief Build a LocusView hiding the individuals of a mask, with the name of the calling method in the error message.
+   *
+   * @throw IndexOutOfBoundsException if locusPosition excedes the number of loci.
+   * @throw DimensionException if the mask is not empty and does not have one element per individual.
+   */
+  static PolymorphismMultiGContainer::LocusView locusView_(
+      const PolymorphismMultiGContainer& pmgc,
+      size_t locusPosition,
+      const std::string& method,
+      const std::vector<bool>& individualMask);
 };
 } // end of namespace bpp;
 
@@ -10,14 +10,18 @@ using namespace std;
 // ** Constructors : **********************************************************/
 
 PolymorphismMultiGContainer::PolymorphismMultiGContainer(const PolymorphismMultiGContainer& pmgc) :
+  arena_(),
   multilocusGenotypes_(pmgc.size()),
   groups_(pmgc.size()),
   groupsNames_()
 {
+  GenotypeArena::Scope scope(arena_);
   for (size_t i = 0; i < pmgc.size(); ++i)
   {
     multilocusGenotypes_[i].reset(pmgc.multilocusGenotype(i).clone());
     groups_[i] = pmgc.getGroupId(i);
+    if (MemoryTracker::isTracking())
+      MemoryTracker::notifyAllocation(multilocusGenotypes_[i]->memoryUsage());
   }
   for (auto& id : pmgc.getAllGroupsIds())
   {
@@ -31,10 +35,13 @@ PolymorphismMultiGContainer::PolymorphismMultiGContainer(const PolymorphismMulti
 PolymorphismMultiGContainer& PolymorphismMultiGContainer::operator=(const PolymorphismMultiGContainer& pmgc)
 {
   clear();
+  GenotypeArena::Scope scope(arena_);
   for (size_t i = 0; i < pmgc.size(); ++i)
   {
     multilocusGenotypes_.push_back(make_unique<MultilocusGenotype>(pmgc.multilocusGenotype(i)));
     groups_.push_back(pmgc.getGroupId(i));
+    if (MemoryTracker::isTracking())
+      MemoryTracker::notifyAllocation(multilocusGenotypes_.back()->memoryUsage());
   }
   for (auto& id : pmgc.getAllGroupsIds())
   {
@@ -49,6 +56,8 @@ PolymorphismMultiGContainer& PolymorphismMultiGContainer::operator=(const Polymo
 
 void PolymorphismMultiGContainer::addMultilocusGenotype(unique_ptr<MultilocusGenotype>& mg, size_t group)
 {
+  if (MemoryTracker::isTracking())
+    MemoryTracker::notifyAllocation(mg->memoryUsage());
   multilocusGenotypes_.push_back(std::move(mg));
   groups_.push_back(group);
   auto it = groupsNames_.find(group);
@@ -61,6 +70,15 @@ void PolymorphismMultiGContainer::addMultilocusGenotype(unique_ptr<MultilocusGen
 
 /******************************************************************************/
 
+void PolymorphismMultiGContainer::addMultilocusGenotype(const MultilocusGenotype& mg, size_t group)
+{
+  GenotypeArena::Scope scope(arena_);
+  auto copy = make_unique<MultilocusGenotype>(mg);
+  addMultilocusGenotype(copy, group);
+}
+
+/******************************************************************************/
+
 const MultilocusGenotype& PolymorphismMultiGContainer::multilocusGenotype(size_t position) const
 {
   if (position >= size())
@@ -75,6 +93,8 @@ unique_ptr<MultilocusGenotype> PolymorphismMultiGContainer::removeMultilocusGeno
   if (position >= size())
     throw IndexOutOfBoundsException("PolymorphismMultiGContainer::removeMultilocusGenotype: position out of bounds.", position, 0, size() - 1);
   unique_ptr<MultilocusGenotype> tmpMg = std::move(multilocusGenotypes_[position]);
+  if (MemoryTracker::isTracking())
+    MemoryTracker::notifyRelease(tmpMg->memoryUsage());
   multilocusGenotypes_.erase(multilocusGenotypes_.begin() + static_cast<ptrdiff_t>(position));
   groups_.erase(groups_.begin() + static_cast<ptrdiff_t>(position));
   return tmpMg;
@@ -86,6 +106,8 @@ void PolymorphismMultiGContainer::deleteMultilocusGenotype(size_t position)
 {
   if (position >= size())
     throw IndexOutOfBoundsException("PolymorphismMultiGContainer::deleteMultilocusGenotype: position out of bounds.", position, 0, size() - 1);
+  if (MemoryTracker::isTracking())
+    MemoryTracker::notifyRelease(multilocusGenotypes_[position]->memoryUsage());
   multilocusGenotypes_.erase(multilocusGenotypes_.begin() + static_cast<ptrdiff_t>(position));
   groups_.erase(groups_.begin() + static_cast<ptrdiff_t>(position));
 }
@@ -224,23 +246,49 @@ void PolymorphismMultiGContainer::addGroupName(size_t groupId, const string& nam
 size_t PolymorphismMultiGContainer::getLocusGroupSize(size_t group, size_t locusPosition) const
 {
   size_t counter = 0;
-  for (size_t i = 0; i < size(); ++i)
+  try
   {
-    try
+    for (const auto& entry : locusView(locusPosition))
     {
-      if (groups_[i] == group && !multilocusGenotypes_[i]->isMonolocusGenotypeMissing(locusPosition))
+      if (entry.groupId == group && entry.genotype)
         counter++;
     }
-    catch (IndexOutOfBoundsException& ioobe)
-    {
-      throw IndexOutOfBoundsException("PolymorphismMultiGContainer::getGroupSize: locusPosition out of bounds.", ioobe.getBadIndex(), ioobe.getBounds()[0], ioobe.getBounds()[1]);
-    }
+  }
+  catch (IndexOutOfBoundsException& ioobe)
+  {
+    throw IndexOutOfBoundsException("PolymorphismMultiGContainer::getGroupSize: locusPosition out of bounds.", ioobe.getBadIndex(), ioobe.getBounds()[0], ioobe.getBounds()[1]);
   }
   return counter;
 }
 
 /******************************************************************************/
 
+PolymorphismMultiGContainer::LocusView::LocusView(const PolymorphismMultiGContainer& pmgc, size_t locusPosition) :
+  pmgc_(&pmgc),
+  locusPosition_(locusPosition),
+  individualMask_(nullptr)
+{
+  for (const auto& mg : pmgc.multilocusGenotypes_)
+  {
+    if (locusPosition >= mg->size())
+      throw IndexOutOfBoundsException("PolymorphismMultiGContainer::LocusView: locusPosition out of bounds.", locusPosition, 0, mg->size());
+  }
+}
+
+/******************************************************************************/
+
+PolymorphismMultiGContainer::LocusView::LocusView(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const vector<bool>& individualMask) :
+  LocusView(pmgc, locusPosition)
+{
+  if (individualMask.empty())
+    return;
+  if (individualMask.size() != pmgc.size())
+    throw DimensionException("PolymorphismMultiGContainer::LocusView: wrong size of the individual mask.", individualMask.size(), pmgc.size());
+  individualMask_ = &individualMask;
+}
+
+/******************************************************************************/
+
 size_t PolymorphismMultiGContainer::size() const
 {
   return multilocusGenotypes_.size();
@@ -250,9 +298,35 @@ size_t PolymorphismMultiGContainer::size() const
 
 void PolymorphismMultiGContainer::clear()
 {
+  if (MemoryTracker::isTracking())
+  {
+    for (const auto& mg : multilocusGenotypes_)
+    {
+      MemoryTracker::notifyRelease(mg->memoryUsage());
+    }
+  }
+  GenotypeArena::Scope scope(arena_);
   multilocusGenotypes_.clear();
   groups_.clear();
   groupsNames_.clear();
 }
 
 /******************************************************************************/
+
+MemoryUsage PolymorphismMultiGContainer::memoryUsage() const
+{
+  MemoryUsage usage;
+  usage.add(MemoryUsage::GENOTYPES, sizeof(*this) + MemoryUsage::ofVector(multilocusGenotypes_) + MemoryUsage::ofVector(groups_));
+  for (const auto& mg : multilocusGenotypes_)
+  {
+    usage += mg->memoryUsage();
+  }
+  for (const auto& it : groupsNames_)
+  {
+    // Each map node holds the pair and three links
+    usage.add(MemoryUsage::NAMES, sizeof(it) + 3 * sizeof(void*) + MemoryUsage::ofString(it.second));
+  }
+  return usage;
+}
+
+/******************************************************************************/
@@ -14,6 +14,8 @@
 // From popgenlib
 #include "MultilocusGenotype.h"
 #include "GeneralExceptions.h"
+#include "MemoryUsage.h"
+#include "GenotypeArena.h"
 
 // From STL
 #include <string>
@@ -28,12 +30,17 @@ namespace bpp
  *
  * This class is a container of MultilocusGenotype.
  *
+ * The genotypes copied by the container are allocated from its own
+ * GenotypeArena, whose slabs are returned to the heap at once with the
+ * container.
+ *
  * @author Sylvain Gaillard
  */
 class PolymorphismMultiGContainer :
   public virtual Clonable
 {
 private:
+  GenotypeArena arena_;
   std::vector<std::unique_ptr<MultilocusGenotype>> multilocusGenotypes_;
   std::vector<size_t> groups_; // group id for each multilocusgenotype
   std::map<size_t, std::string> groupsNames_;
@@ -44,6 +51,7 @@ public:
    * @brief Build a new PolymorphismMultilocusGenotypeContainer.
    */
   PolymorphismMultiGContainer() :
+    arena_(),
     multilocusGenotypes_(),
     groups_(std::vector<size_t>()),
     groupsNames_(std::map<size_t, std::string>())
@@ -75,6 +83,21 @@ public:
    */
   void addMultilocusGenotype(std::unique_ptr<MultilocusGenotype>& mg, size_t group);
 
+  /**
+   * @brief Add a copy of a MultilocusGenotype to the container.
+   *
+   * The copy is allocated from the arena of the container.
+   */
+  void addMultilocusGenotype(const MultilocusGenotype& mg, size_t group);
+
+  /**
+   * @brief Get the arena of the container.
+   *
+   * Activate it with a GenotypeArena::Scope to build genotypes which are
+   * then added to the container.
+   */
+  GenotypeArena& arena() { return arena_; }
+
   /**
    * @brief Get a MultilocusGenotype at a position.
    *
@@ -170,6 +193,125 @@ public:
    */
   size_t getLocusGroupSize(size_t group, size_t locusPosition) const;
 
+  /**
+   * @brief Read-only view of one locus across all the MultilocusGenotypes.
+   *
+   * The locus position is checked against every MultilocusGenotype once,
+   * when the view is built. The accessors of the view do not check bounds,
+   * so that statistics can loop over the individuals without any test nor
+   * exception handling in the loop body.
+   *
+   * A view may also hide some individuals, given by a mask with one
+   * element per MultilocusGenotype: the MonolocusGenotype of an individual
+   * whose element is false is then read as missing. The mask is not
+   * copied and must outlive the view.
+   *
+   * A view is invalidated by any modification of the container.
+   */
+  class LocusView
+  {
+  public:
+    /**
+     * @brief The group id and the MonolocusGenotype of one individual.
+     */
+    struct Entry
+    {
+      size_t groupId;
+
+      /**
+       * @brief The MonolocusGenotype, or nullptr if it is missing.
+       */
+      const MonolocusGenotypeInterface* genotype;
+    };
+
+    class ConstIterator
+    {
+    private:
+      const LocusView* view_;
+      size_t position_;
+
+    public:
+      ConstIterator(const LocusView& view, size_t position) :
+        view_(&view),
+        position_(position)
+      {}
+
+      Entry operator*() const { return (*view_)[position_]; }
+
+      ConstIterator& operator++()
+      {
+        ++position_;
+        return *this;
+      }
+
+      bool operator==(const ConstIterator& it) const { return position_ == it.position_; }
+      bool operator!=(const ConstIterator& it) const { return position_ != it.position_; }
+    };
+
+  private:
+    const PolymorphismMultiGContainer* pmgc_;
+    size_t locusPosition_;
+    const std::vector<bool>* individualMask_;
+
+  public:
+    /**
+     * @brief Build a view of a locus.
+     *
+     * @throw IndexOutOfBoundsException if locusPosition excedes the number of loci of a MultilocusGenotype.
+     */
+    LocusView(const PolymorphismMultiGContainer& pmgc, size_t locusPosition);
+
+    /**
+     * @brief Build a view of a locus hiding some individuals.
+     *
+     * @param pmgc The container.
+     * @param locusPosition The locus.
+     * @param individualMask For each MultilocusGenotype, true if it is visible. An empty mask hides nothing.
+     * @throw IndexOutOfBoundsException if locusPosition excedes the number of loci of a MultilocusGenotype.
+     * @throw DimensionException if the mask is not empty and does not have one element per MultilocusGenotype.
+     */
+    LocusView(const PolymorphismMultiGContainer& pmgc, size_t locusPosition, const std::vector<bool>& individualMask);
+
+    size_t size() const { return pmgc_->multilocusGenotypes_.size(); }
+
+    size_t getLocusPosition() const { return locusPosition_; }
+
+    /**
+     * @brief Get the entry of an individual, without bounds checking.
+     */
+    Entry operator[](size_t position) const
+    {
+      Entry entry;
+      entry.groupId = pmgc_->groups_[position];
+      entry.genotype = individualMask_ && !(*individualMask_)[position] ? nullptr : pmgc_->multilocusGenotypes_[position]->monolocusGenotypeUnchecked(locusPosition_);
+      return entry;
+    }
+
+    ConstIterator begin() const { return ConstIterator(*this, 0); }
+    ConstIterator end() const { return ConstIterator(*this, size()); }
+  };
+
+  /**
+   * @brief Get a view of a locus, checked once for all the individuals.
+   *
+   * @throw IndexOutOfBoundsException if locusPosition excedes the number of loci of a MultilocusGenotype.
+   */
+  LocusView locusView(size_t locusPosition) const
+  {
+    return LocusView(*this, locusPosition);
+  }
+
+  /**
+   * @brief Get a view of a locus hiding the individuals whose element of the mask is false.
+   *
+   * @throw IndexOutOfBoundsException if locusPosition excedes the number of loci of a MultilocusGenotype.
+   * @throw DimensionException if the mask is not empty and does not have one element per MultilocusGenotype.
+   */
+  LocusView locusView(size_t locusPosition, const std::vector<bool>& individualMask) const
+  {
+    return LocusView(*this, locusPosition, individualMask);
+  }
+
   /**
    * @brief Get the number of MultilocusGenotype.
    */
@@ -179,6 +321,18 @@ public:
    * @brief Clear the container.
    */
   void clear();
+
+  /**
+   * @brief Get the estimated memory footprint of the container.
+   *
+   * Genotypes and group ids are reported as MemoryUsage::GENOTYPES,
+   * group names as MemoryUsage::NAMES.
+   *
+   * When a global MemoryTracker is installed, the container notifies it
+   * of the genotypes it gains or loses, with their footprint at that
+   * time. Changes made in place to its genotypes are not notified.
+   */
+  MemoryUsage memoryUsage() const;
 };
 } // end of namespace bpp;
 
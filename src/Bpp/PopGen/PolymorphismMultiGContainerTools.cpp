@@ -12,8 +12,12 @@ using namespace bpp;
 
 /******************************************************************************/
 
-unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::permuteMultiG(
-    const PolymorphismMultiGContainer& pmgc)
+namespace
+{
+template<class Generator>
+unique_ptr<PolymorphismMultiGContainer> permuteMultiG_(
+    const PolymorphismMultiGContainer& pmgc,
+    Generator& generator)
 {
   auto permutedPmgc = make_unique<PolymorphismMultiGContainer>(pmgc);
   vector<size_t> groups;
@@ -21,7 +25,7 @@ unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::permut
   {
     groups.push_back(permutedPmgc->getGroupId(i));
   }
-  std::shuffle(groups.begin(), groups.end(), RandomTools::DEFAULT_GENERATOR);
+  std::shuffle(groups.begin(), groups.end(), generator);
   for (size_t i = 0; i < permutedPmgc->size(); ++i)
   {
     permutedPmgc->setGroupId(i, groups[i]);
@@ -31,6 +35,119 @@ unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::permut
 
 /******************************************************************************/
 
+template<class Generator>
+unique_ptr<PolymorphismMultiGContainer> permuteIntraGroupAlleles_(
+    const PolymorphismMultiGContainer& pmgc,
+    const set<size_t>& groups,
+    Generator& generator)
+{
+  auto permutedPmgc = make_unique<PolymorphismMultiGContainer>();
+  GenotypeArena::Scope scope(permutedPmgc->arena());
+  size_t locNum = pmgc.getNumberOfLoci();
+
+  // Insert as is the individuals of the other groups
+  for (size_t i = 0; i < pmgc.size(); ++i)
+  {
+    size_t indivGrp = pmgc.getGroupId(i);
+    if (groups.find(indivGrp) == groups.end())
+    {
+      auto tmpMg = make_unique<MultilocusGenotype>(pmgc.multilocusGenotype(i));
+      permutedPmgc->addMultilocusGenotype(tmpMg, indivGrp);
+    }
+  }
+
+  for (auto& g : groups) // for each group
+  {
+    size_t nbIndInGroup = 0;
+
+    vector<vector<size_t>> alleles(locNum);
+    // 0 for a missing MonolocusGenotype, which stays missing.
+    vector<vector<size_t>> nbAllelesForInds(locNum);
+    // Get all the alleles to permute
+    for (size_t i = 0; i < pmgc.size(); ++i)
+    {
+      if (pmgc.getGroupId(i) == g)
+      {
+        nbIndInGroup++;
+        for (size_t j = 0; j < locNum; ++j)
+        {
+          size_t nbAlls = 0;
+          if (!pmgc.multilocusGenotype(i).isMonolocusGenotypeMissing(j))
+          {
+            nbAlls = pmgc.multilocusGenotype(i).monolocusGenotype(j).getAlleleIndex().size();
+            for (size_t k = 0; k < nbAlls; ++k)
+            {
+              alleles[j].push_back(pmgc.multilocusGenotype(i).monolocusGenotype(j).getAlleleIndex()[k]);
+            }
+          }
+          nbAllelesForInds[j].push_back(nbAlls);
+        }
+      }
+    } // for i
+
+    // Permute the alleles
+    if (nbIndInGroup > 0)
+    {
+      for (size_t i = 0; i < locNum; ++i)
+      {
+        // alleles[i] = RandomTools::getSample(alleles[i], alleles[i].size());
+        std::shuffle(alleles[i].begin(), alleles[i].end(), generator);
+      }
+
+      // Build the new PolymorphismMultiGContainer
+      vector<size_t> k(locNum, 0);
+
+      for (size_t ind = 0; ind < nbIndInGroup; ind++)
+      {
+        auto tmpMg = make_unique<MultilocusGenotype>(locNum);
+        for (size_t j = 0; j < locNum; ++j)
+        {
+          if (nbAllelesForInds[j][ind] == 1)
+            tmpMg->setMonolocusGenotype(j, MonoAlleleMonolocusGenotype(alleles[j][k[j]++]));
+          if (nbAllelesForInds[j][ind] == 2)
+          {
+            size_t first = alleles[j][k[j]++];
+            size_t second = alleles[j][k[j]++];
+            tmpMg->setMonolocusGenotype(j, BiAlleleMonolocusGenotype(first, second));
+          }
+        } // for j
+
+        permutedPmgc->addMultilocusGenotype(tmpMg, g);
+      } // for ind
+    } // if nbIndInGroup
+  } // for g
+
+
+  // update groups names
+  auto grpIds = pmgc.getAllGroupsIds();
+  for (auto& id : grpIds)
+  {
+    string name = pmgc.getGroupName(id);
+    permutedPmgc->setGroupName(id, name);
+  }
+
+  return permutedPmgc;
+}
+
+} // end of anonymous namespace
+
+/******************************************************************************/
+
+unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::permuteMultiG(
+    const PolymorphismMultiGContainer& pmgc)
+{
+  return permuteMultiG_(pmgc, RandomTools::DEFAULT_GENERATOR);
+}
+
+unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::permuteMultiG(
+    const PolymorphismMultiGContainer& pmgc,
+    std::mt19937& generator)
+{
+  return permuteMultiG_(pmgc, generator);
+}
+
+/******************************************************************************/
+
 unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::permuteMonoG(
     const PolymorphismMultiGContainer& pmgc,
     const std::set<size_t>& groups)
@@ -95,6 +212,7 @@ unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::permut
     const set<size_t>& groups)
 {
   auto permutedPmgc = make_unique<PolymorphismMultiGContainer>();
+  GenotypeArena::Scope scope(permutedPmgc->arena());
   size_t locNum = pmgc.getNumberOfLoci();
   vector<vector<unique_ptr<const MonolocusGenotypeInterface>>> monoGens;
   monoGens.resize(locNum);
@@ -166,6 +284,7 @@ unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::permut
     const std::set<size_t>& groups)
 {
   auto permutedPmgc = make_unique<PolymorphismMultiGContainer>();
+  GenotypeArena::Scope scope(permutedPmgc->arena());
   size_t locNum = pmgc.getNumberOfLoci();
   vector<vector<size_t>> alleles;
   alleles.resize(locNum);
@@ -232,99 +351,35 @@ unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::permut
     const PolymorphismMultiGContainer& pmgc,
     const set<size_t>& groups)
 {
-  auto permutedPmgc = make_unique<PolymorphismMultiGContainer>();
-  size_t locNum = pmgc.getNumberOfLoci();
-  vector<vector<size_t>> alleles;
-  alleles.resize(locNum);
-
-  for (auto& g : groups) // for each group
-  {
-    size_t nbIndInGroup = 0;
-
-    vector<vector<size_t>> nbAllelesForInds;
-    nbAllelesForInds.resize(locNum);
-    // Get all the alleles to permute
-    for (size_t i = 0; i < pmgc.size(); ++i)
-    {
-      size_t indivGrp = pmgc.getGroupId(i);
-      if (groups.find(indivGrp) != groups.end() )
-      {
-        if (indivGrp == g)
-        {
-          nbIndInGroup++;
-          for (size_t j = 0; j < locNum; ++j)
-          {
-            if (!pmgc.multilocusGenotype(i).isMonolocusGenotypeMissing(j))
-            {
-              size_t nbAlls = pmgc.multilocusGenotype(i).monolocusGenotype(j).getAlleleIndex().size();
-              nbAllelesForInds[j].push_back(nbAlls);
-              for (size_t k = 0; k < nbAlls; ++k)
-              {
-                alleles[j].push_back(pmgc.multilocusGenotype(i).monolocusGenotype(j).getAlleleIndex()[k]);
-              }
-            }
-          }
-        }
-      }
-      else // insert as is
-      {
-        auto tmpMg = make_unique<MultilocusGenotype>(pmgc.multilocusGenotype(i));
-        permutedPmgc->addMultilocusGenotype(tmpMg, indivGrp);
-      }
-    } // for i
-
-    // Permute the alleles
-    if (nbIndInGroup > 0)
-    {
-      for (size_t i = 0; i < locNum; ++i)
-      {
-        // alleles[i] = RandomTools::getSample(alleles[i], alleles[i].size());
-        std::shuffle(alleles[i].begin(), alleles[i].end(), RandomTools::DEFAULT_GENERATOR);
-      }
-
-      // Build the new PolymorphismMultiGContainer
-      vector<size_t> k(locNum, 0);
-
-      for (size_t ind = 0; ind < nbIndInGroup; ind++)
-      {
-        auto tmpMg = make_unique<MultilocusGenotype>(locNum);
-        for (size_t j = 0; j < locNum; ++j)
-        {
-          if (nbAllelesForInds[j][ind] == 1)
-            tmpMg->setMonolocusGenotype(j, MonoAlleleMonolocusGenotype(alleles[j][k[j]++]));
-          if (nbAllelesForInds[j][ind] == 2)
-            tmpMg->setMonolocusGenotype(j, BiAlleleMonolocusGenotype(alleles[j][k[j]++], alleles[j][k[j]++]));
-        } // for j
-
-        permutedPmgc->addMultilocusGenotype(tmpMg, g);
-      } // for ind
-    } // if nbIndInGroup
-  } // for g
-
-
-  // update groups names
-  auto grpIds = pmgc.getAllGroupsIds();
-  for (auto& id : grpIds)
-  {
-    string name = pmgc.getGroupName(id);
-    permutedPmgc->setGroupName(id, name);
-  }
+  return permuteIntraGroupAlleles_(pmgc, groups, RandomTools::DEFAULT_GENERATOR);
+}
 
-  return permutedPmgc;
+unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::permuteIntraGroupAlleles(
+    const PolymorphismMultiGContainer& pmgc,
+    const set<size_t>& groups,
+    std::mt19937& generator)
+{
+  return permuteIntraGroupAlleles_(pmgc, groups, generator);
 }
 
 /******************************************************************************/
 
 unique_ptr<PolymorphismMultiGContainer> PolymorphismMultiGContainerTools::extractGroups(
     const PolymorphismMultiGContainer& pmgc,
-    const set<size_t>& groups)
+    const set<size_t>& groups,
+    const vector<bool>& individualMask)
 {
+  if (!individualMask.empty() && individualMask.size() != pmgc.size())
+    throw DimensionException("PolymorphismMultiGContainerTools::extractGroups: wrong size of the individual mask.", individualMask.size(), pmgc.size());
   auto subPmgc = make_unique<PolymorphismMultiGContainer>();
+  GenotypeArena::Scope scope(subPmgc->arena());
   for (auto& g : groups) // for each group
   {
     // Get all the MonolocusGenotypes of group g to extract
     for (size_t i = 0; i < pmgc.size(); ++i)
     {
+      if (!individualMask.empty() && !individualMask[i])
+        continue;
       size_t indivGrp = pmgc.getGroupId(i);
       if (groups.find(indivGrp) != groups.end() )
       {
@@ -7,6 +7,8 @@
 
 // From the STL
 #include <set>
+#include <random>
+#include <vector>
 
 // From the PolGenLib library
 #include "PolymorphismMultiGContainer.h"
@@ -33,6 +35,18 @@ public:
    */
   static std::unique_ptr<PolymorphismMultiGContainer> permuteMultiG(const PolymorphismMultiGContainer& pmgc);
 
+  /**
+   * @brief Permut the MultilocusGenotype in the whole PolymorphismMultiGContainer using a given generator.
+   *
+   * This version does not use RandomTools::DEFAULT_GENERATOR and can be run
+   * concurrently with distinct generators.
+   *
+   * @param pmgc The PolymorphismMultiGContainer to permut.
+   * @param generator The random number generator to use.
+   * @return A permuted PolymorphismMultiGContainer.
+   */
+  static std::unique_ptr<PolymorphismMultiGContainer> permuteMultiG(const PolymorphismMultiGContainer& pmgc, std::mt19937& generator);
+
   /**
    * @brief Permut the MonolocusGenotype.
    *
@@ -80,7 +94,32 @@ public:
    */
   static std::unique_ptr<PolymorphismMultiGContainer> permuteIntraGroupAlleles(const PolymorphismMultiGContainer& pmgc, const std::set<size_t>& groups);
 
-  static std::unique_ptr<PolymorphismMultiGContainer> extractGroups(const PolymorphismMultiGContainer& pmgc, const std::set<size_t>& groups);
+  /**
+   * @brief Permut the alleles between individuals in the same group using a given generator.
+   *
+   * This version does not use RandomTools::DEFAULT_GENERATOR and can be run
+   * concurrently with distinct generators.
+   *
+   * @param pmgc The PolymorphismMultiGContainer to permut.
+   * @param groups The groups ids in which the alleles will be permuted.
+   * @param generator The random number generator to use.
+   * @return A permuted PolymorphismMultiGContainer.
+   */
+  static std::unique_ptr<PolymorphismMultiGContainer> permuteIntraGroupAlleles(const PolymorphismMultiGContainer& pmgc, const std::set<size_t>& groups, std::mt19937& generator);
+
+  /**
+   * @brief Copy the individuals of some groups.
+   *
+   * @param pmgc The PolymorphismMultiGContainer to copy.
+   * @param groups The groups ids of the individuals copied.
+   * @param individualMask For each individual, true if it can be copied. An empty mask keeps all the individuals.
+   * @return A PolymorphismMultiGContainer with the individuals of the groups, group by group.
+   * @throw DimensionException if the mask is not empty and does not have one element per individual.
+   */
+  static std::unique_ptr<PolymorphismMultiGContainer> extractGroups(
+      const PolymorphismMultiGContainer& pmgc,
+      const std::set<size_t>& groups,
+      const std::vector<bool>& individualMask = std::vector<bool>());
 };
 } // end of namespace bpp;
 
@@ -15,7 +15,15 @@ PolymorphismSequenceContainer::PolymorphismSequenceContainer(const SequenceConta
   VectorSiteContainer(sc.getAlphabet()),
   ingroup_(),
   count_(),
-  group_()
+  group_(),
+  version_(0),
+  cacheEnabled_(false),
+  cacheMutex_(),
+  cacheVersion_(0),
+  cacheNbSites_(0),
+  cacheNbSequences_(0),
+  cache_(),
+  trackedMemory_()
 {
   if (sc.getNumberOfSequences() == 0)
     return; // done.
@@ -44,6 +52,7 @@ PolymorphismSequenceContainer::PolymorphismSequenceContainer(const SequenceConta
   }
   ingroup_.resize(getNumberOfSequences(), true);
   group_.resize(getNumberOfSequences());
+  reportMemoryUsage_();
 }
 
 /******************************************************************************/
@@ -52,7 +61,15 @@ PolymorphismSequenceContainer::PolymorphismSequenceContainer(const PolymorphismS
   VectorSiteContainer(psc),
   ingroup_(psc.getNumberOfSequences()),
   count_(psc.getNumberOfSequences()),
-  group_(psc.getNumberOfSequences())
+  group_(psc.getNumberOfSequences()),
+  version_(0),
+  cacheEnabled_(psc.cacheEnabled_),
+  cacheMutex_(),
+  cacheVersion_(0),
+  cacheNbSites_(0),
+  cacheNbSequences_(0),
+  cache_(),
+  trackedMemory_()
 {
   for (size_t i = 0; i < psc.getNumberOfSequences(); i++)
   {
@@ -60,6 +77,7 @@ PolymorphismSequenceContainer::PolymorphismSequenceContainer(const PolymorphismS
     ingroup_[i] = psc.isIngroupMember(i);
     group_[i] = psc.getGroupId(i);
   }
+  reportMemoryUsage_();
 }
 
 /******************************************************************************/
@@ -78,6 +96,11 @@ PolymorphismSequenceContainer& PolymorphismSequenceContainer::operator=(const Po
     ingroup_[i] = psc.isIngroupMember(i);
     group_[i] = psc.getGroupId(i);
   }
+  // Like the copy constructor, keep the cache setting but not the cached results:
+  cacheEnabled_ = psc.cacheEnabled_;
+  clearCache();
+  notifyModification();
+  reportMemoryUsage_();
   return *this;
 }
 
@@ -101,6 +124,9 @@ std::unique_ptr<Sequence> PolymorphismSequenceContainer::removeSequence(size_t s
   count_.erase(count_.begin() + static_cast<ptrdiff_t>(sequencePosition));
   ingroup_.erase(ingroup_.begin() + static_cast<ptrdiff_t>(sequencePosition));
   group_.erase(group_.begin() + static_cast<ptrdiff_t>(sequencePosition));
+  notifyModification();
+  if (MemoryTracker::isTracking())
+    trackedMemory_.report(sequenceMemoryUsage_(sequencePosition), MemoryUsage());
   return VectorSiteContainer::removeSequence(sequencePosition);
 }
 
@@ -177,6 +203,7 @@ void PolymorphismSequenceContainer::setAsIngroupMember(size_t index)
   if (index >= getNumberOfSequences())
     throw IndexOutOfBoundsException("PolymorphismSequenceContainer::setAsIngroupMember.", index, 0, getNumberOfSequences());
   ingroup_[index] = true;
+  notifyModification();
 }
 
 /******************************************************************************/
@@ -187,6 +214,7 @@ void PolymorphismSequenceContainer::setAsIngroupMember(const std::string& name)
   {
     size_t seqPos = getSequencePosition(name);
     ingroup_[seqPos] = true;
+    notifyModification();
   }
   catch (SequenceNotFoundException& snfe)
   {
@@ -201,6 +229,7 @@ void PolymorphismSequenceContainer::setAsOutgroupMember(size_t index)
   if (index >= getNumberOfSequences())
     throw IndexOutOfBoundsException("PolymorphismSequenceContainer::setAsOutgroupMember.", index, 0, getNumberOfSequences());
   ingroup_[index] = false;
+  notifyModification();
 }
 
 /******************************************************************************/
@@ -211,6 +240,7 @@ void PolymorphismSequenceContainer::setAsOutgroupMember(const std::string& name)
   {
     size_t seqPos = getSequencePosition(name);
     ingroup_[seqPos] = false;
+    notifyModification();
   }
   catch (SequenceNotFoundException& snfe)
   {
@@ -227,6 +257,7 @@ void PolymorphismSequenceContainer::setSequenceCount(size_t index, unsigned int
   if (count < 1)
     throw BadIntegerException("PolymorphismSequenceContainer::setSequenceCount: count can't be < 1.", static_cast<int>(count));
   count_[index] = count;
+  notifyModification();
 }
 
 /******************************************************************************/
@@ -254,6 +285,7 @@ void PolymorphismSequenceContainer::incrementSequenceCount(size_t index)
   if (index >= getNumberOfSequences())
     throw IndexOutOfBoundsException("PolymorphismSequenceContainer::incrementSequenceCount.", index, 0, getNumberOfSequences());
   count_[index]++;
+  notifyModification();
 }
 
 /******************************************************************************/
@@ -279,6 +311,7 @@ void PolymorphismSequenceContainer::decrementSequenceCount(size_t index)
   if (count_[index] - 1 < 1)
     throw BadIntegerException("PolymorphismSequenceContainer::decrementSequenceCount: count can't be < 1.", static_cast<int>(count_[index] - 1));
   count_[index]--;
+  notifyModification();
 }
 
 /******************************************************************************/
@@ -351,3 +384,35 @@ unique_ptr<SiteContainerInterface> PolymorphismSequenceContainer::toSiteContaine
 }
 
 /******************************************************************************/
+
+MemoryUsage PolymorphismSequenceContainer::memoryUsage() const
+{
+  MemoryUsage usage;
+  size_t nbSites = getNumberOfSites();
+  usage.add(MemoryUsage::SITES, nbSites * sizeof(void*));
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    usage.add(MemoryUsage::SITES, sizeof(Site) + site(i).size() * sizeof(int));
+  }
+  usage.add(MemoryUsage::SEQUENCES, sizeof(*this) + MemoryUsage::ofVector(ingroup_) + MemoryUsage::ofVector(count_) + MemoryUsage::ofVector(group_));
+  for (const auto& name : getSequenceNames())
+  {
+    usage.add(MemoryUsage::NAMES, sizeof(name) + MemoryUsage::ofString(name));
+  }
+  return usage;
+}
+
+/******************************************************************************/
+
+MemoryUsage PolymorphismSequenceContainer::sequenceMemoryUsage_(size_t sequencePosition) const
+{
+  // The part of memoryUsage() which depends on the sequence
+  MemoryUsage usage;
+  usage.add(MemoryUsage::SITES, getNumberOfSites() * sizeof(int));
+  usage.add(MemoryUsage::SEQUENCES, sizeof(unsigned int) + sizeof(size_t));
+  const string& name = sequence(sequencePosition).getName();
+  usage.add(MemoryUsage::NAMES, sizeof(name) + MemoryUsage::ofString(name));
+  return usage;
+}
+
+/******************************************************************************/
@@ -5,6 +5,9 @@
 #ifndef _POLYMORPHISMSEQUENCECONTAINER_H_
 #define _POLYMORPHISMSEQUENCECONTAINER_H_
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 
@@ -15,6 +18,8 @@
 #include <Bpp/Seq/Container/VectorSiteContainer.h>
 #include <Bpp/Seq/Container/SequenceContainerTools.h>
 
+#include "MemoryUsage.h"
+
 /**
  * @mainpage
  *
@@ -61,6 +66,21 @@ namespace bpp
  * This is a VectorSiteContainer with effectif for each sequence.
  * It also has flag for ingroup and outgroup.
  *
+ * The container can keep a cache of results derived from its content (see
+ * getDerived()), such as the site summaries or the linkage disequilibrium
+ * container computed by SequenceStatistics. The cache is disabled by
+ * default, and must be enabled with setCacheEnabled().
+ *
+ * The cache is emptied when the version of the container changes, which
+ * happens on every modification made through the methods of this class:
+ * adding, inserting or removing sequences, changing their counts, groups
+ * or ingroup flags, copying. It is also emptied when the number of sites
+ * or of sequences changes. The site and sequence mutators inherited from
+ * VectorSiteContainer (setSite(), setSequence(), edits through a reference
+ * returned by site(), ...) can not all be detected: while the cache is
+ * enabled, every such modification must be followed by a call to
+ * notifyModification(), otherwise the cached results are stale.
+ *
  * @author Sylvain Gaillard
  */
 class PolymorphismSequenceContainer :
@@ -70,6 +90,14 @@ private:
   std::vector<bool> ingroup_;
   std::vector<unsigned int> count_;
   std::vector<size_t> group_;
+  unsigned long version_;
+  bool cacheEnabled_;
+  mutable std::mutex cacheMutex_;
+  mutable unsigned long cacheVersion_;
+  mutable size_t cacheNbSites_;
+  mutable size_t cacheNbSequences_;
+  mutable std::map<std::string, std::shared_ptr<const void> > cache_;
+  TrackedMemoryUsage trackedMemory_;
 
 public:
   // Constructors and destructor
@@ -80,8 +108,18 @@ public:
     VectorSiteContainer(alpha),
     ingroup_(std::vector<bool>()),
     count_(0),
-    group_(0)
-  {}
+    group_(0),
+    version_(0),
+    cacheEnabled_(false),
+    cacheMutex_(),
+    cacheVersion_(0),
+    cacheNbSites_(0),
+    cacheNbSequences_(0),
+    cache_(),
+    trackedMemory_()
+  {
+    reportMemoryUsage_();
+  }
 
   /**
    * @brief Build a new empty PolymorphismSequenceContainer of given size.
@@ -90,8 +128,18 @@ public:
     VectorSiteContainer(size, alpha),
     ingroup_(size),
     count_(size),
-    group_(size)
-  {}
+    group_(size),
+    version_(0),
+    cacheEnabled_(false),
+    cacheMutex_(),
+    cacheVersion_(0),
+    cacheNbSites_(0),
+    cacheNbSequences_(0),
+    cache_(),
+    trackedMemory_()
+  {
+    reportMemoryUsage_();
+  }
 
   /**
    * @brief Build a new empty PolymorphismSequenceContainer with given sequence names.
@@ -100,8 +148,18 @@ public:
     VectorSiteContainer(names, alpha),
     ingroup_(names.size()),
     count_(names.size()),
-    group_(names.size())
-  {}
+    group_(names.size()),
+    version_(0),
+    cacheEnabled_(false),
+    cacheMutex_(),
+    cacheVersion_(0),
+    cacheNbSites_(0),
+    cacheNbSequences_(0),
+    cache_(),
+    trackedMemory_()
+  {
+    reportMemoryUsage_();
+  }
 
   /**
    * @brief Build a PolymorphismSequenceContainer by copying data from a SequenceContainer.
@@ -112,8 +170,18 @@ public:
     VectorSiteContainer(sc),
     ingroup_(sc.getNumberOfSequences(), true),
     count_(sc.getNumberOfSequences(), 1),
-    group_(sc.getNumberOfSequences(), 1)
-  {}
+    group_(sc.getNumberOfSequences(), 1),
+    version_(0),
+    cacheEnabled_(false),
+    cacheMutex_(),
+    cacheVersion_(0),
+    cacheNbSites_(0),
+    cacheNbSequences_(0),
+    cache_(),
+    trackedMemory_()
+  {
+    reportMemoryUsage_();
+  }
 
   /**
    * @brief Build a PolymorphismSequenceContainer by copying data from a SequenceContainer.
@@ -175,6 +243,9 @@ public:
     count_.push_back(frequency);
     ingroup_.push_back(true);
     group_.push_back(0);
+    notifyModification();
+    if (MemoryTracker::isTracking())
+      trackedMemory_.report(MemoryUsage(), sequenceMemoryUsage_(getNumberOfSequences() - 1));
   }
 
 
@@ -188,6 +259,9 @@ public:
     count_.insert(count_.begin() + static_cast<ptrdiff_t>(sequencePosition), frequency);
     ingroup_.insert(ingroup_.begin() + static_cast<ptrdiff_t>(sequencePosition), true);
     group_.insert(group_.begin() + static_cast<ptrdiff_t>(sequencePosition), 0);
+    notifyModification();
+    if (MemoryTracker::isTracking())
+      trackedMemory_.report(MemoryUsage(), sequenceMemoryUsage_(sequencePosition));
   }
 
   void addSequence(
@@ -211,6 +285,8 @@ public:
     count_.clear();
     ingroup_.clear();
     group_.clear();
+    notifyModification();
+    reportMemoryUsage_();
   }
 
   /**
@@ -258,6 +334,7 @@ public:
     if (index >= getNumberOfSequences())
       throw IndexOutOfBoundsException("PolymorphismSequenceContainer::setGroupId: index out of bounds.", index, 0, getNumberOfSequences());
     group_[index] = group_id;
+    notifyModification();
   }
 
   /**
@@ -270,6 +347,7 @@ public:
     try
     {
       group_[getSequencePosition(name)] = group_id;
+      notifyModification();
     }
     catch (SequenceNotFoundException& snfe)
     {
@@ -413,6 +491,125 @@ public:
    * @return A SiteContainer object, eventually with duplicated sequences. Names of duplicated sequences are happended with _1, _2, etc.
    */
   std::unique_ptr<SiteContainerInterface> toSiteContainer() const;
+
+  /**
+   * @brief Get the estimated memory footprint of the container.
+   *
+   * The content of the sites is reported as MemoryUsage::SITES, the
+   * sequence counts, groups and ingroup flags as MemoryUsage::SEQUENCES
+   * and the sequence names as MemoryUsage::NAMES.
+   *
+   * When a MemoryTracker is installed, the container reports the
+   * footprint of each sequence added or removed, and its whole footprint
+   * when it is built, assigned or cleared. Changes of the sites made in
+   * place or through the site methods are not reported.
+   */
+  MemoryUsage memoryUsage() const;
+
+  /**
+   * @brief Get the version of the container, increased by every modification.
+   */
+  unsigned long getVersion() const { return version_; }
+
+  /**
+   * @brief Increase the version of the container, making the cached results obsolete.
+   *
+   * This must be called after a modification of the sites which is not made
+   * through the methods of this class.
+   */
+  void notifyModification() { version_++; }
+
+  /**
+   * @brief Enable or disable the cache of derived results.
+   *
+   * The cache is disabled by default. Disabling it empties it. A copy of
+   * the container, or an assignment, keeps this setting, but not the cached results.
+   */
+  void setCacheEnabled(bool enabled)
+  {
+    cacheEnabled_ = enabled;
+    if (!enabled)
+      clearCache();
+  }
+
+  bool isCacheEnabled() const { return cacheEnabled_; }
+
+  /**
+   * @brief Get a result derived from the content of the container, computing it if it is not cached.
+   *
+   * If the cache is disabled, the result is computed at each call.
+   * The key must identify both the computation and its parameters. The
+   * computation is done without holding the lock of the cache, so that it
+   * can itself use the cache; two threads may then compute the same result,
+   * the first one being kept.
+   *
+   * @param key The key of the result.
+   * @param compute A function returning the result as a std::shared_ptr<const T>.
+   * @return The result.
+   */
+  template<class T, class F>
+  std::shared_ptr<const T> getDerived(const std::string& key, F compute) const
+  {
+    if (!cacheEnabled_)
+      return compute();
+    {
+      std::lock_guard<std::mutex> lock(cacheMutex_);
+      clearObsoleteCache_();
+      auto it = cache_.find(key);
+      if (it != cache_.end())
+        return std::static_pointer_cast<const T>(it->second);
+    }
+    unsigned long version = version_;
+    std::shared_ptr<const T> result = compute();
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    clearObsoleteCache_();
+    if (version == version_)
+    {
+      auto it = cache_.insert(std::make_pair(key, std::static_pointer_cast<const void>(result))).first;
+      return std::static_pointer_cast<const T>(it->second);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Remove all the cached results.
+   */
+  void clearCache() const
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cache_.clear();
+  }
+
+private:
+  /**
+   * @brief Get the estimated footprint of one sequence of the container.
+   */
+  MemoryUsage sequenceMemoryUsage_(size_t sequencePosition) const;
+
+  /**
+   * @brief Report the whole footprint of the container to the global tracker, if any.
+   */
+  void reportMemoryUsage_()
+  {
+    if (MemoryTracker::isTracking())
+      trackedMemory_.reportAll(memoryUsage());
+  }
+
+  /**
+   * @brief Empty the cache if the container has changed since it was filled.
+   *
+   * The lock of the cache must be held.
+   */
+  void clearObsoleteCache_() const
+  {
+    if (cacheVersion_ != version_ || cacheNbSites_ != getNumberOfSites() || cacheNbSequences_ != getNumberOfSequences())
+    {
+      cache_.clear();
+      cacheVersion_ = version_;
+      cacheNbSites_ = getNumberOfSites();
+      cacheNbSequences_ = getNumberOfSequences();
+    }
+  }
 };
 } // end of namespace bpp;
 
@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _REPLICATESOURCE_H_
+#define _REPLICATESOURCE_H_
+
+// From local
+#include "HaplotypeMatrix.h"
+
+namespace bpp
+{
+/**
+ * @brief The ReplicateSource interface.
+ *
+ * A ReplicateSource delivers a sequence of replicated datasets (e.g.
+ * simulated by a coalescent simulator) as HaplotypeMatrix objects.
+ * The matrix to fill is given by the caller, so that its memory can be
+ * reused from one replicate to the next.
+ */
+class ReplicateSource
+{
+public:
+  virtual ~ReplicateSource() {}
+
+public:
+  /**
+   * @brief Read the next replicate.
+   *
+   * @param replicate The matrix receiving the replicate, reset by this method.
+   * @return false if there is no more replicate, replicate is then left unspecified.
+   */
+  virtual bool nextReplicate(HaplotypeMatrix& replicate) = 0;
+};
+} // end of namespace bpp;
+
+#endif // _REPLICATESOURCE_H_
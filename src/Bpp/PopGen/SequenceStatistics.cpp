@@ -5,11 +5,19 @@
 #include "SequenceStatistics.h" // class's header file
 #include "PolymorphismSequenceContainerTools.h"
 #include "PolymorphismSequenceContainer.h"
+#include "HaplotypeMatrix.h"
 
 // From the STL:
 #include <ctype.h>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
 #include <vector>
 
 using namespace std;
@@ -27,6 +35,348 @@ using namespace std;
 
 using namespace bpp;
 
+namespace
+{
+/**
+ * @brief Sequences packed as bit planes, 64 sites per word.
+ *
+ * For each word of each sequence, the first plane flags the sites with a
+ * resolved state, and the following ones hold the bits of the state.
+ */
+class PackedSequences
+{
+private:
+  size_t nbWords_;
+  size_t nbPlanes_;
+  std::vector<uint64_t> planes_;
+
+public:
+  PackedSequences(const PolymorphismSequenceContainer& psc) :
+    nbWords_((psc.getNumberOfSites() + 63) / 64),
+    nbPlanes_(1),
+    planes_()
+  {
+    int alphabetSize = static_cast<int>(psc.getAlphabet()->getSize());
+    while ((1 << nbPlanes_) < alphabetSize)
+    {
+      nbPlanes_++;
+    }
+    size_t nbSequences = psc.getNumberOfSequences();
+    size_t stride = nbPlanes_ + 1;
+    planes_.assign(nbSequences * nbWords_ * stride, 0);
+    for (size_t k = 0; k < psc.getNumberOfSites(); ++k)
+    {
+      const Site& site = psc.site(k);
+      size_t w = k / 64;
+      uint64_t bit = uint64_t(1) << (k % 64);
+      for (size_t i = 0; i < nbSequences; ++i)
+      {
+        int state = site.getValue(i);
+        if (state < 0 || state >= alphabetSize)
+          continue;
+        uint64_t* word = &planes_[(i * nbWords_ + w) * stride];
+        word[0] |= bit;
+        for (size_t p = 0; p < nbPlanes_; ++p)
+        {
+          if ((state >> p) & 1)
+            word[p + 1] |= bit;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Count the differences between two sequences, and the sites where both are resolved.
+   */
+  void compare(size_t i, size_t j, unsigned int& differences, unsigned int& sites) const
+  {
+    size_t stride = nbPlanes_ + 1;
+    const uint64_t* a = &planes_[i * nbWords_ * stride];
+    const uint64_t* b = &planes_[j * nbWords_ * stride];
+    differences = 0;
+    sites = 0;
+    for (size_t w = 0; w < nbWords_; ++w, a += stride, b += stride)
+    {
+      uint64_t resolved = a[0] & b[0];
+      uint64_t diff = 0;
+      for (size_t p = 1; p < stride; ++p)
+      {
+        diff |= a[p] ^ b[p];
+      }
+      differences += HaplotypeMatrix::popCount(diff & resolved);
+      sites += HaplotypeMatrix::popCount(resolved);
+    }
+  }
+};
+
+/**
+ * @brief Number of rows and columns of the tiles of pairwiseDifferences().
+ */
+const size_t TILE_SIZE = 32;
+
+/**
+ * @brief Counts of the states of a site.
+ *
+ * The storage holds one count per resolved state, plus a last one for the
+ * gaps and unresolved characters. With a std::array, the number of states
+ * is known at compilation time, so that the counting loops have no
+ * alphabet-dependent bound nor branch.
+ */
+template<class Storage>
+class StateCounts
+{
+private:
+  Storage counts_;
+  size_t sampleSize_;
+
+public:
+  explicit StateCounts(size_t alphabetSize) :
+    counts_(),
+    sampleSize_(0)
+  {
+    init_(counts_, alphabetSize + 1);
+  }
+
+public:
+  size_t getNumberOfStates() const { return counts_.size() - 1; }
+
+  /**
+   * @brief Count the states of a site.
+   */
+  void count(const Site& site)
+  {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    size_t nbStates = getNumberOfStates();
+    for (int state : site.getContent())
+    {
+      // Negative states become large, and go to the last count.
+      size_t s = static_cast<size_t>(static_cast<unsigned int>(state));
+      counts_[s < nbStates ? s : nbStates]++;
+    }
+    sampleSize_ = site.size() - counts_[nbStates];
+  }
+
+  /**
+   * @brief Get the number of resolved states.
+   */
+  size_t getSampleSize() const { return sampleSize_; }
+
+  size_t getCount(size_t state) const { return counts_[state]; }
+
+  /**
+   * @brief Get the number of distinct resolved states.
+   */
+  size_t getNumberOfDistinctStates() const
+  {
+    size_t nb = 0;
+    for (size_t s = 0; s < getNumberOfStates(); ++s)
+    {
+      nb += counts_[s] > 0;
+    }
+    return nb;
+  }
+
+  /**
+   * @brief Get the probability that two resolved states drawn without replacement differ.
+   */
+  double pairwiseDiversity() const
+  {
+    if (sampleSize_ < 2)
+      return 0.;
+    size_t pairs = 0;
+    for (size_t s = 0; s < getNumberOfStates(); ++s)
+    {
+      // 0 * (0 - 1) wraps to 0.
+      pairs += counts_[s] * (counts_[s] - 1);
+    }
+    return 1. - static_cast<double>(pairs) / static_cast<double>(sampleSize_ * (sampleSize_ - 1));
+  }
+
+private:
+  template<size_t N>
+  static void init_(std::array<size_t, N>& counts, size_t) { counts.fill(0); }
+
+  static void init_(std::vector<size_t>& counts, size_t size) { counts.assign(size, 0); }
+};
+
+template<size_t N>
+using FixedStateCounts = StateCounts< std::array<size_t, N + 1> >;
+
+/**
+ * @brief Call a kernel with the StateCounts specialized for an alphabet size.
+ *
+ * Nucleotides (4 states), proteins (20 states) and codons (64 states) get
+ * a fixed number of states, the other alphabets a dynamic one.
+ *
+ * @param alphabetSize The number of resolved states.
+ * @param kernel A generic function taking a StateCounts, returning the same type for all of them.
+ */
+template<class F>
+auto dispatchAlphabetSize(size_t alphabetSize, F kernel) -> decltype(kernel(StateCounts< std::vector<size_t> >(alphabetSize)))
+{
+  switch (alphabetSize)
+  {
+  case 4:
+    return kernel(FixedStateCounts<4>(alphabetSize));
+  case 20:
+    return kernel(FixedStateCounts<20>(alphabetSize));
+  case 64:
+    return kernel(FixedStateCounts<64>(alphabetSize));
+  default:
+    return kernel(StateCounts< std::vector<size_t> >(alphabetSize));
+  }
+}
+
+/**
+ * @brief Get the set of the resolved nucleotides of a site, as a 4-bit mask.
+ */
+inline unsigned int nucleotideMask(const FixedStateCounts<4>& counts)
+{
+  unsigned int mask = 0;
+  for (size_t state = 0; state < 4; ++state)
+  {
+    mask |= static_cast<unsigned int>(counts.getCount(state) > 0) << state;
+  }
+  return mask;
+}
+
+/**
+ * @brief Tell if a set of nucleotides is a transition, {A, G} or {C, T}.
+ */
+inline bool isTransition(unsigned int mask)
+{
+  return mask == 0x5 || mask == 0xA;
+}
+
+/**
+ * @brief Tell if a set of nucleotides is a transversion, two nucleotides not forming a transition.
+ */
+inline bool isTransversion(unsigned int mask)
+{
+  return HaplotypeMatrix::popCount(mask) == 2 && !isTransition(mask);
+}
+/**
+ * @brief Aggregates of the sites of a container, shared by several statistics.
+ *
+ * The complete sites, where every sequence is resolved, give the counts
+ * used with gapflag set. The sample sizes and the state counts of all the
+ * sites, where each sequence stands for its count of copies, give the
+ * SiteSampleSizeSummary.
+ */
+struct SiteSummary
+{
+  unsigned int numberOfCompleteSites;
+  unsigned int numberOfPolymorphicCompleteSites;
+  unsigned int numberOfSingletons;
+  unsigned int numberOfMutations;
+  double pairwiseDiversity;
+  vector<unsigned int> sampleSizeHistogram;
+  vector<unsigned int> polymorphicSites;
+  vector<size_t> identicalPairs;
+};
+
+/**
+ * @brief Compute the SiteSummary of a container in a single pass over its sites.
+ */
+shared_ptr<const SiteSummary> siteSummary(const PolymorphismSequenceContainer& psc)
+{
+  return psc.getDerived<SiteSummary>("siteSummary", [&]() {
+        size_t nbSequences = psc.getNumberOfSequences();
+        vector<size_t> weights(nbSequences);
+        size_t totalWeight = 0;
+        bool weighted = false;
+        for (size_t j = 0; j < nbSequences; ++j)
+        {
+          weights[j] = psc.getSequenceCount(j);
+          totalWeight += weights[j];
+          weighted = weighted || weights[j] != 1;
+        }
+        size_t alphabetSize = psc.getAlphabet()->getSize();
+        return dispatchAlphabetSize(alphabetSize, [&](auto counts) {
+              auto summary = make_shared<SiteSummary>(SiteSummary{
+                    0, 0, 0, 0, 0.,
+                    vector<unsigned int>(totalWeight + 1, 0),
+                    vector<unsigned int>(totalWeight + 1, 0),
+                    vector<size_t>(totalWeight + 1, 0)
+                  });
+              vector<size_t> weightedCounts(alphabetSize);
+              for (size_t i = 0; i < psc.getNumberOfSites(); ++i)
+              {
+                const Site& site = psc.site(i);
+                counts.count(site);
+                size_t nbStates = counts.getNumberOfDistinctStates();
+                if (counts.getSampleSize() == nbSequences && nbSequences > 0)
+                {
+                  summary->numberOfCompleteSites++;
+                  if (nbStates > 1)
+                    summary->numberOfPolymorphicCompleteSites++;
+                  summary->numberOfMutations += static_cast<unsigned int>(nbStates - 1);
+                  for (size_t state = 0; state < counts.getNumberOfStates(); ++state)
+                  {
+                    if (counts.getCount(state) == 1)
+                      summary->numberOfSingletons++;
+                  }
+                  summary->pairwiseDiversity += counts.pairwiseDiversity();
+                }
+
+                size_t n = 0, pairs = 0;
+                if (weighted)
+                {
+                  fill(weightedCounts.begin(), weightedCounts.end(), 0);
+                  for (size_t j = 0; j < nbSequences; ++j)
+                  {
+                    int state = site.getValue(j);
+                    if (state >= 0 && state < static_cast<int>(alphabetSize))
+                      weightedCounts[static_cast<size_t>(state)] += weights[j];
+                  }
+                  for (size_t k : weightedCounts)
+                  {
+                    n += k;
+                    // 0 * (0 - 1) wraps to 0.
+                    pairs += k * (k - 1);
+                  }
+                }
+                else
+                {
+                  n = counts.getSampleSize();
+                  for (size_t state = 0; state < counts.getNumberOfStates(); ++state)
+                  {
+                    pairs += counts.getCount(state) * (counts.getCount(state) - 1);
+                  }
+                }
+                summary->sampleSizeHistogram[n]++;
+                if (nbStates < 2)
+                  continue;
+                summary->polymorphicSites[n]++;
+                summary->identicalPairs[n] += pairs;
+              }
+              return shared_ptr<const SiteSummary>(summary);
+            });
+      });
+}
+
+/**
+ * @brief The ingroup sequences of a container.
+ *
+ * This is the container itself when it has no outgroup sequence, else a
+ * copy of its ingroup sequences, owned by copy.
+ */
+const PolymorphismSequenceContainer& ingroupOf(
+    const PolymorphismSequenceContainer& psc,
+    unique_ptr<PolymorphismSequenceContainer>& copy)
+{
+  for (size_t i = 0; i < psc.getNumberOfSequences(); ++i)
+  {
+    if (!psc.isIngroupMember(i))
+    {
+      copy = PolymorphismSequenceContainerTools::extractIngroup(psc);
+      return *copy;
+    }
+  }
+  return psc;
+}
+}
+
 // ******************************************************************************
 // Basic statistics
 // ******************************************************************************
@@ -36,35 +386,62 @@ unsigned int SequenceStatistics::numberOfPolymorphicSites(
     bool gapflag,
     bool ignoreUnknown)
 {
-  unsigned int s = 0;
-  unique_ptr<ConstSiteIterator> si;
+  // Complete sites have no unknown state.
   if (gapflag)
-    si.reset(new CompleteSiteContainerIterator(psc));
-  else
-    si.reset(new SimpleSiteContainerIterator(psc));
-  while (si->hasMoreSites())
+    return siteSummary(psc)->numberOfPolymorphicCompleteSites;
+  return *psc.getDerived<unsigned int>("numberOfPolymorphicSites/" + TextTools::toString(ignoreUnknown), [&]() {
+        unsigned int s = 0;
+        SimpleSiteContainerIterator si(psc);
+        while (si.hasMoreSites())
+        {
+          auto& site = si.nextSite();
+          if (!SiteTools::isConstant(site, ignoreUnknown))
+          {
+            s++;
+          }
+        }
+        return make_shared<const unsigned int>(s);
+      });
+}
+
+unsigned int SequenceStatistics::numberOfPolymorphicSites(
+    const SitePatterns& patterns,
+    bool gapflag,
+    bool ignoreUnknown)
+{
+  unsigned int s = 0;
+  for (size_t p = 0; p < patterns.getNumberOfPatterns(); ++p)
   {
-    auto site = si->nextSite();
+    const Site& site = patterns.getPattern(p);
+    if (gapflag && !SiteTools::isComplete(site))
+      continue;
     if (!SiteTools::isConstant(site, ignoreUnknown))
     {
-      s++;
+      s += patterns.getWeight(p);
     }
   }
   return s;
 }
 
+unsigned int SequenceStatistics::numberOfPolymorphicSites(const VariantSiteContainer& vsc)
+{
+  // Complete variant sites have at least two resolved states
+  return static_cast<unsigned int>(vsc.getNumberOfCompleteVariantSites());
+}
+
 double SequenceStatistics::frequencyOfPolymorphicSites(const PolymorphismSequenceContainer& psc, bool gapflag, bool ignoreUnknown)
 {
+  if (gapflag)
+  {
+    shared_ptr<const SiteSummary> summary = siteSummary(psc);
+    return static_cast<double>(summary->numberOfPolymorphicCompleteSites) / static_cast<double>(summary->numberOfCompleteSites);
+  }
   double s = 0;
   double n = 0;
-  unique_ptr<ConstSiteIterator> si;
-  if (gapflag)
-    si.reset(new CompleteSiteContainerIterator(psc));
-  else
-    si.reset(new SimpleSiteContainerIterator(psc));
-  while (si->hasMoreSites())
+  SimpleSiteContainerIterator si(psc);
+  while (si.hasMoreSites())
   {
-    auto& site = si->nextSite();
+    auto& site = si.nextSite();
     n++;
     if (!SiteTools::isConstant(site, ignoreUnknown))
     {
@@ -74,6 +451,30 @@ double SequenceStatistics::frequencyOfPolymorphicSites(const PolymorphismSequenc
   return s / n;
 }
 
+double SequenceStatistics::frequencyOfPolymorphicSites(const SitePatterns& patterns, bool gapflag, bool ignoreUnknown)
+{
+  double s = 0;
+  double n = 0;
+  for (size_t p = 0; p < patterns.getNumberOfPatterns(); ++p)
+  {
+    const Site& site = patterns.getPattern(p);
+    if (gapflag && !SiteTools::isComplete(site))
+      continue;
+    double weight = static_cast<double>(patterns.getWeight(p));
+    n += weight;
+    if (!SiteTools::isConstant(site, ignoreUnknown))
+    {
+      s += weight;
+    }
+  }
+  return s / n;
+}
+
+double SequenceStatistics::frequencyOfPolymorphicSites(const VariantSiteContainer& vsc)
+{
+  return static_cast<double>(vsc.getNumberOfCompleteVariantSites()) / static_cast<double>(vsc.getNumberOfCompleteSites());
+}
+
 unsigned int SequenceStatistics::numberOfParsimonyInformativeSites(const PolymorphismSequenceContainer& psc, bool gapflag)
 {
   unique_ptr<ConstSiteIterator> si;
@@ -95,16 +496,29 @@ unsigned int SequenceStatistics::numberOfParsimonyInformativeSites(const Polymor
 
 unsigned int SequenceStatistics::numberOfSingletons(const PolymorphismSequenceContainer& psc, bool gapflag)
 {
-  unique_ptr<ConstSiteIterator> si;
   if (gapflag)
-    si.reset(new CompleteSiteContainerIterator(psc));
-  else
-    si.reset(new SimpleSiteContainerIterator(psc));
+    return siteSummary(psc)->numberOfSingletons;
+  return *psc.getDerived<unsigned int>("numberOfSingletons", [&]() {
+        SimpleSiteContainerIterator si(psc);
+        unsigned int nus = 0;
+        while (si.hasMoreSites())
+        {
+          auto& site = si.nextSite();
+          nus += getNumberOfSingletons_(site);
+        }
+        return make_shared<const unsigned int>(nus);
+      });
+}
+
+unsigned int SequenceStatistics::numberOfSingletons(const SitePatterns& patterns, bool gapflag)
+{
   unsigned int nus = 0;
-  while (si->hasMoreSites())
+  for (size_t p = 0; p < patterns.getNumberOfPatterns(); ++p)
   {
-    auto& site = si->nextSite();
-    nus += getNumberOfSingletons_(site);
+    const Site& site = patterns.getPattern(p);
+    if (gapflag && !SiteTools::isComplete(site))
+      continue;
+    nus += patterns.getWeight(p) * getNumberOfSingletons_(site);
   }
   return nus;
 }
@@ -130,16 +544,29 @@ unsigned int SequenceStatistics::numberOfTriplets(const PolymorphismSequenceCont
 
 unsigned int SequenceStatistics::totalNumberOfMutations(const PolymorphismSequenceContainer& psc, bool gapflag)
 {
-  unique_ptr<ConstSiteIterator> si;
   if (gapflag)
-    si.reset(new CompleteSiteContainerIterator(psc));
-  else
-    si.reset(new SimpleSiteContainerIterator(psc));
+    return siteSummary(psc)->numberOfMutations;
+  return *psc.getDerived<unsigned int>("totalNumberOfMutations", [&]() {
+        SimpleSiteContainerIterator si(psc);
+        unsigned int tnm = 0;
+        while (si.hasMoreSites())
+        {
+          auto& site = si.nextSite();
+          tnm += getNumberOfMutations_(site);
+        }
+        return make_shared<const unsigned int>(tnm);
+      });
+}
+
+unsigned int SequenceStatistics::totalNumberOfMutations(const SitePatterns& patterns, bool gapflag)
+{
   unsigned int tnm = 0;
-  while (si->hasMoreSites())
+  for (size_t p = 0; p < patterns.getNumberOfPatterns(); ++p)
   {
-    auto& site = si->nextSite();
-    tnm += getNumberOfMutations_(site);
+    const Site& site = patterns.getPattern(p);
+    if (gapflag && !SiteTools::isComplete(site))
+      continue;
+    tnm += patterns.getWeight(p) * getNumberOfMutations_(site);
   }
   return tnm;
 }
@@ -164,35 +591,94 @@ unsigned int SequenceStatistics::totalNumberOfMutationsOnExternalBranches(
   return nmuts;
 }
 
+unsigned int SequenceStatistics::totalNumberOfMutationsOnExternalBranches(
+    const PolymorphismSequenceContainer& ing,
+    const AncestralStates& ancestral)
+{
+  if (ing.getNumberOfSites() != ancestral.getNumberOfSites())
+    throw DimensionException("SequenceStatistics::totalNumberOfMutationsOnExternalBranches: ing and ancestral don't have the same size.", ancestral.getNumberOfSites(), ing.getNumberOfSites());
+  unique_ptr<PolymorphismSequenceContainer> copy;
+  const PolymorphismSequenceContainer& samples = ingroupOf(ing, copy);
+  return dispatchAlphabetSize(samples.getAlphabet()->getSize(), [&](auto counts) {
+        unsigned int nmuts = 0;
+        for (size_t i = 0; i < samples.getNumberOfSites(); ++i)
+        {
+          if (!ancestral.isKnown(i))
+            continue;
+          counts.count(samples.site(i));
+          // use fully resolved sites
+          if (counts.getSampleSize() != samples.getNumberOfSequences())
+            continue;
+          size_t ancestralState = static_cast<size_t>(ancestral.getState(i));
+          for (size_t state = 0; state < counts.getNumberOfStates(); ++state)
+          {
+            nmuts += counts.getCount(state) == 1 && state != ancestralState;
+          }
+        }
+        return nmuts;
+      });
+}
+
 double SequenceStatistics::heterozygosity(const PolymorphismSequenceContainer& psc, bool gapflag)
 {
-  unique_ptr<ConstSiteIterator> si;
-  if (gapflag)
-    si.reset(new CompleteSiteContainerIterator(psc));
-  else
-    si.reset(new SimpleSiteContainerIterator(psc));
+  return *psc.getDerived<double>("heterozygosity/" + TextTools::toString(gapflag), [&]() {
+        unique_ptr<ConstSiteIterator> si;
+        if (gapflag)
+          si.reset(new CompleteSiteContainerIterator(psc));
+        else
+          si.reset(new SimpleSiteContainerIterator(psc));
+        double s = 0;
+        while (si->hasMoreSites())
+        {
+          auto& site = si->nextSite();
+          s += SiteTools::heterozygosity(site);
+        }
+        return make_shared<const double>(s);
+      });
+}
+
+double SequenceStatistics::heterozygosity(const SitePatterns& patterns, bool gapflag)
+{
   double s = 0;
-  while (si->hasMoreSites())
+  for (size_t p = 0; p < patterns.getNumberOfPatterns(); ++p)
   {
-    auto& site = si->nextSite();
-    s += SiteTools::heterozygosity(site);
+    const Site& site = patterns.getPattern(p);
+    if (gapflag && !SiteTools::isComplete(site))
+      continue;
+    s += patterns.getWeight(p) * SiteTools::heterozygosity(site);
   }
   return s;
 }
 
 double SequenceStatistics::squaredHeterozygosity(const PolymorphismSequenceContainer& psc, bool gapflag)
 {
-  unique_ptr<ConstSiteIterator> si;
-  if (gapflag)
-    si.reset(new CompleteSiteContainerIterator(psc));
-  else
-    si.reset(new SimpleSiteContainerIterator(psc));
+  return *psc.getDerived<double>("squaredHeterozygosity/" + TextTools::toString(gapflag), [&]() {
+        unique_ptr<ConstSiteIterator> si;
+        if (gapflag)
+          si.reset(new CompleteSiteContainerIterator(psc));
+        else
+          si.reset(new SimpleSiteContainerIterator(psc));
+        double s = 0;
+        while (si->hasMoreSites())
+        {
+          auto& site = si->nextSite();
+          double h = SiteTools::heterozygosity(site);
+          s += h * h;
+        }
+        return make_shared<const double>(s);
+      });
+}
+
+double SequenceStatistics::squaredHeterozygosity(const SitePatterns& patterns, bool gapflag)
+{
   double s = 0;
-  while (si->hasMoreSites())
+  for (size_t p = 0; p < patterns.getNumberOfPatterns(); ++p)
   {
-    auto& site = si->nextSite();
+    const Site& site = patterns.getPattern(p);
+    if (gapflag && !SiteTools::isComplete(site))
+      continue;
     double h = SiteTools::heterozygosity(site);
-    s += h * h;
+    s += patterns.getWeight(p) * h * h;
   }
   return s;
 }
@@ -203,14 +689,38 @@ double SequenceStatistics::squaredHeterozygosity(const PolymorphismSequenceConta
 
 double SequenceStatistics::gcContent(const PolymorphismSequenceContainer& psc)
 {
-  map<int, double> freqs;
-  SequenceContainerTools::getFrequencies(psc, freqs);
   auto& alpha = psc.alphabet();
-  return (freqs[alpha.charToInt("C")] + freqs[alpha.charToInt("G")]) / (freqs[alpha.charToInt("A")] + freqs[alpha.charToInt("C")] + freqs[alpha.charToInt("G")] + freqs[alpha.charToInt("T")]);
+  if (!AlphabetTools::isNucleicAlphabet(&alpha))
+    throw AlphabetMismatchException("SequenceStatistics::gcContent(). PolymorphismSequenceContainer must be with a nucleic alphabet.", &alpha, AlphabetTools::DNA_ALPHABET.get());
+  int a = alpha.charToInt("A"), c = alpha.charToInt("C"), g = alpha.charToInt("G");
+  int t = alpha.charToInt(AlphabetTools::isDNAAlphabet(&alpha) ? "T" : "U");
+  FixedStateCounts<4> counts(4);
+  size_t nbGC = 0, nbResolved = 0;
+  for (size_t i = 0; i < psc.getNumberOfSites(); ++i)
+  {
+    const Site& site = psc.site(i);
+    counts.count(site);
+    if (counts.getSampleSize() < site.size()
+        && counts.getSampleSize() + static_cast<size_t>(std::count(site.getContent().begin(), site.getContent().end(), alpha.getGapCharacterCode())) < site.size())
+    {
+      // Unresolved characters: use the frequencies of all the states.
+      map<int, double> freqs;
+      SequenceContainerTools::getFrequencies(psc, freqs);
+      return (freqs[c] + freqs[g]) / (freqs[a] + freqs[c] + freqs[g] + freqs[t]);
+    }
+    size_t nbSiteGC = counts.getCount(static_cast<size_t>(c)) + counts.getCount(static_cast<size_t>(g));
+    nbGC += nbSiteGC;
+    nbResolved += nbSiteGC + counts.getCount(static_cast<size_t>(a)) + counts.getCount(static_cast<size_t>(t));
+  }
+  return static_cast<double>(nbGC) / static_cast<double>(nbResolved);
 }
 
 std::vector<unsigned int> SequenceStatistics::gcPolymorphism(const PolymorphismSequenceContainer& psc, bool gapflag)
 {
+  auto& alpha = psc.alphabet();
+  if (!AlphabetTools::isNucleicAlphabet(&alpha))
+    throw AlphabetMismatchException("SequenceStatistics::gcPolymorphism(). PolymorphismSequenceContainer must be with a nucleic alphabet.", &alpha, AlphabetTools::DNA_ALPHABET.get());
+  size_t c = static_cast<size_t>(alpha.charToInt("C")), g = static_cast<size_t>(alpha.charToInt("G"));
   unsigned int nbMut = 0;
   unsigned int nbGC = 0;
   size_t nbSeq = psc.getNumberOfSequences();
@@ -220,18 +730,27 @@ std::vector<unsigned int> SequenceStatistics::gcPolymorphism(const PolymorphismS
     si.reset(new CompleteSiteContainerIterator(psc));
   else
     si.reset(new NoGapSiteContainerIterator(psc));
+  FixedStateCounts<4> counts(4);
   while (si->hasMoreSites())
   {
     auto& site = si->nextSite();
-    if (!SiteTools::isConstant(site))
+    counts.count(site);
+    long double freqGC = 0.;
+    if (counts.getSampleSize() == site.size())
     {
-      long double freqGC = SymbolListTools::getGCContent(site);
-      if (freqGC > 0 && freqGC < 1) // Not 100% AT or GC
-      {
-        nbMut += static_cast<unsigned int>(nbSeq);
-        long double adGC = freqGC * nbSeq;
-        nbGC += static_cast<unsigned int>(adGC);
-      }
+      // Only resolved states: the site is constant unless it has GC and AT states.
+      freqGC = static_cast<double>(counts.getCount(c) + counts.getCount(g)) / static_cast<double>(site.size());
+    }
+    else if (!SiteTools::isConstant(site))
+    {
+      // Unresolved characters
+      freqGC = SymbolListTools::getGCContent(site);
+    }
+    if (freqGC > 0 && freqGC < 1) // Not 100% AT or GC
+    {
+      nbMut += static_cast<unsigned int>(nbSeq);
+      long double adGC = freqGC * nbSeq;
+      nbGC += static_cast<unsigned int>(adGC);
     }
   }
   vect[0] = nbMut;
@@ -257,201 +776,238 @@ double SequenceStatistics::watterson75(const PolymorphismSequenceContainer& psc,
   return ThetaW;
 }
 
+double SequenceStatistics::watterson75(const SitePatterns& patterns, bool gapflag, bool ignoreUnknown, bool scaled)
+{
+  double ThetaW;
+  size_t n = patterns.getNumberOfSequences();
+  map<string, double> values = getUsefulValues_(n);
+  double s = 0;
+  if (scaled)
+    s = frequencyOfPolymorphicSites(patterns, gapflag, ignoreUnknown);
+  else
+    s = static_cast<double>(numberOfPolymorphicSites(patterns, gapflag, ignoreUnknown));
+  ThetaW = s / values["a1"];
+  return ThetaW;
+}
+
+double SequenceStatistics::watterson75(const VariantSiteContainer& vsc, bool scaled)
+{
+  map<string, double> values = getUsefulValues_(vsc.getNumberOfSequences());
+  double s = scaled ? frequencyOfPolymorphicSites(vsc) : static_cast<double>(numberOfPolymorphicSites(vsc));
+  return s / values["a1"];
+}
+
 double SequenceStatistics::tajima83(const PolymorphismSequenceContainer& psc, bool gapflag, bool ignoreUnknown, bool scaled)
 {
-  size_t alphabetSize = psc.getAlphabet()->getSize();
-  unique_ptr<ConstSiteIterator> si;
-  double value2 = 0.;
-  double l = 0;
   if (gapflag)
-    si.reset(new CompleteSiteContainerIterator(psc));
-  else
-    si.reset(new SimpleSiteContainerIterator(psc));
-  while (si->hasMoreSites())
   {
-    auto& site = si->nextSite();
-    l++;
-    if (!SiteTools::isConstant(site, ignoreUnknown))
-    {
-      double value = 0.;
-      map<int, size_t> count;
-      SymbolListTools::getCounts(site, count);
-      map<int, size_t> tmp_k;
-      size_t tmp_n = 0;
-      for (auto& it : count)
-      {
-        if (it.first >= 0 && it.first < static_cast<int>(alphabetSize))
+    shared_ptr<const SiteSummary> summary = siteSummary(psc);
+    return scaled ? summary->pairwiseDiversity / static_cast<double>(summary->numberOfCompleteSites) : summary->pairwiseDiversity;
+  }
+  return *psc.getDerived<double>("tajima83/" + TextTools::toString(ignoreUnknown) + "/" + TextTools::toString(scaled), [&]() {
+        // The pairwise diversity of a site only depends on its resolved
+        // states, whatever ignoreUnknown.
+        return dispatchAlphabetSize(psc.getAlphabet()->getSize(), [&](auto counts) {
+              SimpleSiteContainerIterator si(psc);
+              double value2 = 0.;
+              double l = 0;
+              while (si.hasMoreSites())
+              {
+                counts.count(si.nextSite());
+                l++;
+                value2 += counts.pairwiseDiversity();
+              }
+              return make_shared<const double>(scaled ? value2 / l : value2);
+            });
+      });
+}
+
+double SequenceStatistics::tajima83(const SitePatterns& patterns, bool gapflag, bool ignoreUnknown, bool scaled)
+{
+  if (patterns.getNumberOfPatterns() == 0)
+    return scaled ? NAN : 0.;
+  return dispatchAlphabetSize(patterns.getPattern(0).getAlphabet()->getSize(), [&](auto counts) {
+        double value2 = 0.;
+        double l = 0;
+        for (size_t p = 0; p < patterns.getNumberOfPatterns(); ++p)
         {
-          tmp_k[it.first] = it.second * (it.second - 1);
-          tmp_n += it.second;
+          const Site& site = patterns.getPattern(p);
+          if (gapflag && !SiteTools::isComplete(site))
+            continue;
+          double weight = static_cast<double>(patterns.getWeight(p));
+          l += weight;
+          counts.count(site);
+          value2 += weight * counts.pairwiseDiversity();
         }
-      }
-      if (tmp_n == 0 || tmp_n == 1)
-        continue;
-      for (auto& it : tmp_k)
-      {
-        value += static_cast<double>(it.second) / static_cast<double>(tmp_n * (tmp_n - 1));
-      }
-      value2 += 1. - value;
-    }
-  }
-  return scaled ? value2 / l : value2;
+        return scaled ? value2 / l : value2;
+      });
+}
+
+double SequenceStatistics::tajima83(const VariantSiteContainer& vsc, bool scaled)
+{
+  double value2 = dispatchAlphabetSize(vsc.getAlphabet()->getSize(), [&](auto counts) {
+        double sum = 0.;
+        for (size_t v = 0; v < vsc.getNumberOfVariantSites(); ++v)
+        {
+          counts.count(vsc.getVariantSite(v));
+          if (counts.getSampleSize() == vsc.getNumberOfSequences())
+            sum += counts.pairwiseDiversity();
+        }
+        return sum;
+      });
+  return scaled ? value2 / static_cast<double>(vsc.getNumberOfCompleteSites()) : value2;
 }
 
 double SequenceStatistics::fayWu2000(const PolymorphismSequenceContainer& psc, const Sequence& ancestralSites)
 {
   if (psc.getNumberOfSites() != ancestralSites.size())
     throw Exception("SequenceStatistics::FayWu2000: ancestralSites and psc don't have the same size!!!'" );
+  return fayWu2000_(psc, AncestralStates(ancestralSites));
+}
 
-  const Sequence& tmps = psc.sequence(0);
-
-  size_t alphabetSize = psc.alphabet().getSize();
-  double value = 0.;
-  for (size_t i = 0; i < psc.getNumberOfSites(); ++i)
-  {
-    const Site& site = psc.site(i);
-    string ancB = ancestralSites.getChar(i);
-    int ancV = ancestralSites.getValue(i);
+double SequenceStatistics::fayWu2000(const PolymorphismSequenceContainer& psc, const AncestralStates& ancestral)
+{
+  if (psc.getNumberOfSites() != ancestral.getNumberOfSites())
+    throw DimensionException("SequenceStatistics::fayWu2000: ancestral and psc don't have the same size.", ancestral.getNumberOfSites(), psc.getNumberOfSites());
+  unique_ptr<PolymorphismSequenceContainer> copy;
+  return fayWu2000_(ingroupOf(psc, copy), ancestral);
+}
 
-    if (!SiteTools::isConstant(site) || tmps.getChar(i) != ancB)
-    {
-      if (ancV < 0)
-        continue;
-
-      map<int, size_t> count;
-      SymbolListTools::getCounts(site, count);
-      map<int, size_t> tmp_k;
-      size_t tmp_n = 0;
-      for (auto& it : count)
-      {
-        if (it.first >= 0 && it.first < static_cast<int>(alphabetSize))
+double SequenceStatistics::fayWu2000_(const PolymorphismSequenceContainer& psc, const AncestralStates& ancestral)
+{
+  return dispatchAlphabetSize(psc.getAlphabet()->getSize(), [&](auto counts) {
+        double value = 0.;
+        for (size_t i = 0; i < psc.getNumberOfSites(); ++i)
         {
-          /* if derived allele */
-          if (it.first != ancV)
+          if (!ancestral.isKnown(i))
+            continue;
+          counts.count(psc.site(i));
+          size_t n = counts.getSampleSize();
+          if (n < 2)
+            continue;
+          // Sum of the squared counts of the derived alleles
+          size_t squares = 0;
+          for (size_t state = 0; state < counts.getNumberOfStates(); ++state)
           {
-            tmp_k[it.first] = 2 * it.second * it.second;
+            squares += counts.getCount(state) * counts.getCount(state);
           }
-          tmp_n += it.second;
+          size_t ancestralState = static_cast<size_t>(ancestral.getState(i));
+          if (ancestralState < counts.getNumberOfStates())
+            squares -= counts.getCount(ancestralState) * counts.getCount(ancestralState);
+          value += static_cast<double>(2 * squares) / static_cast<double>(n * (n - 1));
         }
-      }
-      if (tmp_n == 0 || tmp_n == 1)
-        continue;
-      for (map<int, size_t>::iterator it = tmp_k.begin(); it != tmp_k.end(); it++)
-      {
-        value += static_cast<double>(it->second) / static_cast<double>(tmp_n * (tmp_n - 1));
-      }
-    }
+        return value;
+      });
+}
+
+SequenceStatistics::SiteSampleSizeSummary SequenceStatistics::siteSampleSizeSummary(const PolymorphismSequenceContainer& psc)
+{
+  return *psc.getDerived<SiteSampleSizeSummary>("siteSampleSizeSummary", [&]() {
+        shared_ptr<const SiteSummary> summary = siteSummary(psc);
+        return make_shared<const SiteSampleSizeSummary>(siteSampleSizeSummary(summary->sampleSizeHistogram, summary->polymorphicSites, summary->identicalPairs));
+      });
+}
+
+SequenceStatistics::SiteSampleSizeSummary SequenceStatistics::siteSampleSizeSummary(
+    const vector<unsigned int>& sampleSizeHistogram,
+    const vector<unsigned int>& polymorphicSites,
+    const vector<size_t>& identicalPairs)
+{
+  if (polymorphicSites.size() != sampleSizeHistogram.size())
+    throw DimensionException("SequenceStatistics::siteSampleSizeSummary: polymorphicSites and sampleSizeHistogram don't have the same size.", polymorphicSites.size(), sampleSizeHistogram.size());
+  if (identicalPairs.size() != sampleSizeHistogram.size())
+    throw DimensionException("SequenceStatistics::siteSampleSizeSummary: identicalPairs and sampleSizeHistogram don't have the same size.", identicalPairs.size(), sampleSizeHistogram.size());
+  SiteSampleSizeSummary summary;
+  summary.tajimaD = NAN;
+  summary.sampleSizeHistogram = sampleSizeHistogram;
+
+  // The constants of each sample size are computed once.
+  double sumE1 = 0., sumE2 = 0.;
+  for (size_t n = 2; n < sampleSizeHistogram.size(); ++n)
+  {
+    summary.numberOfSites += sampleSizeHistogram[n];
+    if (polymorphicSites[n] == 0)
+      continue;
+    double s = static_cast<double>(polymorphicSites[n]);
+    summary.numberOfPolymorphicSites += polymorphicSites[n];
+    summary.pi += s - static_cast<double>(identicalPairs[n]) / static_cast<double>(n * (n - 1));
+    map<string, double> values = getUsefulValues_(n);
+    summary.thetaW += s / values["a1"];
+    sumE1 += s * values["e1"];
+    sumE2 += s * values["e2"];
+  }
+
+  if (summary.numberOfPolymorphicSites > 0)
+  {
+    double s = static_cast<double>(summary.numberOfPolymorphicSites);
+    summary.tajimaD = (summary.pi - summary.thetaW) / sqrt(sumE1 + sumE2 * (s - 1.));
   }
-  return value;
+  return summary;
 }
 
 unsigned int SequenceStatistics::dvk(const PolymorphismSequenceContainer& psc, bool gapflag)
 {
-  /*
-   * Sylvain Gaillard 17/03/2010:
-   * This implementation uses unneeded SequenceContainer recopy and works on
-   * string. It needs to be improved.
-   */
-  unique_ptr<PolymorphismSequenceContainer> sc;
-  if (gapflag)
-    sc = PolymorphismSequenceContainerTools::getSitesWithoutGaps(psc);
-  else
-    sc = make_unique<PolymorphismSequenceContainer>(psc);
-  // int K = 0;
-  vector<string> pscvector;
-  pscvector.push_back(sc->sequence(0).toString());
-  // K++;
-  for (size_t i = 1; i < sc->getNumberOfSequences(); ++i)
-  {
-    bool uniq = true;
-    string query = sc->sequence(i).toString();
-    for (auto& it : pscvector)
-    {
-      if (query.compare(it) == 0)
-      {
-        uniq = false;
-        break;
-      }
-    }
-    if (uniq)
-    {
-      // K++;
-      pscvector.push_back(query);
-    }
-  }
-  // return K;
-  return static_cast<unsigned int>(pscvector.size());
+  return static_cast<unsigned int>(getHaplotypeCounts_(psc, gapflag).size());
 }
 
 double SequenceStatistics::dvh(const PolymorphismSequenceContainer& psc, bool gapflag)
 {
-  /*
-   * Sylvain Gaillard 17/03/2010:
-   * This implementation uses unneeded SequenceContainer recopy and works on
-   * string. It needs to be improved.
-   */
-  unique_ptr<PolymorphismSequenceContainer> sc;
-  if (gapflag)
-    sc = PolymorphismSequenceContainerTools::getSitesWithoutGaps(psc);
-  else
-    sc = make_unique<PolymorphismSequenceContainer>(psc);
-  double H = 0.;
-  size_t nbSeq;
-  vector<string> pscvector;
-  vector<size_t> effvector;
-  pscvector.push_back(sc->sequence(0).toString());
-  effvector.push_back(sc->getSequenceCount(0));
-  nbSeq = sc->getSequenceCount(0);
-  for (size_t i = 1; i < sc->getNumberOfSequences(); ++i)
-  {
-    nbSeq += sc->getSequenceCount(i);
-    bool uniq = true;
-    string query = sc->sequence(i).toString();
-    for (size_t j = 0; j < pscvector.size(); ++j)
-    {
-      if (query.compare(pscvector[j]) == 0)
-      {
-        effvector[j] += sc->getSequenceCount(i);
-        uniq = false;
-        break;
-      }
-    }
-    if (uniq)
-    {
-      pscvector.push_back(query);
-      effvector.push_back(sc->getSequenceCount(i));
-    }
+  return haplotypeFrequencyStatistics(psc, gapflag).diversity;
+}
+
+SequenceStatistics::HaplotypeFrequencyStats SequenceStatistics::haplotypeFrequencyStatistics(const PolymorphismSequenceContainer& psc, bool gapflag)
+{
+  return haplotypeFrequencyStatistics(getHaplotypeCounts_(psc, gapflag));
+}
+
+SequenceStatistics::HaplotypeFrequencyStats SequenceStatistics::haplotypeFrequencyStatistics(const vector<size_t>& counts)
+{
+  vector<double> freqs;
+  return haplotypeFrequencyStatistics(counts, freqs);
+}
+
+SequenceStatistics::HaplotypeFrequencyStats SequenceStatistics::haplotypeFrequencyStatistics(const vector<size_t>& counts, vector<double>& freqs)
+{
+  size_t nbSeq = 0;
+  for (size_t count : counts)
+  {
+    nbSeq += count;
   }
-  for (size_t i = 0; i < effvector.size(); ++i)
+  if (nbSeq == 0)
+    throw ZeroDivisionException("SequenceStatistics::haplotypeFrequencyStatistics: no haplotype.");
+
+  freqs.clear();
+  for (size_t count : counts)
   {
-    H -= (static_cast<double>(effvector[i]) / static_cast<double>(nbSeq)) * ( static_cast<double>(effvector[i]) / static_cast<double>(nbSeq));
+    if (count > 0)
+      freqs.push_back(static_cast<double>(count) / static_cast<double>(nbSeq));
   }
-  H += 1.;
-  return H;
+  sort(freqs.begin(), freqs.end(), greater<double>());
+
+  HaplotypeFrequencyStats stats;
+  stats.numberOfHaplotypes = static_cast<unsigned int>(freqs.size());
+  stats.H1 = 0.;
+  for (double p : freqs)
+  {
+    stats.H1 += p * p;
+  }
+  stats.diversity = 1. - stats.H1;
+  stats.H12 = stats.H1;
+  if (freqs.size() >= 2)
+    stats.H12 += 2. * freqs[0] * freqs[1];
+  stats.H2H1 = (stats.H1 - freqs[0] * freqs[0]) / stats.H1;
+  return stats;
 }
 
 unsigned int SequenceStatistics::numberOfTransitions(const PolymorphismSequenceContainer& psc)
 {
   unsigned int nbT = 0;
+  FixedStateCounts<4> counts(4);
   unique_ptr<ConstSiteIterator> si(new CompleteSiteContainerIterator(psc));
   while (si->hasMoreSites())
   {
-    const auto& site = si->nextSite();
-    // if (SiteTools::isConstant(*site) || SiteTools::isTriplet(*site)) continue;
-    if (SiteTools::getNumberOfDistinctCharacters(site) != 2)
-      continue;
-    int state1 = site[0];
-    int state2 = site[0];
-    for (size_t i = 1; i < site.size(); ++i)
-    {
-      if (state1 != site[i])
-      {
-        state2 = site[i];
-        break;
-      }
-    }
-    if (((state1 == 0 && state2 == 2) || (state1 == 2 && state2 == 0)) ||
-        ((state1 == 1 && state2 == 3) || (state1 == 3 && state2 == 1)))
+    counts.count(si->nextSite());
+    if (isTransition(nucleotideMask(counts)))
     {
       nbT++;
     }
@@ -462,25 +1018,12 @@ unsigned int SequenceStatistics::numberOfTransitions(const PolymorphismSequenceC
 unsigned int SequenceStatistics::numberOfTransversions(const PolymorphismSequenceContainer& psc)
 {
   unsigned int nbTv = 0;
+  FixedStateCounts<4> counts(4);
   unique_ptr<ConstSiteIterator> si(new CompleteSiteContainerIterator(psc));
   while (si->hasMoreSites())
   {
-    const auto& site = si->nextSite();
-    // if (SiteTools::isConstant(*site) || SiteTools::isTriplet(*site)) continue;
-    if (SiteTools::getNumberOfDistinctCharacters(site) != 2)
-      continue;
-    int state1 = site[0];
-    int state2 = site[0];
-    for (size_t i = 1; i < site.size(); ++i)
-    {
-      if (state1 != site[i])
-      {
-        state2 = site[i];
-        break;
-      }
-    }
-    if (!(((state1 == 0 && state2 == 2) || (state1 == 2 && state2 == 0)) ||
-        ((state1 == 1 && state2 == 3) || (state1 == 3 && state2 == 1))))
+    counts.count(si->nextSite());
+    if (isTransversion(nucleotideMask(counts)))
     {
       nbTv++;
     }
@@ -493,30 +1036,14 @@ double SequenceStatistics::ratioOfTransitionsTransversions(const PolymorphismSeq
   // return (double) getNumberOfTransitions(psc)/getNumberOfTransversions(psc);
   double nbTs = 0;
   double nbTv = 0;
+  FixedStateCounts<4> counts(4);
   unique_ptr<ConstSiteIterator> si(new CompleteSiteContainerIterator(psc));
-  vector<int> state(2);
   while (si->hasMoreSites())
   {
-    map<int, size_t> count;
-    const auto& site = si->nextSite();
-    SymbolListTools::getCounts(site, count);
-    if (count.size() != 2)
-      continue;
-    size_t i = 0;
-    for (const auto& it : count)
-    {
-      state[i] = it.first;
-      i++;
-    }
-    if (((state[0] == 0 && state[1] == 2) || (state[0] == 2 && state[1] == 0)) ||
-        ((state[0] == 1 && state[1] == 3) || (state[0] == 3 && state[1] == 1)))
-    {
-      nbTs++; // transitions
-    }
-    else
-    {
-      nbTv++; // transversion
-    }
+    counts.count(si->nextSite());
+    unsigned int mask = nucleotideMask(counts);
+    nbTs += isTransition(mask); // transitions
+    nbTv += isTransversion(mask); // transversion
   }
   if (nbTv == 0)
     throw ZeroDivisionException("SequenceStatistics::getTransitionsTransversionsRatio.");
@@ -791,6 +1318,29 @@ double SequenceStatistics::fuLiD(
     const PolymorphismSequenceContainer& outgroup,
     bool useNbSingletons,
     bool useNbSegregatingSites)
+{
+  double etae = 0.;
+  if (useNbSingletons)
+    etae = static_cast<double>(numberOfSingletons(outgroup));
+  else
+    etae = static_cast<double>(totalNumberOfMutationsOnExternalBranches(ingroup, outgroup)); // added by Khalid 13/07/2005
+  return fuLiD_(ingroup, etae, useNbSegregatingSites);
+}
+
+double SequenceStatistics::fuLiD(
+    const PolymorphismSequenceContainer& ingroup,
+    const AncestralStates& ancestral,
+    bool useNbSegregatingSites)
+{
+  unique_ptr<PolymorphismSequenceContainer> copy;
+  const PolymorphismSequenceContainer& samples = ingroupOf(ingroup, copy);
+  return fuLiD_(samples, static_cast<double>(totalNumberOfMutationsOnExternalBranches(samples, ancestral)), useNbSegregatingSites);
+}
+
+double SequenceStatistics::fuLiD_(
+    const PolymorphismSequenceContainer& ingroup,
+    double etae,
+    bool useNbSegregatingSites)
 {
   size_t n = ingroup.getNumberOfSequences();
   map<string, double> values = getUsefulValues_(n);
@@ -804,11 +1354,6 @@ double SequenceStatistics::fuLiD(
   if (etaP == 0)
     throw ZeroDivisionException("SequenceStatistics::fuLiD. Eta should not be 0.");
   double eta = static_cast<double>(etaP);
-  double etae = 0.;
-  if (useNbSingletons)
-    etae = static_cast<double>(numberOfSingletons(outgroup));
-  else
-    etae = static_cast<double>(totalNumberOfMutationsOnExternalBranches(ingroup, outgroup)); // added by Khalid 13/07/2005
   return (eta - (values["a1"] * etae)) / sqrt((uD * eta) + (vD * eta * eta));
 }
 
@@ -846,6 +1391,29 @@ double SequenceStatistics::fuLiF(
     const PolymorphismSequenceContainer& outgroup,
     bool useNbSingletons,
     bool useNbSegregatingSites)
+{
+  double etae = 0.;
+  if (useNbSingletons)
+    etae = static_cast<double>(numberOfSingletons(outgroup));
+  else
+    etae = static_cast<double>(totalNumberOfMutationsOnExternalBranches(ingroup, outgroup)); // added by Khalid 13/07/2005
+  return fuLiF_(ingroup, etae, useNbSegregatingSites);
+}
+
+double SequenceStatistics::fuLiF(
+    const PolymorphismSequenceContainer& ingroup,
+    const AncestralStates& ancestral,
+    bool useNbSegregatingSites)
+{
+  unique_ptr<PolymorphismSequenceContainer> copy;
+  const PolymorphismSequenceContainer& samples = ingroupOf(ingroup, copy);
+  return fuLiF_(samples, static_cast<double>(totalNumberOfMutationsOnExternalBranches(samples, ancestral)), useNbSegregatingSites);
+}
+
+double SequenceStatistics::fuLiF_(
+    const PolymorphismSequenceContainer& ingroup,
+    double etae,
+    bool useNbSegregatingSites)
 {
   size_t n = ingroup.getNumberOfSequences();
   double nn = static_cast<double>(n);
@@ -861,11 +1429,6 @@ double SequenceStatistics::fuLiF(
   if (etaP == 0)
     throw ZeroDivisionException("eta should not be null");
   double eta = static_cast<double>(etaP);
-  double etae = 0.;
-  if (useNbSingletons)
-    etae = static_cast<double>(numberOfSingletons(outgroup));
-  else
-    etae = static_cast<double>(totalNumberOfMutationsOnExternalBranches(ingroup, outgroup)); // added by Khalid 13/07/2005
   return (pi - etae) / sqrt(uF * eta + vF * eta * eta);
 }
 
@@ -901,9 +1464,9 @@ double SequenceStatistics::fuLiFStar(
 double SequenceStatistics::fstHudson92(
     const PolymorphismSequenceContainer& psc,
     size_t id1,
-    size_t id2)
+    size_t id2,
+    const ExecutionContext& context)
 {
-  vector<double> vdiff;
   double piIntra1, piIntra2, meanPiIntra, piInter, Fst;
 
   auto Pop1 = PolymorphismSequenceContainerTools::extractGroup(psc, id1);
@@ -914,24 +1477,100 @@ double SequenceStatistics::fstHudson92(
 
   meanPiIntra = (piIntra1 + piIntra2) / 2;
 
-  double n = 0;
-  for (size_t i = 0; i < Pop1->getNumberOfSequences(); ++i)
+  vector<size_t> seqs1, seqs2;
+  for (size_t i = 0; i < psc.getNumberOfSequences(); ++i)
   {
-    const Sequence& s1 = Pop1->sequence(i);
-    for (size_t j = 0; j < Pop2->getNumberOfSequences(); ++j)
-    {
-      n++;
-      const auto& s2 = Pop2->sequence(j);
-      vdiff.push_back(SiteContainerTools::computeSimilarity(s1, s2, true, "no gap", true));
-    }
+    if (psc.getGroupId(i) == id1)
+      seqs1.push_back(i);
+    if (psc.getGroupId(i) == id2)
+      seqs2.push_back(i);
   }
-  piInter = (VectorTools::sum(vdiff) / n) * static_cast<double>(psc.getNumberOfSites());
+  PackedSequences packed(psc);
+  double sum = context.parallelReduce(0, seqs1.size(), 0.,
+      [&](size_t i) {
+        double sumi = 0.;
+        unsigned int differences, sites;
+        for (size_t j : seqs2)
+        {
+          packed.compare(seqs1[i], j, differences, sites);
+          sumi += static_cast<double>(differences) / static_cast<double>(sites);
+        }
+        return sumi;
+      },
+      [](double a, double b) {
+        return a + b;
+      });
+  double n = static_cast<double>(seqs1.size() * seqs2.size());
+  piInter = (sum / n) * static_cast<double>(psc.getNumberOfSites());
 
   Fst = 1.0 - meanPiIntra / piInter;
 
   return Fst;
 }
 
+unique_ptr<DistanceMatrix> SequenceStatistics::pairwiseDifferences(
+    const PolymorphismSequenceContainer& psc,
+    bool pDistance,
+    const ExecutionContext& context)
+{
+  vector<size_t> sequences(psc.getNumberOfSequences());
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    sequences[i] = i;
+  }
+  return pairwiseDifferences(psc, sequences, pDistance, context);
+}
+
+unique_ptr<DistanceMatrix> SequenceStatistics::pairwiseDifferences(
+    const PolymorphismSequenceContainer& psc,
+    const vector<size_t>& sequences,
+    bool pDistance,
+    const ExecutionContext& context)
+{
+  size_t nbSequences = sequences.size();
+  vector<string> names(nbSequences);
+  for (size_t i = 0; i < nbSequences; ++i)
+  {
+    if (sequences[i] >= psc.getNumberOfSequences())
+      throw IndexOutOfBoundsException("SequenceStatistics::pairwiseDifferences: sequence index out of bounds.", sequences[i], 0, psc.getNumberOfSequences());
+    names[i] = psc.sequence(sequences[i]).getName();
+  }
+  unique_ptr<DistanceMatrix> matrix(new DistanceMatrix(names));
+  PackedSequences packed(psc);
+
+  // Tiles (ti, tj) with ti <= tj, each filling distinct cells of the matrix
+  size_t nbTiles = (nbSequences + TILE_SIZE - 1) / TILE_SIZE;
+  vector< pair<size_t, size_t> > tiles;
+  for (size_t ti = 0; ti < nbTiles; ++ti)
+  {
+    for (size_t tj = ti; tj < nbTiles; ++tj)
+    {
+      tiles.push_back(make_pair(ti, tj));
+    }
+  }
+  context.parallelFor(0, tiles.size(), [&](size_t t) {
+        size_t iEnd = min(nbSequences, (tiles[t].first + 1) * TILE_SIZE);
+        size_t jEnd = min(nbSequences, (tiles[t].second + 1) * TILE_SIZE);
+        unsigned int differences, sites;
+        for (size_t i = tiles[t].first * TILE_SIZE; i < iEnd; ++i)
+        {
+          // Only the diagonal tiles write the diagonal, the tiles of a row running concurrently.
+          if (tiles[t].first == tiles[t].second)
+            (*matrix)(i, i) = 0.;
+          for (size_t j = max(i + 1, tiles[t].second * TILE_SIZE); j < jEnd; ++j)
+          {
+            packed.compare(sequences[i], sequences[j], differences, sites);
+            double d = static_cast<double>(differences);
+            if (pDistance)
+              d = sites > 0 ? d / static_cast<double>(sites) : NAN;
+            (*matrix)(i, j) = d;
+            (*matrix)(j, i) = d;
+          }
+        }
+      });
+  return matrix;
+}
+
 // ******************************************************************************
 // Linkage disequilibrium statistics
 // ******************************************************************************
@@ -1008,6 +1647,25 @@ unique_ptr<PolymorphismSequenceContainer> SequenceStatistics::generateLdContaine
   return ldpsc;
 }
 
+shared_ptr<const PolymorphismSequenceContainer> SequenceStatistics::getLdContainer_(
+    const PolymorphismSequenceContainer& psc,
+    bool keepsingleton,
+    double freqmin)
+{
+  ostringstream key;
+  key << "ldContainer/" << keepsingleton << "/" << setprecision(17) << freqmin;
+  return psc.getDerived<PolymorphismSequenceContainer>(key.str(), [&]() {
+        return shared_ptr<const PolymorphismSequenceContainer>(generateLdContainer(psc, keepsingleton, freqmin));
+      });
+}
+
+shared_ptr<const PolymorphismSequenceContainer> SequenceStatistics::getCompleteSites_(const PolymorphismSequenceContainer& psc)
+{
+  return psc.getDerived<PolymorphismSequenceContainer>("completeSites", [&]() {
+        return shared_ptr<const PolymorphismSequenceContainer>(PolymorphismSequenceContainerTools::getCompleteSites(psc));
+      });
+}
+
 /*************************************/
 /* Pairwise LD and distance measures */
 /*************************************/
@@ -1157,37 +1815,85 @@ Vdouble SequenceStatistics::pairwiseDistances2(const PolymorphismSequenceContain
   return distance;
 }
 
+Vdouble SequenceStatistics::pairwiseHaplotypeFrequencies_(
+    const PolymorphismSequenceContainer& ldpsc,
+    Vdouble& freqs,
+    const ExecutionContext& context)
+{
+  size_t nbsite = ldpsc.getNumberOfSites();
+  size_t nbseq = ldpsc.getNumberOfSequences();
+  // Sites sharing a pattern have the same frequencies: each pair of
+  // patterns is computed once.
+  SitePatterns patterns(ldpsc);
+  size_t nbpattern = patterns.getNumberOfPatterns();
+  Vdouble patternFreqs(nbpattern, 0.);
+  for (size_t p = 0; p < nbpattern; ++p)
+  {
+    const Site& site = patterns.getPattern(p);
+    for (size_t k = 0; k < nbseq; ++k)
+    {
+      if (site.getValue(k) == 1)
+        patternFreqs[p]++;
+    }
+    patternFreqs[p] /= static_cast<double>(nbseq);
+  }
+  vector<Vdouble> patternHaplo(nbpattern);
+  context.parallelFor(0, nbpattern, [&](size_t p) {
+        const Site& site1 = patterns.getPattern(p);
+        patternHaplo[p].resize(nbpattern - p);
+        for (size_t q = p; q < nbpattern; ++q)
+        {
+          const Site& site2 = patterns.getPattern(q);
+          double count = 0;
+          for (size_t k = 0; k < nbseq; ++k)
+          {
+            if (site1.getValue(k) + site2.getValue(k) == 2)
+              count++;
+          }
+          patternHaplo[p][q - p] = count / static_cast<double>(nbseq);
+        }
+      });
+
+  freqs.resize(nbsite);
+  for (size_t i = 0; i < nbsite; ++i)
+  {
+    freqs[i] = patternFreqs[patterns.getPatternIndex(i)];
+  }
+  Vdouble haplo(nbsite * (nbsite - 1) / 2, 0.);
+  size_t pair = 0;
+  for (size_t i = 0; i < nbsite - 1; ++i)
+  {
+    size_t p = patterns.getPatternIndex(i);
+    for (size_t j = i + 1; j < nbsite; ++j, ++pair)
+    {
+      size_t q = patterns.getPatternIndex(j);
+      haplo[pair] = p <= q ? patternHaplo[p][q - p] : patternHaplo[q][p - q];
+    }
+  }
+  return haplo;
+}
+
 Vdouble SequenceStatistics::pairwiseD(
     const PolymorphismSequenceContainer& psc,
     bool keepsingleton,
-    double freqmin)
+    double freqmin,
+    const ExecutionContext& context)
 {
-  auto newpsc = generateLdContainer(psc, keepsingleton, freqmin);
-  Vdouble D;
+  auto newpsc = getLdContainer_(psc, keepsingleton, freqmin);
   size_t nbsite = newpsc->getNumberOfSites();
   size_t nbseq = newpsc->getNumberOfSequences();
   if (nbsite < 2)
     throw DimensionException("SequenceStatistics::pairwiseD: less than two sites are available", nbsite, 2);
   if (nbseq < 2)
     throw DimensionException("SequenceStatistics::pairwiseD: less than two sequences are available", nbseq, 2);
+  Vdouble freqs;
+  Vdouble D = pairwiseHaplotypeFrequencies_(*newpsc, freqs, context);
+  size_t pair = 0;
   for (size_t i = 0; i < nbsite - 1; ++i)
   {
-    for (size_t j = i + 1; j < nbsite; ++j)
+    for (size_t j = i + 1; j < nbsite; ++j, ++pair)
     {
-      double haplo = 0;
-      const Site& site1 = newpsc->site(i);
-      const Site& site2 = newpsc->site(j);
-      map<int, double> freq1;
-      map<int, double> freq2;
-      SymbolListTools::getFrequencies(site1, freq1);
-      SymbolListTools::getFrequencies(site2, freq2);
-      for (size_t k = 0; k < nbseq; ++k)
-      {
-        if (site1.getValue(k) + site2.getValue(k) == 2)
-          haplo++;
-      }
-      haplo = haplo / static_cast<double>(nbseq);
-      D.push_back(std::abs(haplo - freq1[1] * freq2[1]));
+      D[pair] = std::abs(D[pair] - freqs[i] * freqs[j]);
     }
   }
   return D;
@@ -1196,57 +1902,49 @@ Vdouble SequenceStatistics::pairwiseD(
 Vdouble SequenceStatistics::pairwiseDprime(
     const PolymorphismSequenceContainer& psc,
     bool keepsingleton,
-    double freqmin)
+    double freqmin,
+    const ExecutionContext& context)
 {
-  auto newpsc = generateLdContainer(psc, keepsingleton, freqmin);
-  Vdouble Dprime;
+  auto newpsc = getLdContainer_(psc, keepsingleton, freqmin);
   size_t nbsite = newpsc->getNumberOfSites();
   size_t nbseq = newpsc->getNumberOfSequences();
   if (nbsite < 2)
     throw DimensionException("SequenceStatistics::pairwiseD: less than two sites are available", nbsite, 2);
   if (nbseq < 2)
     throw DimensionException("SequenceStatistics::pairwiseD: less than two sequences are available", nbseq, 2);
+  Vdouble freqs;
+  Vdouble Dprime = pairwiseHaplotypeFrequencies_(*newpsc, freqs, context);
+  size_t pair = 0;
   for (size_t i = 0; i < nbsite - 1; i++)
   {
-    for (size_t j = i + 1; j < nbsite; j++)
+    for (size_t j = i + 1; j < nbsite; j++, pair++)
     {
-      double haplo = 0;
-      const Site& site1 = newpsc->site(i);
-      const Site& site2 = newpsc->site(j);
-      map<int, double> freq1;
-      map<int, double> freq2;
-      SymbolListTools::getFrequencies(site1, freq1);
-      SymbolListTools::getFrequencies(site2, freq2);
-      for (size_t k = 0; k < nbseq; ++k)
-      {
-        if (site1.getValue(k) + site2.getValue(k) == 2)
-          haplo++;
-      }
-      haplo = haplo / static_cast<double>(nbseq);
-      double d, D = (haplo - freq1[1] * freq2[1]);
+      double p1 = freqs[i], q1 = freqs[j];
+      double p0 = 1. - p1, q0 = 1. - q1;
+      double d, D = (Dprime[pair] - p1 * q1);
       if (D > 0)
       {
-        if (freq1[1] * freq2[0] <= freq1[0] * freq2[1])
+        if (p1 * q0 <= p0 * q1)
         {
-          d = std::abs(D) / (freq1[1] * freq2[0]);
+          d = std::abs(D) / (p1 * q0);
         }
         else
         {
-          d = std::abs(D) / (freq1[0] * freq2[1]);
+          d = std::abs(D) / (p0 * q1);
         }
       }
       else
       {
-        if (freq1[1] * freq2[1] <= freq1[0] * freq2[0])
+        if (p1 * q1 <= p0 * q0)
         {
-          d = std::abs(D) / (freq1[1] * freq2[1]);
+          d = std::abs(D) / (p1 * q1);
         }
         else
         {
-          d = std::abs(D) / (freq1[0] * freq2[0]);
+          d = std::abs(D) / (p0 * q0);
         }
       }
-      Dprime.push_back(d);
+      Dprime[pair] = d;
     }
   }
   return Dprime;
@@ -1255,35 +1953,25 @@ Vdouble SequenceStatistics::pairwiseDprime(
 Vdouble SequenceStatistics::pairwiseR2(
     const PolymorphismSequenceContainer& psc,
     bool keepsingleton,
-    double freqmin)
+    double freqmin,
+    const ExecutionContext& context)
 {
-  auto newpsc = generateLdContainer(psc, keepsingleton, freqmin);
-  Vdouble R2;
+  auto newpsc = getLdContainer_(psc, keepsingleton, freqmin);
   size_t nbsite = newpsc->getNumberOfSites();
   size_t nbseq = newpsc->getNumberOfSequences();
   if (nbsite < 2)
     throw DimensionException("SequenceStatistics::pairwiseD: less than two sites are available", nbsite, 2);
   if (nbseq < 2)
     throw DimensionException("SequenceStatistics::pairwiseD: less than two sequences are available", nbseq, 2);
+  Vdouble freqs;
+  Vdouble R2 = pairwiseHaplotypeFrequencies_(*newpsc, freqs, context);
+  size_t pair = 0;
   for (size_t i = 0; i < nbsite - 1; ++i)
   {
-    for (size_t j = i + 1; j < nbsite; ++j)
+    for (size_t j = i + 1; j < nbsite; ++j, ++pair)
     {
-      double haplo = 0;
-      const Site& site1 = newpsc->site(i);
-      const Site& site2 = newpsc->site(j);
-      map<int, double> freq1;
-      map<int, double> freq2;
-      SymbolListTools::getFrequencies(site1, freq1);
-      SymbolListTools::getFrequencies(site2, freq2);
-      for (size_t k = 0; k < nbseq; ++k)
-      {
-        if (site1.getValue(k) + site2.getValue(k) == 2)
-          haplo++;
-      }
-      haplo = haplo / static_cast<double>(nbseq);
-      double r = ((haplo - freq1[1] * freq2[1]) * (haplo - freq1[1] * freq2[1])) / (freq1[0] * freq1[1] * freq2[0] * freq2[1]);
-      R2.push_back(r);
+      double D = R2[pair] - freqs[i] * freqs[j];
+      R2[pair] = (D * D) / ((1. - freqs[i]) * freqs[i] * (1. - freqs[j]) * freqs[j]);
     }
   }
   return R2;
@@ -1419,9 +2107,9 @@ double SequenceStatistics::inverseRegressionR2(const PolymorphismSequenceContain
 /*   Hudson method    */
 /**********************/
 
-double SequenceStatistics::hudson87(const PolymorphismSequenceContainer& psc, double precision, double cinf, double csup)
+double SequenceStatistics::hudson87(const PolymorphismSequenceContainer& psc, double precision, double cinf, double csup, const ExecutionContext& context)
 {
-  double left = leftHandHudson_(psc);
+  double left = leftHandHudson_(psc, context);
   size_t n = psc.getNumberOfSequences();
   double dif = 1;
   double c1 = cinf;
@@ -1477,6 +2165,30 @@ void SequenceStatistics::testUsefulValues(std::ostream& s, size_t n)
 // Private methods
 // ******************************************************************************
 
+vector<size_t> SequenceStatistics::getHaplotypeCounts_(const PolymorphismSequenceContainer& psc, bool gapflag)
+{
+  /*
+   * Sylvain Gaillard 17/03/2010:
+   * This implementation uses unneeded SequenceContainer recopy and works on
+   * string. It needs to be improved.
+   */
+  unique_ptr<PolymorphismSequenceContainer> sc;
+  if (gapflag)
+    sc = PolymorphismSequenceContainerTools::getSitesWithoutGaps(psc);
+  else
+    sc = make_unique<PolymorphismSequenceContainer>(psc);
+  vector<size_t> counts;
+  map<string, size_t> haplotypeIndex;
+  for (size_t i = 0; i < sc->getNumberOfSequences(); ++i)
+  {
+    auto it = haplotypeIndex.insert(make_pair(sc->sequence(i).toString(), counts.size()));
+    if (it.second)
+      counts.push_back(0);
+    counts[it.first->second] += sc->getSequenceCount(i);
+  }
+  return counts;
+}
+
 unsigned int SequenceStatistics::getNumberOfMutations_(const Site& site)
 {
   // jdutheil 27/06/15: does not work if gaps and unknown!!!
@@ -1633,22 +2345,21 @@ double SequenceStatistics::getUDstar_(size_t n, double a1, double vDs)
   return uDs;
 }
 
-double SequenceStatistics::leftHandHudson_(const PolymorphismSequenceContainer& psc)
+double SequenceStatistics::leftHandHudson_(const PolymorphismSequenceContainer& psc, const ExecutionContext& context)
 {
-  auto newpsc = PolymorphismSequenceContainerTools::getCompleteSites(psc);
+  auto newpsc = getCompleteSites_(psc);
   size_t nbseq = newpsc->getNumberOfSequences();
-  double S1 = 0;
-  double S2 = 0;
-  for (size_t i = 0; i < nbseq - 1; ++i)
+  // On complete sites, the number of segregating sites between two
+  // sequences (Watterson's theta with n = 2) is their number of differences.
+  auto differences = SequenceStatistics::pairwiseDifferences(*newpsc, false, context);
+  double S1 = 0., S2 = 0.;
+  for (size_t i = 0; i < nbseq; ++i)
   {
     for (size_t j = i + 1; j < nbseq; ++j)
     {
-      SequenceSelection ss(2);
-      ss[0] = i;
-      ss[1] = j;
-      auto psc2 = PolymorphismSequenceContainerTools::getSelectedSequences(*newpsc, ss);
-      S1 += SequenceStatistics::watterson75(*psc2, true);
-      S2 += SequenceStatistics::watterson75(*psc2, true) * SequenceStatistics::watterson75(*psc2, true);
+      double Sij = (*differences)(i, j);
+      S1 += Sij;
+      S2 += Sij * Sij;
     }
   }
   double Sk = (2 * S2 - pow(2 * S1 / static_cast<double>(nbseq), 2.)) / pow(nbseq, 2.);
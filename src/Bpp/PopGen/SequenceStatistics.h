@@ -13,11 +13,17 @@
 #include <Bpp/Seq/Container/SiteContainerIterator.h>
 #include <Bpp/Seq/Container/SiteContainer.h>
 #include <Bpp/Seq/Container/SiteContainerTools.h>
+#include <Bpp/Seq/DistanceMatrix.h>
 
 #include "PolymorphismSequenceContainer.h"
 #include "PolymorphismSequenceContainerTools.h"
+#include "AncestralStates.h"
+#include "ExecutionContext.h"
+#include "SitePatterns.h"
+#include "VariantSiteContainer.h"
 
 // From the STL
+#include <memory>
 #include <string>
 #include <map>
 #include <vector>
@@ -29,11 +35,80 @@ using ConstSiteIterator = TemplateSiteIteratorInterface<const Site>;
 /**
  * @brief Static class providing methods to compute statistics on sequences data.
  *
+ * When the cache of a container is enabled (see
+ * PolymorphismSequenceContainer::setCacheEnabled()), some results are
+ * cached in the container they are computed from, keyed by their
+ * parameters: the number of polymorphic sites, of singletons and of
+ * mutations, the heterozygosity, Tajima's theta, the site sample size
+ * summary, the container of the complete sites used by hudson87, and the
+ * linkage disequilibrium container shared by pairwiseD, pairwiseDprime and
+ * pairwiseR2. Calling several statistics on the same container, as the
+ * neutrality tests do, then computes each of them once.
+ *
  * @author Sylvain Gaillard
  */
 class SequenceStatistics
 {
 public:
+  /**
+   * @brief Statistics computed from the frequencies of the haplotypes of a sample.
+   *
+   * With @f$p_1 \geq p_2 \geq \dots@f$ the haplotype frequencies:
+   * - numberOfHaplotypes is the number of distinct haplotypes (dvk),
+   * - diversity is @f$1 - \sum_i p_i^2@f$ (dvh),
+   * - H1 is @f$\sum_i p_i^2@f$,
+   * - H12 is @f$(p_1 + p_2)^2 + \sum_{i>2} p_i^2@f$,
+   * - H2H1 is @f$(H1 - p_1^2) / H1@f$.
+   *
+   * See Garud et al. 2015, PLoS Genetics 11:e1005004 for H1, H12 and H2/H1.
+   */
+  struct HaplotypeFrequencyStats
+  {
+    unsigned int numberOfHaplotypes;
+    double diversity;
+    double H1;
+    double H12;
+    double H2H1;
+  };
+
+  /**
+   * @brief Diversity estimates computed with the sample size of each site.
+   *
+   * With missing data, the number @f$n_i@f$ of resolved characters (gaps
+   * and unknown characters excluded) differs from site to site. Sites with
+   * @f$n_i < 2@f$ are not used. Each sequence of a PolymorphismSequenceContainer
+   * stands for as many copies as its count (see
+   * PolymorphismSequenceContainer::getSequenceCount()), in @f$n_i@f$ and in the
+   * state counts @f$k_{j,i}@f$.
+   * - pi is @f$\sum_i \left(1 - \sum_j \frac{k_{j,i}(k_{j,i}-1)}{n_i(n_i-1)}\right)@f$,
+   * - thetaW is @f$\sum_{i \in S} 1 / a_1(n_i)@f$, summed over the polymorphic sites,
+   * - tajimaD is @f$(\pi - \theta_W) / \sqrt{\bar{e}_1 S + \bar{e}_2 S (S - 1)}@f$,
+   *   where @f$\bar{e}_1@f$ and @f$\bar{e}_2@f$ are the means of @f$e_1(n_i)@f$ and
+   *   @f$e_2(n_i)@f$ over the polymorphic sites (NaN if S = 0).
+   *
+   * Without missing data, these are tajima83, watterson75 and tajimaDss.
+   * The sample size histogram gives the number of sites for each value of
+   * @f$n_i@f$, including the sites that are not used.
+   */
+  struct SiteSampleSizeSummary
+  {
+    unsigned int numberOfSites;
+    unsigned int numberOfPolymorphicSites;
+    double pi;
+    double thetaW;
+    double tajimaD;
+    std::vector<unsigned int> sampleSizeHistogram;
+
+    SiteSampleSizeSummary() :
+      numberOfSites(0),
+      numberOfPolymorphicSites(0),
+      pi(0.),
+      thetaW(0.),
+      tajimaD(0.),
+      sampleSizeHistogram()
+    {}
+  };
+
   /**
    * @brief Compute the number of polymorphic site in an alignment
    *
@@ -54,6 +129,33 @@ public:
       bool gapflag = true,
       bool ignoreUnknown = true);
 
+  /**
+   * @brief Compute the number of polymorphic sites from the unique site patterns.
+   *
+   * Each pattern is evaluated once and weighted by its number of sites.
+   *
+   * @param patterns the site patterns of a PolymorphismSequenceContainer
+   * @param gapflag a boolean set by default to true if you don't want to
+   * take gap into account
+   * @param ignoreUnknown a boolean set by default to true to ignore
+   * unknown states
+   */
+  static unsigned int numberOfPolymorphicSites(
+      const SitePatterns& patterns,
+      bool gapflag = true,
+      bool ignoreUnknown = true);
+
+  /**
+   * @brief Compute the number of polymorphic sites from the variant sites of an alignment.
+   *
+   * Same as the PolymorphismSequenceContainer version with gapflag and
+   * ignoreUnknown set to true: only the complete sites are used.
+   *
+   * @param vsc the sparse representation of a PolymorphismSequenceContainer
+   */
+  static unsigned int numberOfPolymorphicSites(
+      const VariantSiteContainer& vsc);
+
   /**
    * @brief Compute the frequency of polymorphic site in an alignment
    *
@@ -75,6 +177,31 @@ public:
       bool gapflag = true,
       bool ignoreUnknown = true);
 
+  /**
+   * @brief Compute the frequency of polymorphic sites from the unique site patterns.
+   *
+   * @param patterns the site patterns of a PolymorphismSequenceContainer
+   * @param gapflag a boolean set by default to true if you don't want to
+   * take gap into account
+   * @param ignoreUnknown a boolean set by default to true to ignore
+   * unknown states
+   */
+  static double frequencyOfPolymorphicSites(
+      const SitePatterns& patterns,
+      bool gapflag = true,
+      bool ignoreUnknown = true);
+
+  /**
+   * @brief Compute the frequency of polymorphic sites from the variant sites of an alignment.
+   *
+   * The number of polymorphic sites is divided by the number of complete
+   * sites of the whole alignment.
+   *
+   * @param vsc the sparse representation of a PolymorphismSequenceContainer
+   */
+  static double frequencyOfPolymorphicSites(
+      const VariantSiteContainer& vsc);
+
   /**
    * @brief Compute the number of parsimony informative sites in an alignment
    *
@@ -98,6 +225,17 @@ public:
       const PolymorphismSequenceContainer& psc,
       bool gapflag = true);
 
+  /**
+   * @brief Count the number of singleton nucleotides from the unique site patterns.
+   *
+   * @param patterns the site patterns of a PolymorphismSequenceContainer
+   * @param gapflag a boolean set by default to true if you don't want to
+   * take gap into account
+   */
+  static unsigned int numberOfSingletons(
+      const SitePatterns& patterns,
+      bool gapflag = true);
+
   /**
    * @brief Count the total number of mutations in an alignment.
    *
@@ -112,6 +250,17 @@ public:
       const PolymorphismSequenceContainer& psc,
       bool gapflag = true);
 
+  /**
+   * @brief Count the total number of mutations from the unique site patterns.
+   *
+   * @param patterns the site patterns of a PolymorphismSequenceContainer
+   * @param gapflag a boolean set by default to true if you don't want to
+   * take gap into account
+   */
+  static unsigned int totalNumberOfMutations(
+      const SitePatterns& patterns,
+      bool gapflag = true);
+
   /**
    * @brief Count the total number of mutations in external branchs.
    *
@@ -128,6 +277,23 @@ public:
       const PolymorphismSequenceContainer& ing,
       const PolymorphismSequenceContainer& outg);
 
+  /**
+   * @brief Count the total number of mutations in external branchs, with known ancestral states.
+   *
+   * This is counted as the number of singleton states in the ingroup that
+   * differ from the ancestral state. Only the ingroup sequences of ing (see
+   * PolymorphismSequenceContainer::isIngroupMember()) are counted. A site
+   * is ignored if its ancestral state is unknown, or if it contains
+   * unresolved variants or gaps.
+   *
+   * @param ing a PolymorphismSequenceContainer the ingroup alignement
+   * @param ancestral the ancestral states, see AncestralStates::fromOutgroups()
+   * @throw DimensionException if ing and ancestral don't have the same number of sites
+   */
+  static unsigned int totalNumberOfMutationsOnExternalBranches(
+      const PolymorphismSequenceContainer& ing,
+      const AncestralStates& ancestral);
+
   /**
    * @brief Compute the number of triplet in an alignment
    *
@@ -149,6 +315,16 @@ public:
       const PolymorphismSequenceContainer& psc,
       bool gapflag = true);
 
+  /**
+   * @brief Compute the sum of per site heterozygosity from the unique site patterns.
+   *
+   * @param patterns the site patterns of a PolymorphismSequenceContainer
+   * @param gapflag a boolean set by default to true if you don't want to take gap into account
+   */
+  static double heterozygosity(
+      const SitePatterns& patterns,
+      bool gapflag = true);
+
   /**
    * @brief Compute the sum of per site squared heterozygosity in an alignment
    *
@@ -160,10 +336,22 @@ public:
       const PolymorphismSequenceContainer& psc,
       bool gapflag = true);
 
+  /**
+   * @brief Compute the sum of per site squared heterozygosity from the unique site patterns.
+   *
+   * @param patterns the site patterns of a PolymorphismSequenceContainer
+   * @param gapflag a boolean set by default to true if you don't want
+   * to take gap into account
+   */
+  static double squaredHeterozygosity(
+      const SitePatterns& patterns,
+      bool gapflag = true);
+
   /**
    * @brief Compute the mean GC content in an alignment
    *
    * @param psc a PolymorphismSequenceContainer
+   * @throw AlphabetMismatchException if psc does not have a nucleic alphabet
    */
   static double gcContent(
       const PolymorphismSequenceContainer& psc);
@@ -181,6 +369,7 @@ public:
    * to take gap into account
    * @return A std::vector of size 2 containing the number of GC alleles
    * and the total number of alleles.
+    * @throw AlphabetMismatchException if psc does not have a nucleic alphabet
    */
   static std::vector<unsigned int> gcPolymorphism(
       const PolymorphismSequenceContainer& psc,
@@ -210,6 +399,37 @@ public:
       bool ignoreUnknown = true,
       bool scaled = false);
 
+  /**
+   * @brief Compute Theta of Watterson from the unique site patterns.
+   *
+   * @param patterns the site patterns of a PolymorphismSequenceContainer
+   * @param gapflag flag set by default to true if you don't want to
+   * take gap into account
+   * @param ignoreUnknown a boolean set by default to true to ignore
+   * unknown states
+   * @param scaled Tell if theta should be normalized per nucleotide
+   * (divided by the length of the sequence).
+   */
+  static double watterson75(
+      const SitePatterns& patterns,
+      bool gapflag = true,
+      bool ignoreUnknown = true,
+      bool scaled = false);
+
+  /**
+   * @brief Compute Theta of Watterson from the variant sites of an alignment.
+   *
+   * Same as the PolymorphismSequenceContainer version with gapflag and
+   * ignoreUnknown set to true.
+   *
+   * @param vsc the sparse representation of a PolymorphismSequenceContainer
+   * @param scaled Tell if theta should be normalized per nucleotide
+   * (divided by the number of complete sites of the whole alignment).
+   */
+  static double watterson75(
+      const VariantSiteContainer& vsc,
+      bool scaled = false);
+
   /**
    * @brief Compute diversity estimator Theta of Tajima (1983, Genetics, 105 pp437-460)
    *
@@ -237,6 +457,37 @@ public:
       bool ignoreUnknown = true,
       bool scaled = false);
 
+  /**
+   * @brief Compute Theta of Tajima from the unique site patterns.
+   *
+   * @param patterns the site patterns of a PolymorphismSequenceContainer
+   * @param gapflag flag set by default to true if you don't want to
+   * take gap into account
+   * @param ignoreUnknown a boolean set by default to true to ignore
+   * unknown states
+   * @param scaled Tell if theta should be normalized per nucleotide
+   * (divided by the length of the sequence).
+   */
+  static double tajima83(
+      const SitePatterns& patterns,
+      bool gapflag = true,
+      bool ignoreUnknown = true,
+      bool scaled = false);
+
+  /**
+   * @brief Compute Theta of Tajima from the variant sites of an alignment.
+   *
+   * Same as the PolymorphismSequenceContainer version with gapflag and
+   * ignoreUnknown set to true.
+   *
+   * @param vsc the sparse representation of a PolymorphismSequenceContainer
+   * @param scaled Tell if theta should be normalized per nucleotide
+   * (divided by the number of complete sites of the whole alignment).
+   */
+  static double tajima83(
+      const VariantSiteContainer& vsc,
+      bool scaled = false);
+
   /**
    * @brief Compute diversity estimator Theta H (eq. 3) of Fay and Wu (2000, Genetics, 155: 1405-1413)
    *
@@ -249,6 +500,53 @@ public:
       const PolymorphismSequenceContainer& psc,
       const Sequence& ancestralSites);
 
+  /**
+   * @brief Compute diversity estimator Theta H of Fay and Wu with known ancestral states.
+   *
+   * Only the ingroup sequences of psc (see
+   * PolymorphismSequenceContainer::isIngroupMember()) are counted, so that
+   * the outgroups the states are inferred from are not sampled. The sites
+   * with an unknown ancestral state are ignored.
+   *
+   * @param psc a PolymorphismSequenceContainer
+   * @param ancestral the ancestral states, see AncestralStates::fromOutgroups()
+   * @throw DimensionException if psc and ancestral don't have the same number of sites
+   */
+  static double fayWu2000(
+      const PolymorphismSequenceContainer& psc,
+      const AncestralStates& ancestral);
+
+  /**
+   * @brief Compute pi, theta W and Tajima's D with the sample size of each site.
+   *
+   * The estimates are computed from the pass over the sites which also
+   * gives numberOfPolymorphicSites(), numberOfSingletons(),
+   * totalNumberOfMutations() and tajima83() with gapflag set, the
+   * constants of each sample size being computed only once.
+   *
+   * @param psc a PolymorphismSequenceContainer
+   * @see SiteSampleSizeSummary
+   */
+  static SiteSampleSizeSummary siteSampleSizeSummary(
+      const PolymorphismSequenceContainer& psc);
+
+  /**
+   * @brief Compute pi, theta W and Tajima's D from aggregates by sample size.
+   *
+   * The three vectors are indexed by the sample size @f$n_i@f$.
+   *
+   * @param sampleSizeHistogram the number of sites for each sample size
+   * @param polymorphicSites the number of polymorphic sites for each sample size
+   * @param identicalPairs the sum, over the polymorphic sites of each sample size,
+   * of k(k - 1) for the count k of each state
+   * @throw DimensionException if the vectors don't have the same size
+   * @see SiteSampleSizeSummary
+   */
+  static SiteSampleSizeSummary siteSampleSizeSummary(
+      const std::vector<unsigned int>& sampleSizeHistogram,
+      const std::vector<unsigned int>& polymorphicSites,
+      const std::vector<size_t>& identicalPairs);
+
   /**
    * @brief Return the number of haplotype in the sample.
    * Depaulis and Veuille (1998, Mol Biol Evol, 12 pp1788-1790)
@@ -281,6 +579,39 @@ public:
       const PolymorphismSequenceContainer& psc,
       bool gapflag = true);
 
+  /**
+   * @brief Compute the haplotype frequency statistics of a sample.
+   *
+   * Haplotypes are counted as in dvk and dvh, with the sequence counts of the container.
+   *
+   * @param psc a PolymorphismSequenceContainer
+   * @param gapflag flag set by default to true if you don't want to
+   * take gaps into account
+   */
+  static HaplotypeFrequencyStats haplotypeFrequencyStatistics(
+      const PolymorphismSequenceContainer& psc,
+      bool gapflag = true);
+
+  /**
+   * @brief Compute the haplotype frequency statistics from haplotype counts.
+   *
+   * @param counts the number of copies of each distinct haplotype
+   * @throw ZeroDivisionException if the total count is 0
+   */
+  static HaplotypeFrequencyStats haplotypeFrequencyStatistics(
+      const std::vector<size_t>& counts);
+
+  /**
+   * @brief Compute the haplotype frequency statistics from haplotype counts, with a given buffer.
+   *
+   * @param counts the number of copies of each distinct haplotype
+   * @param frequencies the buffer receiving the sorted haplotype frequencies, whose storage is reused
+   * @throw ZeroDivisionException if the total count is 0
+   */
+  static HaplotypeFrequencyStats haplotypeFrequencyStatistics(
+      const std::vector<size_t>& counts,
+      std::vector<double>& frequencies);
+
   /**
    * @brief Return the number of transitions.
    *
@@ -631,6 +962,25 @@ public:
       bool useNbSingletons = true,
       bool useNbSegregatingSites = false);
 
+  /**
+   * @brief Return the Fu and Li D test with known ancestral states.
+   *
+   * Only the ingroup sequences of ingroup (see
+   * PolymorphismSequenceContainer::isIngroupMember()) are counted. The
+   * mutations in external branches are counted with
+   * totalNumberOfMutationsOnExternalBranches(ingroup, ancestral).
+   *
+   * @param ingroup a PolymorphismSequenceContainer
+   * @param ancestral the ancestral states, see AncestralStates::fromOutgroups()
+   * @param useNbSegregatingSites use the number of seggregating sites, otherwise use the total number of mutations.
+   * @throw ZeroDivisionException if eta == 0
+   * @throw DimensionException if ingroup and ancestral don't have the same number of sites
+   */
+  static double fuLiD(
+      const PolymorphismSequenceContainer& ingroup,
+      const AncestralStates& ancestral,
+      bool useNbSegregatingSites = false);
+
   /**
    * @brief Return the Fu and Li D<sup>*</sup> test (Fu & Li 1993, Genetics, 133 pp693-709).
    *
@@ -668,6 +1018,25 @@ public:
       bool useNbSingletons = true,
       bool useNbSegregatingSites = false);
 
+  /**
+   * @brief Return the Fu and Li F test with known ancestral states.
+   *
+   * Only the ingroup sequences of ingroup (see
+   * PolymorphismSequenceContainer::isIngroupMember()) are counted. The
+   * mutations in external branches are counted with
+   * totalNumberOfMutationsOnExternalBranches(ingroup, ancestral).
+   *
+   * @param ingroup a PolymorphismSequenceContainer
+   * @param ancestral the ancestral states, see AncestralStates::fromOutgroups()
+   * @param useNbSegregatingSites use the number of seggregating sites, otherwise use the total number of mutations.
+   * @throw ZeroDivisionException if eta == 0
+   * @throw DimensionException if ingroup and ancestral don't have the same number of sites
+   */
+  static double fuLiF(
+      const PolymorphismSequenceContainer& ingroup,
+      const AncestralStates& ancestral,
+      bool useNbSegregatingSites = false);
+
   /**
    * @brief Return the Fu and Li F<sup>*</sup> test (Fu & Li 1993, Genetics, 133 pp693-709).
    *
@@ -694,15 +1063,62 @@ public:
    * mean number of differences between sequences sampled from the two
    * different subpopulations sampled.
    *
+   * Gaps and unresolved characters are ignored (see pairwiseDifferences()).
+   *
    * @param psc a PolymorphismSequenceContainer will at least two populations
    * @param id1 is the id of the population 1
    * @param id2 is the id of the population 2
+   * @param context the ExecutionContext used to compare the pairs of sequences
    * @author Benoit Nabholz
    */
   static double fstHudson92(
       const PolymorphismSequenceContainer& psc,
       size_t id1,
-      size_t id2);
+      size_t id2,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Compute the number of differences, or the p-distance, between every pair of sequences.
+   *
+   * Two sequences are compared on the sites where both have a resolved
+   * state: gaps and unresolved characters are ignored, as done by
+   * SiteContainerTools::computeSimilarity() with the "no gap" option.
+   *
+   * Each sequence is first packed as bit planes, one plane per bit of the
+   * state plus a plane flagging the resolved sites. The comparison of two
+   * sequences then costs a few word operations and two popcounts per 64
+   * sites. The matrix is split in tiles of pairs which are filled in
+   * parallel.
+   *
+   * Sequence counts are not used: each sequence is one row of the matrix.
+   *
+   * @param psc a PolymorphismSequenceContainer
+   * @param pDistance if true, the number of differences is divided by the
+   * number of compared sites (NaN when no site can be compared)
+   * @param context the ExecutionContext used to fill the tiles
+   * @return a matrix named after the sequences
+   */
+  static std::unique_ptr<DistanceMatrix> pairwiseDifferences(
+      const PolymorphismSequenceContainer& psc,
+      bool pDistance = false,
+      const ExecutionContext& context = ExecutionContext::sequential());
+
+  /**
+   * @brief Compute the number of differences, or the p-distance, between every pair of a subset of sequences.
+   *
+   * @param psc a PolymorphismSequenceContainer
+   * @param sequences the indices of the sequences to compare, which give the rows of the matrix
+   * @param pDistance if true, the number of differences is divided by the
+   * number of compared sites (NaN when no site can be compared)
+   * @param context the ExecutionContext used to fill the tiles
+   * @return a matrix named after the selected sequences
+   * @throw IndexOutOfBoundsException if a sequence index is out of bounds.
+   */
+  static std::unique_ptr<DistanceMatrix> pairwiseDifferences(
+      const PolymorphismSequenceContainer& psc,
+      const std::vector<size_t>& sequences,
+      bool pDistance = false,
+      const ExecutionContext& context = ExecutionContext::sequential());
 
 
   /**
@@ -781,6 +1197,7 @@ public:
    * singleton)
    * @param freqmin a float (to exlude site with the lowest allele
    * frequency less than the threshold given by freqmin, 0 by default)
+   * @param context the ExecutionContext used to compute the pairs of sites
    * @throw DimensionException if the number of sites or the number of
    * sequences is lower than 2
    * @author Sylvain Glémin
@@ -788,7 +1205,8 @@ public:
   static Vdouble pairwiseD(
       const PolymorphismSequenceContainer& psc,
       bool keepsingleton = true,
-      double freqmin = 0.);
+      double freqmin = 0.,
+      const ExecutionContext& context = ExecutionContext::sequential());
 
   /**
    * @brief give the vector of all mean pairwise D' value between two sites (Lewontin 1964, Genetics 49 pp49-67))
@@ -798,6 +1216,7 @@ public:
    * singleton)
    * @param freqmin a float (to exlude site with the lowest allele
    * frequency less than the threshold given by freqmin, 0 by default)
+   * @param context the ExecutionContext used to compute the pairs of sites
    * @throw DimensionException if the number of sites or the number of
    * sequences is lower than 2
    * @author Sylvain Glémin
@@ -805,7 +1224,8 @@ public:
   static Vdouble pairwiseDprime(
       const PolymorphismSequenceContainer& psc,
       bool keepsingleton = true,
-      double freqmin = 0.);
+      double freqmin = 0.,
+      const ExecutionContext& context = ExecutionContext::sequential());
 
   /**
    * @brief give the vector of all mean pairwise R² value between two sites (Hill & Robertson 1968, Theor. Appl. Genet., 38 pp226-231)
@@ -815,6 +1235,7 @@ public:
    * singleton)
    * @param freqmin a float (to exlude site with the lowest allele
    * frequency less than the threshold given by freqmin, 0 by default)
+   * @param context the ExecutionContext used to compute the pairs of sites
    * @throw DimensionException if the number of sites or the number of
    * sequences is lower than 2
    * @author Sylvain Glémin
@@ -822,7 +1243,8 @@ public:
   static Vdouble pairwiseR2(
       const PolymorphismSequenceContainer& psc,
       bool keepsingleton = true,
-      double freqmin = 0.);
+      double freqmin = 0.,
+      const ExecutionContext& context = ExecutionContext::sequential());
 
   /**
    * @brief give mean D over all pairwise comparisons
@@ -1069,13 +1491,15 @@ public:
    * @param precision default value = 0.000001
    * @param cinf initial value, by default cinf=0.001
    * @param csup initial value, by default csup = 10000
+   * @param context the ExecutionContext used to compare the pairs of sequences
    * @author Sylvain Glémin
    */
   static double hudson87(
       const PolymorphismSequenceContainer& psc,
       double precision = 0.000001,
       double cinf = 0.001,
-      double csup = 10000.);
+      double csup = 10000.,
+      const ExecutionContext& context = ExecutionContext::sequential());
 
   /**
    * @brief Test useful values
@@ -1088,11 +1512,76 @@ public:
       size_t n);
 
 private:
+  /**
+   * @brief Count the copies of each distinct haplotype.
+   *
+   * @param psc a PolymorphismSequenceContainer
+   * @param gapflag remove the sites with gaps before comparing the sequences
+   * @return one count per distinct haplotype, in order of first occurrence
+   */
+  static std::vector<size_t> getHaplotypeCounts_(
+      const PolymorphismSequenceContainer& psc,
+      bool gapflag);
+
   /**
    * @brief Count the number of mutation for a site.
    */
   static unsigned int getNumberOfMutations_(const Site& site);
 
+  /**
+   * @brief Get the LD container of a container, computing it once for given parameters.
+   *
+   * @see generateLdContainer
+   */
+  static std::shared_ptr<const PolymorphismSequenceContainer> getLdContainer_(
+      const PolymorphismSequenceContainer& psc,
+      bool keepsingleton,
+      double freqmin);
+
+  /**
+   * @brief Get the complete sites of a container, computing them once.
+   */
+  static std::shared_ptr<const PolymorphismSequenceContainer> getCompleteSites_(
+      const PolymorphismSequenceContainer& psc);
+
+  /**
+   * @brief Compute the frequency of the 1-1 haplotype for all pairs of sites of a LD container.
+   *
+   * Each pair of unique site patterns (see SitePatterns) is computed once.
+   *
+   * @param ldpsc a PolymorphismSequenceContainer built with generateLdContainer
+   * @param freqs output vector receiving the frequency of allele 1 for each site
+   * @param context the ExecutionContext used to compute the pairs of sites
+   * @return the haplotype frequencies, pairs (i, j) with i < j being in lexicographic order
+   */
+  static Vdouble pairwiseHaplotypeFrequencies_(
+      const PolymorphismSequenceContainer& ldpsc,
+      Vdouble& freqs,
+      const ExecutionContext& context);
+
+  /**
+   * @brief Compute Fay and Wu's Theta H over all the sequences of a container.
+   */
+  static double fayWu2000_(
+      const PolymorphismSequenceContainer& psc,
+      const AncestralStates& ancestral);
+
+  /**
+   * @brief Compute Fu and Li D given the number of mutations in external branches.
+   */
+  static double fuLiD_(
+      const PolymorphismSequenceContainer& ingroup,
+      double etae,
+      bool useNbSegregatingSites);
+
+  /**
+   * @brief Compute Fu and Li F given the number of mutations in external branches.
+   */
+  static double fuLiF_(
+      const PolymorphismSequenceContainer& ingroup,
+      double etae,
+      bool useNbSegregatingSites);
+
   /**
    * @brief Count the number of singleton for a site.
    */
@@ -1215,9 +1704,11 @@ private:
    * @brief give the left hand term of equation (4) in Hudson (Hudson 1987, Genet. Res., 50 pp245-250)
    * This term is used in hudson87
    * @param psc a PolymorphismSequenceContainer
+   * @param context the ExecutionContext used to compare the pairs of sequences
    */
   static double leftHandHudson_(
-      const PolymorphismSequenceContainer& psc);
+      const PolymorphismSequenceContainer& psc,
+      const ExecutionContext& context);
 
   /**
    * @brief give the right hand term of equation (4) in Hudson (Hudson 1987, Genet. Res., 50 pp245-250)
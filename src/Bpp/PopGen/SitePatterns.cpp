@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "SitePatterns.h"
+
+// From the STL
+#include <cstdint>
+#include <unordered_map>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+/**
+ * @brief Odd multiplier of the polynomial hash, computed modulo 2^64.
+ */
+const uint64_t HASH_BASE = 0x9E3779B97F4A7C15ULL;
+}
+
+/******************************************************************************/
+
+SitePatterns::SitePatterns(const PolymorphismSequenceContainer& psc) :
+  nbSequences_(psc.getNumberOfSequences()),
+  patterns_(),
+  weights_(),
+  positions_(),
+  patternOfSite_(psc.getNumberOfSites())
+{
+  // Patterns with a given hash, usually only one
+  unordered_map< uint64_t, vector<size_t> > buckets;
+  for (size_t k = 0; k < psc.getNumberOfSites(); ++k)
+  {
+    const Site& site = psc.site(k);
+    uint64_t hash = 0;
+    for (size_t i = 0; i < nbSequences_; ++i)
+    {
+      hash = hash * HASH_BASE + static_cast<uint64_t>(static_cast<int64_t>(site.getValue(i)));
+    }
+    vector<size_t>& bucket = buckets[hash];
+    size_t pattern = patterns_.size();
+    for (size_t p : bucket)
+    {
+      if (patterns_[p].getContent() == site.getContent())
+      {
+        pattern = p;
+        break;
+      }
+    }
+    if (pattern == patterns_.size())
+    {
+      bucket.push_back(pattern);
+      patterns_.push_back(site);
+      weights_.push_back(0);
+      positions_.push_back(vector<size_t>());
+    }
+    weights_[pattern]++;
+    positions_[pattern].push_back(k);
+    patternOfSite_[k] = pattern;
+  }
+}
+
+/******************************************************************************/
+
+const Site& SitePatterns::getPattern(size_t pattern) const
+{
+  if (pattern >= patterns_.size())
+    throw IndexOutOfBoundsException("SitePatterns::getPattern.", pattern, 0, patterns_.size());
+  return patterns_[pattern];
+}
+
+/******************************************************************************/
+
+unsigned int SitePatterns::getWeight(size_t pattern) const
+{
+  if (pattern >= patterns_.size())
+    throw IndexOutOfBoundsException("SitePatterns::getWeight.", pattern, 0, patterns_.size());
+  return weights_[pattern];
+}
+
+/******************************************************************************/
+
+const vector<size_t>& SitePatterns::getPositions(size_t pattern) const
+{
+  if (pattern >= patterns_.size())
+    throw IndexOutOfBoundsException("SitePatterns::getPositions.", pattern, 0, patterns_.size());
+  return positions_[pattern];
+}
+
+/******************************************************************************/
+
+size_t SitePatterns::getPatternIndex(size_t site) const
+{
+  if (site >= patternOfSite_.size())
+    throw IndexOutOfBoundsException("SitePatterns::getPatternIndex.", site, 0, patternOfSite_.size());
+  return patternOfSite_[site];
+}
+
+/******************************************************************************/
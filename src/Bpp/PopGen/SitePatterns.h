@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _SITEPATTERNS_H_
+#define _SITEPATTERNS_H_
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Seq/Site.h>
+
+// From local
+#include "PolymorphismSequenceContainer.h"
+
+// From the STL
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief The unique site patterns of a PolymorphismSequenceContainer.
+ *
+ * Sites with the same character in every sequence share a pattern, which
+ * is stored once with its multiplicity and the positions of its sites.
+ * Patterns are kept in order of first occurrence. They are found with a
+ * hash of the columns, the content of the columns being compared when two
+ * hashes are equal.
+ *
+ * Per-site estimators can then evaluate each pattern once and weight it by
+ * its multiplicity: see the SequenceStatistics overloads taking a
+ * SitePatterns. Alignments with many sites sharing the same partition of
+ * the sequences, such as clonal or weakly recombining ones, benefit most.
+ */
+class SitePatterns
+{
+private:
+  size_t nbSequences_;
+  std::vector<Site> patterns_;
+  std::vector<unsigned int> weights_;
+  std::vector< std::vector<size_t> > positions_;
+  std::vector<size_t> patternOfSite_;
+
+public:
+  /**
+   * @brief Compress the sites of a container.
+   *
+   * @param psc The sequences.
+   */
+  SitePatterns(const PolymorphismSequenceContainer& psc);
+
+  virtual ~SitePatterns() {}
+
+public:
+  size_t getNumberOfPatterns() const { return patterns_.size(); }
+
+  size_t getNumberOfSites() const { return patternOfSite_.size(); }
+
+  size_t getNumberOfSequences() const { return nbSequences_; }
+
+  /**
+   * @brief Get a pattern, the first site with this pattern.
+   *
+   * @throw IndexOutOfBoundsException if the pattern is out of bounds.
+   */
+  const Site& getPattern(size_t pattern) const;
+
+  /**
+   * @brief Get the number of sites with a pattern.
+   *
+   * @throw IndexOutOfBoundsException if the pattern is out of bounds.
+   */
+  unsigned int getWeight(size_t pattern) const;
+
+  /**
+   * @brief Get the positions of the sites with a pattern, in increasing order.
+   *
+   * @throw IndexOutOfBoundsException if the pattern is out of bounds.
+   */
+  const std::vector<size_t>& getPositions(size_t pattern) const;
+
+  /**
+   * @brief Get the pattern of a site.
+   *
+   * @throw IndexOutOfBoundsException if the site is out of bounds.
+   */
+  size_t getPatternIndex(size_t site) const;
+};
+} // end of namespace bpp;
+
+#endif // _SITEPATTERNS_H_
@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "VariantSiteContainer.h"
+
+// From the STL
+#include <algorithm>
+#include <limits>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+VariantSiteContainer::VariantSiteContainer(const PolymorphismSequenceContainer& psc) :
+  alphabet_(psc.getAlphabet()),
+  names_(psc.getSequenceNames()),
+  counts_(),
+  groups_(),
+  ingroup_(),
+  reference_(psc.getNumberOfSites()),
+  positions_(),
+  variants_(),
+  runs_(psc.getNumberOfSequences()),
+  nbCompleteSites_(0),
+  nbCompleteVariantSites_(0)
+{
+  size_t nbSequences = psc.getNumberOfSequences();
+  for (size_t i = 0; i < nbSequences; ++i)
+  {
+    counts_.push_back(psc.getSequenceCount(i));
+    groups_.push_back(psc.getGroupId(i));
+    ingroup_.push_back(psc.isIngroupMember(i));
+  }
+  int alphabetSize = static_cast<int>(alphabet_->getSize());
+  auto isResolved = [&](int state) {
+        return state >= 0 && state < alphabetSize;
+      };
+
+  for (size_t k = 0; k < psc.getNumberOfSites(); ++k)
+  {
+    const Site& site = psc.site(k);
+    int first = -1;
+    bool variant = false, complete = true;
+    for (size_t i = 0; i < nbSequences; ++i)
+    {
+      int state = site.getValue(i);
+      if (!isResolved(state))
+        complete = false;
+      else if (first < 0)
+        first = state;
+      else if (state != first)
+        variant = true;
+    }
+    // Counted here rather than from the runs: a site where all the sequences
+    // share the same unresolved character has none.
+    if (complete && nbSequences > 0)
+      nbCompleteSites_++;
+    if (variant)
+    {
+      positions_.push_back(k);
+      for (size_t i = 0; i < nbSequences; ++i)
+      {
+        variants_.push_back(site.getValue(i));
+      }
+      if (complete)
+        nbCompleteVariantSites_++;
+    }
+    else if (nbSequences > 0)
+    {
+      if (first < 0)
+        first = site.getValue(0);
+      // The sequences departing from the reference have a gap or an unresolved character.
+      for (size_t i = 0; i < nbSequences; ++i)
+      {
+        int state = site.getValue(i);
+        if (state == first)
+          continue;
+        vector<Run>& runs = runs_[i];
+        if (!runs.empty() && runs.back().start + runs.back().length == k && runs.back().state == state)
+          runs.back().length++;
+        else
+        {
+          Run run;
+          run.start = k;
+          run.length = 1;
+          run.state = state;
+          runs.push_back(run);
+        }
+      }
+    }
+    if (first < numeric_limits<int8_t>::min() || first > numeric_limits<int8_t>::max())
+      throw BadIntegerException("VariantSiteContainer::VariantSiteContainer: state does not fit in a byte.", first);
+    reference_[k] = static_cast<int8_t>(first);
+  }
+}
+
+/******************************************************************************/
+
+Site VariantSiteContainer::getVariantSite(size_t variant) const
+{
+  if (variant >= positions_.size())
+    throw IndexOutOfBoundsException("VariantSiteContainer::getVariantSite.", variant, 0, positions_.size());
+  size_t nbSequences = getNumberOfSequences();
+  vector<int> content(variants_.begin() + static_cast<ptrdiff_t>(variant * nbSequences), variants_.begin() + static_cast<ptrdiff_t>((variant + 1) * nbSequences));
+  return Site(content, alphabet_, static_cast<int>(positions_[variant]));
+}
+
+/******************************************************************************/
+
+int VariantSiteContainer::getValue(size_t site, size_t sequence) const
+{
+  if (site >= getNumberOfSites())
+    throw IndexOutOfBoundsException("VariantSiteContainer::getValue: site out of bounds.", site, 0, getNumberOfSites());
+  if (sequence >= getNumberOfSequences())
+    throw IndexOutOfBoundsException("VariantSiteContainer::getValue: sequence out of bounds.", sequence, 0, getNumberOfSequences());
+  auto variant = lower_bound(positions_.begin(), positions_.end(), site);
+  if (variant != positions_.end() && *variant == site)
+    return variants_[static_cast<size_t>(variant - positions_.begin()) * getNumberOfSequences() + sequence];
+  const vector<Run>& runs = runs_[sequence];
+  auto run = upper_bound(runs.begin(), runs.end(), site, [](size_t s, const Run& r) {
+        return s < r.start;
+      });
+  if (run != runs.begin() && site < (run - 1)->start + (run - 1)->length)
+    return (run - 1)->state;
+  return reference_[site];
+}
+
+/******************************************************************************/
+
+const vector<VariantSiteContainer::Run>& VariantSiteContainer::getRuns(size_t sequence) const
+{
+  if (sequence >= getNumberOfSequences())
+    throw IndexOutOfBoundsException("VariantSiteContainer::getRuns.", sequence, 0, getNumberOfSequences());
+  return runs_[sequence];
+}
+
+/******************************************************************************/
+
+unique_ptr<PolymorphismSequenceContainer> VariantSiteContainer::getVariantSites() const
+{
+  size_t nbSequences = getNumberOfSequences();
+  vector< vector<int> > contents(nbSequences, vector<int>(positions_.size()));
+  for (size_t v = 0; v < positions_.size(); ++v)
+  {
+    for (size_t i = 0; i < nbSequences; ++i)
+    {
+      contents[i][v] = variants_[v * nbSequences + i];
+    }
+  }
+  return buildContainer_(contents);
+}
+
+/******************************************************************************/
+
+unique_ptr<PolymorphismSequenceContainer> VariantSiteContainer::toContainer() const
+{
+  size_t nbSequences = getNumberOfSequences();
+  vector<int> reference(reference_.begin(), reference_.end());
+  vector< vector<int> > contents(nbSequences, reference);
+  for (size_t v = 0; v < positions_.size(); ++v)
+  {
+    for (size_t i = 0; i < nbSequences; ++i)
+    {
+      contents[i][positions_[v]] = variants_[v * nbSequences + i];
+    }
+  }
+  for (size_t i = 0; i < nbSequences; ++i)
+  {
+    for (const Run& run : runs_[i])
+    {
+      fill(contents[i].begin() + static_cast<ptrdiff_t>(run.start), contents[i].begin() + static_cast<ptrdiff_t>(run.start + run.length), run.state);
+    }
+  }
+  return buildContainer_(contents);
+}
+
+/******************************************************************************/
+
+unique_ptr<PolymorphismSequenceContainer> VariantSiteContainer::buildContainer_(const vector< vector<int> >& contents) const
+{
+  auto psc = make_unique<PolymorphismSequenceContainer>(alphabet_);
+  for (size_t i = 0; i < getNumberOfSequences(); ++i)
+  {
+    auto sequence = make_unique<Sequence>(names_[i], contents[i], alphabet_);
+    psc->addSequenceWithFrequency(names_[i], sequence, counts_[i]);
+    psc->setGroupId(i, groups_[i]);
+    if (!ingroup_[i])
+      psc->setAsOutgroupMember(i);
+  }
+  return psc;
+}
+
+/******************************************************************************/
+
+MemoryUsage VariantSiteContainer::memoryUsage() const
+{
+  MemoryUsage usage;
+  usage.add(MemoryUsage::SITES, MemoryUsage::ofVector(reference_) + MemoryUsage::ofVector(positions_) + MemoryUsage::ofVector(variants_));
+  for (const auto& runs : runs_)
+  {
+    usage.add(MemoryUsage::SITES, sizeof(runs) + MemoryUsage::ofVector(runs));
+  }
+  usage.add(MemoryUsage::SEQUENCES, sizeof(*this) + MemoryUsage::ofVector(counts_) + MemoryUsage::ofVector(groups_) + MemoryUsage::ofVector(ingroup_));
+  for (const auto& name : names_)
+  {
+    usage.add(MemoryUsage::NAMES, sizeof(name) + MemoryUsage::ofString(name));
+  }
+  return usage;
+}
+
+/******************************************************************************/
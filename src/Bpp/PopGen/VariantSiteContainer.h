@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _VARIANTSITECONTAINER_H_
+#define _VARIANTSITECONTAINER_H_
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Seq/Site.h>
+
+// From local
+#include "MemoryUsage.h"
+#include "PolymorphismSequenceContainer.h"
+
+// From the STL
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Sparse representation of an alignment, storing only its variant sites.
+ *
+ * A site is variant when it holds at least two distinct resolved states.
+ * The variant sites are stored with their positions and their character in
+ * every sequence. The other sites are described by a reference sequence,
+ * holding the resolved state of each site, and by the runs of gaps and
+ * unresolved characters of each sequence at these sites. The memory used
+ * is then proportional to the number of variant sites and of missing data
+ * runs, plus one byte per site for the reference.
+ *
+ * The number of sites and the number of complete sites (without gap nor
+ * unresolved character) of the alignment are kept, so that scaled
+ * estimators can be computed from the variant sites only (see the
+ * SequenceStatistics overloads taking a VariantSiteContainer).
+ *
+ * The sequence names, counts, groups and ingroup flags are kept, and the
+ * full PolymorphismSequenceContainer can be rebuilt with toContainer().
+ */
+class VariantSiteContainer
+{
+public:
+  /**
+   * @brief A run of identical gaps or unresolved characters in a sequence.
+   */
+  struct Run
+  {
+    size_t start;
+    size_t length;
+    int state;
+  };
+
+private:
+  std::shared_ptr<const Alphabet> alphabet_;
+  std::vector<std::string> names_;
+  std::vector<unsigned int> counts_;
+  std::vector<size_t> groups_;
+  std::vector<bool> ingroup_;
+  std::vector<int8_t> reference_;
+  std::vector<size_t> positions_;
+  std::vector<int> variants_;
+  std::vector< std::vector<Run> > runs_;
+  size_t nbCompleteSites_;
+  size_t nbCompleteVariantSites_;
+
+public:
+  /**
+   * @brief Build the sparse representation of a container.
+   *
+   * @param psc The sequences.
+   * @throw BadIntegerException if a state of an invariant site does not fit in a byte.
+   */
+  VariantSiteContainer(const PolymorphismSequenceContainer& psc);
+
+  virtual ~VariantSiteContainer() {}
+
+public:
+  std::shared_ptr<const Alphabet> getAlphabet() const { return alphabet_; }
+
+  size_t getNumberOfSequences() const { return names_.size(); }
+
+  const std::vector<std::string>& getSequenceNames() const { return names_; }
+
+  /**
+   * @brief Get the number of sites of the alignment, L.
+   */
+  size_t getNumberOfSites() const { return reference_.size(); }
+
+  /**
+   * @brief Get the number of sites without gap nor unresolved character.
+   */
+  size_t getNumberOfCompleteSites() const { return nbCompleteSites_; }
+
+  size_t getNumberOfVariantSites() const { return positions_.size(); }
+
+  /**
+   * @brief Get the number of variant sites without gap nor unresolved character.
+   */
+  size_t getNumberOfCompleteVariantSites() const { return nbCompleteVariantSites_; }
+
+  /**
+   * @brief Get the positions of the variant sites, in increasing order.
+   */
+  const std::vector<size_t>& getVariantPositions() const { return positions_; }
+
+  /**
+   * @brief Get a variant site, its coordinate being its position.
+   *
+   * @throw IndexOutOfBoundsException if the variant is out of bounds.
+   */
+  Site getVariantSite(size_t variant) const;
+
+  /**
+   * @brief Get the character of a sequence at any site.
+   *
+   * @throw IndexOutOfBoundsException if the site or the sequence is out of bounds.
+   */
+  int getValue(size_t site, size_t sequence) const;
+
+  /**
+   * @brief Get the runs of gaps and unresolved characters of a sequence at the invariant sites.
+   *
+   * @throw IndexOutOfBoundsException if the sequence is out of bounds.
+   */
+  const std::vector<Run>& getRuns(size_t sequence) const;
+
+  /**
+   * @brief Build a container with the variant sites only.
+   */
+  std::unique_ptr<PolymorphismSequenceContainer> getVariantSites() const;
+
+  /**
+   * @brief Rebuild the full container.
+   */
+  std::unique_ptr<PolymorphismSequenceContainer> toContainer() const;
+
+  /**
+   * @brief Get the estimated memory footprint of the representation.
+   *
+   * The reference, the variant sites and the runs are reported as
+   * MemoryUsage::SITES, the sequence counts, groups and ingroup flags as
+   * MemoryUsage::SEQUENCES and the sequence names as MemoryUsage::NAMES.
+   */
+  MemoryUsage memoryUsage() const;
+
+private:
+  /**
+   * @brief Build a container whose sequences have the given contents.
+   */
+  std::unique_ptr<PolymorphismSequenceContainer> buildContainer_(const std::vector< std::vector<int> >& contents) const;
+};
+} // end of namespace bpp;
+
+#endif // _VARIANTSITECONTAINER_H_
@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/AbcSummaryEngine.h>
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/HaplotypeMatrix.h>
+#include <Bpp/PopGen/MsReplicateReader.h>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool sameValue(double a, double b)
+{
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+int main()
+{
+  // Ten SNPs of twelve haplotypes, one string per SNP:
+  vector<string> snps = {
+    "011100100100", "100011011011", "110100100110", "110100100110", "001011111010",
+    "011111011011", "011111011011", "000000001000", "101101101101", "100100101111"
+  };
+  HaplotypeMatrix hm(12);
+  for (size_t s = 0; s < snps.size(); ++s)
+  {
+    uint64_t* column = hm.addSnp(static_cast<double>(s) / 10.);
+    for (size_t h = 0; h < 12; ++h)
+    {
+      if (snps[s][h] == '1')
+        column[h / 64] |= static_cast<uint64_t>(1) << (h % 64);
+    }
+  }
+
+  // Reference values computed independently from the derived allele counts and the haplotype counts:
+  map<string, double> refs = {
+    {"S", 10.}, {"singletons", 1.}, {"pi", 4.681818181818182}, {"thetaW", 3.3113927679755353},
+    {"thetaH", 7.136363636363637}, {"tajimaD", 1.702606544218067}, {"fayWuH", -2.454545454545455},
+    {"K", 11.}, {"haplotypeDiversity", 0.9027777777777778}, {"H1", 0.09722222222222225},
+    {"H12", 0.125}, {"H2H1", 0.7142857142857144}, {"ZnS", 0.19997883597883598},
+    {"ZA", 0.43381433381433393}, {"wallB", 1. / 3.}, {"wallQ", 0.6}, {"Rm", 4.},
+    {"dxy", 4.5}, {"fstHudson", -0.0888888888888888}
+  };
+  vector<string> names = AbcSummaryEngine::getAvailableStatistics();
+  AbcSummaryEngine engine(names);
+  engine.setGroups({0, 1, 2, 3, 4, 5}, {6, 7, 8, 9, 10, 11});
+  Vdouble values = engine.compute(hm);
+  for (size_t j = 0; j < names.size(); ++j)
+  {
+    cout << names[j] << " = " << values[j] << endl;
+    if (refs.count(names[j]) == 0 || abs(values[j] - refs[names[j]]) > 1e-12)
+    {
+      cout << "Wrong value of " << names[j] << endl;
+      return 1;
+    }
+  }
+
+  // The results do not depend on the execution context:
+  default_random_engine generator(19);
+  uniform_real_distribution<double> uniform(0., 1.);
+  size_t nbReplicates = 50;
+  ostringstream ms;
+  ms << "ms 20 " << nbReplicates << " -t 5" << endl << "1 2 3" << endl;
+  for (size_t r = 0; r < nbReplicates; ++r)
+  {
+    size_t nbSnps = r % 13;
+    ms << endl << "//" << endl << "segsites: " << nbSnps << endl;
+    if (nbSnps == 0)
+      continue;
+    ms << "positions:";
+    for (size_t s = 0; s < nbSnps; ++s)
+    {
+      ms << " " << (static_cast<double>(s) + uniform(generator)) / static_cast<double>(nbSnps);
+    }
+    ms << endl;
+    for (size_t h = 0; h < 20; ++h)
+    {
+      for (size_t s = 0; s < nbSnps; ++s)
+      {
+        ms << (uniform(generator) < 0.3 ? '1' : '0');
+      }
+      ms << endl;
+    }
+  }
+  vector<size_t> group1, group2;
+  for (size_t h = 0; h < 20; ++h)
+  {
+    (h < 8 ? group1 : group2).push_back(h);
+  }
+  ExecutionContext context(4);
+  string results[2];
+  for (size_t k = 0; k < 2; ++k)
+  {
+    AbcSummaryEngine batched(names, 7);
+    batched.setGroups(group1, group2);
+    istringstream input(ms.str());
+    MsReplicateReader reader(input);
+    ostringstream out;
+    size_t nb = batched.run(reader, out, k == 0 ? ExecutionContext::sequential() : context);
+    if (nb != nbReplicates)
+    {
+      cout << "Wrong number of replicates: " << nb << endl;
+      return 1;
+    }
+    results[k] = out.str();
+  }
+  if (results[0] != results[1])
+  {
+    cout << "Results differ between contexts." << endl;
+    return 1;
+  }
+  if (results[0].size() != sizeof(uint64_t) + nbReplicates * names.size() * sizeof(double))
+  {
+    cout << "Wrong size of the results: " << results[0].size() << endl;
+    return 1;
+  }
+
+  // Buffers reused from one replicate to the next give the values of fresh ones:
+  AbcSummaryEngine single(names);
+  single.setGroups(group1, group2);
+  istringstream input(ms.str());
+  MsReplicateReader reader(input);
+  HaplotypeMatrix replicate;
+  AbcSummaryEngine::Workspace workspace;
+  for (size_t r = 0; r < nbReplicates && reader.nextReplicate(replicate); ++r)
+  {
+    Vdouble fresh = single.compute(replicate);
+    Vdouble reused(names.size());
+    single.compute(replicate, reused.data(), workspace);
+    Vdouble written(names.size());
+    memcpy(written.data(), results[0].data() + sizeof(uint64_t) + r * names.size() * sizeof(double), names.size() * sizeof(double));
+    for (size_t j = 0; j < names.size(); ++j)
+    {
+      if (!sameValue(fresh[j], reused[j]) || !sameValue(fresh[j], written[j]))
+      {
+        cout << "Reused buffers change " << names[j] << " in replicate " << r << "." << endl;
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
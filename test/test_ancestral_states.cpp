@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/AncestralStates.h>
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/PopGen/SequenceStatistics.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool same(double a, double b)
+{
+  return abs(a - b) < 1e-9 || (std::isnan(a) && std::isnan(b));
+}
+
+void add(PolymorphismSequenceContainer& psc, const string& name, const string& content)
+{
+  auto seq = make_unique<Sequence>(name, content, psc.getAlphabet());
+  psc.addSequence(name, seq);
+}
+
+/**
+ * @brief The agreement of the outgroups of a container at a site, by its definition.
+ */
+AncestralStates::Confidence naiveConfidence(const PolymorphismSequenceContainer& psc, size_t site, int& state)
+{
+  map<int, unsigned int> counts;
+  size_t nbOutgroups = 0, nbResolved = 0;
+  for (size_t i = 0; i < psc.getNumberOfSequences(); ++i)
+  {
+    if (psc.isIngroupMember(i))
+      continue;
+    nbOutgroups++;
+    int value = psc.site(site).getValue(i);
+    if (value >= 0 && value < 4)
+    {
+      counts[value] += psc.getSequenceCount(i);
+      nbResolved++;
+    }
+  }
+  state = -1;
+  unsigned int best = 0;
+  bool tie = false;
+  for (auto& count : counts)
+  {
+    if (count.second > best)
+    {
+      state = count.first;
+      best = count.second;
+      tie = false;
+    }
+    else if (count.second == best)
+      tie = true;
+  }
+  if (counts.empty() || tie)
+  {
+    state = -1;
+    return AncestralStates::UNKNOWN;
+  }
+  if (counts.size() > 1)
+    return AncestralStates::MAJORITY;
+  return nbResolved == nbOutgroups ? AncestralStates::COMPLETE : AncestralStates::UNANIMOUS;
+}
+
+int main()
+{
+  shared_ptr<const Alphabet> alpha = AlphabetTools::DNA_ALPHABET;
+  default_random_engine generator(37);
+  uniform_int_distribution<int> nucleotide(0, 3);
+  bernoulli_distribution mutated(0.15);
+  bernoulli_distribution missing(0.1);
+  string ancestor(200, 'A');
+  for (auto& c : ancestor)
+  {
+    c = "ACGT"[nucleotide(generator)];
+  }
+  auto draw = [&](double rate) {
+        bernoulli_distribution changed(rate);
+        string content = ancestor;
+        for (auto& c : content)
+        {
+          if (changed(generator))
+            c = "ACGT"[nucleotide(generator)];
+        }
+        return content;
+      };
+
+  // Outgroups which disagree, with missing data and counts:
+  PolymorphismSequenceContainer psc(alpha);
+  for (size_t i = 0; i < 8; ++i)
+  {
+    add(psc, "in" + to_string(i), draw(0.1));
+  }
+  for (size_t i = 0; i < 4; ++i)
+  {
+    string content = draw(0.15);
+    for (auto& c : content)
+    {
+      if (missing(generator))
+        c = missing(generator) ? 'N' : '-';
+    }
+    add(psc, "out" + to_string(i), content);
+    psc.setAsOutgroupMember(8 + i);
+    psc.setSequenceCount(8 + i, static_cast<unsigned int>(1 + i % 2));
+  }
+
+  vector<size_t> nbSites(4, 0);
+  for (AncestralStates::Confidence minConfidence : {AncestralStates::UNKNOWN, AncestralStates::MAJORITY, AncestralStates::UNANIMOUS, AncestralStates::COMPLETE})
+  {
+    AncestralStates ancestral(psc, minConfidence);
+    size_t nbKnown = 0;
+    for (size_t k = 0; k < psc.getNumberOfSites(); ++k)
+    {
+      int state;
+      AncestralStates::Confidence confidence = naiveConfidence(psc, k, state);
+      if (ancestral.getConfidence(k) != confidence || ancestral.getState(k) != (confidence >= minConfidence ? state : -1)
+          || ancestral.isKnown(k) != (ancestral.getState(k) >= 0))
+      {
+        cout << "Wrong ancestral state at site " << k << " with confidence " << minConfidence << "." << endl;
+        return 1;
+      }
+      if (ancestral.isKnown(k))
+        nbKnown++;
+      if (minConfidence == AncestralStates::UNKNOWN)
+        nbSites[confidence]++;
+    }
+    if (ancestral.getNumberOfSites() != psc.getNumberOfSites() || ancestral.getNumberOfKnownSites() != nbKnown)
+    {
+      cout << "Wrong number of known sites with confidence " << minConfidence << "." << endl;
+      return 1;
+    }
+  }
+  for (size_t confidence = 0; confidence < 4; ++confidence)
+  {
+    if (nbSites[confidence] == 0)
+    {
+      cout << "No site with confidence " << confidence << "." << endl;
+      return 1;
+    }
+  }
+
+  // States taken from a sequence:
+  Sequence sequence("ancestor", "ACGT-NAC", alpha);
+  AncestralStates fromSequence(sequence);
+  if (fromSequence.getNumberOfSites() != 8 || fromSequence.getNumberOfKnownSites() != 6 || fromSequence.getState(2) != 2
+      || fromSequence.getConfidence(3) != AncestralStates::COMPLETE || fromSequence.isKnown(4) || fromSequence.getConfidence(5) != AncestralStates::UNKNOWN)
+  {
+    cout << "Wrong ancestral states of a sequence." << endl;
+    return 1;
+  }
+  try
+  {
+    fromSequence.getConfidence(8);
+    cout << "A site out of bounds is accepted." << endl;
+    return 1;
+  }
+  catch (IndexOutOfBoundsException& e)
+  {}
+
+  // The states are computed once when the cache is enabled:
+  auto uncached = AncestralStates::fromOutgroups(psc);
+  if (AncestralStates::fromOutgroups(psc) == uncached)
+  {
+    cout << "The states are cached by default." << endl;
+    return 1;
+  }
+  psc.setCacheEnabled(true);
+  auto cached = AncestralStates::fromOutgroups(psc);
+  if (AncestralStates::fromOutgroups(psc) != cached || AncestralStates::fromOutgroups(psc, AncestralStates::COMPLETE) == cached
+      || cached->getNumberOfKnownSites() != uncached->getNumberOfKnownSites())
+  {
+    cout << "Wrong cached states." << endl;
+    return 1;
+  }
+  psc.setAsIngroupMember(8);
+  if (AncestralStates::fromOutgroups(psc) == cached)
+  {
+    cout << "The cached states are stale after a modification." << endl;
+    return 1;
+  }
+  psc.setCacheEnabled(false);
+
+  // With a single outgroup, the statistics are those of the ingroup and the outgroup containers:
+  PolymorphismSequenceContainer ingroup(alpha), outgroup(alpha), combined(alpha);
+  string outgroupContent = draw(0.1);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    string content = draw(0.1);
+    add(ingroup, "in" + to_string(i), content);
+    add(combined, "in" + to_string(i), content);
+  }
+  add(outgroup, "out", outgroupContent);
+  add(combined, "out", outgroupContent);
+  combined.setAsOutgroupMember(10);
+  Sequence outgroupSequence("out", outgroupContent, alpha);
+  auto inferred = AncestralStates::fromOutgroups(combined);
+  AncestralStates given(outgroupSequence);
+  if (SequenceStatistics::totalNumberOfMutationsOnExternalBranches(combined, *inferred) != SequenceStatistics::totalNumberOfMutationsOnExternalBranches(ingroup, outgroup)
+      || SequenceStatistics::totalNumberOfMutationsOnExternalBranches(ingroup, given) != SequenceStatistics::totalNumberOfMutationsOnExternalBranches(ingroup, outgroup)
+      || !same(SequenceStatistics::fayWu2000(combined, *inferred), SequenceStatistics::fayWu2000(ingroup, outgroupSequence))
+      || !same(SequenceStatistics::fayWu2000(ingroup, given), SequenceStatistics::fayWu2000(ingroup, outgroupSequence)))
+  {
+    cout << "The statistics with the inferred ancestral states differ from the ones with the outgroup." << endl;
+    return 1;
+  }
+  try
+  {
+    SequenceStatistics::fayWu2000(ingroup, fromSequence);
+    cout << "Ancestral states of another length are accepted." << endl;
+    return 1;
+  }
+  catch (DimensionException& e)
+  {}
+
+  return 0;
+}
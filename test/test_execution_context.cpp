@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/ExecutionContext.h>
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  ExecutionContext pool(4, 7);
+  size_t n = 1000;
+
+  // Every index is visited exactly once:
+  vector<unsigned int> visits(n, 0);
+  pool.parallelFor(0, n, [&](size_t i) {
+        visits[i]++;
+      });
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (visits[i] != 1)
+    {
+      cout << "Index " << i << " visited " << visits[i] << " times." << endl;
+      return 1;
+    }
+  }
+  pool.parallelFor(5, 5, [&](size_t) {
+        visits[0]++;
+      });
+  if (visits[0] != 1)
+  {
+    cout << "Empty range visited." << endl;
+    return 1;
+  }
+
+  // A deterministic reduction does not depend on the number of threads
+  // (for a given grain size):
+  ExecutionContext pool4(4);
+  auto map = [](size_t i) { return 1. / (static_cast<double>(i) + 1.); };
+  auto reduce = [](double a, double b) { return a + b; };
+  double seq = ExecutionContext::sequential().parallelReduce(0, n, 0., map, reduce);
+  double par = pool4.parallelReduce(0, n, 0., map, reduce);
+  ExecutionContext pool3(3);
+  double par3 = pool3.parallelReduce(0, n, 0., map, reduce);
+  cout << "Sequential: " << seq << ", parallel: " << par << ", " << par3 << endl;
+  if (seq != par || seq != par3)
+  {
+    cout << "Deterministic reduction differs between contexts." << endl;
+    return 1;
+  }
+  double ref = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    ref += map(i);
+  }
+  if (abs(seq - ref) > 1e-12)
+  {
+    cout << "Wrong reduction: " << seq << " instead of " << ref << endl;
+    return 1;
+  }
+
+  // Non-deterministic reductions still give the exact result on integers:
+  pool.setDeterministic(false);
+  size_t sum = pool.parallelReduce(0, n, static_cast<size_t>(0),
+                                   [](size_t i) { return i; },
+                                   [](size_t a, size_t b) { return a + b; });
+  if (sum != n * (n - 1) / 2)
+  {
+    cout << "Wrong non-deterministic reduction: " << sum << endl;
+    return 1;
+  }
+
+  // Exceptions are rethrown in the calling thread:
+  bool caught = false;
+  try
+  {
+    pool.parallelFor(0, n, [](size_t i) {
+          if (i == 500)
+            throw runtime_error("index 500");
+        });
+  }
+  catch (runtime_error&)
+  {
+    caught = true;
+  }
+  if (!caught)
+  {
+    cout << "Exception was not propagated." << endl;
+    return 1;
+  }
+
+  // Nested loops do not deadlock:
+  vector<size_t> rows(20, 0);
+  pool.parallelFor(0, rows.size(), [&](size_t i) {
+        rows[i] = pool.parallelReduce(0, i + 1, static_cast<size_t>(0),
+                                      [](size_t j) { return j; },
+                                      [](size_t a, size_t b) { return a + b; });
+      });
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    if (rows[i] != i * (i + 1) / 2)
+    {
+      cout << "Wrong nested result at row " << i << endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/AlleleFrequencyTable.h>
+#include <Bpp/PopGen/BiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/FStatistics.h>
+#include <Bpp/PopGen/MultilocusGenotype.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainer.h>
+
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool check(const string& name, const FStatistics::Estimate& estimate, double value, double standardError)
+{
+  cout << name << " = " << estimate.value << " (" << estimate.standardError << ")" << endl;
+  if (abs(estimate.value - value) > 1e-12 || abs(estimate.standardError - standardError) > 1e-12)
+  {
+    cout << "Expected " << value << " (" << standardError << ")" << endl;
+    return false;
+  }
+  return true;
+}
+
+bool same(const vector<FStatistics::Estimate>& x, const vector<FStatistics::Estimate>& y)
+{
+  if (x.size() != y.size())
+    return false;
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    if (x[i].value != y[i].value || x[i].standardError != y[i].standardError)
+      return false;
+  }
+  return true;
+}
+
+int main()
+{
+  // Nine biallelic loci in four groups of three individuals, -1 being missing:
+  int genotypes[9][12][2] = {
+    {{0, 0}, {-1, -1}, {0, 1}, {1, 0}, {-1, -1}, {0, 0}, {1, 0}, {0, 0}, {1, 0}, {1, 1}, {0, 1}, {0, 1}},
+    {{1, 1}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {1, 0}, {1, 0}, {-1, -1}, {0, 0}, {1, 0}, {0, 1}},
+    {{0, 0}, {1, 0}, {0, 0}, {0, 0}, {-1, -1}, {1, 1}, {-1, -1}, {1, 1}, {0, 1}, {1, 0}, {0, 1}, {1, 0}},
+    {{0, 0}, {0, 0}, {0, 1}, {0, 0}, {0, 0}, {0, 1}, {0, 0}, {1, 1}, {0, 1}, {-1, -1}, {1, 1}, {-1, -1}},
+    {{-1, -1}, {1, 0}, {-1, -1}, {0, 1}, {1, 0}, {0, 0}, {1, 1}, {1, 1}, {1, 1}, {1, 1}, {1, 1}, {0, 0}},
+    {{0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 1}, {1, 1}, {-1, -1}, {1, 0}, {1, 0}, {0, 1}, {1, 1}, {1, 0}},
+    {{0, 0}, {1, 0}, {0, 0}, {1, 0}, {0, 0}, {1, 0}, {1, 1}, {0, 0}, {0, 0}, {1, 1}, {1, 0}, {1, 0}},
+    {{0, 0}, {0, 0}, {0, 0}, {1, 0}, {0, 0}, {1, 0}, {1, 1}, {-1, -1}, {1, 1}, {1, 1}, {1, 1}, {1, 1}},
+    {{0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 1}, {0, 0}, {0, 0}, {1, 0}, {1, 1}, {1, 1}, {-1, -1}, {1, 0}}
+  };
+  PolymorphismMultiGContainer pmgc;
+  for (size_t i = 0; i < 12; ++i)
+  {
+    MultilocusGenotype mg(9);
+    for (size_t l = 0; l < 9; ++l)
+    {
+      if (genotypes[l][i][0] >= 0)
+        mg.setMonolocusGenotype(l, BiAlleleMonolocusGenotype(static_cast<size_t>(genotypes[l][i][0]), static_cast<size_t>(genotypes[l][i][1])));
+    }
+    pmgc.addMultilocusGenotype(mg, i / 3);
+  }
+  AlleleFrequencyTable table(pmgc);
+  FStatistics stats(table, 3);
+  if (table.getNumberOfSites() != 9 || stats.getNumberOfBlocks() != 3)
+  {
+    cout << "Wrong number of sites or blocks." << endl;
+    return 1;
+  }
+
+  // Reference values computed from the per-site statistics with the weighted block jackknife:
+  if (!check("f2(0, 1)", stats.f2(0, 1), -0.017592592592592594, 0.013929980365921921)
+      || !check("f2(1, 3)", stats.f2(1, 3), 0.14382716049382716, 0.07207434475649037)
+      || !check("f4(0, 1; 2, 3)", stats.f4(0, 1, 2, 3), 0.023148148148148147, 0.016692367016036987)
+      || !check("D(0, 1; 2, 3)", stats.dStatistic(0, 1, 2, 3), 0.14077163712200208, 0.1281711504767054))
+    return 1;
+  if (!std::isnan(FStatistics(table, 10).f2(0, 1).standardError))
+  {
+    cout << "Standard error with a single block should be NaN." << endl;
+    return 1;
+  }
+
+  // The statistics do not depend on the execution context:
+  default_random_engine generator(5);
+  uniform_real_distribution<double> uniform(0., 1.);
+  size_t nbLoci = 2000;
+  PolymorphismMultiGContainer big;
+  for (size_t i = 0; i < 50; ++i)
+  {
+    MultilocusGenotype mg(nbLoci);
+    for (size_t l = 0; l < nbLoci; ++l)
+    {
+      double p = 0.1 + 0.15 * static_cast<double>(i % 5) + 0.1 * static_cast<double>(l % 3);
+      mg.setMonolocusGenotype(l, BiAlleleMonolocusGenotype(uniform(generator) < p ? 1 : 0, uniform(generator) < p ? 1 : 0));
+    }
+    big.addMultilocusGenotype(mg, i % 5);
+  }
+  AlleleFrequencyTable bigTable(big);
+  ExecutionContext context(4);
+  FStatistics seq(bigTable, 50);
+  FStatistics par(bigTable, 50, context);
+  vector< array<size_t, 3> > triples;
+  vector< array<size_t, 4> > quartets;
+  for (size_t a = 0; a < 5; ++a)
+  {
+    for (size_t b = 0; b < 5; ++b)
+    {
+      if (a == b)
+        continue;
+      triples.push_back({{ (a + 3) % 5, a, b }});
+      quartets.push_back({{ a, b, (a + 2) % 5, (b + 3) % 5 }});
+    }
+  }
+  vector<FStatistics::Estimate> f3 = seq.f3(triples);
+  vector<FStatistics::Estimate> f4 = seq.f4(quartets);
+  vector<FStatistics::Estimate> d = seq.dStatistic(quartets);
+  if (!same(f3, par.f3(triples, context)) || !same(f4, par.f4(quartets, context))
+      || !same(d, par.dStatistic(quartets, context)))
+  {
+    cout << "Statistics differ between contexts." << endl;
+    return 1;
+  }
+  for (size_t q = 0; q < quartets.size(); ++q)
+  {
+    FStatistics::Estimate single = seq.f4(quartets[q][0], quartets[q][1], quartets[q][2], quartets[q][3]);
+    if (single.value != f4[q].value || single.standardError != f4[q].standardError)
+    {
+      cout << "Batched f4 differs from single f4." << endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
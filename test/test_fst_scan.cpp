@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/BiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/DataSet/AnalyzedLoci.h>
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/FstScan.h>
+#include <Bpp/PopGen/LocusInfo.h>
+#include <Bpp/PopGen/MultilocusGenotype.h>
+#include <Bpp/PopGen/MultilocusGenotypeStatistics.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainer.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+typedef MultilocusGenotypeStatistics::VarComp VarComp;
+
+class Collector :
+  public FstScan::Sink
+{
+public:
+  vector<FstScan::LocusRow> loci;
+  vector<FstScan::WindowRow> windows;
+
+public:
+  Collector() : loci(), windows() {}
+
+public:
+  void addLocus(const FstScan::LocusRow& row) override { loci.push_back(row); }
+  void addWindow(const FstScan::WindowRow& row) override { windows.push_back(row); }
+};
+
+bool near(double a, double b)
+{
+  return abs(a - b) < 1e-12 || (std::isnan(a) && std::isnan(b));
+}
+
+bool nearComp(const VarComp& x, const VarComp& y)
+{
+  return near(x.a, y.a) && near(x.b, y.b) && near(x.c, y.c);
+}
+
+bool sameComp(const VarComp& x, const VarComp& y)
+{
+  return x.a == y.a && x.b == y.b && x.c == y.c;
+}
+
+int main()
+{
+  // Two loci in three groups of 5, 5 and 4 individuals, -1 being missing:
+  int genotypes[2][14][2] = {
+    {{0, 0}, {0, 1}, {0, 0}, {1, 1}, {0, 1},
+     {1, 1}, {1, 1}, {0, 1}, {1, 2}, {-1, -1},
+     {0, 2}, {2, 2}, {0, 0}, {1, 2}},
+    {{0, 1}, {0, 0}, {0, 0}, {0, 0}, {0, 1},
+     {1, 1}, {0, 1}, {1, 1}, {1, 1}, {0, 1},
+     {0, 0}, {0, 1}, {1, 1}, {0, 0}}
+  };
+  size_t groupOf[14] = {1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 3, 3, 3, 3};
+  PolymorphismMultiGContainer pmgc;
+  for (size_t i = 0; i < 14; ++i)
+  {
+    MultilocusGenotype mg(2);
+    for (size_t l = 0; l < 2; ++l)
+    {
+      if (genotypes[l][i][0] >= 0)
+        mg.setMonolocusGenotype(l, BiAlleleMonolocusGenotype(static_cast<size_t>(genotypes[l][i][0]), static_cast<size_t>(genotypes[l][i][1])));
+    }
+    pmgc.addMultilocusGenotype(mg, groupOf[i]);
+  }
+  set<size_t> groups = {1, 2, 3};
+  vector<size_t> positions = {0, 1};
+
+  // Reference values computed from the formulas of Weir and Cockerham (1984):
+  VarComp refs[2] = {
+    {0.1380357142857143, 0.10923076923076921, 0.46153846153846156},
+    {0.15304195804195808, 0.05551948051948051, 0.35714285714285715}
+  };
+  VarComp maskedRefs[2] = {
+    {0.10208333333333337, 0.2348484848484848, 0.36363636363636365},
+    {0.11382978723404259, 0.024999999999999984, 0.4166666666666667}
+  };
+  vector<bool> mask(14, true);
+  mask[1] = false;
+  mask[10] = false;
+  vector<MultilocusGenotypeStatistics::LocusComponents> components = MultilocusGenotypeStatistics::getLocusComponents(pmgc, positions, groups);
+  vector<MultilocusGenotypeStatistics::LocusComponents> maskedComponents = MultilocusGenotypeStatistics::getLocusComponents(pmgc, positions, groups, ExecutionContext::sequential(), mask);
+  for (size_t l = 0; l < 2; ++l)
+  {
+    VarComp v = components[l].varComp;
+    cout << "Locus " << l << ": a = " << v.a << ", b = " << v.b << ", c = " << v.c << endl;
+    if (!nearComp(v, refs[l]) || !sameComp(v, FstScan::getVarianceComponents(pmgc, l, groups)))
+    {
+      cout << "Wrong variance components." << endl;
+      return 1;
+    }
+    if (!nearComp(maskedComponents[l].varComp, maskedRefs[l]) || !sameComp(maskedComponents[l].varComp, FstScan::getVarianceComponents(pmgc, l, groups, mask)))
+    {
+      cout << "Wrong variance components with an individual mask." << endl;
+      return 1;
+    }
+  }
+  VarComp pair = FstScan::getVarianceComponents(pmgc, 0, {1, 2});
+  if (!nearComp(pair, {0.11678571428571427, 0.06706349206349212, 0.4444444444444444}))
+  {
+    cout << "Wrong variance components for a subset of groups." << endl;
+    return 1;
+  }
+  double fst = MultilocusGenotypeStatistics::getWCMultilocusFst(pmgc, positions, groups);
+  double fis = MultilocusGenotypeStatistics::getWCMultilocusFis(pmgc, positions, groups);
+  cout << "Fst = " << fst << ", Fis = " << fis << endl;
+  if (!near(fst, 0.22838412074146583) || !near(fis, 0.1675258910114129))
+  {
+    cout << "Wrong multilocus estimates." << endl;
+    return 1;
+  }
+
+  // Scan of a larger data set, sequential and parallel:
+  default_random_engine generator(1);
+  uniform_int_distribution<size_t> allele(0, 3);
+  bernoulli_distribution missing(0.05);
+  size_t nbLoci = 300;
+  PolymorphismMultiGContainer big;
+  for (size_t i = 0; i < 40; ++i)
+  {
+    MultilocusGenotype mg(nbLoci);
+    for (size_t l = 0; l < nbLoci; ++l)
+    {
+      if (!missing(generator))
+        mg.setMonolocusGenotype(l, BiAlleleMonolocusGenotype((allele(generator) + i % 4) % (l % 4 + 1), allele(generator) % 2));
+    }
+    big.addMultilocusGenotype(mg, i % 4);
+  }
+  set<size_t> bigGroups = {0, 1, 2, 3};
+  AnalyzedLoci loci(nbLoci);
+  uniform_int_distribution<size_t> gap(1, 30);
+  size_t position = 0;
+  for (size_t l = 0; l < nbLoci; ++l)
+  {
+    position += gap(generator);
+    LocusInfo info("L" + to_string(l));
+    info.setCoordinates(l < 200 ? "chr1" : "chr2", l == 200 ? position = 3 : position);
+    loci.setLocusInfo(l, info);
+  }
+  vector<size_t> bigPositions(nbLoci);
+  for (size_t l = 0; l < nbLoci; ++l)
+  {
+    bigPositions[l] = l;
+  }
+
+  ExecutionContext context(4);
+  Collector seq, par;
+  FstScan::scan(big, loci, bigGroups, 100, 40, seq);
+  FstScan::scan(big, loci, bigGroups, 100, 40, par, context, 16);
+  vector<MultilocusGenotypeStatistics::LocusComponents> bigComponents = MultilocusGenotypeStatistics::getLocusComponents(big, bigPositions, bigGroups);
+  vector<MultilocusGenotypeStatistics::LocusComponents> parComponents = MultilocusGenotypeStatistics::getLocusComponents(big, bigPositions, bigGroups, context);
+  if (seq.loci.size() != nbLoci || par.loci.size() != nbLoci)
+  {
+    cout << "Wrong number of loci in the scan." << endl;
+    return 1;
+  }
+  for (size_t i = 0; i < nbLoci; ++i)
+  {
+    const FstScan::LocusRow& row = seq.loci[i];
+    if (row.locus != par.loci[i].locus || !sameComp(row.varComp, par.loci[i].varComp)
+        || !sameComp(row.varComp, bigComponents[row.locus].varComp)
+        || !sameComp(bigComponents[row.locus].varComp, parComponents[row.locus].varComp))
+    {
+      cout << "Scan of locus " << row.locus << " differs." << endl;
+      return 1;
+    }
+  }
+  vector<MultilocusGenotypeStatistics::WindowStatistics> windows = MultilocusGenotypeStatistics::getWindowStatistics(big, loci, bigGroups, 100, 40);
+  vector<MultilocusGenotypeStatistics::WindowStatistics> parWindows = MultilocusGenotypeStatistics::getWindowStatistics(big, loci, bigGroups, 100, 40, context);
+  if (seq.windows.size() != windows.size() || par.windows.size() != windows.size() || parWindows.size() != windows.size())
+  {
+    cout << "Wrong number of windows: " << seq.windows.size() << ", " << par.windows.size() << ", " << windows.size() << endl;
+    return 1;
+  }
+  for (size_t w = 0; w < windows.size(); ++w)
+  {
+    const FstScan::WindowRow& row = seq.windows[w];
+    if (row.chromosome != windows[w].chromosome || row.start != windows[w].start || row.end != windows[w].end
+        || row.nbLoci != windows[w].nbLoci || !near(row.Fst, windows[w].Fst)
+        || !sameComp(row.varComp, par.windows[w].varComp)
+        || !(windows[w].Fst == parWindows[w].Fst || (std::isnan(windows[w].Fst) && std::isnan(parWindows[w].Fst))))
+    {
+      cout << "Window " << w << " differs." << endl;
+      return 1;
+    }
+  }
+  double bigFst = MultilocusGenotypeStatistics::getWCMultilocusFst(big, bigPositions, bigGroups);
+  double bigParFst = MultilocusGenotypeStatistics::getWCMultilocusFst(big, bigPositions, bigGroups, context);
+  cout << "Scan: " << windows.size() << " windows, Fst = " << bigFst << endl;
+  if (bigFst != bigParFst)
+  {
+    cout << "Multilocus Fst differs between contexts." << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/PopGen/SequenceStatistics.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+PolymorphismSequenceContainer make(shared_ptr<const Alphabet> alpha, const vector<string>& contents)
+{
+  PolymorphismSequenceContainer psc(alpha);
+  for (size_t i = 0; i < contents.size(); ++i)
+  {
+    string name = "seq" + to_string(i);
+    auto seq = make_unique<Sequence>(name, contents[i], alpha);
+    psc.addSequence(name, seq);
+  }
+  return psc;
+}
+
+int main()
+{
+  // Site 5 has a gap, site 6 an ambiguous M and site 7 is a constant S:
+  vector<string> contents = {"ACGTA-MS", "ACGAACGS", "GCTAACAS", "ACTACACS"};
+  PolymorphismSequenceContainer dna = make(AlphabetTools::DNA_ALPHABET, contents);
+
+  // Only the A, C, G and T states are counted: 12 GC out of 26.
+  if (abs(SequenceStatistics::gcContent(dna) - 12. / 26.) > 1e-12)
+  {
+    cout << "Wrong GC content: " << SequenceStatistics::gcContent(dna) << "." << endl;
+    return 1;
+  }
+
+  // Complete sites 0, 2 and 4 have 1, 2 and 1 GC out of 4, site 1 is only GC and site 3 only AT.
+  vector<unsigned int> complete = SequenceStatistics::gcPolymorphism(dna);
+  if (complete != vector<unsigned int>({12, 4}))
+  {
+    cout << "Wrong GC polymorphism of the complete sites: " << complete[0] << ", " << complete[1] << "." << endl;
+    return 1;
+  }
+
+  // Without gapflag, the ambiguous site is added with M counted as A or T (2 GC out of 4),
+  // while the constant ambiguous site is not polymorphic.
+  vector<unsigned int> noGap = SequenceStatistics::gcPolymorphism(dna, false);
+  if (noGap != vector<unsigned int>({16, 6}))
+  {
+    cout << "Wrong GC polymorphism of the sites without gap: " << noGap[0] << ", " << noGap[1] << "." << endl;
+    return 1;
+  }
+
+  // The states are taken from the alphabet:
+  vector<string> rnaContents = contents;
+  for (auto& content : rnaContents)
+  {
+    for (auto& c : content)
+    {
+      if (c == 'T')
+        c = 'U';
+    }
+  }
+  PolymorphismSequenceContainer rna = make(AlphabetTools::RNA_ALPHABET, rnaContents);
+  if (abs(SequenceStatistics::gcContent(rna) - 12. / 26.) > 1e-12
+      || SequenceStatistics::gcPolymorphism(rna) != complete
+      || SequenceStatistics::gcPolymorphism(rna, false) != noGap)
+  {
+    cout << "Wrong GC statistics with an RNA alphabet." << endl;
+    return 1;
+  }
+
+  // Without ambiguities, the statistics are the same:
+  PolymorphismSequenceContainer resolved = make(AlphabetTools::DNA_ALPHABET, {"ACGTA", "ACGAA", "GCTAA", "ACTAC"});
+  if (abs(SequenceStatistics::gcContent(resolved) - 8. / 20.) > 1e-12
+      || SequenceStatistics::gcPolymorphism(resolved) != vector<unsigned int>({12, 4})
+      || SequenceStatistics::gcPolymorphism(resolved, false) != vector<unsigned int>({12, 4}))
+  {
+    cout << "Wrong GC statistics without ambiguities." << endl;
+    return 1;
+  }
+
+  // Other alphabets are rejected:
+  PolymorphismSequenceContainer proteins = make(AlphabetTools::PROTEIN_ALPHABET, {"ACGT", "ACGA"});
+  try
+  {
+    SequenceStatistics::gcContent(proteins);
+    cout << "GC content of proteins was accepted." << endl;
+    return 1;
+  }
+  catch (AlphabetMismatchException& e)
+  {}
+  try
+  {
+    SequenceStatistics::gcPolymorphism(proteins);
+    cout << "GC polymorphism of proteins was accepted." << endl;
+    return 1;
+  }
+  catch (AlphabetMismatchException& e)
+  {}
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/BiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/GenotypeArena.h>
+#include <Bpp/PopGen/MultilocusGenotype.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainer.h>
+
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  // Scopes select the arena of the current thread, and restore the previous one:
+  GenotypeArena arena, other;
+  if (GenotypeArena::getCurrent() != nullptr)
+  {
+    cout << "An arena is active without scope." << endl;
+    return 1;
+  }
+  {
+    GenotypeArena::Scope scope(arena);
+    {
+      GenotypeArena::Scope nested(other);
+      if (GenotypeArena::getCurrent() != &other)
+      {
+        cout << "The nested arena is not active." << endl;
+        return 1;
+      }
+    }
+    if (GenotypeArena::getCurrent() != &arena)
+    {
+      cout << "The previous arena is not restored." << endl;
+      return 1;
+    }
+  }
+  if (GenotypeArena::getCurrent() != nullptr || arena.getNumberOfLiveBlocks() != 0)
+  {
+    cout << "An arena is still active after its scope." << endl;
+    return 1;
+  }
+
+  // Blocks are counted while they live, and the freed ones are recycled:
+  {
+    GenotypeArena::Scope scope(arena);
+    vector< unique_ptr<BiAlleleMonolocusGenotype> > genotypes;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      genotypes.push_back(make_unique<BiAlleleMonolocusGenotype>(i, i + 1));
+    }
+    size_t reserved = arena.getReservedBytes();
+    if (arena.getNumberOfLiveBlocks() != 1000 || reserved == 0)
+    {
+      cout << "Wrong number of live blocks: " << arena.getNumberOfLiveBlocks() << "." << endl;
+      return 1;
+    }
+    for (size_t round = 0; round < 10; ++round)
+    {
+      genotypes.clear();
+      for (size_t i = 0; i < 1000; ++i)
+      {
+        genotypes.push_back(make_unique<BiAlleleMonolocusGenotype>(i, i + 2));
+      }
+    }
+    if (arena.getReservedBytes() != reserved)
+    {
+      cout << "Freed blocks are not recycled: " << arena.getReservedBytes() << " bytes instead of " << reserved << "." << endl;
+      return 1;
+    }
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      if (genotypes[i]->getAlleleIndexAt(0) != i || genotypes[i]->getAlleleIndexAt(1) != i + 2)
+      {
+        cout << "Genotype " << i << " was overwritten." << endl;
+        return 1;
+      }
+    }
+  }
+  if (arena.getNumberOfLiveBlocks() != 0)
+  {
+    cout << "Blocks still live after their deletion." << endl;
+    return 1;
+  }
+
+  // Objects out of any scope, or too large, come from the heap:
+  {
+    unique_ptr<BiAlleleMonolocusGenotype> outside(new BiAlleleMonolocusGenotype(0, 1));
+    GenotypeArena::Scope scope(arena);
+    void* large = GenotypeArena::allocate(GenotypeArena::MAX_BLOCK_SIZE + 1);
+    if (arena.getNumberOfLiveBlocks() != 0)
+    {
+      cout << "Heap objects are counted in the arena." << endl;
+      return 1;
+    }
+    GenotypeArena::deallocate(large);
+  }
+
+  // Blocks allocated and freed by several threads:
+  {
+    vector<thread> threads;
+    for (size_t t = 0; t < 4; ++t)
+    {
+      threads.push_back(thread([&arena, t]() {
+            GenotypeArena::Scope scope(arena);
+            vector< unique_ptr<BiAlleleMonolocusGenotype> > genotypes;
+            for (size_t i = 0; i < 5000; ++i)
+            {
+              genotypes.push_back(make_unique<BiAlleleMonolocusGenotype>(t, i));
+              if (i % 3 == 0)
+                genotypes.erase(genotypes.begin() + static_cast<ptrdiff_t>(i % genotypes.size()));
+            }
+          }));
+    }
+    for (auto& t : threads)
+    {
+      t.join();
+    }
+  }
+  if (arena.getNumberOfLiveBlocks() != 0)
+  {
+    cout << "Blocks freed by other threads are still live: " << arena.getNumberOfLiveBlocks() << "." << endl;
+    return 1;
+  }
+
+  // A genotype removed from its container outlives the container and its arena:
+  unique_ptr<MultilocusGenotype> removed;
+  {
+    PolymorphismMultiGContainer pmgc;
+    for (size_t i = 0; i < 10; ++i)
+    {
+      MultilocusGenotype mg(3);
+      mg.setMonolocusGenotype(1, BiAlleleMonolocusGenotype(i, i + 1));
+      pmgc.addMultilocusGenotype(mg, 0);
+    }
+    removed = pmgc.removeMultilocusGenotype(4);
+    PolymorphismMultiGContainer copy(pmgc);
+    if (copy.size() != 9 || copy.multilocusGenotype(4).monolocusGenotype(1).getAlleleIndexAt(0) != 5)
+    {
+      cout << "Wrong copy of a container." << endl;
+      return 1;
+    }
+  }
+  if (removed->monolocusGenotype(1).getAlleleIndexAt(0) != 4 || removed->monolocusGenotype(1).getAlleleIndexAt(1) != 5)
+  {
+    cout << "The removed genotype was overwritten." << endl;
+    return 1;
+  }
+  removed.reset();
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/BiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/GenotypeQc.h>
+#include <Bpp/PopGen/MultilocusGenotype.h>
+#include <Bpp/PopGen/MultilocusGenotypeStatistics.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainer.h>
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+
+using namespace bpp;
+using namespace std;
+
+bool sameValue(double a, double b)
+{
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+int main()
+{
+  // Reference values computed by full enumeration of the genotype configurations:
+  struct
+  {
+    size_t het, hom1, hom2;
+    double p;
+  } refs[] = {
+    {57, 14, 29, 0.15068007651576143},
+    {14, 57, 29, 1.5045712489560012e-12},
+    {29, 57, 14, 0.005914831472307853},
+    {10, 10, 10, 0.07421943138053523},
+    {21, 40, 39, 3.0881684575615483e-09},
+    {1, 0, 0, 1.},
+    {0, 3, 0, 1.}
+  };
+  for (const auto& ref : refs)
+  {
+    double p = GenotypeQc::hweExactTest(ref.het, ref.hom1, ref.hom2);
+    cout << "HWE(" << ref.het << ", " << ref.hom1 << ", " << ref.hom2 << ") = " << p << endl;
+    if (abs(p - ref.p) > 1e-9 * max(1., ref.p) && abs(p / ref.p - 1.) > 1e-9)
+    {
+      cout << "Expected " << ref.p << endl;
+      return 1;
+    }
+  }
+  if (!std::isnan(GenotypeQc::hweExactTest(0, 0, 0)))
+  {
+    cout << "HWE test on no genotype should be NaN." << endl;
+    return 1;
+  }
+
+  // The metrics do not depend on the execution context:
+  default_random_engine generator(42);
+  uniform_int_distribution<size_t> allele(0, 2);
+  bernoulli_distribution missing(0.1);
+  size_t nbLoci = 200;
+  PolymorphismMultiGContainer pmgc;
+  for (size_t i = 0; i < 60; ++i)
+  {
+    MultilocusGenotype mg(nbLoci);
+    for (size_t l = 0; l < nbLoci; ++l)
+    {
+      if (!missing(generator))
+        mg.setMonolocusGenotype(l, BiAlleleMonolocusGenotype(allele(generator) % (l % 3 + 1), allele(generator) % 2));
+    }
+    pmgc.addMultilocusGenotype(mg, i % 3);
+  }
+  GenotypeQc seq(pmgc);
+  ExecutionContext context(4);
+  GenotypeQc par(pmgc, context);
+  for (size_t l = 0; l < nbLoci; ++l)
+  {
+    const GenotypeQc::LocusMetrics& s = seq.getLocusMetrics(l);
+    const GenotypeQc::LocusMetrics& p = par.getLocusMetrics(l);
+    if (s.nbGenotyped != p.nbGenotyped || s.nbAlleles != p.nbAlleles
+        || !sameValue(s.missingRate, p.missingRate) || !sameValue(s.maf, p.maf)
+        || !sameValue(s.heterozygosity, p.heterozygosity) || !sameValue(s.hweP, p.hweP))
+    {
+      cout << "Locus metrics differ at locus " << l << endl;
+      return 1;
+    }
+  }
+  for (size_t i = 0; i < pmgc.size(); ++i)
+  {
+    const GenotypeQc::IndividualMetrics& s = seq.getIndividualMetrics(i);
+    const GenotypeQc::IndividualMetrics& p = par.getIndividualMetrics(i);
+    if (s.nbGenotyped != p.nbGenotyped || !sameValue(s.missingRate, p.missingRate)
+        || !sameValue(s.heterozygosity, p.heterozygosity))
+    {
+      cout << "Individual metrics differ at individual " << i << endl;
+      return 1;
+    }
+  }
+
+  // Filters and masks:
+  vector<bool> mask = seq.getLocusMask(GenotypeQc::numberOfAlleles(2, 2) & GenotypeQc::minHweP(0.));
+  for (size_t l = 0; l < nbLoci; ++l)
+  {
+    if (mask[l] != (seq.getLocusMetrics(l).nbAlleles == 2))
+    {
+      cout << "Wrong locus mask at locus " << l << endl;
+      return 1;
+    }
+  }
+  vector<size_t> positions = GenotypeQc::getPositions(mask);
+  for (size_t l : positions)
+  {
+    if (!mask[l])
+    {
+      cout << "Wrong position " << l << endl;
+      return 1;
+    }
+  }
+
+  // The statistics on a mask are those of the container without the hidden individuals:
+  vector<bool> individuals = seq.getIndividualMask(GenotypeQc::maxIndividualMissingRate(0.08));
+  PolymorphismMultiGContainer kept;
+  for (size_t i = 0; i < pmgc.size(); ++i)
+  {
+    if (individuals[i])
+      kept.addMultilocusGenotype(pmgc.multilocusGenotype(i), pmgc.getGroupId(i));
+  }
+  if (kept.size() == 0 || kept.size() == pmgc.size())
+  {
+    cout << "The individual filter should keep some individuals only." << endl;
+    return 1;
+  }
+  set<size_t> groups = {0, 1, 2};
+  for (size_t l = 0; l < nbLoci; ++l)
+  {
+    if (!sameValue(MultilocusGenotypeStatistics::getHobsForGroups(pmgc, l, groups, individuals), MultilocusGenotypeStatistics::getHobsForGroups(kept, l, groups))
+        || !sameValue(MultilocusGenotypeStatistics::getHexpForGroups(pmgc, l, groups, individuals), MultilocusGenotypeStatistics::getHexpForGroups(kept, l, groups))
+        || !sameValue(MultilocusGenotypeStatistics::getHnbForGroups(pmgc, l, groups, individuals), MultilocusGenotypeStatistics::getHnbForGroups(kept, l, groups)))
+    {
+      cout << "Masked statistics differ at locus " << l << endl;
+      return 1;
+    }
+  }
+  vector<size_t> loci = GenotypeQc::getPositions(seq.getLocusMask(GenotypeQc::minMaf(0.1)));
+  if (MultilocusGenotypeStatistics::getWCMultilocusFst(pmgc, loci, groups, ExecutionContext::sequential(), individuals)
+      != MultilocusGenotypeStatistics::getWCMultilocusFst(kept, loci, groups))
+  {
+    cout << "Masked Fst differs." << endl;
+    return 1;
+  }
+  if (!sameValue(MultilocusGenotypeStatistics::getRHMultilocusFst(pmgc, loci, groups, ExecutionContext::sequential(), individuals),
+                 MultilocusGenotypeStatistics::getRHMultilocusFst(kept, loci, groups)))
+  {
+    cout << "Masked RH Fst differs." << endl;
+    return 1;
+  }
+  for (string method : {"nei72", "nei78", "WC", "RH", "Nm", "D", "Rousset"})
+  {
+    unique_ptr<DistanceMatrix> masked = MultilocusGenotypeStatistics::getDistanceMatrix(pmgc, loci, groups, method, context, individuals);
+    unique_ptr<DistanceMatrix> reference = MultilocusGenotypeStatistics::getDistanceMatrix(kept, loci, groups, method);
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+      for (size_t j = 0; j < groups.size(); ++j)
+      {
+        if (!sameValue((*masked)(i, j), (*reference)(i, j)))
+        {
+          cout << "Masked distance " << method << " differs at (" << i << ", " << j << ")." << endl;
+          return 1;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
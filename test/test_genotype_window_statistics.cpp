@@ -0,0 +1,253 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/BiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/DataSet/AnalyzedLoci.h>
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/LocusInfo.h>
+#include <Bpp/PopGen/MultilocusGenotype.h>
+#include <Bpp/PopGen/MultilocusGenotypeStatistics.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+typedef MultilocusGenotypeStatistics::VarComp VarComp;
+typedef MultilocusGenotypeStatistics::WindowStatistics WindowStatistics;
+
+bool near(double a, double b)
+{
+  return abs(a - b) < 1e-9 || (std::isnan(a) && std::isnan(b));
+}
+
+bool nearComp(const VarComp& x, const VarComp& y)
+{
+  return near(x.a, y.a) && near(x.b, y.b) && near(x.c, y.c);
+}
+
+bool nearWindow(const WindowStatistics& x, const WindowStatistics& y)
+{
+  return x.nbLoci == y.nbLoci && near(x.Fst, y.Fst) && near(x.Fis, y.Fis)
+         && near(x.Hobs, y.Hobs) && near(x.Hexp, y.Hexp) && near(x.Gst, y.Gst);
+}
+
+/**
+ * @brief The windows of a set of loci, enumerating every start of every chromosome.
+ */
+vector<AnalyzedLoci::LocusWindow> naiveWindows(const AnalyzedLoci& loci, size_t windowSize, size_t step)
+{
+  vector<AnalyzedLoci::LocusWindow> windows;
+  for (const auto& chromosome : loci.getChromosomes())
+  {
+    size_t maxPosition = 0;
+    for (size_t l = 0; l < loci.getNumberOfLoci(); ++l)
+    {
+      const LocusInfo& info = loci.getLocusInfoAtPosition(l);
+      if (info.getChromosome() == chromosome)
+        maxPosition = max(maxPosition, info.getPosition());
+    }
+    for (size_t start = 0; start <= maxPosition; start += step)
+    {
+      vector< pair<size_t, size_t> > content;
+      for (size_t l = 0; l < loci.getNumberOfLoci(); ++l)
+      {
+        const LocusInfo& info = loci.getLocusInfoAtPosition(l);
+        if (info.getChromosome() == chromosome && info.getPosition() >= start && info.getPosition() < start + windowSize)
+          content.push_back(make_pair(info.getPosition(), l));
+      }
+      if (content.empty())
+        continue;
+      sort(content.begin(), content.end());
+      AnalyzedLoci::LocusWindow window;
+      window.chromosome = chromosome;
+      window.start = start;
+      window.end = start + windowSize;
+      for (auto& c : content)
+      {
+        window.loci.push_back(c.second);
+      }
+      windows.push_back(window);
+    }
+  }
+  return windows;
+}
+
+bool sameWindows(const vector<AnalyzedLoci::LocusWindow>& x, const vector<AnalyzedLoci::LocusWindow>& y)
+{
+  if (x.size() != y.size())
+    return false;
+  for (size_t w = 0; w < x.size(); ++w)
+  {
+    if (x[w].chromosome != y[w].chromosome || x[w].start != y[w].start || x[w].end != y[w].end || x[w].loci != y[w].loci)
+      return false;
+  }
+  return true;
+}
+
+int main()
+{
+  // Two loci in three groups of 5, 5 and 4 individuals, -1 being missing:
+  int genotypes[2][14][2] = {
+    {{0, 0}, {0, 1}, {0, 0}, {1, 1}, {0, 1},
+     {1, 1}, {1, 1}, {0, 1}, {1, 2}, {-1, -1},
+     {0, 2}, {2, 2}, {0, 0}, {1, 2}},
+    {{0, 1}, {0, 0}, {0, 0}, {0, 0}, {0, 1},
+     {1, 1}, {0, 1}, {1, 1}, {1, 1}, {0, 1},
+     {0, 0}, {0, 1}, {1, 1}, {0, 0}}
+  };
+  size_t groupOf[14] = {1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 3, 3, 3, 3};
+  PolymorphismMultiGContainer pmgc;
+  for (size_t i = 0; i < 14; ++i)
+  {
+    MultilocusGenotype mg(2);
+    for (size_t l = 0; l < 2; ++l)
+    {
+      if (genotypes[l][i][0] >= 0)
+        mg.setMonolocusGenotype(l, BiAlleleMonolocusGenotype(static_cast<size_t>(genotypes[l][i][0]), static_cast<size_t>(genotypes[l][i][1])));
+    }
+    pmgc.addMultilocusGenotype(mg, groupOf[i]);
+  }
+  set<size_t> groups = {1, 2, 3};
+  vector<size_t> positions = {0, 1};
+
+  // Reference values computed from the formulas of Weir and Cockerham (1984):
+  VarComp refs[2] = {
+    {0.1380357142857143, 0.10923076923076921, 0.46153846153846156},
+    {0.15304195804195808, 0.05551948051948051, 0.35714285714285715}
+  };
+  vector<MultilocusGenotypeStatistics::LocusComponents> components = MultilocusGenotypeStatistics::getLocusComponents(pmgc, positions, groups);
+  for (size_t l = 0; l < 2; ++l)
+  {
+    VarComp sum = {0., 0., 0.};
+    for (auto& allele : MultilocusGenotypeStatistics::getVarianceComponents(pmgc, l, groups))
+    {
+      sum.a += allele.second.a;
+      sum.b += allele.second.b;
+      sum.c += allele.second.c;
+    }
+    VarComp v = components[l].varComp;
+    cout << "Locus " << l << ": a = " << v.a << ", b = " << v.b << ", c = " << v.c << endl;
+    if (!nearComp(v, refs[l]) || !nearComp(sum, refs[l]))
+    {
+      cout << "Wrong variance components." << endl;
+      return 1;
+    }
+  }
+  double fst = MultilocusGenotypeStatistics::getWCMultilocusFst(pmgc, positions, groups);
+  double fis = MultilocusGenotypeStatistics::getWCMultilocusFis(pmgc, positions, groups);
+  cout << "Fst = " << fst << ", Fis = " << fis << endl;
+  if (!near(fst, 0.22838412074146583) || !near(fis, 0.1675258910114129))
+  {
+    cout << "Wrong multilocus estimates." << endl;
+    return 1;
+  }
+
+  // Loci on two chromosomes, in an order unrelated to their coordinates, and one locus without coordinates:
+  AnalyzedLoci small(5);
+  small.setLocusInfo(0, LocusInfo("a"));
+  LocusInfo b("b"), c("c"), d("d"), e("e");
+  b.setCoordinates("chrA", 150);
+  c.setCoordinates("chrB", 3);
+  d.setCoordinates("chrA", 95);
+  e.setCoordinates("chrA", 400);
+  small.setLocusInfo(1, b);
+  small.setLocusInfo(2, c);
+  small.setLocusInfo(3, d);
+  small.setLocusInfo(4, e);
+  if (small.getChromosomes() != vector<string>({"chrA", "chrB"})
+      || small.getSortedLoci() != vector<size_t>({3, 1, 4, 2})
+      || small.getLociInRange("chrA", 95, 400) != vector<size_t>({3, 1})
+      || small.getLociInRange("chrA", 96, 151) != vector<size_t>({1})
+      || !small.getLociInRange("chrC", 0, 1000).empty())
+  {
+    cout << "Wrong index of the coordinates." << endl;
+    return 1;
+  }
+
+  // The first window of a chromosome is the first one containing its first locus:
+  if (AnalyzedLoci::getFirstWindowStart(95, 100, 10) != 0 || AnalyzedLoci::getFirstWindowStart(150, 100, 10) != 60
+      || AnalyzedLoci::getFirstWindowStart(150, 100, 40) != 80)
+  {
+    cout << "Wrong start of the first window." << endl;
+    return 1;
+  }
+  for (size_t windowSize : {1, 10, 100, 250})
+  {
+    for (size_t step : {1, 10, 40, 300})
+    {
+      if (!sameWindows(small.getWindows(windowSize, step), naiveWindows(small, windowSize, step)))
+      {
+        cout << "Wrong windows of size " << windowSize << " and step " << step << "." << endl;
+        return 1;
+      }
+    }
+  }
+
+  // Windows of a larger data set, sequential and parallel:
+  default_random_engine generator(1);
+  uniform_int_distribution<size_t> allele(0, 3);
+  bernoulli_distribution missing(0.05);
+  size_t nbLoci = 300;
+  PolymorphismMultiGContainer big;
+  for (size_t i = 0; i < 40; ++i)
+  {
+    MultilocusGenotype mg(nbLoci);
+    for (size_t l = 0; l < nbLoci; ++l)
+    {
+      if (!missing(generator))
+        mg.setMonolocusGenotype(l, BiAlleleMonolocusGenotype((allele(generator) + i % 4) % (l % 4 + 1), allele(generator) % 2));
+    }
+    big.addMultilocusGenotype(mg, i % 4);
+  }
+  set<size_t> bigGroups = {0, 1, 2, 3};
+  AnalyzedLoci loci(nbLoci);
+  uniform_int_distribution<size_t> gap(1, 30);
+  size_t position = 0;
+  for (size_t l = 0; l < nbLoci; ++l)
+  {
+    position += gap(generator);
+    LocusInfo info("L" + to_string(l));
+    info.setCoordinates(l < 200 ? "chr1" : "chr2", l == 200 ? position = 3 : position);
+    loci.setLocusInfo(l, info);
+  }
+
+  ExecutionContext context(4);
+  vector<AnalyzedLoci::LocusWindow> locusWindows = loci.getWindows(100, 40);
+  vector<WindowStatistics> windows = MultilocusGenotypeStatistics::getWindowStatistics(big, loci, bigGroups, 100, 40);
+  vector<WindowStatistics> parWindows = MultilocusGenotypeStatistics::getWindowStatistics(big, loci, bigGroups, 100, 40, context);
+  if (!sameWindows(locusWindows, naiveWindows(loci, 100, 40)) || windows.size() != locusWindows.size() || parWindows.size() != windows.size())
+  {
+    cout << "Wrong number of windows: " << windows.size() << ", " << parWindows.size() << ", " << locusWindows.size() << endl;
+    return 1;
+  }
+  for (size_t w = 0; w < windows.size(); ++w)
+  {
+    // The sums of the window only use the components of its loci:
+    vector<MultilocusGenotypeStatistics::LocusComponents> windowComponents = MultilocusGenotypeStatistics::getLocusComponents(big, locusWindows[w].loci, bigGroups);
+    WindowStatistics naive = MultilocusGenotypeStatistics::sumLocusComponents(windowComponents, 0, windowComponents.size());
+    if (windows[w].chromosome != locusWindows[w].chromosome || windows[w].start != locusWindows[w].start
+        || windows[w].end != locusWindows[w].end || !nearWindow(windows[w], naive))
+    {
+      cout << "Window " << w << " differs from the sums of its loci: Fst = " << windows[w].Fst << " instead of " << naive.Fst << "." << endl;
+      return 1;
+    }
+    if (windows[w].nbLoci != parWindows[w].nbLoci
+        || !(windows[w].Fst == parWindows[w].Fst || (std::isnan(windows[w].Fst) && std::isnan(parWindows[w].Fst))))
+    {
+      cout << "Window " << w << " differs between contexts." << endl;
+      return 1;
+    }
+  }
+  cout << windows.size() << " windows." << endl;
+
+  return 0;
+}
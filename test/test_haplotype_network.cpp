@@ -0,0 +1,255 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/HaplotypeNetwork.h>
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+void add(PolymorphismSequenceContainer& psc, const string& name, const string& content)
+{
+  auto seq = make_unique<Sequence>(name, content, psc.getAlphabet());
+  psc.addSequence(name, seq);
+}
+
+/**
+ * @brief The number of differences between two sequences, on the sites where both are resolved.
+ */
+unsigned int differences(const string& a, const string& b)
+{
+  unsigned int d = 0;
+  for (size_t k = 0; k < a.size(); ++k)
+  {
+    if (a[k] != b[k] && a[k] != '-' && a[k] != 'N' && b[k] != '-' && b[k] != 'N')
+      d++;
+  }
+  return d;
+}
+
+/**
+ * @brief The relaxed minimum spanning network, by its definition: a pair is
+ * linked if its ends are not connected by the pairs shorter than its length
+ * minus epsilon.
+ */
+set< tuple<size_t, size_t, unsigned int> > naiveLinks(const HaplotypeNetwork& network, unsigned int epsilon)
+{
+  size_t n = network.getNumberOfVertices();
+  set< tuple<size_t, size_t, unsigned int> > links;
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (size_t j = i + 1; j < n; ++j)
+    {
+      unsigned int d = network.getDistance(i, j);
+      vector<size_t> component(n);
+      for (size_t v = 0; v < n; ++v)
+      {
+        component[v] = v;
+      }
+      bool changed = true;
+      while (changed)
+      {
+        changed = false;
+        for (size_t u = 0; u < n; ++u)
+        {
+          for (size_t v = 0; v < n; ++v)
+          {
+            if (u != v && network.getDistance(u, v) + epsilon < d && component[v] < component[u])
+            {
+              component[u] = component[v];
+              changed = true;
+            }
+          }
+        }
+      }
+      if (component[i] != component[j])
+        links.insert(make_tuple(i, j, d));
+    }
+  }
+  return links;
+}
+
+/**
+ * @brief Compare the links of a network with its naive relaxed minimum spanning network.
+ */
+bool sameLinks(const HaplotypeNetwork& network, unsigned int epsilon)
+{
+  set< tuple<size_t, size_t, unsigned int> > links;
+  unsigned int previous = 0;
+  for (const auto& edge : network.getEdges())
+  {
+    if (edge.first >= edge.second || edge.length < previous || edge.length != network.getDistance(edge.first, edge.second))
+      return false;
+    previous = edge.length;
+    links.insert(make_tuple(edge.first, edge.second, edge.length));
+  }
+  return links.size() == network.getEdges().size() && links == naiveLinks(network, epsilon);
+}
+
+int main()
+{
+  shared_ptr<const Alphabet> alpha = AlphabetTools::DNA_ALPHABET;
+
+  // Three haplotypes at distance 4, around a missing median:
+  PolymorphismSequenceContainer star(alpha);
+  add(star, "seq0", "TTAAAACG");
+  add(star, "seq1", "AATTAACG");
+  add(star, "seq2", "AAAATTCG");
+  add(star, "seq3", "AATTAACG");
+  star.setSequenceCount(1, 3);
+  HaplotypeNetwork msn(star);
+  if (msn.getNumberOfHaplotypes() != 3 || msn.getNumberOfVertices() != 3 || msn.getSites().size() != 6
+      || msn.getHaplotype(3) != 1 || msn.getSequences(1) != vector<size_t>({1, 3}) || msn.getWeight(1) != 4.
+      || msn.getEdges().size() != 3 || !sameLinks(msn, 0))
+  {
+    cout << "Wrong minimum spanning network of the star." << endl;
+    return 1;
+  }
+  HaplotypeNetwork mjn(star, HaplotypeNetwork::MEDIAN_JOINING);
+  if (mjn.getNumberOfVertices() != 4 || !mjn.isMedian(3) || mjn.getWeight(3) != 0. || !mjn.getSequences(3).empty()
+      || mjn.getStates(3) != vector<int>(6, 0) || mjn.getEdges().size() != 3 || !sameLinks(mjn, 0))
+  {
+    cout << "Wrong median-joining network of the star." << endl;
+    return 1;
+  }
+  for (const auto& edge : mjn.getEdges())
+  {
+    if (edge.second != 3 || edge.length != 2)
+    {
+      cout << "The star is not linked through its median." << endl;
+      return 1;
+    }
+  }
+
+  // Related sequences, with duplicates and missing data:
+  default_random_engine generator(23);
+  uniform_int_distribution<int> nucleotide(0, 3);
+  uniform_int_distribution<size_t> parent(0, 4);
+  bernoulli_distribution mutated(0.04);
+  bernoulli_distribution changed(0.005);
+  bernoulli_distribution missing(0.002);
+  vector<string> founders(5, string(60, 'A'));
+  for (auto& c : founders[0])
+  {
+    c = "ACGT"[nucleotide(generator)];
+  }
+  for (size_t f = 1; f < founders.size(); ++f)
+  {
+    founders[f] = founders[f - 1];
+    for (auto& c : founders[f])
+    {
+      if (mutated(generator))
+        c = "ACGT"[nucleotide(generator)];
+    }
+  }
+  PolymorphismSequenceContainer psc(alpha);
+  vector<string> contents;
+  for (size_t i = 0; i < 30; ++i)
+  {
+    string content = founders[parent(generator)];
+    for (auto& c : content)
+    {
+      if (changed(generator))
+        c = "ACGT"[nucleotide(generator)];
+      if (missing(generator))
+        c = '-';
+    }
+    contents.push_back(content);
+    add(psc, "seq" + to_string(i), content);
+    psc.setSequenceCount(i, static_cast<unsigned int>(1 + i % 3));
+  }
+
+  for (unsigned int epsilon : {0, 1, 2})
+  {
+    HaplotypeNetwork network(psc, HaplotypeNetwork::MINIMUM_SPANNING, epsilon);
+    double weights = 0.;
+    for (size_t h = 0; h < network.getNumberOfHaplotypes(); ++h)
+    {
+      weights += network.getWeight(h);
+      for (size_t i : network.getSequences(h))
+      {
+        if (network.getHaplotype(i) != h || contents[i] != contents[network.getSequences(h)[0]])
+        {
+          cout << "Sequence " << i << " is not in the right haplotype." << endl;
+          return 1;
+        }
+      }
+    }
+    for (size_t i = 0; i < contents.size(); ++i)
+    {
+      for (size_t j = 0; j < contents.size(); ++j)
+      {
+        if ((contents[i] == contents[j]) != (network.getHaplotype(i) == network.getHaplotype(j))
+            || network.getDistance(network.getHaplotype(i), network.getHaplotype(j)) != differences(contents[i], contents[j]))
+        {
+          cout << "Wrong distance between sequences " << i << " and " << j << "." << endl;
+          return 1;
+        }
+      }
+    }
+    if (weights != 60. || !sameLinks(network, epsilon))
+    {
+      cout << "Wrong minimum spanning network with epsilon = " << epsilon << "." << endl;
+      return 1;
+    }
+
+    // The medians keep the haplotypes, are linked to at least three vertices,
+    // and the links are the minimum spanning network of all the vertices:
+    HaplotypeNetwork joined(psc, HaplotypeNetwork::MEDIAN_JOINING, epsilon);
+    if (joined.getNumberOfHaplotypes() != network.getNumberOfHaplotypes() || !sameLinks(joined, epsilon))
+    {
+      cout << "Wrong median-joining network with epsilon = " << epsilon << "." << endl;
+      return 1;
+    }
+    vector<size_t> degrees(joined.getNumberOfVertices(), 0);
+    for (const auto& edge : joined.getEdges())
+    {
+      degrees[edge.first]++;
+      degrees[edge.second]++;
+    }
+    for (size_t v = 0; v < joined.getNumberOfVertices(); ++v)
+    {
+      if (v < joined.getNumberOfHaplotypes() && joined.getStates(v) != network.getStates(v))
+      {
+        cout << "Haplotype " << v << " is changed by the median joining." << endl;
+        return 1;
+      }
+      if (joined.isMedian(v) && (degrees[v] < 3 || joined.getWeight(v) != 0.))
+      {
+        cout << "Median " << v << " is linked to " << degrees[v] << " vertices." << endl;
+        return 1;
+      }
+    }
+  }
+
+  // The indices are checked:
+  try
+  {
+    msn.getStates(3);
+    cout << "A vertex out of bounds is accepted." << endl;
+    return 1;
+  }
+  catch (IndexOutOfBoundsException& e)
+  {}
+  try
+  {
+    msn.getHaplotype(4);
+    cout << "A sequence out of bounds is accepted." << endl;
+    return 1;
+  }
+  catch (IndexOutOfBoundsException& e)
+  {}
+
+  return 0;
+}
@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/HaplotypeMatrix.h>
+#include <Bpp/PopGen/HaplotypeStatistics.h>
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool same(const Vdouble& x, const Vdouble& y)
+{
+  if (x.size() != y.size())
+    return false;
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    if (x[i] != y[i] && !(std::isnan(x[i]) && std::isnan(y[i])))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Build a haplotype matrix from the derived alleles of each SNP, C being derived from A.
+ */
+HaplotypeMatrix buildMatrix(const vector< vector<bool> >& snps, size_t nbHaplotypes)
+{
+  PolymorphismSequenceContainer psc(AlphabetTools::DNA_ALPHABET);
+  for (size_t h = 0; h < nbHaplotypes; ++h)
+  {
+    string content;
+    for (const auto& snp : snps)
+    {
+      content += snp[h] ? 'C' : 'A';
+    }
+    auto seq = make_unique<Sequence>("h" + to_string(h), content, psc.getAlphabet());
+    psc.addSequence(seq->getName(), seq);
+  }
+  return HaplotypeMatrix(psc, Sequence("ancestor", string(snps.size(), 'A'), psc.getAlphabet()));
+}
+
+int main()
+{
+  // Ten SNPs of twelve haplotypes, one string per SNP:
+  vector<string> snps = {
+    "011100100100", "000101100100", "110100100110", "001011111010", "011111011011",
+    "111101100101", "110011101010", "000000001000", "101101101101", "100100101111"
+  };
+  vector< vector<bool> > bits(snps.size(), vector<bool>(12));
+  for (size_t s = 0; s < snps.size(); ++s)
+  {
+    for (size_t h = 0; h < 12; ++h)
+    {
+      bits[s][h] = (snps[s][h] == '1');
+    }
+  }
+  HaplotypeMatrix hm = buildMatrix(bits, 12);
+
+  // Reference values from the mean lengths of the segments shared by each pair of haplotypes,
+  // a pair separated by a SNP counting for half a SNP:
+  double refs[10] = {
+    0.442617373739457, 0.20686266571007214, 0.44393138893596046, -0.05406722127027582, 0.27329333499968134,
+    0.5273549257172012, 0.23111172096338664, NAN, 0.12883287184296838, -0.4584576382486748
+  };
+  Vdouble nsl = HaplotypeStatistics::nSL(hm);
+  for (size_t s = 0; s < snps.size(); ++s)
+  {
+    cout << "nSL(" << s << ") = " << nsl[s] << endl;
+    if (std::isnan(refs[s]) ? !std::isnan(nsl[s]) : abs(nsl[s] - refs[s]) > 1e-12)
+    {
+      cout << "Expected " << refs[s] << endl;
+      return 1;
+    }
+  }
+
+  // The scans do not depend on the execution context:
+  default_random_engine generator(9);
+  uniform_real_distribution<double> uniform(0., 1.);
+  size_t nbHaplotypes = 150, nbSnps = 400;
+  vector< vector<bool> > founders(5, vector<bool>(nbSnps));
+  for (auto& founder : founders)
+  {
+    for (size_t s = 0; s < nbSnps; ++s)
+    {
+      founder[s] = uniform(generator) < 0.4;
+    }
+  }
+  vector< vector<bool> > bigBits(nbSnps, vector<bool>(nbHaplotypes));
+  for (size_t s = 0; s < nbSnps; ++s)
+  {
+    for (size_t h = 0; h < nbHaplotypes; ++h)
+    {
+      bigBits[s][h] = (founders[h % 5][s] != (uniform(generator) < 0.05));
+    }
+  }
+  HaplotypeMatrix big = buildMatrix(bigBits, nbHaplotypes);
+  vector<size_t> population1, population2;
+  for (size_t h = 0; h < nbHaplotypes; ++h)
+  {
+    (h < 70 ? population1 : population2).push_back(h);
+  }
+  ExecutionContext context(4);
+  Vdouble ihs = HaplotypeStatistics::iHS(big, 0.05, 0.05, false);
+  if (!same(ihs, HaplotypeStatistics::iHS(big, 0.05, 0.05, false, context))
+      || !same(HaplotypeStatistics::nSL(big), HaplotypeStatistics::nSL(big, 0.05, context))
+      || !same(HaplotypeStatistics::xpEHH(big, population1, population2, 0.05, false),
+               HaplotypeStatistics::xpEHH(big, population1, population2, 0.05, false, context)))
+  {
+    cout << "Scans differ between contexts." << endl;
+    return 1;
+  }
+  size_t nbDefined = 0;
+  for (double value : ihs)
+  {
+    if (!std::isnan(value))
+      nbDefined++;
+  }
+  cout << nbDefined << " iHS values defined." << endl;
+  if (nbDefined == 0)
+  {
+    cout << "No iHS value defined." << endl;
+    return 1;
+  }
+
+  return 0;
+}
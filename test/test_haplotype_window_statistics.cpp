@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/HaplotypeMatrix.h>
+#include <Bpp/PopGen/HaplotypeWindowStatistics.h>
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief The haplotype statistics of a window, counting the haplotypes by their bits.
+ */
+SequenceStatistics::HaplotypeFrequencyStats naiveStatistics(const HaplotypeMatrix& hm, const vector<size_t>& weights, size_t first, size_t last)
+{
+  map<vector<bool>, size_t> counts;
+  size_t total = 0;
+  for (size_t h = 0; h < hm.getNumberOfHaplotypes(); ++h)
+  {
+    vector<bool> haplotype;
+    for (size_t snp = first; snp <= last; ++snp)
+    {
+      haplotype.push_back(hm.isDerived(h, snp));
+    }
+    counts[haplotype] += weights[h];
+    total += weights[h];
+  }
+  vector<double> freqs;
+  for (auto& c : counts)
+  {
+    freqs.push_back(static_cast<double>(c.second) / static_cast<double>(total));
+  }
+  sort(freqs.begin(), freqs.end(), greater<double>());
+  SequenceStatistics::HaplotypeFrequencyStats stats;
+  stats.numberOfHaplotypes = static_cast<unsigned int>(freqs.size());
+  stats.H1 = 0.;
+  for (double p : freqs)
+  {
+    stats.H1 += p * p;
+  }
+  stats.diversity = 1. - stats.H1;
+  stats.H12 = freqs.size() < 2 ? stats.H1 : stats.H1 + 2. * freqs[0] * freqs[1];
+  stats.H2H1 = (stats.H1 - freqs[0] * freqs[0]) / stats.H1;
+  return stats;
+}
+
+bool same(const SequenceStatistics::HaplotypeFrequencyStats& x, const SequenceStatistics::HaplotypeFrequencyStats& y)
+{
+  return x.numberOfHaplotypes == y.numberOfHaplotypes && abs(x.diversity - y.diversity) < 1e-12
+         && abs(x.H1 - y.H1) < 1e-12 && abs(x.H12 - y.H12) < 1e-12 && abs(x.H2H1 - y.H2H1) < 1e-12;
+}
+
+int main()
+{
+  // A few founder haplotypes, copied with rare changes, over more than one word:
+  default_random_engine generator(17);
+  bernoulli_distribution derived(0.4);
+  bernoulli_distribution changed(0.03);
+  uniform_int_distribution<size_t> founder(0, 4);
+  uniform_int_distribution<size_t> copies(1, 3);
+  size_t nbHaplotypes = 100, nbSnps = 40;
+  vector< vector<bool> > founders(5, vector<bool>(nbSnps));
+  for (auto& f : founders)
+  {
+    for (size_t snp = 0; snp < nbSnps; ++snp)
+    {
+      f[snp] = derived(generator);
+    }
+  }
+  vector<size_t> origins(nbHaplotypes);
+  vector<size_t> weights(nbHaplotypes);
+  for (size_t h = 0; h < nbHaplotypes; ++h)
+  {
+    origins[h] = founder(generator);
+    weights[h] = copies(generator);
+  }
+  PolymorphismSequenceContainer psc(AlphabetTools::DNA_ALPHABET);
+  for (size_t h = 0; h < nbHaplotypes; ++h)
+  {
+    string content;
+    for (size_t snp = 0; snp < nbSnps; ++snp)
+    {
+      content += founders[origins[h]][snp] != changed(generator) ? 'C' : 'A';
+    }
+    auto seq = make_unique<Sequence>("h" + to_string(h), content, psc.getAlphabet());
+    psc.addSequence(seq->getName(), seq);
+  }
+  HaplotypeMatrix hm(psc, Sequence("ancestor", string(nbSnps, 'A'), psc.getAlphabet()));
+  vector<double> positions(hm.getNumberOfSnps());
+  for (size_t snp = 0; snp < positions.size(); ++snp)
+  {
+    positions[snp] = static_cast<double>(10 * snp);
+  }
+  hm.setPositions(positions);
+  nbSnps = hm.getNumberOfSnps();
+
+  // Sliding windows (step < windowSize) and restarted ones:
+  for (size_t windowSize : {1, 5, 13})
+  {
+    for (size_t step : {1, 2, 7, 20})
+    {
+      vector<HaplotypeWindowStatistics::Window> windows = HaplotypeWindowStatistics::scan(hm, weights, windowSize, step);
+      size_t nbWindows = (nbSnps - windowSize) / step + 1;
+      if (windows.size() != nbWindows)
+      {
+        cout << windows.size() << " windows of size " << windowSize << " instead of " << nbWindows << "." << endl;
+        return 1;
+      }
+      for (size_t w = 0; w < nbWindows; ++w)
+      {
+        const HaplotypeWindowStatistics::Window& window = windows[w];
+        size_t first = w * step, last = w * step + windowSize - 1;
+        if (window.firstSnp != first || window.lastSnp != last || window.start != 10. * static_cast<double>(first)
+            || window.end != 10. * static_cast<double>(last) || !same(window.stats, naiveStatistics(hm, weights, first, last)))
+        {
+          cout << "Window [" << first << ", " << last << "] differs from the naive counts: "
+               << window.stats.numberOfHaplotypes << " haplotypes, H1 = " << window.stats.H1 << "." << endl;
+          return 1;
+        }
+      }
+    }
+  }
+
+  // A single window with reused buffers, and one copy of each haplotype without weights:
+  HaplotypeWindowStatistics::Workspace workspace;
+  vector<size_t> ones(nbHaplotypes, 1);
+  for (size_t first : {0, 7, 30})
+  {
+    for (size_t last : {first, first + 3, nbSnps - 1})
+    {
+      if (!same(HaplotypeWindowStatistics::windowStatistics(hm, weights, first, last, workspace), naiveStatistics(hm, weights, first, last))
+          || !same(HaplotypeWindowStatistics::windowStatistics(hm, vector<size_t>(), first, last, workspace), naiveStatistics(hm, ones, first, last)))
+      {
+        cout << "Window [" << first << ", " << last << "] computed alone differs from the naive counts." << endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
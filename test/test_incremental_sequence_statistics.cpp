@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/IncrementalSequenceStatistics.h>
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/PopGen/SequenceStatistics.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool same(double a, double b)
+{
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+bool same(const SequenceStatistics::SiteSampleSizeSummary& x, const SequenceStatistics::SiteSampleSizeSummary& y)
+{
+  // The histograms of the incremental object have one entry per sequence, so they are compared up to the longest one.
+  size_t size = max(x.sampleSizeHistogram.size(), y.sampleSizeHistogram.size());
+  for (size_t n = 0; n < size; ++n)
+  {
+    unsigned int a = n < x.sampleSizeHistogram.size() ? x.sampleSizeHistogram[n] : 0;
+    unsigned int b = n < y.sampleSizeHistogram.size() ? y.sampleSizeHistogram[n] : 0;
+    if (a != b)
+      return false;
+  }
+  return x.numberOfSites == y.numberOfSites && x.numberOfPolymorphicSites == y.numberOfPolymorphicSites
+         && same(x.pi, y.pi) && same(x.thetaW, y.thetaW) && same(x.tajimaD, y.tajimaD);
+}
+
+void add(PolymorphismSequenceContainer& psc, const string& name, const string& content, unsigned int count)
+{
+  auto seq = make_unique<Sequence>(name, content, psc.getAlphabet());
+  psc.addSequenceWithFrequency(name, seq, count);
+}
+
+int main()
+{
+  shared_ptr<const Alphabet> alpha = AlphabetTools::DNA_ALPHABET;
+
+  // Each sequence stands for its count of copies: n = 4 at both sites, 1.0 and not 4 / 3.
+  PolymorphismSequenceContainer small(alpha);
+  add(small, "seq0", "AC", 1);
+  add(small, "seq1", "AT", 2);
+  add(small, "seq2", "GT", 1);
+  IncrementalSequenceStatistics smallStats(small);
+  SequenceStatistics::SiteSampleSizeSummary smallSummary = smallStats.getSummary();
+  if (smallStats.getNumberOfSequences() != 4 || smallSummary.pi != 1. || abs(smallSummary.thetaW - 1.0909090909090908) > 1e-12
+      || !same(smallSummary, SequenceStatistics::siteSampleSizeSummary(small)))
+  {
+    cout << "Sequence counts are not weighted: pi = " << smallSummary.pi << ", theta W = " << smallSummary.thetaW << "." << endl;
+    return 1;
+  }
+  if (smallStats.getSiteFrequencySpectrum() != vector<unsigned int>({0, 2, 0}))
+  {
+    cout << "Wrong site frequency spectrum." << endl;
+    return 1;
+  }
+
+  // Random sequences with missing data and counts:
+  default_random_engine generator(5);
+  uniform_int_distribution<int> nucleotide(0, 3);
+  uniform_int_distribution<unsigned int> copies(1, 3);
+  bernoulli_distribution missing(0.05);
+  bernoulli_distribution mutated(0.2);
+  size_t nbSites = 200;
+  string ancestor(nbSites, 'A');
+  for (auto& c : ancestor)
+  {
+    c = "ACGT"[nucleotide(generator)];
+  }
+  PolymorphismSequenceContainer psc(alpha);
+  for (size_t i = 0; i < 12; ++i)
+  {
+    string content = ancestor;
+    for (auto& c : content)
+    {
+      if (mutated(generator))
+        c = "ACGT"[nucleotide(generator)];
+      if (missing(generator))
+        c = missing(generator) ? 'N' : '-';
+    }
+    add(psc, "seq" + to_string(i), content, copies(generator));
+  }
+
+  // Adding the sequences one by one follows the statistics of the growing container:
+  IncrementalSequenceStatistics stats(alpha, nbSites);
+  PolymorphismSequenceContainer growing(alpha);
+  for (size_t i = 0; i < psc.getNumberOfSequences(); ++i)
+  {
+    stats.addSequence(psc.sequence(i), psc.getSequenceCount(i));
+    add(growing, psc.sequence(i).getName(), psc.sequence(i).toString(), psc.getSequenceCount(i));
+    if (!same(stats.getSummary(), SequenceStatistics::siteSampleSizeSummary(growing)))
+    {
+      cout << "Summary differs after adding sequence " << i << "." << endl;
+      return 1;
+    }
+  }
+  if (!same(IncrementalSequenceStatistics(psc).getSummary(), SequenceStatistics::siteSampleSizeSummary(psc)))
+  {
+    cout << "Summary of a container differs from the batch one." << endl;
+    return 1;
+  }
+
+  // Removing them in another order:
+  for (size_t i = psc.getNumberOfSequences(); i > 1; --i)
+  {
+    size_t j = (i * 7) % growing.getNumberOfSequences();
+    stats.removeSequence(growing.sequence(j), growing.getSequenceCount(j));
+    growing.deleteSequence(j);
+    if (!same(stats.getSummary(), SequenceStatistics::siteSampleSizeSummary(growing)))
+    {
+      cout << "Summary differs after removing a sequence, " << i - 1 << " left." << endl;
+      return 1;
+    }
+  }
+
+  // Leave-one-out removes all the copies of each sequence:
+  vector<SequenceStatistics::SiteSampleSizeSummary> summaries = IncrementalSequenceStatistics::leaveOneOut(psc);
+  for (size_t i = 0; i < psc.getNumberOfSequences(); ++i)
+  {
+    PolymorphismSequenceContainer without(psc);
+    without.deleteSequence(i);
+    if (!same(summaries[i], SequenceStatistics::siteSampleSizeSummary(without)))
+    {
+      cout << "Leave-one-out summary differs without sequence " << i << "." << endl;
+      return 1;
+    }
+  }
+
+  // Without missing data nor counts, these are the batch statistics:
+  PolymorphismSequenceContainer complete(alpha);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    string content = ancestor;
+    for (auto& c : content)
+    {
+      if (mutated(generator))
+        c = "ACGT"[nucleotide(generator)];
+    }
+    add(complete, "seq" + to_string(i), content, 1);
+  }
+  SequenceStatistics::SiteSampleSizeSummary completeSummary = IncrementalSequenceStatistics(complete).getSummary();
+  if (abs(completeSummary.pi - SequenceStatistics::tajima83(complete)) > 1e-9
+      || abs(completeSummary.thetaW - SequenceStatistics::watterson75(complete)) > 1e-9
+      || abs(completeSummary.tajimaD - SequenceStatistics::tajimaDss(complete)) > 1e-9
+      || completeSummary.numberOfPolymorphicSites != SequenceStatistics::numberOfPolymorphicSites(complete))
+  {
+    cout << "Summary differs from the batch statistics." << endl;
+    return 1;
+  }
+
+  // A sequence that was never added is rejected, and the sample is unchanged:
+  PolymorphismSequenceContainer pair(alpha);
+  add(pair, "seq0", "AA", 1);
+  add(pair, "seq1", "A-", 1);
+  IncrementalSequenceStatistics pairStats(pair);
+  SequenceStatistics::SiteSampleSizeSummary before = pairStats.getSummary();
+  for (string content : {"-A", "CA", "AA"})
+  {
+    try
+    {
+      pairStats.removeSequence(Sequence("other", content, alpha), content == "AA" ? 2 : 1);
+      cout << "Removing " << content << " was accepted." << endl;
+      return 1;
+    }
+    catch (Exception& e)
+    {}
+  }
+  if (pairStats.getNumberOfSequences() != 2 || !same(pairStats.getSummary(), before))
+  {
+    cout << "A rejected removal changed the sample." << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/AlleleFrequencyTable.h>
+#include <Bpp/PopGen/BiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/JointSfs.h>
+#include <Bpp/PopGen/MultilocusGenotype.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainer.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  // Six loci in two groups of 3 and 2 individuals, -1 being missing:
+  int genotypes[6][5][2] = {
+    {{0, 1}, {0, 0}, {1, 1}, {0, 0}, {0, 1}},
+    {{0, 0}, {0, 0}, {-1, -1}, {1, 1}, {0, 1}},
+    {{2, 3}, {3, 3}, {3, 3}, {2, 2}, {-1, -1}},
+    {{0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}},
+    {{0, 1}, {0, 2}, {0, 0}, {0, 0}, {0, 0}},
+    {{0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}}
+  };
+  PolymorphismMultiGContainer pmgc;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    MultilocusGenotype mg(6);
+    for (size_t l = 0; l < 6; ++l)
+    {
+      if (genotypes[l][i][0] >= 0)
+        mg.setMonolocusGenotype(l, BiAlleleMonolocusGenotype(static_cast<size_t>(genotypes[l][i][0]), static_cast<size_t>(genotypes[l][i][1])));
+    }
+    pmgc.addMultilocusGenotype(mg, i < 3 ? 1 : 2);
+  }
+  AlleleFrequencyTable table(pmgc);
+  if (table.getNumberOfSites() != 4)
+  {
+    cout << "Wrong number of biallelic sites: " << table.getNumberOfSites() << endl;
+    return 1;
+  }
+
+  // Reference values of the hypergeometric projection to 4 and 2 alleles:
+  double refs[5][3] = {
+    {0., 0.5, 0.8333333333333333},
+    {0.13333333333333333, 0.23333333333333334, 0.7},
+    {0.39999999999999997, 0.7, 0.09999999999999999},
+    {0.13333333333333333, 0.23333333333333334, 0.03333333333333333},
+    {0., 0., 0.}
+  };
+  JointSfs sfs(table, {1, 2}, {4, 2});
+  if (sfs.getNumberOfSites() != 4. || sfs.getNumberOfCells() != 15 || sfs.isSparse())
+  {
+    cout << "Wrong dimensions of the spectrum." << endl;
+    return 1;
+  }
+  for (unsigned int a = 0; a <= 4; ++a)
+  {
+    for (unsigned int b = 0; b <= 2; ++b)
+    {
+      double value = sfs.getValue({a, b});
+      cout << value << (b < 2 ? "\t" : "\n");
+      if (abs(value - refs[a][b]) > 1e-12)
+      {
+        cout << "Wrong value at (" << a << ", " << b << "), expected " << refs[a][b] << endl;
+        return 1;
+      }
+    }
+  }
+
+  // Projection to more alleles than sampled drops the site:
+  JointSfs large(table, {1, 2}, {6, 4});
+  if (large.getNumberOfSites() != 2.)
+  {
+    cout << "Wrong number of fully sampled sites: " << large.getNumberOfSites() << endl;
+    return 1;
+  }
+
+  // The spectrum does not depend on the execution context:
+  default_random_engine generator(3);
+  uniform_int_distribution<size_t> allele(0, 1);
+  bernoulli_distribution missing(0.1);
+  size_t nbLoci = 3000;
+  PolymorphismMultiGContainer big;
+  for (size_t i = 0; i < 45; ++i)
+  {
+    MultilocusGenotype mg(nbLoci);
+    for (size_t l = 0; l < nbLoci; ++l)
+    {
+      if (!missing(generator))
+        mg.setMonolocusGenotype(l, BiAlleleMonolocusGenotype(allele(generator), allele(generator) * (l % 5 == 0 ? 0 : 1)));
+    }
+    big.addMultilocusGenotype(mg, i % 3);
+  }
+  AlleleFrequencyTable bigTable(big);
+  ExecutionContext context(4);
+  JointSfs seq(bigTable, {0, 1, 2}, {20, 20, 20});
+  JointSfs par(bigTable, {0, 1, 2}, {20, 20, 20}, context);
+  cout << "Spectrum of " << seq.getNumberOfSites() << " sites." << endl;
+  if (seq.getDenseValues() != par.getDenseValues() || seq.getNumberOfSites() != par.getNumberOfSites())
+  {
+    cout << "Spectrum differs between contexts." << endl;
+    return 1;
+  }
+  double total = 0.;
+  for (double value : seq.getDenseValues())
+  {
+    total += value;
+  }
+  if (abs(total - seq.getNumberOfSites()) > 1e-6)
+  {
+    cout << "Spectrum does not sum to the number of sites: " << total << endl;
+    return 1;
+  }
+
+  return 0;
+}
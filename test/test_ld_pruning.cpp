@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/BiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/HaplotypeMatrix.h>
+#include <Bpp/PopGen/LdPruning.h>
+#include <Bpp/PopGen/MultilocusGenotype.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainer.h>
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  // Ten SNPs of twelve haplotypes, one string per SNP. SNPs 0 and 1, 2 and 3, 5 and 6 are in complete LD:
+  vector<string> snps = {
+    "011100100100", "100011011011", "110100100110", "110100100110", "001011111010",
+    "011111011011", "011111011011", "000000001000", "101101101101", "100100101111"
+  };
+  HaplotypeMatrix hm(12);
+  for (size_t s = 0; s < snps.size(); ++s)
+  {
+    uint64_t* column = hm.addSnp(static_cast<double>(s));
+    for (size_t h = 0; h < 12; ++h)
+    {
+      if (snps[s][h] == '1')
+        column[h / 64] |= static_cast<uint64_t>(1) << (h % 64);
+    }
+  }
+  vector<bool> expected = {true, false, true, false, true, true, false, true, true, true};
+  if (LdPruning::indepPairwise(hm, 10, 5, 0.99) != expected
+      || LdPruning::indepPairwise(hm, 3, 1, 0.99) != expected)
+  {
+    cout << "Wrong pruning of the haplotypes." << endl;
+    return 1;
+  }
+  // SNPs 0 and 1 are not compared when they are in different segments:
+  expected[1] = true;
+  if (LdPruning::indepPairwise(hm, 10, 5, 0.99, {0, 1, 1, 1, 1, 1, 1, 1, 1, 1}) != expected)
+  {
+    cout << "Wrong pruning of the segments." << endl;
+    return 1;
+  }
+
+  // The same SNPs as genotypes, pairing consecutive haplotypes:
+  PolymorphismMultiGContainer pmgc;
+  for (size_t i = 0; i < 6; ++i)
+  {
+    MultilocusGenotype mg(snps.size());
+    for (size_t s = 0; s < snps.size(); ++s)
+    {
+      mg.setMonolocusGenotype(s, BiAlleleMonolocusGenotype(static_cast<size_t>(snps[s][2 * i] - '0'), static_cast<size_t>(snps[s][2 * i + 1] - '0')));
+    }
+    pmgc.addMultilocusGenotype(mg, 0);
+  }
+  expected[1] = false;
+  vector<bool> kept = LdPruning::indepPairwise(pmgc, 10, 5, 0.99);
+  for (size_t s : {1, 3, 6})
+  {
+    if (kept[s] || !kept[s - 1])
+    {
+      cout << "Wrong pruning of the genotypes at locus " << s << endl;
+      return 1;
+    }
+  }
+
+  // The pruning does not depend on the execution context:
+  default_random_engine generator(17);
+  uniform_real_distribution<double> uniform(0., 1.);
+  size_t nbHaplotypes = 80, nbSnps = 1000;
+  HaplotypeMatrix big(nbHaplotypes);
+  vector<size_t> segments(nbSnps);
+  vector<bool> previous(nbHaplotypes);
+  for (size_t s = 0; s < nbSnps; ++s)
+  {
+    uint64_t* column = big.addSnp(static_cast<double>(s));
+    double p = 0.05 + 0.9 * uniform(generator);
+    for (size_t h = 0; h < nbHaplotypes; ++h)
+    {
+      // Copy the previous SNP most of the time, to create LD.
+      bool derived = (s > 0 && uniform(generator) < 0.7) ? previous[h] : uniform(generator) < p;
+      previous[h] = derived;
+      if (derived)
+        column[h / 64] |= static_cast<uint64_t>(1) << (h % 64);
+    }
+    segments[s] = s / 97;
+  }
+  PolymorphismMultiGContainer genotypes;
+  for (size_t i = 0; i < nbHaplotypes / 2; ++i)
+  {
+    MultilocusGenotype mg(nbSnps);
+    for (size_t s = 0; s < nbSnps; ++s)
+    {
+      if (uniform(generator) > 0.05)
+        mg.setMonolocusGenotype(s, BiAlleleMonolocusGenotype(big.isDerived(2 * i, s) ? 1 : 0, big.isDerived(2 * i + 1, s) ? 1 : 0));
+    }
+    genotypes.addMultilocusGenotype(mg, 0);
+  }
+  ExecutionContext context(4);
+  vector<bool> seq = LdPruning::indepPairwise(big, 50, 5, 0.2, segments);
+  vector<bool> par = LdPruning::indepPairwise(big, 50, 5, 0.2, segments, context);
+  vector<bool> seqGenotypes = LdPruning::indepPairwise(genotypes, 50, 5, 0.2, segments);
+  vector<bool> parGenotypes = LdPruning::indepPairwise(genotypes, 50, 5, 0.2, segments, context);
+  size_t nbKept = 0;
+  for (bool k : seq)
+  {
+    if (k)
+      nbKept++;
+  }
+  cout << nbKept << " SNPs kept out of " << nbSnps << endl;
+  if (seq != par || seqGenotypes != parGenotypes)
+  {
+    cout << "Pruning differs between contexts." << endl;
+    return 1;
+  }
+  if (nbKept == 0 || nbKept == nbSnps)
+  {
+    cout << "Nothing pruned or everything pruned." << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/HaplotypeMatrix.h>
+#include <Bpp/PopGen/LinkageStatistics.h>
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool near(double a, double b)
+{
+  return abs(a - b) < 1e-12;
+}
+
+bool same(const LinkageStatistics::LdTests& x, const LinkageStatistics::LdTests& y)
+{
+  auto equal = [](double a, double b) {
+        return a == b || (std::isnan(a) && std::isnan(b));
+      };
+  return x.firstSnp == y.firstSnp && x.lastSnp == y.lastSnp && equal(x.ZnS, y.ZnS)
+         && equal(x.ZA, y.ZA) && equal(x.wallB, y.wallB) && equal(x.wallQ, y.wallQ);
+}
+
+/**
+ * @brief Build a haplotype matrix from the derived alleles of each SNP, C being derived from A.
+ */
+HaplotypeMatrix buildMatrix(const vector< vector<bool> >& snps, size_t nbHaplotypes)
+{
+  PolymorphismSequenceContainer psc(AlphabetTools::DNA_ALPHABET);
+  for (size_t h = 0; h < nbHaplotypes; ++h)
+  {
+    string content;
+    for (const auto& snp : snps)
+    {
+      content += snp[h] ? 'C' : 'A';
+    }
+    auto seq = make_unique<Sequence>("h" + to_string(h), content, psc.getAlphabet());
+    psc.addSequence(seq->getName(), seq);
+  }
+  return HaplotypeMatrix(psc, Sequence("ancestor", string(snps.size(), 'A'), psc.getAlphabet()));
+}
+
+HaplotypeMatrix randomMatrix(default_random_engine& generator, size_t nbHaplotypes, size_t nbSnps)
+{
+  uniform_real_distribution<double> uniform(0., 1.);
+  vector< vector<bool> > snps(nbSnps, vector<bool>(nbHaplotypes));
+  for (auto& snp : snps)
+  {
+    double p = 0.05 + 0.9 * uniform(generator);
+    for (size_t h = 0; h < nbHaplotypes; ++h)
+    {
+      snp[h] = uniform(generator) < p;
+    }
+  }
+  return buildMatrix(snps, nbHaplotypes);
+}
+
+int main()
+{
+  // Ten SNPs of twelve haplotypes, one string per SNP, one unit apart:
+  vector<string> snps = {
+    "011100100100", "100011011011", "110100100110", "110100100110", "001011111010",
+    "011111011011", "011111011011", "000000001000", "101101101101", "100100101111"
+  };
+  vector< vector<bool> > bits(snps.size(), vector<bool>(12));
+  for (size_t s = 0; s < snps.size(); ++s)
+  {
+    for (size_t h = 0; h < 12; ++h)
+    {
+      bits[s][h] = (snps[s][h] == '1');
+    }
+  }
+  HaplotypeMatrix hm = buildMatrix(bits, 12);
+  vector<double> positions(snps.size());
+  for (size_t s = 0; s < snps.size(); ++s)
+  {
+    positions[s] = static_cast<double>(s);
+  }
+  hm.setPositions(positions);
+
+  // Reference values computed from the haplotype frequencies of every pair of SNPs:
+  LinkageStatistics::LdTests tests = LinkageStatistics::ldTests(hm);
+  cout << "ZnS = " << tests.ZnS << ", ZA = " << tests.ZA << ", B = " << tests.wallB << ", Q = " << tests.wallQ << endl;
+  if (!near(tests.ZnS, 0.19997883597883598) || !near(tests.ZA, 0.43381433381433393)
+      || !near(tests.wallB, 1. / 3.) || !near(tests.wallQ, 0.6))
+  {
+    cout << "Wrong LD tests." << endl;
+    return 1;
+  }
+  vector<LinkageStatistics::LdTests> windows = LinkageStatistics::ldTestsInWindows(hm, 4, 3);
+  double windowZnS[3] = {0.5047619047619049, 0.34920634920634913, 0.12900432900432898};
+  if (windows.size() != 3)
+  {
+    cout << "Wrong number of windows: " << windows.size() << endl;
+    return 1;
+  }
+  for (size_t w = 0; w < 3; ++w)
+  {
+    if (!near(windows[w].ZnS, windowZnS[w]) || !same(windows[w], LinkageStatistics::ldTests(hm, 3 * w, 3 * w + 3)))
+    {
+      cout << "Wrong window " << w << endl;
+      return 1;
+    }
+  }
+  vector< pair<size_t, size_t> > incompatible = LinkageStatistics::fourGameteTest(hm, 3.);
+  vector< pair<size_t, size_t> > expected = {
+    {0, 2}, {0, 3}, {1, 2}, {1, 3}, {1, 4}, {2, 4}, {3, 4}, {4, 5}, {4, 6}, {8, 9}
+  };
+  if (incompatible != expected || LinkageStatistics::rm(hm, 3.) != 4 || LinkageStatistics::rm(hm) != 4)
+  {
+    cout << "Wrong four-gamete test." << endl;
+    return 1;
+  }
+
+  // The scans do not depend on the execution context:
+  default_random_engine generator(13);
+  HaplotypeMatrix big = randomMatrix(generator, 100, 500);
+  vector<HaplotypeMatrix> replicates;
+  for (size_t r = 0; r < 20; ++r)
+  {
+    replicates.push_back(randomMatrix(generator, 30, 40 + r));
+  }
+  ExecutionContext context(4);
+  vector<LinkageStatistics::LdTests> seqWindows = LinkageStatistics::ldTestsInWindows(big, 50, 10);
+  vector<LinkageStatistics::LdTests> parWindows = LinkageStatistics::ldTestsInWindows(big, 50, 10, context);
+  vector<LinkageStatistics::LdTests> seqReplicates = LinkageStatistics::ldTests(replicates);
+  vector<LinkageStatistics::LdTests> parReplicates = LinkageStatistics::ldTests(replicates, context);
+  if (seqWindows.size() != parWindows.size() || seqReplicates.size() != parReplicates.size())
+  {
+    cout << "Number of results differs between contexts." << endl;
+    return 1;
+  }
+  for (size_t w = 0; w < seqWindows.size(); ++w)
+  {
+    if (!same(seqWindows[w], parWindows[w]))
+    {
+      cout << "Window " << w << " differs between contexts." << endl;
+      return 1;
+    }
+  }
+  for (size_t r = 0; r < seqReplicates.size(); ++r)
+  {
+    if (!same(seqReplicates[r], parReplicates[r]))
+    {
+      cout << "Replicate " << r << " differs between contexts." << endl;
+      return 1;
+    }
+  }
+  if (LinkageStatistics::fourGameteTest(big, 20.) != LinkageStatistics::fourGameteTest(big, 20., context)
+      || LinkageStatistics::rm(big) != LinkageStatistics::rm(big, numeric_limits<double>::infinity(), context))
+  {
+    cout << "Four-gamete test differs between contexts." << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/BiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/MonoAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/MultiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/MultilocusGenotype.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainer.h>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief Compare an entry of a view with the checked accessors of the container.
+ */
+bool sameEntry(const PolymorphismMultiGContainer& pmgc, size_t i, size_t locus, const PolymorphismMultiGContainer::LocusView::Entry& entry, bool hidden)
+{
+  if (entry.groupId != pmgc.getGroupId(i))
+    return false;
+  const MultilocusGenotype& mg = pmgc.multilocusGenotype(i);
+  if (hidden || mg.isMonolocusGenotypeMissing(locus))
+    return entry.genotype == nullptr;
+  if (entry.genotype != &mg.monolocusGenotype(locus))
+    return false;
+  vector<size_t> alleles = mg.monolocusGenotype(locus).getAlleleIndex();
+  if (entry.genotype->getNumberOfAlleles() != alleles.size())
+    return false;
+  for (size_t a = 0; a < alleles.size(); ++a)
+  {
+    if (entry.genotype->getAlleleIndexAt(a) != alleles[a])
+      return false;
+  }
+  return true;
+}
+
+int main()
+{
+  // Genotypes of the three kinds, with missing data:
+  default_random_engine generator(11);
+  uniform_int_distribution<size_t> allele(0, 4);
+  uniform_int_distribution<int> kind(0, 3);
+  size_t nbLoci = 6;
+  PolymorphismMultiGContainer pmgc;
+  for (size_t i = 0; i < 30; ++i)
+  {
+    MultilocusGenotype mg(nbLoci);
+    for (size_t l = 0; l < nbLoci; ++l)
+    {
+      switch (kind(generator))
+      {
+      case 0: mg.setMonolocusGenotype(l, MonoAlleleMonolocusGenotype(allele(generator))); break;
+      case 1: mg.setMonolocusGenotype(l, BiAlleleMonolocusGenotype(allele(generator), allele(generator))); break;
+      case 2: mg.setMonolocusGenotype(l, MultiAlleleMonolocusGenotype(vector<size_t>({allele(generator), allele(generator), allele(generator)}))); break;
+      default: break; // missing
+      }
+    }
+    pmgc.addMultilocusGenotype(mg, i % 4);
+  }
+
+  vector<bool> mask(pmgc.size());
+  for (size_t i = 0; i < mask.size(); ++i)
+  {
+    mask[i] = (i % 3 != 1);
+  }
+  for (size_t l = 0; l < nbLoci; ++l)
+  {
+    PolymorphismMultiGContainer::LocusView view = pmgc.locusView(l);
+    PolymorphismMultiGContainer::LocusView masked = pmgc.locusView(l, mask);
+    if (view.size() != pmgc.size() || view.getLocusPosition() != l)
+    {
+      cout << "Wrong size of the view of locus " << l << "." << endl;
+      return 1;
+    }
+    size_t i = 0;
+    for (const auto& entry : view)
+    {
+      if (!sameEntry(pmgc, i, l, entry, false) || !sameEntry(pmgc, i, l, masked[i], !mask[i]))
+      {
+        cout << "Wrong entry of individual " << i << " at locus " << l << "." << endl;
+        return 1;
+      }
+      i++;
+    }
+    if (i != pmgc.size())
+    {
+      cout << "The iteration over locus " << l << " stops after " << i << " individuals." << endl;
+      return 1;
+    }
+
+    // The counts of the views are those of the container:
+    for (size_t group = 0; group < 4; ++group)
+    {
+      size_t counter = 0;
+      for (const auto& entry : view)
+      {
+        if (entry.groupId == group && entry.genotype)
+          counter++;
+      }
+      if (counter != pmgc.getLocusGroupSize(group, l))
+      {
+        cout << "Wrong size of group " << group << " at locus " << l << "." << endl;
+        return 1;
+      }
+    }
+  }
+
+  // The bounds are checked when the view is built:
+  try
+  {
+    pmgc.locusView(nbLoci);
+    cout << "A view out of bounds was built." << endl;
+    return 1;
+  }
+  catch (IndexOutOfBoundsException& e)
+  {}
+  pmgc.addMultilocusGenotype(MultilocusGenotype(nbLoci - 1), 0);
+  try
+  {
+    pmgc.locusView(nbLoci - 1);
+    cout << "A view out of the bounds of one genotype was built." << endl;
+    return 1;
+  }
+  catch (IndexOutOfBoundsException& e)
+  {}
+  try
+  {
+    pmgc.locusView(0, mask);
+    cout << "A view with a mask of the wrong size was built." << endl;
+    return 1;
+  }
+  catch (DimensionException& e)
+  {}
+
+  // An empty mask hides nothing:
+  PolymorphismMultiGContainer::LocusView all = pmgc.locusView(0, vector<bool>());
+  for (size_t i = 0; i < pmgc.size(); ++i)
+  {
+    if (!sameEntry(pmgc, i, 0, all[i], false))
+    {
+      cout << "An empty mask hides individual " << i << "." << endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
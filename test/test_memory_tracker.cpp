@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/BiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/DataSet/DataSet.h>
+#include <Bpp/PopGen/MemoryUsage.h>
+#include <Bpp/PopGen/MultilocusGenotype.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainer.h>
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace bpp;
+using namespace std;
+
+void add(PolymorphismSequenceContainer& psc, const string& name, const string& content)
+{
+  auto seq = make_unique<Sequence>(name, content, psc.getAlphabet());
+  psc.addSequence(name, seq);
+}
+
+int main()
+{
+  MemoryTracker tracker;
+  MemoryTracker::setGlobalTracker(&tracker);
+  size_t start = tracker.getCurrent();
+
+  // Sequences:
+  {
+    PolymorphismSequenceContainer psc(AlphabetTools::DNA_ALPHABET);
+    size_t empty = tracker.getCurrent();
+    add(psc, "seq0", "ACGTACGTAC");
+    size_t one = tracker.getCurrent();
+    add(psc, "seq1", "ACGAACGTAC");
+    size_t two = tracker.getCurrent();
+    if (one <= empty || two <= one || tracker.getCurrent(MemoryUsage::SITES) < 20 * sizeof(int))
+    {
+      cout << "Adding sequences is not reported: " << empty << ", " << one << ", " << two << "." << endl;
+      return 1;
+    }
+    psc.deleteSequence(1);
+    if (tracker.getCurrent() != one)
+    {
+      cout << "Deleting a sequence is not reported: " << tracker.getCurrent() << " instead of " << one << "." << endl;
+      return 1;
+    }
+    {
+      PolymorphismSequenceContainer copy(psc);
+      if (tracker.getCurrent() <= one)
+      {
+        cout << "A copy is not reported." << endl;
+        return 1;
+      }
+    }
+    if (tracker.getCurrent() != one)
+    {
+      cout << "A destroyed copy is not released." << endl;
+      return 1;
+    }
+    psc.clear();
+    if (tracker.getCurrent() >= one)
+    {
+      cout << "Clearing the container is not reported." << endl;
+      return 1;
+    }
+  }
+  if (tracker.getCurrent() != start)
+  {
+    cout << "The sequences are not released: " << tracker.getCurrent() << " instead of " << start << "." << endl;
+    return 1;
+  }
+
+  // Individuals and genotypes:
+  {
+    DataSet ds;
+    ds.addEmptyGroup(0);
+    ds.initAnalyzedLoci(3);
+    size_t empty = tracker.getCurrent();
+    ds.addEmptyIndividualToGroup(0, "ind0");
+    ds.initIndividualGenotypeInGroup(0, 0);
+    size_t individual = tracker.getCurrent();
+    ds.setIndividualMonolocusGenotypeInGroup(0, 0, 1, BiAlleleMonolocusGenotype(0, 1));
+    size_t genotype = tracker.getCurrent();
+    if (individual <= empty || genotype <= individual || tracker.getCurrent(MemoryUsage::GENOTYPES) == 0)
+    {
+      cout << "Adding an individual is not reported: " << empty << ", " << individual << ", " << genotype << "." << endl;
+      return 1;
+    }
+    ds.addEmptyIndividualToGroup(0, "ind1");
+    if (tracker.getCurrent() <= genotype)
+    {
+      cout << "Adding a second individual is not reported." << endl;
+      return 1;
+    }
+    ds.deleteIndividualAtPositionFromGroup(0, 1);
+    if (tracker.getCurrent() != genotype)
+    {
+      cout << "Deleting an individual is not reported: " << tracker.getCurrent() << " instead of " << genotype << "." << endl;
+      return 1;
+    }
+    ds.deleteIndividualAtPositionFromGroup(0, 0);
+    if (tracker.getCurrent() != empty)
+    {
+      cout << "Deleting an individual with a genotype is not reported: " << tracker.getCurrent() << " instead of " << empty << "." << endl;
+      return 1;
+    }
+    ds.addEmptyIndividualToGroup(0, "ind2");
+  }
+  if (tracker.getCurrent() != start)
+  {
+    cout << "The data set is not released: " << tracker.getCurrent() << " instead of " << start << "." << endl;
+    return 1;
+  }
+
+  // Multilocus genotypes:
+  {
+    PolymorphismMultiGContainer pmgc;
+    size_t empty = tracker.getCurrent();
+    auto mg = make_unique<MultilocusGenotype>(3);
+    mg->setMonolocusGenotype(0, BiAlleleMonolocusGenotype(0, 1));
+    auto copy = make_unique<MultilocusGenotype>(*mg);
+    pmgc.addMultilocusGenotype(mg, 0);
+    size_t one = tracker.getCurrent();
+    pmgc.addMultilocusGenotype(copy, 1);
+    if (one <= empty || tracker.getCurrent() <= one)
+    {
+      cout << "Adding genotypes is not reported." << endl;
+      return 1;
+    }
+    pmgc.deleteMultilocusGenotype(1);
+    if (tracker.getCurrent() != one)
+    {
+      cout << "Deleting a genotype is not reported: " << tracker.getCurrent() << " instead of " << one << "." << endl;
+      return 1;
+    }
+  }
+  if (tracker.getCurrent() != start || tracker.getPeak() <= start)
+  {
+    cout << "The genotypes are not released: " << tracker.getCurrent() << " instead of " << start << "." << endl;
+    return 1;
+  }
+
+  // Nothing is reported without a tracker:
+  MemoryTracker::setGlobalTracker(nullptr);
+  PolymorphismSequenceContainer untracked(AlphabetTools::DNA_ALPHABET);
+  add(untracked, "seq0", "ACGT");
+  if (tracker.getCurrent() != start)
+  {
+    cout << "A container reports to an uninstalled tracker." << endl;
+    return 1;
+  }
+
+  return 0;
+}
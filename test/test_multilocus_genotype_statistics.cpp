@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Numeric/Random/RandomTools.h>
+#include <Bpp/PopGen/BiAlleleMonolocusGenotype.h>
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/MultilocusGenotype.h>
+#include <Bpp/PopGen/MultilocusGenotypeStatistics.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainer.h>
+#include <Bpp/PopGen/PolymorphismMultiGContainerTools.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool samePerm(const MultilocusGenotypeStatistics::PermResults& x, const MultilocusGenotypeStatistics::PermResults& y)
+{
+  return x.statistic == y.statistic && x.percentSup == y.percentSup && x.percentInf == y.percentInf;
+}
+
+int main()
+{
+  default_random_engine generator(23);
+  uniform_int_distribution<size_t> allele(0, 3);
+  bernoulli_distribution missing(0.05);
+  size_t nbLoci = 120;
+  PolymorphismMultiGContainer pmgc;
+  for (size_t i = 0; i < 48; ++i)
+  {
+    auto mg = make_unique<MultilocusGenotype>(nbLoci);
+    for (size_t l = 0; l < nbLoci; ++l)
+    {
+      if (!missing(generator))
+        mg->setMonolocusGenotype(l, BiAlleleMonolocusGenotype((allele(generator) + i % 4) % (l % 3 + 2), allele(generator) % 2));
+    }
+    pmgc.addMultilocusGenotype(mg, i % 4);
+  }
+  vector<size_t> positions(nbLoci);
+  for (size_t l = 0; l < nbLoci; ++l)
+  {
+    positions[l] = l;
+  }
+  set<size_t> groups = {0, 1, 2, 3};
+  ExecutionContext context(4);
+
+  // Multilocus estimates and distances do not depend on the execution context:
+  double rh = MultilocusGenotypeStatistics::getRHMultilocusFst(pmgc, positions, groups);
+  cout << "RH Fst = " << rh << endl;
+  if (rh != MultilocusGenotypeStatistics::getRHMultilocusFst(pmgc, positions, groups, context)
+      || MultilocusGenotypeStatistics::getWCMultilocusFis(pmgc, positions, groups)
+      != MultilocusGenotypeStatistics::getWCMultilocusFis(pmgc, positions, groups, context))
+  {
+    cout << "Multilocus estimates differ between contexts." << endl;
+    return 1;
+  }
+  for (string method : {"nei72", "nei78", "WC", "RH"})
+  {
+    unique_ptr<DistanceMatrix> seq = MultilocusGenotypeStatistics::getDistanceMatrix(pmgc, positions, groups, method);
+    unique_ptr<DistanceMatrix> par = MultilocusGenotypeStatistics::getDistanceMatrix(pmgc, positions, groups, method, context);
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+      for (size_t j = 0; j < groups.size(); ++j)
+      {
+        if ((*seq)(i, j) != (*par)(i, j) || (*seq)(i, j) != (*seq)(j, i))
+        {
+          cout << "Distance " << method << " differs between contexts at (" << i << ", " << j << ")." << endl;
+          return 1;
+        }
+      }
+    }
+  }
+
+  // Loci are read at their positions, a monomorphic one being skipped:
+  PolymorphismMultiGContainer small;
+  vector< vector<size_t> > locus1 = {{0, 0}, {0, 1}, {0, 0}, {0, 0}, {1, 1}, {1, 0}, {1, 1}, {0, 1}};
+  vector< vector<size_t> > locus2 = {{0, 1}, {1, 1}, {2, 1}, {0, 0}, {2, 2}, {1, 2}, {0, 2}, {2, 2}};
+  for (size_t i = 0; i < locus1.size(); ++i)
+  {
+    auto mg = make_unique<MultilocusGenotype>(3);
+    mg->setMonolocusGenotype(0, BiAlleleMonolocusGenotype(0, 0));
+    mg->setMonolocusGenotype(1, BiAlleleMonolocusGenotype(locus1[i][0], locus1[i][1]));
+    mg->setMonolocusGenotype(2, BiAlleleMonolocusGenotype(locus2[i][0], locus2[i][1]));
+    small.addMultilocusGenotype(mg, i / 4);
+  }
+  set<size_t> pair = {0, 1};
+  double rhAll = MultilocusGenotypeStatistics::getRHMultilocusFst(small, {0, 1, 2}, pair);
+  double rh1 = MultilocusGenotypeStatistics::getRHMultilocusFst(small, {1}, pair);
+  double rh2 = MultilocusGenotypeStatistics::getRHMultilocusFst(small, {2}, pair);
+  if (rh1 == rh2 || rhAll != MultilocusGenotypeStatistics::getRHMultilocusFst(small, {1, 2}, pair)
+      || rhAll != MultilocusGenotypeStatistics::getRHMultilocusFst(small, {2, 1, 0}, pair, context)
+      || rhAll <= min(rh1, rh2) || rhAll >= max(rh1, rh2))
+  {
+    cout << "RH Fst does not use the locus positions: " << rh1 << ", " << rh2 << ", " << rhAll << "." << endl;
+    return 1;
+  }
+
+  // Intra-group permutations keep the individuals of the other groups once and the missing genotypes:
+  mt19937 permGenerator(11);
+  unique_ptr<PolymorphismMultiGContainer> permuted = PolymorphismMultiGContainerTools::permuteIntraGroupAlleles(pmgc, {0, 1}, permGenerator);
+  if (permuted->size() != pmgc.size())
+  {
+    cout << "Permuted container has " << permuted->size() << " individuals instead of " << pmgc.size() << "." << endl;
+    return 1;
+  }
+  for (size_t g : groups)
+  {
+    size_t nbMissing = 0, nbPermutedMissing = 0;
+    for (size_t i = 0; i < pmgc.size(); ++i)
+    {
+      for (size_t l = 0; l < nbLoci; ++l)
+      {
+        if (pmgc.getGroupId(i) == g && pmgc.multilocusGenotype(i).isMonolocusGenotypeMissing(l))
+          nbMissing++;
+        if (permuted->getGroupId(i) == g && permuted->multilocusGenotype(i).isMonolocusGenotypeMissing(l))
+          nbPermutedMissing++;
+      }
+    }
+    if (permuted->getGroupSize(g) != pmgc.getGroupSize(g) || nbPermutedMissing != nbMissing)
+    {
+      cout << "Permutation changes group " << g << "." << endl;
+      return 1;
+    }
+  }
+
+  // Parallel permutation tests do not depend on the number of threads:
+  ExecutionContext two(2);
+  RandomTools::DEFAULT_GENERATOR.seed(7);
+  MultilocusGenotypeStatistics::PermResults fst2 = MultilocusGenotypeStatistics::getWCMultilocusFstAndPerm(pmgc, positions, groups, 20, two);
+  MultilocusGenotypeStatistics::PermResults fis2 = MultilocusGenotypeStatistics::getWCMultilocusFisAndPerm(pmgc, positions, groups, 20, two);
+  RandomTools::DEFAULT_GENERATOR.seed(7);
+  MultilocusGenotypeStatistics::PermResults fst4 = MultilocusGenotypeStatistics::getWCMultilocusFstAndPerm(pmgc, positions, groups, 20, context);
+  MultilocusGenotypeStatistics::PermResults fis4 = MultilocusGenotypeStatistics::getWCMultilocusFisAndPerm(pmgc, positions, groups, 20, context);
+  cout << "Fst = " << fst2.statistic << " (" << fst2.percentSup << ", " << fst2.percentInf << ")" << endl;
+  if (!samePerm(fst2, fst4) || !samePerm(fis2, fis4))
+  {
+    cout << "Permutation tests depend on the number of threads." << endl;
+    return 1;
+  }
+  if (fst2.statistic != MultilocusGenotypeStatistics::getWCMultilocusFst(pmgc, positions, groups))
+  {
+    cout << "Permutation test does not report the observed Fst." << endl;
+    return 1;
+  }
+
+  return 0;
+}
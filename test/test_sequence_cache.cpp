@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/PopGen/SequenceStatistics.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool same(double a, double b)
+{
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+void add(PolymorphismSequenceContainer& psc, const string& name, const string& content)
+{
+  auto seq = make_unique<Sequence>(name, content, psc.getAlphabet());
+  psc.addSequence(name, seq);
+}
+
+/**
+ * @brief Compare the statistics of a container with the ones of an uncached copy.
+ */
+bool sameAsUncached(const PolymorphismSequenceContainer& psc)
+{
+  PolymorphismSequenceContainer copy(psc);
+  copy.setCacheEnabled(false);
+  for (bool gapflag : {true, false})
+  {
+    if (SequenceStatistics::numberOfPolymorphicSites(psc, gapflag) != SequenceStatistics::numberOfPolymorphicSites(copy, gapflag)
+        || SequenceStatistics::numberOfSingletons(psc, gapflag) != SequenceStatistics::numberOfSingletons(copy, gapflag)
+        || SequenceStatistics::totalNumberOfMutations(psc, gapflag) != SequenceStatistics::totalNumberOfMutations(copy, gapflag)
+        || !same(SequenceStatistics::tajima83(psc, gapflag), SequenceStatistics::tajima83(copy, gapflag))
+        || !same(SequenceStatistics::heterozygosity(psc, gapflag), SequenceStatistics::heterozygosity(copy, gapflag)))
+      return false;
+  }
+  return true;
+}
+
+int main()
+{
+  shared_ptr<const Alphabet> alpha = AlphabetTools::DNA_ALPHABET;
+  default_random_engine generator(3);
+  uniform_int_distribution<int> nucleotide(0, 3);
+  bernoulli_distribution mutated(0.3);
+  bernoulli_distribution missing(0.05);
+  string ancestor(50, 'A');
+  for (auto& c : ancestor)
+  {
+    c = "ACGT"[nucleotide(generator)];
+  }
+  auto draw = [&]() {
+        string content = ancestor;
+        for (auto& c : content)
+        {
+          if (mutated(generator))
+            c = "ACGT"[nucleotide(generator)];
+          if (missing(generator))
+            c = missing(generator) ? 'N' : '-';
+        }
+        return content;
+      };
+
+  PolymorphismSequenceContainer psc(alpha);
+  for (size_t i = 0; i < 8; ++i)
+  {
+    add(psc, "seq" + to_string(i), draw());
+  }
+
+  // A result is computed once while the cache is enabled, at each call otherwise:
+  unsigned int nbComputations = 0;
+  auto compute = [&]() {
+        nbComputations++;
+        return make_shared<const unsigned int>(nbComputations);
+      };
+  psc.getDerived<unsigned int>("test", compute);
+  psc.getDerived<unsigned int>("test", compute);
+  if (psc.isCacheEnabled() || nbComputations != 2)
+  {
+    cout << "Results are cached by default." << endl;
+    return 1;
+  }
+  psc.setCacheEnabled(true);
+  psc.getDerived<unsigned int>("test", compute);
+  if (*psc.getDerived<unsigned int>("test", compute) != 3 || nbComputations != 3)
+  {
+    cout << "The cached result is not reused." << endl;
+    return 1;
+  }
+  psc.notifyModification();
+  if (*psc.getDerived<unsigned int>("test", compute) != 4)
+  {
+    cout << "The cached result is reused after a modification." << endl;
+    return 1;
+  }
+  psc.setCacheEnabled(false);
+  psc.setCacheEnabled(true);
+  if (*psc.getDerived<unsigned int>("test", compute) != 5)
+  {
+    cout << "Disabling the cache does not empty it." << endl;
+    return 1;
+  }
+
+  // The cached statistics follow the modifications of the container:
+  if (!sameAsUncached(psc))
+  {
+    cout << "Cached statistics differ from the uncached ones." << endl;
+    return 1;
+  }
+  add(psc, "added", draw());
+  if (!sameAsUncached(psc))
+  {
+    cout << "Cached statistics are stale after adding a sequence." << endl;
+    return 1;
+  }
+  psc.deleteSequence(2);
+  if (!sameAsUncached(psc))
+  {
+    cout << "Cached statistics are stale after deleting a sequence." << endl;
+    return 1;
+  }
+  psc.setSequenceCount(0, 4);
+  if (!sameAsUncached(psc))
+  {
+    cout << "Cached statistics are stale after changing a sequence count." << endl;
+    return 1;
+  }
+
+  // Copies and assignments keep the setting, but not the results of the other container:
+  PolymorphismSequenceContainer other(alpha);
+  add(other, "other0", draw());
+  add(other, "other1", draw());
+  other.setCacheEnabled(true);
+  unsigned int before = SequenceStatistics::numberOfPolymorphicSites(other, false);
+  other = psc;
+  if (!other.isCacheEnabled() || !PolymorphismSequenceContainer(psc).isCacheEnabled()
+      || SequenceStatistics::numberOfPolymorphicSites(other, false) != SequenceStatistics::numberOfPolymorphicSites(psc, false)
+      || !sameAsUncached(other))
+  {
+    cout << "Wrong cache after an assignment (" << before << " sites before)." << endl;
+    return 1;
+  }
+  PolymorphismSequenceContainer uncached(alpha);
+  other = uncached;
+  if (other.isCacheEnabled())
+  {
+    cout << "The cache setting is not assigned." << endl;
+    return 1;
+  }
+
+  return 0;
+}
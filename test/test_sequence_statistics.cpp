@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/ExecutionContext.h>
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/PopGen/SequenceStatistics.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool same(double a, double b)
+{
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+bool same(const Vdouble& x, const Vdouble& y)
+{
+  if (x.size() != y.size())
+    return false;
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    if (!same(x[i], y[i]))
+      return false;
+  }
+  return true;
+}
+
+int main()
+{
+  shared_ptr<const Alphabet> alpha = AlphabetTools::DNA_ALPHABET;
+
+  // Gaps and unresolved characters are not compared:
+  PolymorphismSequenceContainer small(alpha);
+  vector<string> contents = {"ACGT-A", "ACTTAA", "NCGTAC"};
+  for (size_t i = 0; i < contents.size(); ++i)
+  {
+    string name = "seq" + to_string(i);
+    auto seq = make_unique<Sequence>(name, contents[i], alpha);
+    small.addSequence(name, seq);
+  }
+  unique_ptr<DistanceMatrix> differences = SequenceStatistics::pairwiseDifferences(small);
+  unique_ptr<DistanceMatrix> distances = SequenceStatistics::pairwiseDifferences(small, true);
+  if ((*differences)(0, 1) != 1. || (*differences)(0, 2) != 1. || (*differences)(1, 2) != 2.
+      || abs((*distances)(0, 1) - 0.2) > 1e-12 || abs((*distances)(0, 2) - 0.25) > 1e-12
+      || abs((*distances)(1, 2) - 0.4) > 1e-12 || (*distances)(2, 1) != (*distances)(1, 2))
+  {
+    cout << "Wrong pairwise differences." << endl;
+    return 1;
+  }
+
+  // The statistics do not depend on the execution context (gaps only in the first sites,
+  // so that the LD statistics have complete sites):
+  default_random_engine generator(29);
+  uniform_real_distribution<double> uniform(0., 1.);
+  string bases = "ACGT";
+  size_t nbSequences = 90, nbSites = 200;
+  string reference(nbSites, 'A');
+  for (size_t s = 0; s < nbSites; ++s)
+  {
+    reference[s] = bases[static_cast<size_t>(uniform(generator) * 4.) % 4];
+  }
+  PolymorphismSequenceContainer psc(alpha);
+  for (size_t i = 0; i < nbSequences; ++i)
+  {
+    string content = reference;
+    for (size_t s = 0; s < nbSites; ++s)
+    {
+      double u = uniform(generator);
+      if (s < 20 && u < 0.05)
+        content[s] = '-';
+      else if (u < 0.1 + 0.1 * static_cast<double>(i % 2))
+        content[s] = bases[(bases.find(reference[s]) + 1) % 4];
+    }
+    string name = "seq" + to_string(i);
+    auto seq = make_unique<Sequence>(name, content, alpha);
+    psc.addSequence(name, seq);
+    psc.setGroupId(i, i % 2 + 1);
+  }
+  ExecutionContext context(4);
+  unique_ptr<DistanceMatrix> seq = SequenceStatistics::pairwiseDifferences(psc, true);
+  unique_ptr<DistanceMatrix> par = SequenceStatistics::pairwiseDifferences(psc, true, context);
+  for (size_t i = 0; i < nbSequences; ++i)
+  {
+    for (size_t j = 0; j < nbSequences; ++j)
+    {
+      if (!same((*seq)(i, j), (*par)(i, j)) || !same((*seq)(i, j), (*seq)(j, i)))
+      {
+        cout << "Pairwise differences differ at (" << i << ", " << j << ")." << endl;
+        return 1;
+      }
+    }
+  }
+  if (!same(SequenceStatistics::fstHudson92(psc, 1, 2), SequenceStatistics::fstHudson92(psc, 1, 2, context)))
+  {
+    cout << "Fst of Hudson et al. differs between contexts." << endl;
+    return 1;
+  }
+  if (!same(SequenceStatistics::pairwiseD(psc), SequenceStatistics::pairwiseD(psc, true, 0., context))
+      || !same(SequenceStatistics::pairwiseDprime(psc), SequenceStatistics::pairwiseDprime(psc, true, 0., context))
+      || !same(SequenceStatistics::pairwiseR2(psc), SequenceStatistics::pairwiseR2(psc, true, 0., context)))
+  {
+    cout << "Pairwise LD differs between contexts." << endl;
+    return 1;
+  }
+  if (!same(SequenceStatistics::hudson87(psc), SequenceStatistics::hudson87(psc, 0.000001, 0.001, 10000., context)))
+  {
+    cout << "Hudson's C differs between contexts." << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/PopGen/SequenceStatistics.h>
+#include <Bpp/PopGen/SitePatterns.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool same(double a, double b)
+{
+  return abs(a - b) < 1e-9 || (std::isnan(a) && std::isnan(b));
+}
+
+void add(PolymorphismSequenceContainer& psc, const string& name, const string& content)
+{
+  auto seq = make_unique<Sequence>(name, content, psc.getAlphabet());
+  psc.addSequence(name, seq);
+}
+
+bool sameColumn(const Site& x, const Site& y, size_t nbSequences)
+{
+  for (size_t j = 0; j < nbSequences; ++j)
+  {
+    if (x.getValue(j) != y.getValue(j))
+      return false;
+  }
+  return true;
+}
+
+int main()
+{
+  // Few haplotypes, so that many sites share the same pattern:
+  shared_ptr<const Alphabet> alpha = AlphabetTools::DNA_ALPHABET;
+  default_random_engine generator(29);
+  uniform_int_distribution<int> nucleotide(0, 3);
+  uniform_int_distribution<size_t> haplotype(0, 2);
+  bernoulli_distribution mutated(0.3);
+  bernoulli_distribution missing(0.02);
+  vector<string> haplotypes(3, string(200, 'A'));
+  for (size_t site = 0; site < 200; ++site)
+  {
+    haplotypes[0][site] = "AC"[nucleotide(generator) % 2];
+    for (size_t h = 1; h < haplotypes.size(); ++h)
+    {
+      haplotypes[h][site] = mutated(generator) ? "AC"[nucleotide(generator) % 2] : haplotypes[h - 1][site];
+    }
+  }
+  PolymorphismSequenceContainer psc(alpha);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    string content = haplotypes[haplotype(generator)];
+    for (auto& c : content)
+    {
+      if (missing(generator))
+        c = missing(generator) ? 'N' : '-';
+    }
+    add(psc, "seq" + to_string(i), content);
+  }
+
+  // Each site is stored once, in the pattern of its column:
+  SitePatterns patterns(psc);
+  size_t nbSequences = psc.getNumberOfSequences();
+  if (patterns.getNumberOfSites() != psc.getNumberOfSites() || patterns.getNumberOfSequences() != nbSequences
+      || patterns.getNumberOfPatterns() >= psc.getNumberOfSites() / 2)
+  {
+    cout << "Wrong dimensions: " << patterns.getNumberOfPatterns() << " patterns." << endl;
+    return 1;
+  }
+  size_t nbSites = 0;
+  for (size_t p = 0; p < patterns.getNumberOfPatterns(); ++p)
+  {
+    const vector<size_t>& positions = patterns.getPositions(p);
+    if (positions.size() != patterns.getWeight(p) || positions.empty() || !sameColumn(patterns.getPattern(p), psc.site(positions[0]), nbSequences)
+        || (p > 0 && positions[0] < patterns.getPositions(p - 1)[0]))
+    {
+      cout << "Wrong positions of pattern " << p << "." << endl;
+      return 1;
+    }
+    for (size_t k = 0; k < positions.size(); ++k)
+    {
+      if ((k > 0 && positions[k] <= positions[k - 1]) || patterns.getPatternIndex(positions[k]) != p)
+      {
+        cout << "Wrong positions of pattern " << p << "." << endl;
+        return 1;
+      }
+    }
+    for (size_t q = 0; q < p; ++q)
+    {
+      if (sameColumn(patterns.getPattern(p), patterns.getPattern(q), nbSequences))
+      {
+        cout << "Patterns " << q << " and " << p << " are the same." << endl;
+        return 1;
+      }
+    }
+    nbSites += positions.size();
+  }
+  for (size_t site = 0; site < psc.getNumberOfSites(); ++site)
+  {
+    if (!sameColumn(patterns.getPattern(patterns.getPatternIndex(site)), psc.site(site), nbSequences))
+    {
+      cout << "Site " << site << " differs from its pattern." << endl;
+      return 1;
+    }
+  }
+  if (nbSites != psc.getNumberOfSites())
+  {
+    cout << "The weights sum to " << nbSites << " sites." << endl;
+    return 1;
+  }
+
+  // The statistics of the patterns are those of the sites:
+  for (bool gapflag : {true, false})
+  {
+    for (bool ignoreUnknown : {true, false})
+    {
+      if (SequenceStatistics::numberOfPolymorphicSites(patterns, gapflag, ignoreUnknown) != SequenceStatistics::numberOfPolymorphicSites(psc, gapflag, ignoreUnknown)
+          || !same(SequenceStatistics::frequencyOfPolymorphicSites(patterns, gapflag, ignoreUnknown), SequenceStatistics::frequencyOfPolymorphicSites(psc, gapflag, ignoreUnknown)))
+      {
+        cout << "Wrong number of polymorphic sites with gapflag = " << gapflag << ", ignoreUnknown = " << ignoreUnknown << "." << endl;
+        return 1;
+      }
+      for (bool scaled : {true, false})
+      {
+        if (!same(SequenceStatistics::watterson75(patterns, gapflag, ignoreUnknown, scaled), SequenceStatistics::watterson75(psc, gapflag, ignoreUnknown, scaled))
+            || !same(SequenceStatistics::tajima83(patterns, gapflag, ignoreUnknown, scaled), SequenceStatistics::tajima83(psc, gapflag, ignoreUnknown, scaled)))
+        {
+          cout << "Wrong estimators of theta with gapflag = " << gapflag << ", ignoreUnknown = " << ignoreUnknown << ", scaled = " << scaled << "." << endl;
+          return 1;
+        }
+      }
+    }
+    if (SequenceStatistics::numberOfSingletons(patterns, gapflag) != SequenceStatistics::numberOfSingletons(psc, gapflag)
+        || SequenceStatistics::totalNumberOfMutations(patterns, gapflag) != SequenceStatistics::totalNumberOfMutations(psc, gapflag)
+        || !same(SequenceStatistics::heterozygosity(patterns, gapflag), SequenceStatistics::heterozygosity(psc, gapflag))
+        || !same(SequenceStatistics::squaredHeterozygosity(patterns, gapflag), SequenceStatistics::squaredHeterozygosity(psc, gapflag)))
+    {
+      cout << "Wrong per-site statistics with gapflag = " << gapflag << "." << endl;
+      return 1;
+    }
+  }
+
+  // The indices are checked:
+  try
+  {
+    patterns.getWeight(patterns.getNumberOfPatterns());
+    cout << "A pattern out of bounds is accepted." << endl;
+    return 1;
+  }
+  catch (IndexOutOfBoundsException& e)
+  {}
+  try
+  {
+    patterns.getPatternIndex(psc.getNumberOfSites());
+    cout << "A site out of bounds is accepted." << endl;
+    return 1;
+  }
+  catch (IndexOutOfBoundsException& e)
+  {}
+
+  return 0;
+}
@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/PopGen/SequenceStatistics.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool same(double a, double b)
+{
+  return abs(a - b) < 1e-9 || (std::isnan(a) && std::isnan(b));
+}
+
+void add(PolymorphismSequenceContainer& psc, const string& name, const string& content)
+{
+  auto seq = make_unique<Sequence>(name, content, psc.getAlphabet());
+  psc.addSequence(name, seq);
+}
+
+/**
+ * @brief The summary of a container, computed site by site with the formulas of Tajima (1989).
+ */
+SequenceStatistics::SiteSampleSizeSummary naiveSummary(const PolymorphismSequenceContainer& psc)
+{
+  size_t total = 0;
+  for (size_t j = 0; j < psc.getNumberOfSequences(); ++j)
+  {
+    total += psc.getSequenceCount(j);
+  }
+  SequenceStatistics::SiteSampleSizeSummary summary;
+  summary.sampleSizeHistogram.resize(total + 1);
+  double sumE1 = 0., sumE2 = 0.;
+  for (size_t i = 0; i < psc.getNumberOfSites(); ++i)
+  {
+    map<int, size_t> counts;
+    size_t n = 0;
+    for (size_t j = 0; j < psc.getNumberOfSequences(); ++j)
+    {
+      int state = psc.site(i).getValue(j);
+      if (state >= 0 && state < 4)
+      {
+        counts[state] += psc.getSequenceCount(j);
+        n += psc.getSequenceCount(j);
+      }
+    }
+    summary.sampleSizeHistogram[n]++;
+    if (n < 2)
+      continue;
+    summary.numberOfSites++;
+    if (counts.size() < 2)
+      continue;
+    summary.numberOfPolymorphicSites++;
+    double homozygosity = 0.;
+    for (auto& k : counts)
+    {
+      homozygosity += static_cast<double>(k.second * (k.second - 1)) / static_cast<double>(n * (n - 1));
+    }
+    summary.pi += 1. - homozygosity;
+    double nn = static_cast<double>(n), a1 = 0., a2 = 0.;
+    for (size_t k = 1; k < n; ++k)
+    {
+      a1 += 1. / static_cast<double>(k);
+      a2 += 1. / static_cast<double>(k * k);
+    }
+    double b1 = (nn + 1.) / (3. * (nn - 1.));
+    double b2 = 2. * (nn * nn + nn + 3.) / (9. * nn * (nn - 1.));
+    double c1 = b1 - 1. / a1;
+    double c2 = b2 - (nn + 2.) / (a1 * nn) + a2 / (a1 * a1);
+    summary.thetaW += 1. / a1;
+    sumE1 += c1 / a1;
+    sumE2 += c2 / (a1 * a1 + a2);
+  }
+  double s = static_cast<double>(summary.numberOfPolymorphicSites);
+  summary.tajimaD = summary.numberOfPolymorphicSites > 0 ? (summary.pi - summary.thetaW) / sqrt(sumE1 + sumE2 * (s - 1.)) : NAN;
+  return summary;
+}
+
+bool same(const SequenceStatistics::SiteSampleSizeSummary& x, const SequenceStatistics::SiteSampleSizeSummary& y)
+{
+  return x.numberOfSites == y.numberOfSites && x.numberOfPolymorphicSites == y.numberOfPolymorphicSites
+         && same(x.pi, y.pi) && same(x.thetaW, y.thetaW) && same(x.tajimaD, y.tajimaD)
+         && x.sampleSizeHistogram == y.sampleSizeHistogram;
+}
+
+int main()
+{
+  shared_ptr<const Alphabet> alpha = AlphabetTools::DNA_ALPHABET;
+  default_random_engine generator(5);
+  uniform_int_distribution<int> nucleotide(0, 3);
+  bernoulli_distribution mutated(0.2);
+  bernoulli_distribution missing(0.08);
+  string ancestor(80, 'A');
+  for (auto& c : ancestor)
+  {
+    c = "ACGT"[nucleotide(generator)];
+  }
+
+  PolymorphismSequenceContainer psc(alpha);
+  vector<string> contents;
+  for (size_t i = 0; i < 12; ++i)
+  {
+    string content = ancestor;
+    for (auto& c : content)
+    {
+      if (mutated(generator))
+        c = "ACGT"[nucleotide(generator)];
+      if (missing(generator))
+        c = missing(generator) ? 'N' : '-';
+    }
+    contents.push_back(content);
+    add(psc, "seq" + to_string(i), content);
+  }
+
+  // The same alignment, restricted to its complete sites:
+  PolymorphismSequenceContainer complete(alpha);
+  for (size_t i = 0; i < contents.size(); ++i)
+  {
+    string content;
+    for (size_t site = 0; site < ancestor.size(); ++site)
+    {
+      bool resolved = true;
+      for (auto& c : contents)
+      {
+        resolved = resolved && c[site] != '-' && c[site] != 'N';
+      }
+      if (resolved)
+        content += contents[i][site];
+    }
+    add(complete, "seq" + to_string(i), content);
+  }
+
+  // Without missing data, the summary gives the usual estimates:
+  SequenceStatistics::SiteSampleSizeSummary summary = SequenceStatistics::siteSampleSizeSummary(complete);
+  if (summary.numberOfSites != complete.getNumberOfSites()
+      || summary.numberOfPolymorphicSites != SequenceStatistics::numberOfPolymorphicSites(complete, false)
+      || !same(summary.pi, SequenceStatistics::tajima83(complete, false))
+      || !same(summary.thetaW, SequenceStatistics::watterson75(complete, false))
+      || !same(summary.tajimaD, SequenceStatistics::tajimaDss(complete, false)))
+  {
+    cout << "Wrong summary without missing data: pi = " << summary.pi << ", thetaW = " << summary.thetaW << ", D = " << summary.tajimaD << "." << endl;
+    return 1;
+  }
+
+  // With missing data and sequence counts, each site has its own sample size:
+  psc.setCacheEnabled(true);
+  for (bool cached : {false, true})
+  {
+    psc.setCacheEnabled(cached);
+    if (!same(SequenceStatistics::siteSampleSizeSummary(psc), naiveSummary(psc)))
+    {
+      cout << "Wrong summary with missing data." << endl;
+      return 1;
+    }
+    psc.setSequenceCount(3, 4);
+    psc.setSequenceCount(7, 2);
+    if (!same(SequenceStatistics::siteSampleSizeSummary(psc), naiveSummary(psc)))
+    {
+      cout << "Wrong summary with sequence counts." << endl;
+      return 1;
+    }
+    psc.setSequenceCount(3, 1);
+    psc.setSequenceCount(7, 1);
+
+    // The statistics of the complete sites are those of the restricted alignment:
+    if (SequenceStatistics::numberOfPolymorphicSites(psc, true) != SequenceStatistics::numberOfPolymorphicSites(complete, false)
+        || SequenceStatistics::numberOfSingletons(psc, true) != SequenceStatistics::numberOfSingletons(complete, false)
+        || SequenceStatistics::totalNumberOfMutations(psc, true) != SequenceStatistics::totalNumberOfMutations(complete, false)
+        || !same(SequenceStatistics::frequencyOfPolymorphicSites(psc, true), SequenceStatistics::frequencyOfPolymorphicSites(complete, false))
+        || !same(SequenceStatistics::tajima83(psc, true), SequenceStatistics::tajima83(complete, false))
+        || !same(SequenceStatistics::tajima83(psc, true, true, true), SequenceStatistics::tajima83(complete, false, true, true)))
+    {
+      cout << "The statistics of the complete sites differ from the ones of the restricted alignment." << endl;
+      return 1;
+    }
+  }
+
+  // The aggregates must have the same size:
+  try
+  {
+    SequenceStatistics::siteSampleSizeSummary(vector<unsigned int>(5), vector<unsigned int>(4), vector<size_t>(5));
+    cout << "Aggregates of different sizes are accepted." << endl;
+    return 1;
+  }
+  catch (DimensionException& e)
+  {}
+  try
+  {
+    SequenceStatistics::siteSampleSizeSummary(vector<unsigned int>(5), vector<unsigned int>(5), vector<size_t>(6));
+    cout << "Aggregates of different sizes are accepted." << endl;
+    return 1;
+  }
+  catch (DimensionException& e)
+  {}
+
+  return 0;
+}
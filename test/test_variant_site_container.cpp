@@ -0,0 +1,252 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/PopGen/PolymorphismSequenceContainer.h>
+#include <Bpp/PopGen/SequenceStatistics.h>
+#include <Bpp/PopGen/VariantSiteContainer.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Sequence.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+bool same(double a, double b)
+{
+  return abs(a - b) < 1e-9 || (std::isnan(a) && std::isnan(b));
+}
+
+void add(PolymorphismSequenceContainer& psc, const string& name, const string& content)
+{
+  auto seq = make_unique<Sequence>(name, content, psc.getAlphabet());
+  psc.addSequence(name, seq);
+}
+
+/**
+ * @brief Compare the sequences, names, counts, groups and ingroup flags of two containers.
+ */
+bool sameContainer(const PolymorphismSequenceContainer& x, const PolymorphismSequenceContainer& y)
+{
+  if (x.getNumberOfSequences() != y.getNumberOfSequences() || x.getNumberOfSites() != y.getNumberOfSites())
+    return false;
+  for (size_t j = 0; j < x.getNumberOfSequences(); ++j)
+  {
+    if (x.sequence(j).getName() != y.sequence(j).getName() || x.getSequenceCount(j) != y.getSequenceCount(j)
+        || x.getGroupId(j) != y.getGroupId(j) || x.isIngroupMember(j) != y.isIngroupMember(j))
+      return false;
+    for (size_t i = 0; i < x.getNumberOfSites(); ++i)
+    {
+      if (x.site(i).getValue(j) != y.site(i).getValue(j))
+        return false;
+    }
+  }
+  return true;
+}
+
+int main()
+{
+  // A long alignment with few variants, and runs of missing data:
+  shared_ptr<const Alphabet> alpha = AlphabetTools::DNA_ALPHABET;
+  default_random_engine generator(31);
+  uniform_int_distribution<int> nucleotide(0, 3);
+  uniform_int_distribution<size_t> runLength(1, 20);
+  bernoulli_distribution mutated(0.005);
+  bernoulli_distribution runStart(0.002);
+  string reference(3000, 'A');
+  for (auto& c : reference)
+  {
+    c = "ACGT"[nucleotide(generator)];
+  }
+  PolymorphismSequenceContainer psc(alpha);
+  for (size_t j = 0; j < 12; ++j)
+  {
+    string content = reference;
+    for (size_t i = 0; i < content.size(); ++i)
+    {
+      if (mutated(generator))
+        content[i] = "ACGT"[nucleotide(generator)];
+      if (runStart(generator))
+      {
+        char missing = runStart(generator) ? 'N' : '-';
+        for (size_t end = min(content.size(), i + runLength(generator)); i < end; ++i)
+        {
+          content[i] = missing;
+        }
+      }
+    }
+    // A site with a single resolved state, and a site without any:
+    content[0] = j == 0 ? 'A' : '-';
+    content[1] = 'N';
+    add(psc, "seq" + to_string(j), content);
+    psc.setSequenceCount(j, static_cast<unsigned int>(1 + j % 2));
+    psc.setGroupId(j, j % 3);
+    if (j % 4 == 0)
+      psc.setAsOutgroupMember(j);
+  }
+  VariantSiteContainer vsc(psc);
+
+  // The variant sites are those with two resolved states at least:
+  vector<size_t> positions;
+  size_t nbCompleteSites = 0, nbCompleteVariantSites = 0;
+  for (size_t i = 0; i < psc.getNumberOfSites(); ++i)
+  {
+    set<int> states;
+    bool complete = true;
+    for (size_t j = 0; j < psc.getNumberOfSequences(); ++j)
+    {
+      int state = psc.site(i).getValue(j);
+      if (state >= 0 && state < 4)
+        states.insert(state);
+      else
+        complete = false;
+    }
+    if (states.size() > 1)
+      positions.push_back(i);
+    if (complete)
+      nbCompleteSites++;
+    if (complete && states.size() > 1)
+      nbCompleteVariantSites++;
+  }
+  if (vsc.getNumberOfSites() != psc.getNumberOfSites() || vsc.getNumberOfSequences() != psc.getNumberOfSequences()
+      || vsc.getVariantPositions() != positions || vsc.getNumberOfVariantSites() != positions.size()
+      || vsc.getNumberOfCompleteSites() != nbCompleteSites || vsc.getNumberOfCompleteVariantSites() != nbCompleteVariantSites
+      || nbCompleteSites == psc.getNumberOfSites() || nbCompleteVariantSites == positions.size())
+  {
+    cout << "Wrong counts of sites: " << vsc.getNumberOfVariantSites() << " variant and " << vsc.getNumberOfCompleteSites() << " complete ones." << endl;
+    return 1;
+  }
+
+  // Every character is found back, at the variant sites or in the runs of
+  // the characters departing from the reference:
+  size_t nbMissing = 0, nbRunSites = 0;
+  for (size_t i = 0; i < psc.getNumberOfSites(); ++i)
+  {
+    int reference = psc.site(i).getValue(0);
+    for (size_t j = 0; j < psc.getNumberOfSequences(); ++j)
+    {
+      int state = psc.site(i).getValue(j);
+      if (vsc.getValue(i, j) != state)
+      {
+        cout << "Wrong character of sequence " << j << " at site " << i << "." << endl;
+        return 1;
+      }
+      if (state >= 0 && state < 4)
+        reference = state;
+    }
+    for (size_t j = 0; j < psc.getNumberOfSequences(); ++j)
+    {
+      if (psc.site(i).getValue(j) != reference && !binary_search(positions.begin(), positions.end(), i))
+        nbMissing++;
+    }
+  }
+  for (size_t j = 0; j < psc.getNumberOfSequences(); ++j)
+  {
+    for (const auto& run : vsc.getRuns(j))
+    {
+      nbRunSites += run.length;
+      for (size_t i = run.start; i < run.start + run.length; ++i)
+      {
+        if (psc.site(i).getValue(j) != run.state)
+        {
+          cout << "Wrong run of sequence " << j << " at site " << i << "." << endl;
+          return 1;
+        }
+      }
+    }
+  }
+  if (nbRunSites != nbMissing)
+  {
+    cout << "The runs cover " << nbRunSites << " characters instead of " << nbMissing << "." << endl;
+    return 1;
+  }
+  for (size_t v = 0; v < positions.size(); ++v)
+  {
+    Site site = vsc.getVariantSite(v);
+    if (site.getCoordinate() != static_cast<int>(positions[v]))
+    {
+      cout << "Wrong coordinate of variant " << v << "." << endl;
+      return 1;
+    }
+    for (size_t j = 0; j < psc.getNumberOfSequences(); ++j)
+    {
+      if (site.getValue(j) != psc.site(positions[v]).getValue(j))
+      {
+        cout << "Wrong variant " << v << "." << endl;
+        return 1;
+      }
+    }
+  }
+
+  // The containers rebuilt from the sparse representation:
+  auto rebuilt = vsc.toContainer();
+  auto variants = vsc.getVariantSites();
+  if (!sameContainer(*rebuilt, psc) || variants->getNumberOfSites() != positions.size())
+  {
+    cout << "The rebuilt container differs from the original one." << endl;
+    return 1;
+  }
+  for (size_t v = 0; v < positions.size(); ++v)
+  {
+    for (size_t j = 0; j < psc.getNumberOfSequences(); ++j)
+    {
+      if (variants->site(v).getValue(j) != psc.site(positions[v]).getValue(j) || variants->getSequenceCount(j) != psc.getSequenceCount(j))
+      {
+        cout << "Wrong container of the variant sites." << endl;
+        return 1;
+      }
+    }
+  }
+
+  // The statistics are those of the complete sites of the full container:
+  if (SequenceStatistics::numberOfPolymorphicSites(vsc) != SequenceStatistics::numberOfPolymorphicSites(psc, true)
+      || !same(SequenceStatistics::frequencyOfPolymorphicSites(vsc), SequenceStatistics::frequencyOfPolymorphicSites(psc, true)))
+  {
+    cout << "Wrong number of polymorphic sites." << endl;
+    return 1;
+  }
+  for (bool scaled : {true, false})
+  {
+    if (!same(SequenceStatistics::watterson75(vsc, scaled), SequenceStatistics::watterson75(psc, true, true, scaled))
+        || !same(SequenceStatistics::tajima83(vsc, scaled), SequenceStatistics::tajima83(psc, true, true, scaled)))
+    {
+      cout << "Wrong estimators of theta with scaled = " << scaled << "." << endl;
+      return 1;
+    }
+  }
+
+  // The sparse representation is smaller:
+  if (vsc.memoryUsage().getTotal() >= psc.memoryUsage().getTotal() / 2)
+  {
+    cout << "The sparse representation uses " << vsc.memoryUsage().getTotal() << " bytes." << endl;
+    return 1;
+  }
+
+  // The indices are checked:
+  try
+  {
+    vsc.getValue(psc.getNumberOfSites(), 0);
+    cout << "A site out of bounds is accepted." << endl;
+    return 1;
+  }
+  catch (IndexOutOfBoundsException& e)
+  {}
+  try
+  {
+    vsc.getRuns(psc.getNumberOfSequences());
+    cout << "A sequence out of bounds is accepted." << endl;
+    return 1;
+  }
+  catch (IndexOutOfBoundsException& e)
+  {}
+
+  return 0;
+}